@@ -7,7 +7,12 @@ varying vec3 lightDir;
 
 void main(void)
 {
-	gl_Position = logarithmicTransform();
+	// all four corners come in at the centre, and gl_Normal moves each out
+	// in view space so the quad always faces the camera
+	vec4 viewPos = gl_ModelViewMatrix * gl_Vertex;
+	viewPos.xy += gl_Normal.xy;
+	gl_Position = gl_ProjectionMatrix * viewPos;
+	varLogDepth = gl_Position.z;
 	color = gl_Color;
 	uv = gl_MultiTexCoord0.xy * 2.0 - 1.0; //recenter to -1,1 range
 	lightDir = normalize(-gl_Vertex.xyz);
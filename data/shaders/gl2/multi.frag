@@ -50,6 +50,10 @@ void main(void)
 {
 #ifdef VERTEXCOLOR
 	vec4 color = vertexColor;
+#if (NUM_LIGHTS == 0)
+	// unlit, so the material colour tints the vertex colours
+	color *= material.diffuse;
+#endif
 #else
 	vec4 color = material.diffuse;
 #endif
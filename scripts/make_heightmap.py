@@ -0,0 +1,120 @@
+#!/usr/bin/env python
+# vim: set ts=8 sts=4 sw=4 expandtab autoindent fileencoding=utf-8:
+
+# Writes a tiled heightmap (.thm, see src/terrain/HeightMap.h) from an old
+# .hmap file or from a raw grid of 16-bit samples, such as a DEM exported
+# with gdal_translate -of ENVI -ot Int16. Needs numpy. The input is mapped
+# rather than read, so maps far bigger than memory can be converted.
+#
+#   make_heightmap.py moon.hmap moon.thm
+#   make_heightmap.py --raw 16384x8192 --signed mars.raw mars.thm
+
+import sys
+import struct
+import tempfile
+from optparse import OptionParser
+
+import numpy
+
+MAGIC = b'PHMT'
+VERSION = 1
+HEADER = '<4sIIIIIddI'
+DATA_OFFSET = 4096
+
+def load_hmap(filename, fractal):
+    head = open(filename, 'rb').read(20)
+    if fractal == 0:
+        w, h = struct.unpack('<HH', head[:4])
+        return numpy.memmap(filename, '<i2', 'r', 4, (h, w)), 1.0, 0.0
+    # x and y the other way round, and already scaled
+    h, w, scale, offset = struct.unpack('<HHdd', head)
+    return numpy.memmap(filename, '<u2', 'r', 20, (h, w)), scale, offset
+
+def to_unsigned(strip, signed):
+    # signed samples are shifted into range exactly, as the game does
+    if signed:
+        return (strip.astype(numpy.int32) + 32768).astype('<u2')
+    return strip.astype('<u2')
+
+def halve(strip):
+    # average each 2x2, repeating the last row or column of an odd size
+    h, w = strip.shape
+    if h & 1: strip = numpy.vstack((strip, strip[-1:]))
+    if w & 1: strip = numpy.hstack((strip, strip[:, -1:]))
+    l = strip.astype(numpy.uint32)
+    s = l[0::2, 0::2] + l[0::2, 1::2] + l[1::2, 0::2] + l[1::2, 1::2]
+    return ((s + 2) // 4).astype('<u2')
+
+def write_level(out, level, tile, signed, last):
+    # a strip of rows at a time, so that only that much of the level is ever
+    # in memory. returns the next level down, in a temporary mapped file
+    h, w = level.shape
+    tw = (w + tile - 1) // tile
+    strip = max(tile, 2)
+    if not last:
+        nw = (w + 1) // 2
+        nh = (h + 1) // 2
+        following = numpy.memmap(tempfile.TemporaryFile(), '<u2', 'w+', 0, (nh, nw))
+    for y in range(0, h, strip):
+        rows = to_unsigned(level[y:y+strip], signed)
+        n = rows.shape[0]
+        padded = numpy.pad(rows, ((0, (n + tile - 1) // tile * tile - n), (0, tw*tile - w)), 'edge')
+        for ty in range(0, padded.shape[0], tile):
+            for tx in range(tw):
+                out.write(numpy.ascontiguousarray(padded[ty:ty+tile, tx*tile:(tx+1)*tile]).tobytes())
+        if not last:
+            following[y//2:y//2 + (n + 1)//2] = halve(rows)
+    if last:
+        return None
+    following.flush()
+    return following
+
+def main():
+    parser = OptionParser(usage='%prog [options] input output.thm')
+    parser.add_option('--fractal', type='int', default=0,
+            help='layout of an .hmap input, as for the heightmap fractal (0 or 1)')
+    parser.add_option('--raw', metavar='WxH',
+            help='input is a headerless little endian grid of this size')
+    parser.add_option('--signed', action='store_true',
+            help='raw samples are signed')
+    parser.add_option('--scale', type='float', default=1.0,
+            help='metres per raw sample')
+    parser.add_option('--offset', type='float', default=0.0,
+            help='metres at raw sample 0')
+    parser.add_option('--tile', type='int', default=64,
+            help='tile size, a power of two')
+    (options, args) = parser.parse_args()
+    if len(args) != 2:
+        parser.error('need an input and an output')
+    tile = options.tile
+    if tile < 1 or tile & (tile - 1):
+        parser.error('tile size must be a power of two')
+
+    if options.raw:
+        w, h = [int(x) for x in options.raw.split('x')]
+        dtype = '<i2' if options.signed else '<u2'
+        level = numpy.memmap(args[0], dtype, 'r', 0, (h, w))
+        scale, offset = options.scale, options.offset
+    else:
+        level, scale, offset = load_hmap(args[0], options.fractal)
+    signed = level.dtype.kind == 'i'
+    if signed:
+        offset -= 32768 * scale
+
+    h, w = level.shape
+    levels = 1
+    while (max(w, h) + (1 << (levels - 1)) - 1) >> (levels - 1) > tile:
+        levels += 1
+
+    out = open(args[1], 'wb')
+    header = struct.pack(HEADER, MAGIC, VERSION, w, h, tile, levels, scale, offset, DATA_OFFSET)
+    out.write(header + b'\0' * (DATA_OFFSET - len(header)))
+    for i in range(levels):
+        level = write_level(out, level, tile, signed and i == 0, i == levels - 1)
+    out.close()
+
+    sys.stdout.write('%s: %dx%d, %d levels of %d tiles, %g m per sample from %g m\n'
+            % (args[1], w, h, levels, tile, scale, offset))
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,530 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "AutoSave.h"
+#include "FileSystem.h"
+#include "Game.h"
+#include "Pi.h"
+#include "Player.h"
+#include "Serializer.h"
+#include "jenkins/lookup3.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+// bump when the layout of the files changes
+static const Uint32 FORMAT_VERSION = 2;
+static const Uint32 BASE_MAGIC = 0x45534142;  // 'BASE'
+static const Uint32 DELTA_MAGIC = 0x41544c44; // 'DLTA'
+
+// every record is its magic, the size and checksum of its payload and then
+// the payload. a base file is one record, the delta file any number of them.
+//
+// every part has a key: a body's is FIRST_BODY_KEY plus its id, the others'
+// are their place in the save counting only those.
+//
+// base payload: version, generation, number of parts, then each part as its
+// key, size and bytes.
+// delta payload: version, generation of the base it applies to, number of
+// parts, the key of each in order, number of changed parts, then each of
+// those as its key, size and bytes. keys not in the order are dropped
+
+// Game::Serialize puts the bodies' parts after these
+static const Uint32 FIRST_BODY_PART = 2;
+static const Uint32 FIRST_BODY_KEY = 16;
+
+static void put_int32(std::string &out, Uint32 x)
+{
+	out.push_back(char(x & 0xff));
+	out.push_back(char((x >> 8) & 0xff));
+	out.push_back(char((x >> 16) & 0xff));
+	out.push_back(char((x >> 24) & 0xff));
+}
+
+static void put_part(std::string &out, const std::string &part)
+{
+	put_int32(out, part.size());
+	out += part;
+}
+
+namespace {
+	// Serializer::Reader asserts when it runs off the end, and these files
+	// can be torn
+	struct RecordReader {
+		RecordReader() : at(nullptr), end(nullptr), ok(false) {}
+		RecordReader(const char *begin, const char *end_) : at(begin), end(end_), ok(true) {}
+
+		Uint32 Int32() {
+			if (!ok || end - at < 4) { ok = false; return 0; }
+			const Uint32 x = Uint32(Uint8(at[0])) | (Uint32(Uint8(at[1])) << 8) |
+				(Uint32(Uint8(at[2])) << 16) | (Uint32(Uint8(at[3])) << 24);
+			at += 4;
+			return x;
+		}
+
+		void Part(std::string &out) {
+			const Uint32 size = Int32();
+			if (!ok || Uint32(end - at) < size) { ok = false; return; }
+			out.assign(at, size);
+			at += size;
+		}
+
+		const char *at;
+		const char *end;
+		bool ok;
+	};
+}
+
+// the payload of the next record, if there's a whole one
+static bool read_record(RecordReader &rd, Uint32 magic, RecordReader &payload)
+{
+	const Uint32 m = rd.Int32();
+	const Uint32 size = rd.Int32();
+	const Uint32 sum = rd.Int32();
+	if (!rd.ok || m != magic || Uint32(rd.end - rd.at) < size)
+		return false;
+	if (lookup3_hashlittle(rd.at, size, 0) != sum)
+		return false;
+	payload = RecordReader(rd.at, rd.at + size);
+	rd.at += size;
+	return true;
+}
+
+static bool write_record(FILE *f, Uint32 magic, const std::string &payload)
+{
+	std::string head;
+	put_int32(head, magic);
+	put_int32(head, payload.size());
+	put_int32(head, lookup3_hashlittle(payload.data(), payload.size(), 0));
+	if (fwrite(head.data(), head.size(), 1, f) != 1)
+		return false;
+	return payload.empty() || fwrite(payload.data(), payload.size(), 1, f) == 1;
+}
+
+static std::string base_path(const std::string &name, int slot)
+{
+	return FileSystem::JoinPathBelow(Pi::SAVE_DIR_NAME, name + (slot ? ".base1" : ".base0"));
+}
+
+static std::string delta_path(const std::string &name)
+{
+	return FileSystem::JoinPathBelow(Pi::SAVE_DIR_NAME, name + ".delta");
+}
+
+// parts and keys may be null to only check it
+static bool read_base(const std::string &name, int slot, Uint32 &generation, std::vector<std::string> *parts, std::vector<Uint32> *keys)
+{
+	RefCountedPtr<FileSystem::FileData> file = FileSystem::userFiles.ReadFile(base_path(name, slot));
+	if (!file)
+		return false;
+
+	RecordReader rd(file->GetData(), file->GetData() + file->GetSize());
+	RecordReader payload;
+	if (!read_record(rd, BASE_MAGIC, payload))
+		return false;
+	if (payload.Int32() != FORMAT_VERSION)
+		return false;
+	generation = payload.Int32();
+
+	const Uint32 numParts = payload.Int32();
+	if (!payload.ok)
+		return false;
+	if (parts) {
+		parts->resize(numParts);
+		keys->resize(numParts);
+		for (Uint32 i = 0; i < numParts && payload.ok; i++) {
+			(*keys)[i] = payload.Int32();
+			payload.Part((*parts)[i]);
+		}
+	}
+	return payload.ok;
+}
+
+// what Save took of the game. the bodies' parts are left for the job and
+// FinishBodies, which take them in turn until there are none left
+struct AutoSave::Capture {
+	Capture() : space(nullptr), next(0), done(0) {}
+
+	Space *space;
+	std::vector<std::string> parts;
+	std::vector<Uint32> keys;  // of the parts
+	std::vector<Body*> bodies; // bodies[i]'s part is parts[FIRST_BODY_PART+i]
+	std::atomic<size_t> next;  // the next body to take
+	std::atomic<size_t> done;  // the bodies whose parts are there
+	std::mutex doneLock;
+	std::condition_variable doneCond; // signalled when the last one is done
+
+	void SerializeBodies() {
+		for (size_t i = next++; i < bodies.size(); i = next++) {
+			Serializer::Writer wr;
+			bodies[i]->Serialize(wr, space);
+			parts[FIRST_BODY_PART + i] = wr.GetData();
+			if (++done == bodies.size()) {
+				std::lock_guard<std::mutex> lock(doneLock);
+				doneCond.notify_all();
+			}
+		}
+	}
+
+	// for the ones the other side took
+	void WaitForBodies() {
+		std::unique_lock<std::mutex> lock(doneLock);
+		doneCond.wait(lock, [this] { return done == bodies.size(); });
+	}
+};
+
+struct AutoSave::State {
+	State() : scanned(false), generation(0), slot(1), numDeltas(0), baseSize(0), deltaSize(0), writing(false) {}
+
+	bool scanned;                              // have looked at what's on disk already
+	Uint32 generation;                         // of the newest base
+	int slot;                                  // and which file it's in
+	std::vector<Uint32> keys;                  // of the parts last written, in order
+	std::unordered_map<Uint32, Uint64> hashes; // by key. empty if the next has to be a base
+	Uint32 numDeltas;                          // since that base
+	size_t baseSize;
+	size_t deltaSize;
+
+	std::atomic<bool> writing;
+};
+
+class AutoSave::WriteJob : public Job {
+public:
+	WriteJob(const std::string &name, const std::shared_ptr<State> &state, const std::shared_ptr<Capture> &capture, bool newBase, Uint32 compactEvery) :
+		m_name(name), m_state(state), m_capture(capture), m_newBase(newBase), m_compactEvery(compactEvery), m_ran(false), m_ok(false), m_cancelled(false) {}
+
+	// cancelled before it ran
+	virtual ~WriteJob() {
+		if (!m_ran)
+			m_state->writing = false;
+	}
+
+	virtual void OnRun() { // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
+		m_ran = true;
+		m_capture->SerializeBodies();
+		m_capture->WaitForBodies();
+
+		State &s = *m_state;
+		if (!m_cancelled) {
+			m_ok = Write(s);
+			if (!m_ok)
+				s.hashes.clear();
+		}
+		s.writing = false;
+	}
+
+	virtual void OnFinish() {
+		if (!m_ok)
+			Output("couldn't write autosave '%s'\n", m_name.c_str());
+	}
+
+	// the files are left as they are if it hasn't started on them, and
+	// writing is cleared as OnRun returns; clearing it here would let the
+	// next save start while this one is still on the files
+	virtual void OnCancel() { m_cancelled = true; }
+
+private:
+	static Uint64 Hash(const std::string &part) {
+		Uint32 pc = 0, pb = 0;
+		lookup3_hashlittle2(part.data(), part.size(), &pc, &pb);
+		return (Uint64(pc) << 32) | pb;
+	}
+
+	void Scan(State &s) {
+		Uint32 generation[2];
+		bool valid[2];
+		for (int slot = 0; slot < 2; slot++)
+			valid[slot] = read_base(m_name, slot, generation[slot], nullptr, nullptr);
+
+		// leave the newest good one alone; a torn one is fair game
+		if (valid[0] && (!valid[1] || generation[0] > generation[1])) {
+			s.slot = 0;
+			s.generation = generation[0];
+		} else if (valid[1]) {
+			s.slot = 1;
+			s.generation = generation[1];
+		}
+	}
+
+	bool Write(State &s) {
+		if (!FileSystem::userFiles.MakeDirectory(Pi::SAVE_DIR_NAME))
+			return false;
+		if (!s.scanned) {
+			Scan(s);
+			s.scanned = true;
+		}
+
+		const std::vector<std::string> &parts = m_capture->parts;
+		const std::vector<Uint32> &keys = m_capture->keys;
+
+		std::vector<Uint64> hashes(parts.size());
+		for (size_t i = 0; i < parts.size(); i++)
+			hashes[i] = Hash(parts[i]);
+
+		bool ok;
+		if (m_newBase || s.hashes.empty() || s.numDeltas >= m_compactEvery)
+			ok = WriteBase(s);
+		else {
+			std::vector<Uint32> changed;
+			for (size_t i = 0; i < parts.size(); i++) {
+				auto it = s.hashes.find(keys[i]);
+				if (it == s.hashes.end() || it->second != hashes[i])
+					changed.push_back(i);
+			}
+			if (changed.empty() && keys == s.keys)
+				return true;
+
+			std::string payload;
+			put_int32(payload, FORMAT_VERSION);
+			put_int32(payload, s.generation);
+			put_int32(payload, parts.size());
+			for (Uint32 key : keys)
+				put_int32(payload, key);
+			put_int32(payload, changed.size());
+			for (Uint32 i : changed) {
+				put_int32(payload, keys[i]);
+				put_part(payload, parts[i]);
+			}
+
+			// once the deltas outweigh the base it's cheaper to load a new one
+			if (s.deltaSize + payload.size() > s.baseSize)
+				ok = WriteBase(s);
+			else
+				ok = WriteDelta(s, payload);
+		}
+
+		if (ok) {
+			s.keys = keys;
+			s.hashes.clear();
+			for (size_t i = 0; i < keys.size(); i++)
+				s.hashes[keys[i]] = hashes[i];
+		}
+		return ok;
+	}
+
+	bool WriteBase(State &s) {
+		const int slot = s.slot ^ 1;
+		const Uint32 generation = s.generation + 1;
+
+		const std::vector<std::string> &parts = m_capture->parts;
+		size_t size = 12;
+		for (const std::string &part : parts)
+			size += 8 + part.size();
+		std::string payload;
+		payload.reserve(size);
+		put_int32(payload, FORMAT_VERSION);
+		put_int32(payload, generation);
+		put_int32(payload, parts.size());
+		for (size_t i = 0; i < parts.size(); i++) {
+			put_int32(payload, m_capture->keys[i]);
+			put_part(payload, parts[i]);
+		}
+
+		FILE *f = FileSystem::userFiles.OpenWriteStream(base_path(m_name, slot));
+		if (!f)
+			return false;
+		bool ok = write_record(f, BASE_MAGIC, payload);
+		ok = (fclose(f) == 0) && ok;
+		if (!ok)
+			return false;
+
+		s.slot = slot;
+		s.generation = generation;
+		s.numDeltas = 0;
+		s.baseSize = payload.size();
+		s.deltaSize = 0;
+
+		// anything left in there is against the old base, and would be
+		// skipped anyway
+		f = FileSystem::userFiles.OpenWriteStream(delta_path(m_name));
+		if (f)
+			fclose(f);
+		return true;
+	}
+
+	bool WriteDelta(State &s, const std::string &payload) {
+		FILE *f = FileSystem::userFiles.OpenWriteStream(delta_path(m_name), FileSystem::FileSourceFS::WRITE_APPEND);
+		if (!f)
+			return false;
+		bool ok = write_record(f, DELTA_MAGIC, payload);
+		ok = (fclose(f) == 0) && ok;
+		if (!ok)
+			return false;
+
+		s.numDeltas++;
+		s.deltaSize += payload.size();
+		return true;
+	}
+
+	std::string m_name;
+	std::shared_ptr<State> m_state;
+	std::shared_ptr<Capture> m_capture;
+	bool m_newBase;
+	Uint32 m_compactEvery;
+	bool m_ran;
+	bool m_ok;
+	std::atomic<bool> m_cancelled;
+};
+
+AutoSave::AutoSave(const std::string &name, JobQueue *queue, float interval, Uint32 compactEvery) :
+	m_name(name),
+	m_queue(queue),
+	m_interval(interval),
+	m_compactEvery(compactEvery),
+	m_timer(0.0f),
+	m_newBase(true),
+	m_state(new State)
+{
+}
+
+AutoSave::~AutoSave()
+{
+	FinishBodies();
+	// the job has the files open; let it finish rather than cancel it
+	while (IsWriting())
+		SDL_Delay(1);
+}
+
+void AutoSave::Update(Game *game, float frameTime)
+{
+	if (m_interval <= 0.0f || !game)
+		return;
+
+	m_timer += frameTime;
+	if (m_timer < m_interval)
+		return;
+
+	// otherwise try again next frame
+	if (game->IsHyperspace() || game->GetPlayer()->IsDead())
+		return;
+	if (Save(game))
+		m_timer = 0.0f;
+}
+
+bool AutoSave::Save(Game *game)
+{
+	assert(game);
+	if (IsWriting())
+		return false;
+	// if the job was cancelled before it got to them
+	FinishBodies();
+
+	std::shared_ptr<Capture> capture(new Capture);
+	capture->space = game->GetSpace();
+	game->Serialize(capture->parts, &capture->bodies);
+
+	const size_t numParts = capture->parts.size();
+	const size_t numBodies = capture->bodies.size();
+	capture->keys.resize(numParts);
+	for (size_t i = 0; i < numParts; i++) {
+		if (i < FIRST_BODY_PART)
+			capture->keys[i] = i;
+		else if (i < FIRST_BODY_PART + numBodies)
+			capture->keys[i] = FIRST_BODY_KEY + capture->bodies[i - FIRST_BODY_PART]->GetId();
+		else
+			capture->keys[i] = i - numBodies;
+	}
+
+	m_state->writing = true;
+	m_capture = capture;
+	m_job = m_queue->Queue(new WriteJob(m_name, m_state, capture, m_newBase, m_compactEvery));
+	m_newBase = false;
+	return true;
+}
+
+void AutoSave::FinishBodies()
+{
+	if (!m_capture)
+		return;
+	m_capture->SerializeBodies();
+	m_capture->WaitForBodies();
+	m_capture.reset();
+}
+
+void AutoSave::Reset()
+{
+	FinishBodies();
+	m_newBase = true;
+	m_timer = 0.0f;
+}
+
+bool AutoSave::IsWriting() const
+{
+	return m_state->writing;
+}
+
+bool AutoSave::Exists(const std::string &name)
+{
+	Uint32 generation;
+	for (int slot = 0; slot < 2; slot++)
+		if (read_base(name, slot, generation, nullptr, nullptr))
+			return true;
+	return false;
+}
+
+Game *AutoSave::Load(const std::string &name)
+{
+	Output("AutoSave::Load('%s')\n", name.c_str());
+
+	Uint32 generation[2];
+	std::vector<std::string> parts[2];
+	std::vector<Uint32> keys[2];
+	bool valid[2];
+	for (int slot = 0; slot < 2; slot++)
+		valid[slot] = read_base(name, slot, generation[slot], &parts[slot], &keys[slot]);
+	if (!valid[0] && !valid[1])
+		throw CouldNotOpenFileException();
+
+	const int slot = (valid[0] && (!valid[1] || generation[0] > generation[1])) ? 0 : 1;
+	std::vector<Uint32> order;
+	order.swap(keys[slot]);
+	std::unordered_map<Uint32, std::string> byKey;
+	for (size_t i = 0; i < order.size(); i++)
+		byKey[order[i]].swap(parts[slot][i]);
+
+	RefCountedPtr<FileSystem::FileData> file = FileSystem::userFiles.ReadFile(delta_path(name));
+	if (file) {
+		RecordReader rd(file->GetData(), file->GetData() + file->GetSize());
+		RecordReader payload;
+		// up to the first one that isn't all there
+		while (read_record(rd, DELTA_MAGIC, payload)) {
+			if (payload.Int32() != FORMAT_VERSION || payload.Int32() != generation[slot])
+				continue;
+			const Uint32 numParts = payload.Int32();
+			std::vector<Uint32> newOrder;
+			for (Uint32 i = 0; i < numParts && payload.ok; i++)
+				newOrder.push_back(payload.Int32());
+
+			const Uint32 numChanged = payload.Int32();
+			std::vector<std::pair<Uint32, std::string> > changed;
+			std::unordered_set<Uint32> changedKeys;
+			for (Uint32 i = 0; i < numChanged && payload.ok; i++) {
+				changed.push_back(std::make_pair(payload.Int32(), std::string()));
+				payload.Part(changed.back().second);
+				changedKeys.insert(changed.back().first);
+			}
+			for (Uint32 key : newOrder)
+				if (!byKey.count(key) && !changedKeys.count(key))
+					payload.ok = false;
+			if (!payload.ok)
+				break;
+
+			order.swap(newOrder);
+			for (auto &c : changed)
+				byKey[c.first].swap(c.second);
+		}
+	}
+
+	if (order.size() < 2)
+		throw SavedGameCorruptException();
+
+	std::vector<std::string> current(order.size());
+	for (size_t i = 0; i < order.size(); i++)
+		current[i].swap(byKey[order[i]]);
+
+	const std::string data = Game::JoinParts(current);
+	Serializer::Reader rd(ByteRange(data.data(), data.size()));
+	return new Game(rd);
+}
@@ -0,0 +1,79 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _AUTOSAVE_H
+#define _AUTOSAVE_H
+
+#include "libs.h"
+#include "JobQueue.h"
+#include <memory>
+#include <string>
+
+class Game;
+
+// Periodic saves that only write what has changed.
+//
+// Save takes what's cheap from the game on the main thread: everything but
+// the bodies, which are only listed. A job then serialises the bodies, with
+// the main thread taking whatever it hasn't got to when FinishBodies is
+// called, and compares the pieces (see Game::Serialize) with the previous
+// save's, appending the ones that differ to <name>.delta. Every so often, or
+// when the deltas have grown bigger than the base, the job writes the whole
+// lot as a new base instead and empties the delta file.
+//
+// The two base files are written in turn, so a crash part way through one
+// leaves the other, and every record is checksummed so that a torn write is
+// ignored on load. Bodies are matched by Body::GetId, so adding or removing
+// one only costs its own piece and the order.
+class AutoSave {
+public:
+	// interval is in seconds of real time, 0 to only save when asked.
+	// compactEvery is the most deltas written before the next base
+	AutoSave(const std::string &name, JobQueue *queue, float interval, Uint32 compactEvery = 16);
+	// waits for the save being written, if there is one
+	~AutoSave();
+
+	// call once a frame. saves if it's time to, except in hyperspace or
+	// with the player dead
+	void Update(Game *game, float frameTime);
+
+	// save now. false if the last save is still being written. nothing may
+	// change a body until FinishBodies has been called
+	bool Save(Game *game);
+
+	// serialise the bodies the job hasn't yet, and wait for the ones it's
+	// doing. call before the game moves on from the frame Save was called in
+	void FinishBodies();
+
+	// the game has gone. the next save is a new base
+	void Reset();
+
+	bool IsWriting() const;
+
+	// whether there's a complete autosave to load
+	static bool Exists(const std::string &name);
+
+	// the last save that was written completely. throws like
+	// Game::LoadGame, CouldNotOpenFileException if there isn't one
+	static Game *Load(const std::string &name);
+
+private:
+	class WriteJob;
+	struct State;
+	struct Capture;
+
+	std::string m_name;
+	JobQueue *m_queue;
+	float m_interval;
+	Uint32 m_compactEvery;
+	float m_timer;
+	bool m_newBase;
+
+	// owned by the job while there's a save being written
+	std::shared_ptr<State> m_state;
+	// shared with the job until the bodies are done
+	std::shared_ptr<Capture> m_capture;
+	Job::Handle m_job;
+};
+
+#endif
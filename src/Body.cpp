@@ -14,10 +14,13 @@
 #include "Space.h"
 #include "Game.h"
 
+static Uint32 s_nextId = 0;
+
 Body::Body() : PropertiedObject()
 	, m_flags(0)
 	, m_interpPos(0.0)
 	, m_interpOrient(matrix3x3d::Identity())
+	, m_id(++s_nextId)
 	, m_pos(0.0)
 	, m_orient(matrix3x3d::Identity())
 	, m_frame(0)
@@ -52,6 +52,9 @@ public:
 	// as you can't test for collisions if different objects are on different 'steps'
 	virtual void StaticUpdate(const float timeStep) {}
 	virtual void TimeStepUpdate(const float timeStep) {}
+	// after every body has moved. for anything that wants to see the new
+	// positions (sensors, lights attached to the body)
+	virtual void PostTimeStepUpdate(const float timeStep) {}
 	virtual void Render(Graphics::Renderer *r, const Camera *camera, const vector3d &viewCoords, const matrix4x4d &viewTransform) = 0;
 
 	virtual void SetFrame(Frame *f) { m_frame = f; }
@@ -77,6 +80,10 @@ public:
 	void MarkDead() { m_dead = true; }
 	bool IsDead() const { return m_dead; }
 
+	// never reused while the program runs, so a body can be recognised
+	// again without holding on to it
+	Uint32 GetId() const { return m_id; }
+
 	// all Bodies are in space... except where they're not (Ships hidden in hyperspace clouds)
 	virtual bool IsInSpace() const { return true; }
 
@@ -110,6 +117,7 @@ protected:
 	vector3d m_interpPos;
 	matrix3x3d m_interpOrient;
 private:
+	Uint32 m_id;
 	vector3d m_pos;
 	matrix3x3d m_orient;
 	Frame *m_frame;				// frame of reference
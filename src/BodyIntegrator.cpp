@@ -0,0 +1,129 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "BodyIntegrator.h"
+#include "DynamicBody.h"
+#include "JobQueue.h"
+
+// bodies per chunk when splitting the batch over the job queue. integrating
+// one body is cheap, so a chunk has to be fairly big to be worth handing off
+static const Uint32 INTEGRATE_CHUNK_SIZE = 64;
+
+void BodyIntegrator::Begin(float timeStep)
+{
+	m_timeStep = double(timeStep);
+
+	m_bodies.clear();
+	m_posX.clear(); m_posY.clear(); m_posZ.clear();
+	m_velX.clear(); m_velY.clear(); m_velZ.clear();
+	m_angVelX.clear(); m_angVelY.clear(); m_angVelZ.clear();
+	m_forceX.clear(); m_forceY.clear(); m_forceZ.clear();
+	m_torqueX.clear(); m_torqueY.clear(); m_torqueZ.clear();
+	m_invMass.clear(); m_invAngInertia.clear();
+	for (int i = 0; i < 9; i++)
+		m_orient[i].clear();
+	m_rotated.clear();
+}
+
+void BodyIntegrator::Add(DynamicBody *b)
+{
+	m_bodies.push_back(b);
+
+	const vector3d &pos = b->GetPosition();
+	m_posX.push_back(pos.x); m_posY.push_back(pos.y); m_posZ.push_back(pos.z);
+	m_velX.push_back(b->m_vel.x); m_velY.push_back(b->m_vel.y); m_velZ.push_back(b->m_vel.z);
+	m_angVelX.push_back(b->m_angVel.x); m_angVelY.push_back(b->m_angVel.y); m_angVelZ.push_back(b->m_angVel.z);
+
+	const vector3d force = b->m_force + b->m_externalForce;
+	m_forceX.push_back(force.x); m_forceY.push_back(force.y); m_forceZ.push_back(force.z);
+	m_torqueX.push_back(b->m_torque.x); m_torqueY.push_back(b->m_torque.y); m_torqueZ.push_back(b->m_torque.z);
+
+	m_invMass.push_back(1.0 / b->m_mass);
+	m_invAngInertia.push_back(1.0 / b->m_angInertia);
+
+	const matrix3x3d &orient = b->GetOrient();
+	for (int i = 0; i < 9; i++)
+		m_orient[i].push_back(orient[i]);
+	m_rotated.push_back(0);
+}
+
+void BodyIntegrator::Integrate(JobQueue *queue)
+{
+	PROFILE_SCOPED()
+	ParallelFor(queue, m_bodies.size(), INTEGRATE_CHUNK_SIZE, [this](Uint32 begin, Uint32 end) {
+		IntegrateRange(begin, end);
+	});
+}
+
+void BodyIntegrator::IntegrateRange(Uint32 begin, Uint32 end)
+{
+	const double dt = m_timeStep;
+
+	// linear and angular velocity, then position. straight-line arithmetic
+	// over the arrays so the compiler can vectorise it
+	for (Uint32 i = begin; i < end; i++) {
+		const double dv = dt * m_invMass[i];
+		m_velX[i] += dv * m_forceX[i];
+		m_velY[i] += dv * m_forceY[i];
+		m_velZ[i] += dv * m_forceZ[i];
+
+		const double dw = dt * m_invAngInertia[i];
+		m_angVelX[i] += dw * m_torqueX[i];
+		m_angVelY[i] += dw * m_torqueY[i];
+		m_angVelZ[i] += dw * m_torqueZ[i];
+
+		m_posX[i] += m_velX[i] * dt;
+		m_posY[i] += m_velY[i] * dt;
+		m_posZ[i] += m_velZ[i] * dt;
+	}
+
+	// orientation. same rotation as matrix3x3d::Rotate(len * dt, axis) * orient
+	for (Uint32 i = begin; i < end; i++) {
+		const double wx = m_angVelX[i], wy = m_angVelY[i], wz = m_angVelZ[i];
+		const double len = sqrt(wx*wx + wy*wy + wz*wz);
+		if (len <= 1e-16) continue;
+
+		const double inv = 1.0 / len;
+		const double x = wx * inv, y = wy * inv, z = wz * inv;
+		const double c = cos(len * dt);
+		const double s = sin(len * dt);
+		const double t = 1.0 - c;
+
+		const double r[9] = {
+			x*x*t+c,   x*y*t-z*s, x*z*t+y*s,
+			y*x*t+z*s, y*y*t+c,   y*z*t-x*s,
+			x*z*t-y*s, y*z*t+x*s, z*z*t+c
+		};
+
+		double o[9];
+		for (int k = 0; k < 9; k++)
+			o[k] = m_orient[k][i];
+
+		for (int row = 0; row < 3; row++)
+			for (int col = 0; col < 3; col++)
+				m_orient[row*3+col][i] = r[row*3+0]*o[col] + r[row*3+1]*o[3+col] + r[row*3+2]*o[6+col];
+
+		m_rotated[i] = 1;
+	}
+}
+
+void BodyIntegrator::WriteBack()
+{
+	PROFILE_SCOPED()
+	for (size_t i = 0; i < m_bodies.size(); i++) {
+		DynamicBody *b = m_bodies[i];
+
+		matrix3x3d orient;
+		if (m_rotated[i])
+			for (int k = 0; k < 9; k++)
+				orient[k] = m_orient[k][i];
+
+		b->EndIntegration(
+			vector3d(m_posX[i], m_posY[i], m_posZ[i]),
+			vector3d(m_velX[i], m_velY[i], m_velZ[i]),
+			vector3d(m_angVelX[i], m_angVelY[i], m_angVelZ[i]),
+			m_rotated[i] ? &orient : nullptr,
+			vector3d(m_forceX[i], m_forceY[i], m_forceZ[i]),
+			m_timeStep);
+	}
+}
@@ -0,0 +1,59 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _BODYINTEGRATOR_H
+#define _BODYINTEGRATOR_H
+
+#include "libs.h"
+
+class DynamicBody;
+class JobQueue;
+
+// Physics stage for moving DynamicBodies. Each tick the state of every body
+// that wants integrating is gathered into flat per-component arrays, the
+// whole batch is integrated in one pass (split across the job queue when
+// there is enough of it), and the results are written back to the bodies.
+//
+// Integration of one body never looks at another, so the result does not
+// depend on how the batch was split up.
+class BodyIntegrator {
+public:
+	BodyIntegrator() : m_timeStep(0.0) {}
+
+	// start gathering a new batch
+	void Begin(float timeStep);
+
+	// add a body to the batch. its accumulated force and torque are taken
+	// as they stand, so all forces must be applied before this
+	void Add(DynamicBody *b);
+
+	// integrate all gathered bodies. queue may be null for a serial pass
+	void Integrate(JobQueue *queue);
+
+	// copy the new state back into the bodies
+	void WriteBack();
+
+	size_t GetNumBodies() const { return m_bodies.size(); }
+
+private:
+	void IntegrateRange(Uint32 begin, Uint32 end);
+
+	double m_timeStep;
+
+	// the handle back to each body; every array below is indexed the same
+	std::vector<DynamicBody*> m_bodies;
+
+	std::vector<double> m_posX, m_posY, m_posZ;
+	std::vector<double> m_velX, m_velY, m_velZ;
+	std::vector<double> m_angVelX, m_angVelY, m_angVelZ;
+	std::vector<double> m_forceX, m_forceY, m_forceZ;
+	std::vector<double> m_torqueX, m_torqueY, m_torqueZ;
+	std::vector<double> m_invMass, m_invAngInertia;
+
+	// orientation, row-major like matrix3x3d
+	std::vector<double> m_orient[9];
+	// set when the orientation changed and needs writing back
+	std::vector<Uint8> m_rotated;
+};
+
+#endif /* _BODYINTEGRATOR_H */
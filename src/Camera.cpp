@@ -117,22 +117,36 @@ static void position_system_lights(Frame *camFrame, Frame *frame, std::vector<Ca
 
 void Camera::Update()
 {
+	PROFILE_SCOPED()
+
 	Frame *camFrame = m_context->GetCamFrame();
 
-	// evaluate each body and determine if/where/how to draw it
-	m_sortedBodies.clear();
-	for (Body* b : Pi::game->GetSpace()->GetBodies()) {
-		BodyAttrs attrs;
-		attrs.body = b;
+	// Pick up to four suitable system light sources (stars)
+	m_lightSources.clear();
+	m_lightSources.reserve(4);
+	position_system_lights(camFrame, Pi::game->GetSpace()->GetRootFrame(), m_lightSources);
 
-		// determine position and transform for draw
-		Frame::GetFrameTransform(b->GetFrame(), camFrame, attrs.viewTransform);
-		attrs.viewCoords = attrs.viewTransform * b->GetInterpPosition();
+	if (m_lightSources.empty()) {
+		// no lights means we're somewhere weird (eg hyperspace). fake one
+		const Color col(255);
+		m_lightSources.push_back(LightSource(0, Graphics::Light(Graphics::Light::LIGHT_DIRECTIONAL, vector3f(0.f), col, col)));
+	}
 
-		// cull off-screen objects
-		double rad = b->GetClipRadius();
-		if (!m_context->GetFrustum().TestPointInfinite(attrs.viewCoords, rad))
-			continue;
+	// lighting environment is rebuilt lazily per frame from these
+	m_frameLighting.clear();
+	m_shadowCasters.clear();
+	for (Body* b : Pi::game->GetSpace()->GetBodies())
+		if (b->IsType(Object::PLANET) || b->IsType(Object::STAR))
+			m_shadowCasters.push_back(b);
+
+	// evaluate each body that can be seen and determine where/how to draw it
+	CullBodies(Pi::game->GetSpace(), camFrame);
+
+	m_sortedBodies.clear();
+	for (Uint32 i : m_visible) {
+		BodyAttrs attrs = m_cullAttrs[i];
+		Body *b = attrs.body;
+		const double rad = b->GetClipRadius();
 
 		attrs.camDist = attrs.viewCoords.Length();
 		attrs.bodyFlags = b->GetFlags();
@@ -173,6 +187,100 @@ void Camera::Update()
 	m_sortedBodies.sort();
 }
 
+namespace {
+	// a planet or star in view, seen from the camera
+	struct Occluder {
+		const Body *body;
+		vector3d dir;
+		double dist;
+		double angle; // angular radius
+	};
+}
+
+// is the sphere wholly behind the occluder? it is if it's inside the
+// occluder's silhouette and all of it is further away than the occluder's
+// centre, as every line of sight in the silhouette has gone into the
+// occluder by then
+static bool is_occluded(const vector3d &pos, double radius, const Occluder &o)
+{
+	const double dist = pos.Length();
+	if (dist - radius < o.dist)
+		return false;
+	const double angle = acos(Clamp(pos.Dot(o.dir) / dist, -1.0, 1.0));
+	return angle + asin(radius / dist) <= o.angle;
+}
+
+// only the few that look biggest are worth testing everything against
+static const int MAX_OCCLUDERS = 4;
+
+void Camera::CullBodies(Space *space, Frame *camFrame)
+{
+	PROFILE_SCOPED()
+	m_cullAttrs.clear();
+	for (Body* b : space->GetBodies()) {
+		BodyAttrs attrs;
+		attrs.body = b;
+		m_cullAttrs.push_back(attrs);
+	}
+	const int numBodies = m_cullAttrs.size();
+	m_cullX.resize(numBodies);
+	m_cullY.resize(numBodies);
+	m_cullZ.resize(numBodies);
+	m_cullRadius.resize(numBodies);
+	m_cullInside.resize(numBodies);
+
+	// bounding spheres into camera space
+	for (int i = 0; i < numBodies; i++) {
+		BodyAttrs &attrs = m_cullAttrs[i];
+		const Body *b = attrs.body;
+		Frame::GetFrameTransform(b->GetFrame(), camFrame, attrs.viewTransform);
+		attrs.viewCoords = attrs.viewTransform * b->GetInterpPosition();
+		m_cullX[i] = attrs.viewCoords.x;
+		m_cullY[i] = attrs.viewCoords.y;
+		m_cullZ[i] = attrs.viewCoords.z;
+		m_cullRadius[i] = b->GetClipRadius();
+	}
+
+	// cull off-screen objects
+	if (numBodies)
+		m_context->GetFrustum().TestPointsInfinite(numBodies, &m_cullX[0], &m_cullY[0], &m_cullZ[0], &m_cullRadius[0], &m_cullInside[0]);
+
+	// planets and stars on screen, biggest first. the surface at its lowest
+	// is taken to be the body's radius
+	Occluder occluders[MAX_OCCLUDERS];
+	int numOccluders = 0;
+	for (int i = 0; i < numBodies; i++) {
+		const Body *b = m_cullAttrs[i].body;
+		if (!m_cullInside[i] || !b->IsType(Object::TERRAINBODY))
+			continue;
+		const vector3d &pos = m_cullAttrs[i].viewCoords;
+		const double dist = pos.Length();
+		const double radius = b->GetSystemBody()->GetRadius();
+		if (dist <= radius)
+			continue;
+
+		Occluder o = { b, pos / dist, dist, asin(radius / dist) };
+		int j = std::min(numOccluders, MAX_OCCLUDERS-1);
+		if (j < numOccluders && o.angle <= occluders[j].angle)
+			continue;
+		for (; j > 0 && occluders[j-1].angle < o.angle; j--)
+			occluders[j] = occluders[j-1];
+		occluders[j] = o;
+		numOccluders = std::min(numOccluders+1, MAX_OCCLUDERS);
+	}
+
+	m_visible.clear();
+	for (int i = 0; i < numBodies; i++) {
+		if (!m_cullInside[i])
+			continue;
+		bool occluded = false;
+		for (int j = 0; j < numOccluders && !occluded; j++)
+			occluded = occluders[j].body != m_cullAttrs[i].body && is_occluded(m_cullAttrs[i].viewCoords, m_cullRadius[i], occluders[j]);
+		if (!occluded)
+			m_visible.push_back(i);
+	}
+}
+
 void Camera::Draw(const Body *excludeBody, ShipCockpit* cockpit)
 {
 	PROFILE_SCOPED()
@@ -185,17 +293,6 @@ void Camera::Draw(const Body *excludeBody, ShipCockpit* cockpit)
 	Frame::GetFrameTransform(Pi::game->GetSpace()->GetRootFrame(), camFrame, trans2bg);
 	trans2bg.ClearToRotOnly();
 
-	// Pick up to four suitable system light sources (stars)
-	m_lightSources.clear();
-	m_lightSources.reserve(4);
-	position_system_lights(camFrame, Pi::game->GetSpace()->GetRootFrame(), m_lightSources);
-
-	if (m_lightSources.empty()) {
-		// no lights means we're somewhere weird (eg hyperspace). fake one
-		const Color col(255);
-		m_lightSources.push_back(LightSource(0, Graphics::Light(Graphics::Light::LIGHT_DIRECTIONAL, vector3f(0.f), col, col)));
-	}
-
 	//fade space background based on atmosphere thickness and light angle
 	float bgIntensity = 1.f;
 	if (camFrame->GetParent() && camFrame->GetParent()->IsRotFrame()) {
@@ -263,30 +360,73 @@ void Camera::Draw(const Body *excludeBody, ShipCockpit* cockpit)
 		cockpit->RenderCockpit(m_renderer, this, camFrame);
 }
 
+const Camera::FrameLighting &Camera::GetFrameLighting(const Frame *f) const
+{
+	auto it = m_frameLighting.find(f);
+	if (it != m_frameLighting.end())
+		return it->second;
+
+	PROFILE_SCOPED()
+	FrameLighting &fl = m_frameLighting[f];
+
+	fl.lightPos.reserve(m_lightSources.size());
+	fl.lightInterpDir.reserve(m_lightSources.size());
+	for (const LightSource &l : m_lightSources) {
+		if (l.GetBody()) {
+			fl.lightPos.push_back(l.GetBody()->GetPositionRelTo(f));
+			fl.lightInterpDir.push_back(l.GetBody()->GetInterpPositionRelTo(f).Normalized());
+		} else {
+			// default light for systems without lights; straight overhead
+			fl.lightPos.push_back(vector3d(0.0));
+			fl.lightInterpDir.push_back(vector3d(0.0));
+		}
+	}
+
+	fl.casters.reserve(m_shadowCasters.size());
+	for (const Body *b : m_shadowCasters) {
+		const FrameLighting::Caster c = { b, b->GetPositionRelTo(f), b->GetSystemBody()->GetRadius() };
+		fl.casters.push_back(c);
+	}
+
+	fl.planet = nullptr;
+	fl.planetRadius = fl.atmosphereRadius = 0.0;
+	if (f->GetBody() && f->GetBody()->IsType(Object::PLANET)) {
+		fl.planet = static_cast<const Planet*>(f->GetBody());
+		fl.planetRadius = fl.planet->GetSystemBody()->GetRadius();
+		fl.atmosphereRadius = fl.planet->GetAtmosphereRadius();
+	}
+
+	return fl;
+}
+
 void Camera::CalcShadows(const int lightNum, const Body *b, std::vector<Shadow> &shadowsOut) const {
 	// Set up data for eclipses. All bodies are assumed to be spheres.
 	const Body *lightBody = m_lightSources[lightNum].GetBody();
 	if (!lightBody)
 		return;
 
+	const FrameLighting &fl = GetFrameLighting(b->GetFrame());
+	const vector3d &bPos = b->GetPosition();
+
 	const double lightRadius = lightBody->GetPhysRadius();
-	const vector3d bLightPos = lightBody->GetPositionRelTo(b);
-	const vector3d lightDir = bLightPos.Normalized();
+	const vector3d bLightPos = fl.lightPos[lightNum] - bPos;
+	const double bLightDist = bLightPos.Length();
+	const vector3d lightDir = bLightPos / bLightDist;
 
 	double bRadius;
 	if (b->IsType(Object::TERRAINBODY)) bRadius = b->GetSystemBody()->GetRadius();
 	else bRadius = b->GetPhysRadius();
 
 	// Look for eclipsing third bodies:
-	for (const Body *b2 : Pi::game->GetSpace()->GetBodies()) {
-		if ( b2 == b || b2 == lightBody || !(b2->IsType(Object::PLANET) || b2->IsType(Object::STAR)))
+	for (const FrameLighting::Caster &c : fl.casters) {
+		if (c.body == b || c.body == lightBody)
 			continue;
 
-		double b2Radius = b2->GetSystemBody()->GetRadius();
-		vector3d b2pos = b2->GetPositionRelTo(b);
+		const double b2Radius = c.radius;
+		const vector3d b2pos = c.pos - bPos;
 		const double perpDist = lightDir.Dot(b2pos);
 
-		if ( perpDist <= 0 || perpDist > bLightPos.Length())
+		if ( perpDist <= 0 || perpDist > bLightDist)
 			// b2 isn't between b and lightBody; no eclipse
 			continue;
 
@@ -300,7 +440,7 @@ void Camera::CalcShadows(const int lightNum, const Body *b, std::vector<Shadow>
 		// disc of radius srad centred at projectedCentre-p. To determine the light intensity at p, we
 		// then just need to estimate the proportion of the light disc being occulted.
 		const double srad = b2Radius / bRadius;
-		const double lrad = (lightRadius/bLightPos.Length())*perpDist / bRadius;
+		const double lrad = (lightRadius/bLightDist)*perpDist / bRadius;
 		if (srad / lrad < 0.01) {
 			// any eclipse would have negligible effect - ignore
 			continue;
@@ -338,9 +478,8 @@ float discCovered(const float dist, const float rad) {
 	return Clamp((th + radsq*th2 - dist*d)/float(M_PI), 0.f, 1.f);
 }
 
-static std::vector<Camera::Shadow> shadows;
-
 float Camera::ShadowedIntensity(const int lightNum, const Body *b) const {
+	std::vector<Shadow> &shadows = m_shadowScratch;
 	shadows.clear();
 	shadows.reserve(16);
 	CalcShadows(lightNum, b, shadows);
@@ -352,6 +491,7 @@ float Camera::ShadowedIntensity(const int lightNum, const Body *b) const {
 
 // PrincipalShadows(b,n): returns the n biggest shadows on b in order of size
 void Camera::PrincipalShadows(const Body *b, const int n, std::vector<Shadow> &shadowsOut) const {
+	std::vector<Shadow> &shadows = m_shadowScratch;
 	shadows.clear();
 	shadows.reserve(16);
 	for (size_t i = 0; i < 4 && i < m_lightSources.size(); i++) {
@@ -13,7 +13,9 @@
 #include "Body.h"
 
 class Frame;
+class Planet;
 class ShipCockpit;
+class Space;
 namespace Graphics { class Renderer; }
 
 class CameraContext : public RefCounted {
@@ -98,6 +100,28 @@ public:
 		bool operator< (const Shadow& other) const { return srad/lrad < other.srad/other.lrad; }
 	};
 
+	// light sources and shadow casters positioned relative to a single frame.
+	// built at most once per Update and shared by every body in that frame
+	struct FrameLighting {
+		struct Caster {
+			const Body *body;
+			vector3d pos;
+			double radius;
+		};
+
+		std::vector<vector3d> lightPos;       // per light source, frame-relative
+		std::vector<vector3d> lightInterpDir; // per light source, normalised, interpolated
+		std::vector<Caster> casters;          // planets and stars, frame-relative
+
+		// the planet the frame belongs to, for lighting through its air.
+		// null if the frame's body isn't a planet
+		const Planet *planet;
+		double planetRadius;
+		double atmosphereRadius;
+	};
+
+	const FrameLighting &GetFrameLighting(const Frame *f) const;
+
 	void CalcShadows(const int lightNum, const Body *b, std::vector<Shadow> &shadowsOut) const;
 	float ShadowedIntensity(const int lightNum, const Body *b) const;
 	void PrincipalShadows(const Body *b, const int n, std::vector<Shadow> &shadowsOut) const;
@@ -151,8 +175,25 @@ private:
 		}
 	};
 
+	// find the bodies that can be seen at all, before anything else is
+	// worked out for them. fills m_cullAttrs for every body and m_visible
+	// with the indices of those in view
+	void CullBodies(Space *space, Frame *camFrame);
+
 	std::list<BodyAttrs> m_sortedBodies;
 	std::vector<LightSource> m_lightSources;
+
+	// per body in the space; only body, viewCoords and viewTransform are set
+	std::vector<BodyAttrs> m_cullAttrs;
+	// camera space bounding spheres for the frustum test, a component each
+	std::vector<double> m_cullX, m_cullY, m_cullZ, m_cullRadius;
+	std::vector<Uint8> m_cullInside;
+	std::vector<Uint32> m_visible;
+
+	// eclipsing bodies gathered once per Update; positioned per frame on demand
+	std::vector<const Body*> m_shadowCasters;
+	mutable std::map<const Frame*, FrameLighting> m_frameLighting;
+	mutable std::vector<Shadow> m_shadowScratch;
 };
 
 #endif
@@ -194,7 +194,7 @@ static void lookupBuildingListModels(citybuildinglist_t *list)
 	int i = 0;
 	for (auto m = models.begin(), itEnd = models.end(); m != itEnd; ++m, i++) {
 		list->buildings[i].resolvedModel = *m;
-		list->buildings[i].collMesh = (*m)->CreateCollisionMesh();
+		list->buildings[i].collMesh = (*m)->GetCollisionMesh();
 		const Aabb &aabb = list->buildings[i].collMesh->GetAabb();
 		const double maxx = std::max(fabs(aabb.max.x), fabs(aabb.min.x));
 		const double maxy = std::max(fabs(aabb.max.z), fabs(aabb.min.z));
@@ -42,6 +42,8 @@ struct Color4ub {
 	Color4ub &operator*=(const float f)			{ r=Uint8(r*f); g=Uint8(g*f); b=Uint8(b*f); a=Uint8(a*f); return *this; }
 	Color4ub operator*(const float f) const		{ return Color4ub(Uint8(f*r), Uint8(f*g), Uint8(f*b), Uint8(f*a)); }
 	Color4ub operator/(const float f) const		{ return Color4ub(Uint8(r/f), Uint8(g/f), Uint8(b/f), Uint8(a/f)); }
+	bool operator==(const Color4ub &c) const	{ return r == c.r && g == c.g && b == c.b && a == c.a; }
+	bool operator!=(const Color4ub &c) const	{ return !(*this == c); }
 
 	Color4f ToColor4f() const { return Color4f(r/255.0f, g/255.0f, b/255.0f, a/255.0f); }
 
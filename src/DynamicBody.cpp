@@ -8,9 +8,16 @@
 #include "Serializer.h"
 #include "Planet.h"
 #include "Pi.h"
+#include "Game.h"
 
 static const float KINETIC_ENERGY_MULT = 0.00001f;
 
+// Orbit::FromBodyState is only trusted for a coast if the orbit it gives
+// reproduces the current state this closely (relative)
+static const double COAST_STATE_TOLERANCE = 1e-7;
+// and the anomaly solver doesn't converge close to parabolic
+static const double COAST_PARABOLIC_MARGIN = 0.1;
+
 DynamicBody::DynamicBody(): ModelBody()
 {
 	m_flags = Body::FLAG_CAN_MOVE_FRAME;
@@ -24,6 +31,9 @@ DynamicBody::DynamicBody(): ModelBody()
 	m_angInertia = 1;
 	m_massRadius = 1;
 	m_isMoving = true;
+	m_isCoasting = false;
+	m_coastStart = m_coastResolved = 0.0;
+	m_coastMaxSpeed = 0.0;
 	m_atmosForce = vector3d(0.0);
 	m_gravityForce = vector3d(0.0);
 	m_externalForce = vector3d(0.0);		// do external forces calc instead?
@@ -103,6 +113,7 @@ void DynamicBody::SetMass(double mass)
 
 void DynamicBody::SetFrame(Frame *f)
 {
+	if (m_isCoasting) StopCoasting(Pi::game->GetTime());
 	ModelBody::SetFrame(f);
 	// external forces will be wrong after frame transition
 	m_externalForce = m_gravityForce = m_atmosForce = vector3d(0.0);
@@ -159,39 +170,35 @@ void DynamicBody::CalcExternalForce()
 void DynamicBody::TimeStepUpdate(const float timeStep)
 {
 	m_oldPos = GetPosition();
-	if (m_isMoving) {
-		m_force += m_externalForce;
-
-		m_vel += double(timeStep) * m_force * (1.0 / m_mass);
-		m_angVel += double(timeStep) * m_torque * (1.0 / m_angInertia);
-
-		double len = m_angVel.Length();
-		if (len > 1e-16) {
-			vector3d axis = m_angVel * (1.0 / len);
-			matrix3x3d r = matrix3x3d::Rotate(len * timeStep, axis);
-			SetOrient(r * GetOrient());
-		}
-		m_oldAngDisplacement = m_angVel * timeStep;
-
-		SetPosition(GetPosition() + m_vel * double(timeStep));
-
-//if (this->IsType(Object::PLAYER))
-//Output("pos = %.1f,%.1f,%.1f, vel = %.1f,%.1f,%.1f, force = %.1f,%.1f,%.1f, external = %.1f,%.1f,%.1f\n",
-//	pos.x, pos.y, pos.z, m_vel.x, m_vel.y, m_vel.z, m_force.x, m_force.y, m_force.z,
-//	m_externalForce.x, m_externalForce.y, m_externalForce.z);
-
-		m_lastForce = m_force;
-		m_lastTorque = m_torque;
-		m_force = vector3d(0.0);
-		m_torque = vector3d(0.0);
-		CalcExternalForce();			// regenerate for new pos/vel
-	} else {
+	// if moving, Space integrates us along with every other moving body
+	// once all of them have had their TimeStepUpdate
+	if (!m_isMoving)
 		m_oldAngDisplacement = vector3d(0.0);
-	}
 
 	ModelBody::TimeStepUpdate(timeStep);
 }
 
+void DynamicBody::EndIntegration(const vector3d &pos, const vector3d &vel, const vector3d &angVel, const matrix3x3d *orient, const vector3d &force, double timeStep)
+{
+	const matrix3x3d oldOrient = GetOrient();
+	const vector3d oldPos = GetPosition();
+	m_vel = vel;
+	m_angVel = angVel;
+
+	if (orient)
+		SetOrient(*orient);
+	m_oldAngDisplacement = m_angVel * timeStep;
+
+	SetPosition(pos);
+	SweepGeomsFrom(oldOrient, oldPos);
+
+	m_lastForce = force;
+	m_lastTorque = m_torque;
+	m_force = vector3d(0.0);
+	m_torque = vector3d(0.0);
+	CalcExternalForce();			// regenerate for new pos/vel
+}
+
 void DynamicBody::UpdateInterpTransform(double alpha)
 {
 	m_interpPos = alpha*GetPosition() + (1.0-alpha)*m_oldPos;
@@ -230,6 +237,7 @@ vector3d DynamicBody::GetVelocity() const
 
 void DynamicBody::SetVelocity(const vector3d &v)
 {
+	if (m_isCoasting) StopCoasting(Pi::game->GetTime());
 	m_vel = v;
 }
 
@@ -240,6 +248,7 @@ vector3d DynamicBody::GetAngVelocity() const
 
 void DynamicBody::SetAngVelocity(const vector3d &v)
 {
+	if (m_isCoasting) StopCoasting(Pi::game->GetTime());
 	m_angVel = v;
 }
 
@@ -269,3 +278,85 @@ Orbit DynamicBody::ComputeOrbit() const {
 
 	return Orbit::FromBodyState(pos, vel, mass);
 }
+
+bool DynamicBody::CanCoast() const
+{
+	if (!m_isMoving) return false;
+
+	// nothing pushing or turning us this step
+	if (!is_zero_exact(m_force.LengthSqr()) || !is_zero_exact(m_torque.LengthSqr())) return false;
+	if (!is_zero_exact(m_angVel.LengthSqr())) return false;
+
+	// and gravity is the only external force: no drag or frame rotation
+	const Frame *f = GetFrame();
+	if (!f || f->IsRotFrame()) return false;
+	const Body *body = f->GetBody();
+	return body && !body->IsType(Object::SPACESTATION) && body->GetMass() > 0.0;
+}
+
+bool DynamicBody::StartCoasting(double time)
+{
+	const vector3d &pos = GetPosition();
+	const double mass = GetFrame()->GetBody()->GetMass();
+	const Orbit orbit = Orbit::FromBodyState(pos, m_vel, mass);
+
+	const double e = orbit.GetEccentricity();
+	if (is_zero_exact(orbit.GetSemiMajorAxis()) || fabs(e - 1.0) < COAST_PARABOLIC_MARGIN)
+		return false;
+
+	const double posTol = COAST_STATE_TOLERANCE * pos.Length();
+	const double velTol = COAST_STATE_TOLERANCE * m_vel.Length();
+	if ((orbit.OrbitalPosAtTime(0.0) - pos).LengthSqr() > posTol*posTol) return false;
+	if ((orbit.OrbitalVelocityAtTime(0.0) - m_vel).LengthSqr() > velTol*velTol) return false;
+
+	// nobody looks for terrain under a coasting body, so its orbit has to
+	// stay clear of the body it's around. periapsis from the angular momentum
+	const double h = pos.Cross(m_vel).Length();
+	const double mu = G * mass;
+	if (is_zero_exact(h)) return false;
+	const double periapsis = h*h / (mu * (1.0 + e));
+	if (periapsis < GetFrame()->GetBody()->GetPhysRadius()) return false;
+
+	m_coastOrbit = orbit;
+	m_coastStart = m_coastResolved = time;
+	m_coastPos = pos;
+	m_coastMaxSpeed = h / periapsis;
+	m_isCoasting = true;
+
+	// out of the collision space until we're woken up
+	if (GetFrame()) RemoveGeomsFromFrame(GetFrame());
+	return true;
+}
+
+void DynamicBody::StopCoasting(double time)
+{
+	if (!m_isCoasting) return;
+	// catch up with the orbit first, unless something has moved us off it
+	if (!CoastInterrupted() && m_coastResolved != time)
+		ResolveCoast(time);
+	m_isCoasting = false;
+	if (GetFrame()) AddGeomsToFrame(GetFrame());
+
+	// same bookkeeping as EndIntegration with gravity the only force
+	m_oldAngDisplacement = vector3d(0.0);
+	CalcExternalForce();
+	m_lastForce = m_externalForce;
+	m_lastTorque = vector3d(0.0);
+}
+
+bool DynamicBody::CoastInterrupted() const
+{
+	return !m_isCoasting || !GetPosition().ExactlyEqual(m_coastPos);
+}
+
+void DynamicBody::ResolveCoast(double time)
+{
+	assert(m_isCoasting);
+	const double t = time - m_coastStart;
+	m_coastPos = m_coastOrbit.OrbitalPosAtTime(t);
+	m_vel = m_coastOrbit.OrbitalVelocityAtTime(t);
+	m_coastResolved = time;
+	SetPosition(m_coastPos);
+	// nothing to interpolate from, it's been a while
+	m_oldPos = m_coastPos;
+}
@@ -45,15 +45,41 @@ public:
 	vector3d GetExternalForce() const { return m_externalForce; }
 	vector3d GetAtmosForce() const { return m_atmosForce; }
 	vector3d GetGravityForce() const { return m_gravityForce; }
+	// where it was before the last physics tick
+	vector3d GetOldPosition() const { return m_oldPos; }
 	virtual void UpdateInterpTransform(double alpha);
 
 	virtual void PostLoadFixup(Space *space);
 
 	Orbit ComputeOrbit() const;
+
+	// coasting bodies are unpowered and in free fall around their frame's
+	// body. Space leaves them out of its per-step passes and the collision
+	// space, and only puts them on their orbit when it needs to know where
+	// they are. anything that changes the velocity or frame stops it
+	virtual bool CanCoast() const;
+	bool IsCoasting() const { return m_isCoasting; }
+	// the current state is the one at the given game time
+	bool StartCoasting(double time);
+	// puts it where the orbit has it at the given game time first, unless
+	// something else has moved it
+	void StopCoasting(double time);
+	// the coast was stopped, or the body moved from outside, since it was
+	// last put on its orbit
+	bool CoastInterrupted() const;
+	// move to where the orbit has the body at the given game time
+	void ResolveCoast(double time);
+	double GetCoastResolveTime() const { return m_coastResolved; }
+	// the fastest the body goes anywhere on its orbit
+	double GetCoastMaxSpeed() const { return m_coastMaxSpeed; }
 protected:
 	virtual void Save(Serializer::Writer &wr, Space *space);
 	virtual void Load(Serializer::Reader &rd, Space *space);
 private:
+	// moving bodies are integrated in batches by Space (see BodyIntegrator)
+	friend class BodyIntegrator;
+	void EndIntegration(const vector3d &pos, const vector3d &vel, const vector3d &angVel, const matrix3x3d *orient, const vector3d &force, double timeStep);
+
 	vector3d m_oldPos;
 	vector3d m_oldAngDisplacement;
 
@@ -66,6 +92,13 @@ private:
 	double m_angInertia; // always sphere mass distribution
 	bool m_isMoving;
 
+	bool m_isCoasting;
+	Orbit m_coastOrbit;
+	double m_coastStart;	// game time at the start of m_coastOrbit
+	double m_coastResolved;	// game time m_coastPos is for
+	vector3d m_coastPos;	// where we were last put on the orbit
+	double m_coastMaxSpeed;
+
 	vector3d m_externalForce;
 	vector3d m_atmosForce;
 	vector3d m_gravityForce;
@@ -15,13 +15,36 @@ extern "C" {
 
 namespace FileSystem {
 
-FileSourceZip::FileSourceZip(FileSourceFS &fs, const std::string &zipPath) : FileSource(zipPath), m_archive(0)
+// bytes of inflated entries kept around, and the largest entry worth keeping
+static const size_t CACHE_BUDGET = 32 * 1024 * 1024;
+static const size_t CACHE_MAX_ENTRY = 4 * 1024 * 1024;
+
+// an entry stored without compression, pointing straight into the archive
+class FileDataZipStored : public FileData {
+public:
+	FileDataZipStored(const FileInfo &info, size_t size, const char *data, const RefCountedPtr<FileData> &archive):
+		FileData(info, size, const_cast<char*>(data)), m_archive(archive) {}
+
+private:
+	// keeps the archive (and so the data) alive
+	RefCountedPtr<FileData> m_archive;
+};
+
+FileSourceZip::FileSourceZip(FileSourceFS &fs, const std::string &zipPath) : FileSource(zipPath), m_archive(0), m_cacheSize(0)
 {
+	// with the archive in memory, miniz reads compressed data straight out of
+	// it and keeps its inflator on the stack, so extraction needs no locking
+	m_archiveData = fs.ReadFile(zipPath);
+	if (!m_archiveData) {
+		Output("FileSourceZip: unable to open '%s'\n", zipPath.c_str());
+		return;
+	}
+
 	mz_zip_archive *zip = static_cast<mz_zip_archive*>(std::calloc(1, sizeof(mz_zip_archive)));
-	FILE *file = fs.OpenReadStream(zipPath);
-	if (!mz_zip_reader_init_file_stream(zip, file, 0)) {
+	if (!mz_zip_reader_init_mem(zip, m_archiveData->GetData(), m_archiveData->GetSize(), 0)) {
 		Output("FileSourceZip: unable to open '%s'\n", zipPath.c_str());
 		std::free(zip);
+		m_archiveData.Reset();
 		return;
 	}
 
@@ -50,6 +73,7 @@ FileSourceZip::~FileSourceZip()
 	if (!m_archive) return;
 	mz_zip_archive *zip = static_cast<mz_zip_archive*>(m_archive);
 	mz_zip_reader_end(zip);
+	std::free(zip);
 }
 
 static void SplitPath(const std::string &path, std::vector<std::string> &output)
@@ -112,7 +136,6 @@ FileInfo FileSourceZip::Lookup(const std::string &path)
 RefCountedPtr<FileData> FileSourceZip::ReadFile(const std::string &path)
 {
 	if (!m_archive) return RefCountedPtr<FileData>();
-	mz_zip_archive *zip = static_cast<mz_zip_archive*>(m_archive);
 
 	const Directory *dir;
 	std::string filename;
@@ -125,23 +148,100 @@ RefCountedPtr<FileData> FileSourceZip::ReadFile(const std::string &path)
 
 	const FileStat &st = (*i).second;
 
+	RefCountedPtr<FileData> data = FindInCache(st.index);
+	if (!data) {
+		bool inflated = false;
+		data = Extract(st, path, inflated);
+		// stored entries already cost nothing to read
+		if (data && inflated)
+			AddToCache(st.index, data);
+	}
+	return data;
+}
+
+RefCountedPtr<FileData> FileSourceZip::Extract(const FileStat &st, const std::string &path, bool &inflated)
+{
+	mz_zip_archive *zip = static_cast<mz_zip_archive*>(m_archive);
+
+	mz_zip_archive_file_stat zipStat;
+	if (!mz_zip_reader_file_stat(zip, st.index, &zipStat))
+		return RefCountedPtr<FileData>();
+
+	if (zipStat.m_method == 0 && !(zipStat.m_bit_flag & (1 | 32))) {
+		// the data follows the local header, whose name and extra field
+		// lengths can differ from the central directory's
+		const Uint8 *archive = reinterpret_cast<const Uint8*>(m_archiveData->GetData());
+		const Uint64 archiveSize = m_archiveData->GetSize();
+		const Uint64 headerOfs = zipStat.m_local_header_ofs;
+		if (headerOfs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE <= archiveSize &&
+			MZ_READ_LE32(archive + headerOfs) == MZ_ZIP_LOCAL_DIR_HEADER_SIG) {
+			const Uint64 dataOfs = headerOfs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE +
+				MZ_READ_LE16(archive + headerOfs + MZ_ZIP_LDH_FILENAME_LEN_OFS) +
+				MZ_READ_LE16(archive + headerOfs + MZ_ZIP_LDH_EXTRA_LEN_OFS);
+			if (dataOfs + st.size <= archiveSize) {
+				return RefCountedPtr<FileData>(new FileDataZipStored(st.info, st.size,
+					m_archiveData->GetData() + dataOfs, m_archiveData));
+			}
+		}
+		Output("FileSourceZip::ReadFile: bad local header for '%s'\n", path.c_str());
+		return RefCountedPtr<FileData>();
+	}
+
+	inflated = true;
 	char *data = static_cast<char*>(std::malloc(st.size));
-	if (!mz_zip_reader_extract_to_mem(zip, st.index, data, st.size, 0)) {
+	if (!mz_zip_reader_extract_to_mem_no_alloc(zip, st.index, data, st.size, 0, 0, 0)) {
 		Output("FileSourceZip::ReadFile: couldn't extract '%s'\n", path.c_str());
+		std::free(data);
 		return RefCountedPtr<FileData>();
 	}
 
 	return RefCountedPtr<FileData>(new FileDataMalloc(st.info, st.size, data));
 }
 
+RefCountedPtr<FileData> FileSourceZip::FindInCache(Uint32 index)
+{
+	std::lock_guard<std::mutex> lock(m_cacheLock);
+	std::unordered_map<Uint32, CacheEntry>::iterator it = m_cache.find(index);
+	if (it == m_cache.end())
+		return RefCountedPtr<FileData>();
+	m_cacheOrder.splice(m_cacheOrder.begin(), m_cacheOrder, it->second.order);
+	return it->second.data;
+}
+
+void FileSourceZip::AddToCache(Uint32 index, const RefCountedPtr<FileData> &data)
+{
+	// big entries would just push everything else out
+	if (data->GetSize() > CACHE_MAX_ENTRY)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_cacheLock);
+	// another thread may have extracted it at the same time
+	if (m_cache.count(index))
+		return;
+
+	while (!m_cacheOrder.empty() && m_cacheSize + data->GetSize() > CACHE_BUDGET) {
+		std::unordered_map<Uint32, CacheEntry>::iterator oldest = m_cache.find(m_cacheOrder.back());
+		m_cacheSize -= oldest->second.data->GetSize();
+		m_cache.erase(oldest);
+		m_cacheOrder.pop_back();
+	}
+
+	m_cacheOrder.push_front(index);
+	CacheEntry &entry = m_cache[index];
+	entry.data = data;
+	entry.order = m_cacheOrder.begin();
+	m_cacheSize += data->GetSize();
+}
+
 bool FileSourceZip::ReadDirectory(const std::string &path, std::vector<FileInfo> &output)
 {
-	const Directory *dir;
+	const Directory *dir = &m_root;
 	std::string filename;
-	if (!FindDirectoryAndFile(path, dir, filename))
-		return false;
+	// an empty path is the archive root, which FindDirectoryAndFile can't name
+	if (!NormalisePath(path).empty()) {
+		if (!FindDirectoryAndFile(path, dir, filename))
+			return false;
 
-	{
 		std::map<std::string,Directory>::const_iterator i = dir->subdirs.find(filename);
 		if (i == dir->subdirs.end())
 			return false;
@@ -7,14 +7,18 @@
 #include "FileSystem.h"
 #include <SDL_stdinc.h>
 #include <map>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <mutex>
 
 namespace FileSystem {
 
+// Reads are safe from any thread. The whole archive is held in memory
+// (mapped, for any archive of real size), entries stored without compression
+// are handed out in place, and recently inflated entries are kept around.
 class FileSourceZip : public FileSource {
 public:
-	// for now this needs to be FileSourceFS rather than just FileSource,
-	// because we need a FILE* stream access to the .zip file
 	FileSourceZip(FileSourceFS &fs, const std::string &zipPath);
 	virtual ~FileSourceZip();
 
@@ -24,6 +28,7 @@ public:
 
 private:
 	void *m_archive;
+	RefCountedPtr<FileData> m_archiveData;
 
 	struct FileStat {
 		FileStat(Uint32 _index, Uint64 _size, FileInfo _info) : index(_index), size(_size), info(_info) {}
@@ -41,6 +46,21 @@ private:
 
 	bool FindDirectoryAndFile(const std::string &path, const Directory* &dir, std::string &filename);
 	void AddFile(const std::string &path, const FileStat &fileStat);
+
+	RefCountedPtr<FileData> Extract(const FileStat &st, const std::string &path, bool &inflated);
+
+	// inflated entries, most recently used at the front
+	struct CacheEntry {
+		RefCountedPtr<FileData> data;
+		std::list<Uint32>::iterator order;
+	};
+	RefCountedPtr<FileData> FindInCache(Uint32 index);
+	void AddToCache(Uint32 index, const RefCountedPtr<FileData> &data);
+
+	std::mutex m_cacheLock;
+	std::list<Uint32> m_cacheOrder;
+	std::unordered_map<Uint32, CacheEntry> m_cache;
+	size_t m_cacheSize;
 };
 
 }
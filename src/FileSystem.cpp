@@ -151,7 +151,7 @@ namespace FileSystem {
 		return FileInfo(this, path, fileType);
 	}
 
-	FileSourceUnion::FileSourceUnion(): FileSource(":union:") {}
+	FileSourceUnion::FileSourceUnion(): FileSource(":union:"), m_indexGeneration(0) {}
 	FileSourceUnion::~FileSourceUnion() {}
 
 	void FileSourceUnion::PrependSource(FileSource *fs)
@@ -159,6 +159,7 @@ namespace FileSystem {
 		assert(fs);
 		RemoveSource(fs);
 		m_sources.insert(m_sources.begin(), fs);
+		InvalidateIndex();
 	}
 
 	void FileSourceUnion::AppendSource(FileSource *fs)
@@ -166,16 +167,119 @@ namespace FileSystem {
 		assert(fs);
 		RemoveSource(fs);
 		m_sources.push_back(fs);
+		InvalidateIndex();
 	}
 
 	void FileSourceUnion::RemoveSource(FileSource *fs)
 	{
 		std::vector<FileSource*>::iterator nend = std::remove(m_sources.begin(), m_sources.end(), fs);
 		m_sources.erase(nend, m_sources.end());
+		InvalidateIndex();
+	}
+
+	void FileSourceUnion::InvalidateIndex()
+	{
+		++m_indexGeneration;
+		std::atomic_store(&m_index, std::shared_ptr<const Index>());
+	}
+
+	static std::string fold_case(const std::string &path)
+	{
+		std::string folded(path);
+		for (char &c : folded)
+			if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+		return folded;
+	}
+
+	void FileSourceUnion::BuildIndex(Index &index) const
+	{
+		PROFILE_SCOPED()
+		std::vector<FileInfo> entries;
+		std::vector<std::string> dirs;
+		for (std::vector<FileSource*>::const_iterator
+			it = m_sources.begin(); it != m_sources.end(); ++it)
+		{
+			dirs.push_back("");
+			while (!dirs.empty()) {
+				const std::string dir = dirs.back();
+				dirs.pop_back();
+
+				entries.clear();
+				(*it)->ReadDirectory(dir, entries);
+				for (const FileInfo &info : entries) {
+					if (!info.Exists()) continue;
+					// earlier sources win, so only fill in what isn't already there
+					IndexEntry &entry = index.entries[info.GetPath()];
+					if (!entry.first)
+						entry.first = *it;
+					if (info.IsFile() && !entry.firstFile)
+						entry.firstFile = *it;
+					if (info.IsDir())
+						dirs.push_back(info.GetPath());
+				}
+			}
+		}
+
+#ifdef _WIN32
+		// windows paths aren't case sensitive, so a path in another case
+		// may still name a file
+		for (const auto &entry : index.entries)
+			index.folded.insert(std::make_pair(fold_case(entry.first), entry.first));
+#endif
+	}
+
+	std::shared_ptr<const FileSourceUnion::Index> FileSourceUnion::GetIndex()
+	{
+		std::shared_ptr<const Index> index = std::atomic_load(&m_index);
+		if (index) return index;
+
+		std::lock_guard<std::mutex> lock(m_indexLock);
+		index = std::atomic_load(&m_index);
+		if (index) return index;
+
+		const unsigned int generation = m_indexGeneration;
+		std::shared_ptr<Index> built(new Index);
+		BuildIndex(*built);
+		index = built;
+		// still good for this lookup either way
+		if (generation == m_indexGeneration)
+			std::atomic_store(&m_index, index);
+		return index;
+	}
+
+	// false if the path isn't one the index could hold, and the sources have
+	// to be asked one by one instead. otherwise the index has the last word:
+	// entry is set, with no sources if the path isn't anywhere
+	bool FileSourceUnion::FindInIndex(const std::string &path, IndexEntry &entry)
+	{
+		std::string key;
+		try {
+			key = NormalisePath(path);
+		} catch (std::invalid_argument &) {
+			return false;
+		}
+		if (key.empty() || key[0] == '/')
+			return false;
+
+		const std::shared_ptr<const Index> index = GetIndex();
+		auto it = index->entries.find(key);
+		if (it == index->entries.end() && !index->folded.empty()) {
+			auto folded = index->folded.find(fold_case(key));
+			if (folded != index->folded.end())
+				it = index->entries.find(folded->second);
+		}
+		entry = it != index->entries.end() ? it->second : IndexEntry();
+		return true;
 	}
 
 	FileInfo FileSourceUnion::Lookup(const std::string &path)
 	{
+		IndexEntry entry;
+		if (FindInIndex(path, entry)) {
+			if (entry.first) { return entry.first->Lookup(path); }
+			return MakeFileInfo(path, FileInfo::FT_NON_EXISTENT);
+		}
+
 		for (std::vector<FileSource*>::const_iterator
 			it = m_sources.begin(); it != m_sources.end(); ++it)
 		{
@@ -187,6 +291,12 @@ namespace FileSystem {
 
 	RefCountedPtr<FileData> FileSourceUnion::ReadFile(const std::string &path)
 	{
+		IndexEntry entry;
+		if (FindInIndex(path, entry)) {
+			if (entry.firstFile) { return entry.firstFile->ReadFile(path); }
+			return RefCountedPtr<FileData>();
+		}
+
 		for (std::vector<FileSource*>::const_iterator
 			it = m_sources.begin(); it != m_sources.end(); ++it)
 		{
@@ -196,6 +306,13 @@ namespace FileSystem {
 		return RefCountedPtr<FileData>();
 	}
 
+	void FileSourceUnion::Prefetch(const std::string &path)
+	{
+		IndexEntry entry;
+		if (FindInIndex(path, entry) && entry.firstFile)
+			entry.firstFile->Prefetch(path);
+	}
+
 	// Merge two sets of FileInfo's, by path.
 	// Input vectors must be sorted. Output will be sorted.
 	// Where a path is present in both inputs, directories are selected
@@ -11,6 +11,9 @@
 #include <vector>
 #include <deque>
 #include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
 
 /*
  * Functionality:
@@ -160,6 +163,10 @@ namespace FileSystem {
 		virtual RefCountedPtr<FileData> ReadFile(const std::string &path) = 0;
 		virtual bool ReadDirectory(const std::string &path, std::vector<FileInfo> &output) = 0;
 
+		// hint that path is going to be read soon, so the source can start
+		// fetching it in the background. sources are free to ignore it
+		virtual void Prefetch(const std::string &path) {}
+
 		bool IsTrusted() const { return m_trusted; }
 
 	protected:
@@ -178,16 +185,18 @@ namespace FileSystem {
 		virtual FileInfo Lookup(const std::string &path);
 		virtual RefCountedPtr<FileData> ReadFile(const std::string &path);
 		virtual bool ReadDirectory(const std::string &path, std::vector<FileInfo> &output);
+		virtual void Prefetch(const std::string &path);
 
 		bool MakeDirectory(const std::string &path);
 
 		enum WriteFlags {
-			WRITE_TEXT = 1
+			WRITE_TEXT = 1,
+			WRITE_APPEND = 2
 		};
 
 		// similar to fopen(path, "rb")
 		FILE* OpenReadStream(const std::string &path);
-		// similar to fopen(path, "wb")
+		// similar to fopen(path, "wb"), or "ab" with WRITE_APPEND
 		FILE* OpenWriteStream(const std::string &path, int flags = 0);
 	};
 
@@ -206,9 +215,41 @@ namespace FileSystem {
 		virtual FileInfo Lookup(const std::string &path);
 		virtual RefCountedPtr<FileData> ReadFile(const std::string &path);
 		virtual bool ReadDirectory(const std::string &path, std::vector<FileInfo> &output);
+		virtual void Prefetch(const std::string &path);
+
+		// Lookup and ReadFile go through an index of every path in every
+		// source, built on first use after the source list changes. a path
+		// that isn't in it, even ignoring case, isn't anywhere, so anything
+		// that adds files to one of the sources behind its back has to call
+		// this to have them found
+		void InvalidateIndex();
 
 	private:
+		struct IndexEntry {
+			IndexEntry(): first(0), firstFile(0) {}
+			FileSource *first;      // first source with anything at the path
+			FileSource *firstFile;  // first source with a file at the path
+		};
+		struct Index {
+			std::unordered_map<std::string, IndexEntry> entries;
+			// lower case path to the path as indexed, where paths aren't
+			// case sensitive (windows). empty elsewhere
+			std::unordered_map<std::string, std::string> folded;
+		};
+
+		bool FindInIndex(const std::string &path, IndexEntry &entry);
+		std::shared_ptr<const Index> GetIndex();
+		void BuildIndex(Index &index) const;
+
 		std::vector<FileSource*> m_sources;
+		// never changed once built, so lookups on any thread can hold on to
+		// it while a new one replaces it. only read and written through
+		// std::atomic_load/atomic_store
+		std::shared_ptr<const Index> m_index;
+		// bumped by every InvalidateIndex, so an index built from sources
+		// that changed while it was being built isn't kept
+		std::atomic<unsigned int> m_indexGeneration;
+		std::mutex m_indexLock;
 	};
 
 	class FileEnumerator {
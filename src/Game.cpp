@@ -153,8 +153,10 @@ Game::Game(Serializer::Reader &rd) :
 		if (rd.Byte() != s_saveEnd[i]) throw SavedGameCorruptException();
 }
 
-void Game::Serialize(Serializer::Writer &wr)
+void Game::Serialize(std::vector<std::string> &parts, std::vector<Body*> *bodies)
 {
+	Serializer::Writer wr;
+
 	// leading signature
 	for (Uint32 i = 0; i < strlen(s_saveStart)+1; i++)
 		wr.Byte(s_saveStart[i]);
@@ -176,12 +178,17 @@ void Game::Serialize(Serializer::Writer &wr)
 	wr.WrSection("Game", section.GetData());
 
 
-	// space, all the bodies and things
+	// space, all the bodies and things. JoinParts writes the section around them
+	wr.String("Space");
+	parts.push_back(wr.GetData());
+
+	m_space->Serialize(parts, bodies);
 	section = Serializer::Writer();
-	m_space->Serialize(section);
 	section.Int32(m_space->GetIndexForBody(m_player.get()));
-	wr.WrSection("Space", section.GetData());
+	parts.push_back(section.GetData());
+
 
+	wr = Serializer::Writer();
 
 	// space transition state
 	section = Serializer::Writer();
@@ -205,6 +212,31 @@ void Game::Serialize(Serializer::Writer &wr)
 	// trailing signature
 	for (Uint32 i = 0; i < strlen(s_saveEnd)+1; i++)
 		wr.Byte(s_saveEnd[i]);
+
+	parts.push_back(wr.GetData());
+}
+
+std::string Game::JoinParts(const std::vector<std::string> &parts)
+{
+	assert(parts.size() >= 2);
+
+	size_t spaceSize = 0;
+	for (size_t i = 1; i < parts.size()-1; i++)
+		spaceSize += parts[i].size();
+
+	// as Serializer::Writer::String would have written it
+	Serializer::Writer length;
+	length.Int32(spaceSize+1);
+
+	std::string data;
+	data.reserve(parts.front().size() + 4 + spaceSize + 1 + parts.back().size());
+	data += parts.front();
+	data += length.GetData();
+	for (size_t i = 1; i < parts.size()-1; i++)
+		data += parts[i];
+	data.push_back('\0');
+	data += parts.back();
+	return data;
 }
 
 void Game::TimeStep(float step)
@@ -674,10 +706,10 @@ void Game::SaveGame(const std::string &filename, Game *game)
 		throw CouldNotOpenFileException();
 	}
 
-	Serializer::Writer wr;
-	game->Serialize(wr);
+	std::vector<std::string> parts;
+	game->Serialize(parts);
 
-	const std::string data = wr.GetData();
+	const std::string data = JoinParts(parts);
 
 	FILE *f = FileSystem::userFiles.OpenWriteStream(FileSystem::JoinPathBelow(Pi::SAVE_DIR_NAME, filename));
 	if (!f) throw CouldNotOpenFileException();
@@ -8,7 +8,11 @@
 #include "galaxy/SystemPath.h"
 #include "Serializer.h"
 #include "gameconsts.h"
+#include <list>
+#include <string>
+#include <vector>
 
+class Body;
 class HyperspaceCloud;
 class Player;
 class ShipController;
@@ -33,8 +37,15 @@ public:
 
 	~Game();
 
-	// save game
-	void Serialize(Serializer::Writer &wr);
+	// save game. the space section comes in pieces (see Space::Serialize):
+	// parts.front() is everything before its data, parts.back() everything
+	// after it and the ones between are the data. JoinParts makes them into
+	// what the load constructor reads.
+	// with bodies, the bodies' own parts are left empty for the caller to
+	// fill with Body::Serialize, and they're listed there in the same order.
+	// their parts start at parts[2]
+	void Serialize(std::vector<std::string> &parts, std::vector<Body*> *bodies = nullptr);
+	static std::string JoinParts(const std::vector<std::string> &parts);
 
 	// various game states
 	bool IsNormalSpace() const { return m_state == STATE_NORMAL; }
@@ -30,10 +30,15 @@ GameConfig::GameConfig(const std::map<std::string,std::string> &override_)
 	map["DefaultLowThrustPower"] = "0.25";
 	map["VSync"] = "0";
 	map["UseTextureCompression"] = "0";
+	map["UseShaderCache"] = "1";
+	map["WarmShaderCache"] = "1";
 	map["WorkerThreads"] = "0";
+	map["SystemNameIndexRadius"] = "16";
 	map["SpeedLines"] = "0";
 	map["EnableCockpit"] = "0";
 	map["HudTrails"] = "0";
+	map["AutosaveInterval"] = "300";
+	map["AutosaveCompactEvery"] = "16";
 
 #ifdef _WIN32
 	map["RedirectStdio"] = "1";
@@ -50,6 +50,7 @@ GeoPatch::GeoPatch(const RefCountedPtr<GeoPatchContext> &ctx_, GeoSphere *gs,
  		distMult = 5.0 / Clamp(depth, 1, 5);
  	}
 	m_roughLength = GEOPATCH_SUBDIVIDE_AT_CAMDIST / pow(2.0, depth) * distMult;
+	m_vertexSlot = GeoPatchContext::NO_VERTEX_SLOT;
 	m_needUpdateVBOs = false;
 }
 
@@ -65,6 +66,8 @@ GeoPatch::~GeoPatch() {
 	heights.reset();
 	normals.reset();
 	colors.reset();
+	if (m_vertexSlot != GeoPatchContext::NO_VERTEX_SLOT)
+		ctx->FreeVertexSlot(m_vertexSlot);
 }
 
 void GeoPatch::_UpdateVBOs(Graphics::Renderer *renderer) 
@@ -73,20 +76,12 @@ void GeoPatch::_UpdateVBOs(Graphics::Renderer *renderer)
 		assert(renderer);
 		m_needUpdateVBOs = false;
 
-		//create buffer and upload data
-		Graphics::VertexBufferDesc vbd;
-		vbd.attrib[0].semantic = Graphics::ATTRIB_POSITION;
-		vbd.attrib[0].format   = Graphics::ATTRIB_FORMAT_FLOAT3;
-		vbd.attrib[1].semantic = Graphics::ATTRIB_NORMAL;
-		vbd.attrib[1].format   = Graphics::ATTRIB_FORMAT_FLOAT3;
-		vbd.attrib[2].semantic = Graphics::ATTRIB_DIFFUSE;
-		vbd.attrib[2].format   = Graphics::ATTRIB_FORMAT_UBYTE4;
-		vbd.numVertices = ctx->NUMVERTICES();
-		vbd.usage = Graphics::BUFFER_USAGE_STATIC;
-		m_vertexBuffer.reset(renderer->CreateVertexBuffer(vbd));
+		if (m_vertexSlot == GeoPatchContext::NO_VERTEX_SLOT)
+			m_vertexSlot = ctx->AllocVertexSlot();
 
-		GeoPatchContext::VBOVertex* vtxPtr = m_vertexBuffer->Map<GeoPatchContext::VBOVertex>(Graphics::BUFFER_MAP_WRITE);
-		assert(m_vertexBuffer->GetDesc().stride == sizeof(GeoPatchContext::VBOVertex));
+		std::vector<GeoPatchContext::VBOVertex> &vertices = ctx->vertexScratch;
+		vertices.resize(ctx->NUMVERTICES());
+		GeoPatchContext::VBOVertex* vtxPtr = &vertices[0];
 
 		const Sint32 edgeLen = ctx->edgeLen;
 		const double frac = ctx->frac;
@@ -116,28 +111,15 @@ void GeoPatch::_UpdateVBOs(Graphics::Renderer *renderer)
 				++vtxPtr; // next vertex
 			}
 		}
-		m_vertexBuffer->Unmap();
+		ctx->GetVertexSlotBuffer(m_vertexSlot)->UpdateRange(ctx->GetVertexSlotStart(m_vertexSlot), vertices.size(), &vertices[0]);
 	}
 }
 
-void GeoPatch::Render(Graphics::Renderer *renderer, const vector3d &campos, const matrix4x4d &modelView, const Graphics::Frustum &frustum) {
+void GeoPatch::GatherLeaves(std::vector<GeoPatch*> &leaves) {
 	if (kids[0]) {
-		for (int i=0; i<NUM_KIDS; i++) kids[i]->Render(renderer, campos, modelView, frustum);
+		for (int i=0; i<NUM_KIDS; i++) kids[i]->GatherLeaves(leaves);
 	} else if (heights) {
-		_UpdateVBOs(renderer);
-
-		if (!frustum.TestPoint(clipCentroid, clipRadius))
-			return;
-
-		Graphics::Material *mat = geosphere->GetSurfaceMaterial();
-		Graphics::RenderState *rs = geosphere->GetSurfRenderState();
-
-		const vector3d relpos = clipCentroid - campos;
-		renderer->SetTransform(modelView * matrix4x4d::Translation(relpos));
-
-		Pi::statSceneTris += 2*(ctx->edgeLen-1)*(ctx->edgeLen-1);
-
-		renderer->DrawBufferIndexed(m_vertexBuffer.get(), ctx->indices_list[determineIndexbuffer()].Get(), rs, mat);
+		leaves.push_back(this);
 	}
 }
 
@@ -34,7 +34,7 @@ public:
 	std::unique_ptr<double[]> heights;
 	std::unique_ptr<vector3f[]> normals;
 	std::unique_ptr<Color3ub[]> colors;
-	std::unique_ptr<Graphics::VertexBuffer> m_vertexBuffer;
+	Uint32 m_vertexSlot; // in ctx's vertex buffers
 	std::unique_ptr<GeoPatch> kids[NUM_KIDS];
 	GeoPatch *parent;
 	GeoPatch *edgeFriend[NUM_EDGES]; // [0]=v01, [1]=v12, [2]=v20
@@ -118,7 +118,8 @@ public:
 			(edgeFriend[3] ? 8u : 0u);
 	}
 
-	void Render(Graphics::Renderer *r, const vector3d &campos, const matrix4x4d &modelView, const Graphics::Frustum &frustum);
+	// the leaves under this patch that have heights, or this one if it's a leaf
+	void GatherLeaves(std::vector<GeoPatch*> &leaves);
 
 	inline bool canBeMerged() const {
 		bool merge = true;
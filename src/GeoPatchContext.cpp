@@ -25,6 +25,33 @@ void GeoPatchContext::Cleanup() {
 	}
 }
 
+Uint32 GeoPatchContext::AllocVertexSlot()
+{
+	if (freeVertexSlots.empty()) {
+		// out of room; another buffer's worth of slots
+		Graphics::VertexBufferDesc vbd;
+		vbd.attrib[0].semantic = Graphics::ATTRIB_POSITION;
+		vbd.attrib[0].format   = Graphics::ATTRIB_FORMAT_FLOAT3;
+		vbd.attrib[1].semantic = Graphics::ATTRIB_NORMAL;
+		vbd.attrib[1].format   = Graphics::ATTRIB_FORMAT_FLOAT3;
+		vbd.attrib[2].semantic = Graphics::ATTRIB_DIFFUSE;
+		vbd.attrib[2].format   = Graphics::ATTRIB_FORMAT_UBYTE4;
+		vbd.numVertices = NUMVERTICES() * VERTEX_SLOTS_PER_BUFFER;
+		vbd.usage = Graphics::BUFFER_USAGE_STATIC;
+		vertexBuffers.push_back(RefCountedPtr<Graphics::VertexBuffer>(Pi::renderer->CreateVertexBuffer(vbd)));
+		assert(vertexBuffers.back()->GetDesc().stride == sizeof(VBOVertex));
+
+		// handed out from the front
+		const Uint32 first = (vertexBuffers.size()-1) * VERTEX_SLOTS_PER_BUFFER;
+		for (Uint32 i = VERTEX_SLOTS_PER_BUFFER; i > 0; i--)
+			freeVertexSlots.push_back(first + i-1);
+	}
+
+	const Uint32 slot = freeVertexSlots.back();
+	freeVertexSlots.pop_back();
+	return slot;
+}
+
 int GeoPatchContext::getIndices(std::vector<unsigned short> &pl, const unsigned int edge_hi_flags)
 {
 	// calculate how many tri's there are
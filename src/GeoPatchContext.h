@@ -58,6 +58,21 @@ public:
 	std::unique_ptr<unsigned short[]> hiEdgeIndices[4];
 	RefCountedPtr<Graphics::IndexBuffer> indices_list[NUM_INDEX_LISTS];
 
+	// patch vertices are kept a patch to a slot in a few big buffers, so
+	// that there aren't hundreds of small buffers near the surface. a
+	// slot's index says which buffer it's in and where
+	static const Uint32 VERTEX_SLOTS_PER_BUFFER = 64;
+	static const Uint32 NO_VERTEX_SLOT = ~0u;
+	std::vector< RefCountedPtr<Graphics::VertexBuffer> > vertexBuffers;
+	std::vector<Uint32> freeVertexSlots;
+
+	Uint32 AllocVertexSlot();
+	void FreeVertexSlot(Uint32 slot) { freeVertexSlots.push_back(slot); }
+	Graphics::VertexBuffer *GetVertexSlotBuffer(Uint32 slot) const { return vertexBuffers[slot / VERTEX_SLOTS_PER_BUFFER].Get(); }
+	Uint32 GetVertexSlotStart(Uint32 slot) const { return (slot % VERTEX_SLOTS_PER_BUFFER) * NUMVERTICES(); }
+	// a patch's vertices, built here then copied into its slot
+	std::vector<VBOVertex> vertexScratch;
+
 	GeoPatchContext(int _edgeLen) : edgeLen(_edgeLen) {
 		Init();
 	}
@@ -33,15 +33,23 @@ void BasePatchJob::GenerateMesh(double *heights, vector3f *normals, Color3ub *co
 	const int borderedEdgeLen = edgeLen+2;
 	const int numBorderedVerts = borderedEdgeLen*borderedEdgeLen;
 
+	// octaves finer than the distance between vertices are left out. except
+	// on the edges: each patch is generated on its own, so a seam vertex has
+	// to come out the same whatever the depth of the patch on either side,
+	// and only every octave does that
+	const double footprint = (v1-v0).Length() * fracStep;
+
 	// generate heights plus a 1 unit border
 	double *bhts = borderHeights;
 	vector3d *vrts = borderVertexs;
 	for (int y=-1; y<borderedEdgeLen-1; y++) {
 		const double yfrac = double(y) * fracStep;
+		const bool yEdge = (y == 0 || y == edgeLen-1);
 		for (int x=-1; x<borderedEdgeLen-1; x++) {
 			const double xfrac = double(x) * fracStep;
 			const vector3d p = GetSpherePoint(v0, v1, v2, v3, xfrac, yfrac);
-			const double height = pTerrain->GetHeight(p);
+			const bool edge = (yEdge && x >= 0 && x < edgeLen) || ((x == 0 || x == edgeLen-1) && y >= 0 && y < edgeLen);
+			const double height = pTerrain->GetHeight(p, edge ? 0.0 : footprint);
 			assert(height >= 0.0f && height <= 1.0f);
 			*(bhts++) = height;
 			*(vrts++) = p * (height + 1.0);
@@ -72,7 +80,7 @@ void BasePatchJob::GenerateMesh(double *heights, vector3f *normals, Color3ub *co
 
 			// color
 			const vector3d p = GetSpherePoint(v0, v1, v2, v3, (x-1)*fracStep, (y-1)*fracStep);
-			setColour(*col, pTerrain->GetColor(p, height, n));
+			setColour(*col, pTerrain->GetColor(p, height, n, footprint));
 			assert(col!=&colors[edgeLen*edgeLen]);
 			++col;
 		}
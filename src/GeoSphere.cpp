@@ -343,6 +343,34 @@ void GeoSphere::Update()
 	}
 }
 
+// is the patch wholly hidden by the planet? the ground is never below
+// radius 1 (see GetHeight), and that sphere hides everything inside its
+// silhouette that's further away than the horizon
+static bool below_horizon(const vector3d &campos, const vector3d &centre, double radius)
+{
+	const double camDistSqr = campos.LengthSqr();
+	if (camDistSqr <= 1.0)
+		return false;
+	const vector3d toPatch = centre - campos;
+	const double dist = toPatch.Length();
+	if (dist - radius < sqrt(camDistSqr - 1.0))
+		return false;
+
+	const double camDist = sqrt(camDistSqr);
+	const double angle = acos(Clamp(-toPatch.Dot(campos) / (dist * camDist), -1.0, 1.0));
+	return angle + asin(radius / dist) <= asin(1.0 / camDist);
+}
+
+// patches sharing a vertex buffer and edge variant go together
+static bool draw_order(const GeoPatch *a, const GeoPatch *b)
+{
+	const Graphics::VertexBuffer *va = a->ctx->GetVertexSlotBuffer(a->m_vertexSlot);
+	const Graphics::VertexBuffer *vb = b->ctx->GetVertexSlotBuffer(b->m_vertexSlot);
+	if (va != vb)
+		return va < vb;
+	return a->determineIndexbuffer() < b->determineIndexbuffer();
+}
+
 void GeoSphere::Render(Graphics::Renderer *renderer, const matrix4x4d &modelView, vector3d campos, const float radius, const float scale, const std::vector<Camera::Shadow> &shadows)
 {
 	// store this for later usage in the update method.
@@ -423,8 +451,47 @@ void GeoSphere::Render(Graphics::Renderer *renderer, const matrix4x4d &modelView
 
 	renderer->SetTransform(modelView);
 
-	for (int i=0; i<NUM_PATCHES; i++) {
-		m_patches[i]->Render(renderer, campos, modelView, frustum);
+	// cull over the leaves rather than the tree, and draw what's left a
+	// vertex buffer and edge variant at a time
+	m_leafPatches.clear();
+	for (int i=0; i<NUM_PATCHES; i++)
+		m_patches[i]->GatherLeaves(m_leafPatches);
+
+	m_drawPatches.clear();
+	for (GeoPatch *p : m_leafPatches) {
+		p->_UpdateVBOs(renderer);
+		if (!frustum.TestPoint(p->clipCentroid, p->clipRadius))
+			continue;
+		if (below_horizon(campos, p->clipCentroid, p->clipRadius))
+			continue;
+		m_drawPatches.push_back(p);
+	}
+	std::sort(m_drawPatches.begin(), m_drawPatches.end(), draw_order);
+
+	Graphics::Material *mat = GetSurfaceMaterial();
+	Graphics::RenderState *rs = GetSurfRenderState();
+	for (size_t first = 0; first < m_drawPatches.size(); ) {
+		const GeoPatch *fp = m_drawPatches[first];
+		Graphics::VertexBuffer *vb = fp->ctx->GetVertexSlotBuffer(fp->m_vertexSlot);
+		const GLuint variant = fp->determineIndexbuffer();
+
+		m_drawStarts.clear();
+		m_drawTransforms.clear();
+		size_t end = first;
+		for (; end < m_drawPatches.size(); end++) {
+			const GeoPatch *p = m_drawPatches[end];
+			if (p->ctx->GetVertexSlotBuffer(p->m_vertexSlot) != vb || p->determineIndexbuffer() != variant)
+				break;
+			m_drawStarts.push_back(p->ctx->GetVertexSlotStart(p->m_vertexSlot));
+			matrix4x4f trans;
+			matrix4x4dtof(modelView * matrix4x4d::Translation(p->clipCentroid - campos), trans);
+			m_drawTransforms.push_back(trans);
+			Pi::statSceneTris += 2*(p->ctx->edgeLen-1)*(p->ctx->edgeLen-1);
+		}
+
+		renderer->DrawBufferIndexedRanges(vb, fp->ctx->indices_list[variant].Get(), rs, mat,
+			m_drawStarts.size(), &m_drawStarts[0], &m_drawTransforms[0]);
+		first = end;
 	}
 
 	renderer->SetAmbientColor(oldAmbient);
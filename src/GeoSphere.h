@@ -77,6 +77,12 @@ private:
 	bool m_hasTempCampos;
 	vector3d m_tempCampos;
 
+	// scratch for Render: the leaf patches, and those of them that are drawn
+	std::vector<GeoPatch*> m_leafPatches;
+	std::vector<GeoPatch*> m_drawPatches;
+	std::vector<Uint32> m_drawStarts;
+	std::vector<matrix4x4f> m_drawTransforms;
+
 	inline vector3d GetColor(const vector3d &p, double height, const vector3d &norm) const {
 		return m_terrain->GetColor(p, height, norm);
 	}
@@ -3,6 +3,8 @@
 
 #include "JobQueue.h"
 #include "StringF.h"
+#include <atomic>
+#include <memory>
 
 void Job::UnlinkHandle()
 {
@@ -442,3 +444,99 @@ Uint32 SyncJobQueue::RunJobs(Uint32 count)
 	}
 	return executed;
 }
+
+
+namespace {
+	// shared between the caller of ParallelFor and its helper jobs. helpers
+	// may start after ParallelFor has returned, so they hold a reference
+	// and simply find no chunks left to claim
+	class ParallelForState {
+	public:
+		ParallelForState(Uint32 count, Uint32 chunkSize, const std::function<void(Uint32, Uint32)> &fn) :
+			m_fn(fn), m_count(count), m_chunkSize(chunkSize),
+			m_numChunks((count + chunkSize - 1) / chunkSize),
+			m_nextChunk(0), m_doneChunks(0)
+		{
+			m_lock = SDL_CreateMutex();
+			m_doneCond = SDL_CreateCond();
+		}
+
+		~ParallelForState()
+		{
+			SDL_DestroyCond(m_doneCond);
+			SDL_DestroyMutex(m_lock);
+		}
+
+		Uint32 GetNumChunks() const { return m_numChunks; }
+
+		// claim and run chunks until there are none left
+		void RunChunks()
+		{
+			for (Uint32 chunk = m_nextChunk++; chunk < m_numChunks; chunk = m_nextChunk++) {
+				const Uint32 begin = chunk * m_chunkSize;
+				m_fn(begin, std::min(begin + m_chunkSize, m_count));
+
+				if (++m_doneChunks == m_numChunks) {
+					SDL_LockMutex(m_lock);
+					SDL_CondBroadcast(m_doneCond);
+					SDL_UnlockMutex(m_lock);
+				}
+			}
+		}
+
+		void WaitForChunks()
+		{
+			SDL_LockMutex(m_lock);
+			while (m_doneChunks < m_numChunks)
+				SDL_CondWait(m_doneCond, m_lock);
+			SDL_UnlockMutex(m_lock);
+		}
+
+	private:
+		const std::function<void(Uint32, Uint32)> m_fn;
+		const Uint32 m_count;
+		const Uint32 m_chunkSize;
+		const Uint32 m_numChunks;
+		std::atomic<Uint32> m_nextChunk;
+		std::atomic<Uint32> m_doneChunks;
+		SDL_mutex *m_lock;
+		SDL_cond *m_doneCond;
+	};
+
+	class ParallelForJob : public Job {
+	public:
+		ParallelForJob(const std::shared_ptr<ParallelForState> &state) : m_state(state) {}
+
+		virtual void OnRun() { m_state->RunChunks(); }
+		virtual void OnFinish() {}
+
+	private:
+		std::shared_ptr<ParallelForState> m_state;
+	};
+}
+
+void ParallelFor(JobQueue *queue, Uint32 count, Uint32 chunkSize, const std::function<void(Uint32 begin, Uint32 end)> &fn)
+{
+	PROFILE_SCOPED()
+	assert(chunkSize > 0);
+	if (!count) return;
+
+	// not worth waking anyone up for
+	const Uint32 numHelpers = queue ? std::min(queue->GetNumRunners(), (count - 1) / chunkSize) : 0;
+	if (!numHelpers) {
+		fn(0, count);
+		return;
+	}
+
+	std::shared_ptr<ParallelForState> state(new ParallelForState(count, chunkSize, fn));
+
+	std::vector<Job::Handle> helpers;
+	helpers.reserve(numHelpers);
+	for (Uint32 i = 0; i < numHelpers; i++)
+		helpers.push_back(queue->Queue(new ParallelForJob(state)));
+
+	state->RunChunks();
+	state->WaitForChunks();
+
+	// helpers that never got a runner are cancelled as their handles go away
+}
@@ -9,6 +9,7 @@
 #include <vector>
 #include <set>
 #include <string>
+#include <functional>
 #include "SDL_thread.h"
 
 static const Uint32 MAX_THREADS = 64;
@@ -123,6 +124,9 @@ public:
 	// and then delete all finished and cancelled jobs. returns the number of
 	// finished jobs (not cancelled)
 	virtual Uint32 FinishJobs() = 0;
+
+	// number of jobs that can run alongside the calling thread
+	virtual Uint32 GetNumRunners() const = 0;
 };
 
 // the queue management class. create one from the main thread, and feed your
@@ -155,6 +159,8 @@ public:
 	// finished jobs (not cancelled)
 	virtual Uint32 FinishJobs() override;
 
+	virtual Uint32 GetNumRunners() const override { return m_runners.size(); }
+
 private:
 	// a runner wraps a single thread, and calls into the queue when its ready for
 	// a new job. no user-servicable parts inside!
@@ -223,6 +229,9 @@ public:
 	// finished jobs (not cancelled)
 	virtual Uint32 FinishJobs() override;
 
+	// jobs only run when asked to, so nothing runs alongside the caller
+	virtual Uint32 GetNumRunners() const override { return 0; }
+
 	Uint32 RunJobs(Uint32 count = 1);
 
 private:
@@ -259,4 +268,12 @@ private:
 	std::set<Job::Handle> m_jobs;
 };
 
+// call from the main thread to split [0,count) into chunks of chunkSize and
+// run fn(begin, end) over each of them. the calling thread works through the
+// chunks itself while any idle runners of the queue help out, and this does
+// not return until every chunk is done, so fn may refer to the caller's
+// stack. chunks run in no particular order; fn must only touch the elements
+// it was given
+void ParallelFor(JobQueue *queue, Uint32 count, Uint32 chunkSize, const std::function<void(Uint32 begin, Uint32 end)> &fn);
+
 #endif
@@ -13,11 +13,16 @@
 #include "Camera.h"
 #include "Planet.h"
 #include "collider/collider.h"
+#include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
 #include "scenegraph/SceneGraph.h"
 #include "scenegraph/NodeVisitor.h"
 #include "scenegraph/CollisionGeometry.h"
 
+//models smaller than this on screen, in pixels, have their animations
+//updated every fourth time they're drawn
+static const float ANIMATION_DETAIL_PIXELS = 8.f;
+
 class DynGeomFinder : public SceneGraph::NodeVisitor {
 public:
 	std::vector<SceneGraph::CollisionGeometry*> results;
@@ -66,6 +71,7 @@ ModelBody::ModelBody()
 , m_colliding(true)
 , m_geom(0)
 , m_model(0)
+, m_animationFrame(0)
 {
 }
 
@@ -244,6 +250,13 @@ void ModelBody::RemoveGeomsFromFrame(Frame *f)
 		GetFrame()->RemoveGeom(*it);
 }
 
+void ModelBody::SweepGeomsFrom(const matrix3x3d &orient, const vector3d &pos)
+{
+	// animated parts are only tested where they are
+	const matrix4x4d m = orient;
+	m_geom->SweepFrom(m, pos);
+}
+
 void ModelBody::MoveGeoms(const matrix4x4d &m, const vector3d &p)
 {
 	m_geom->MoveTo(m, p);
@@ -289,17 +302,22 @@ void ModelBody::CalcLighting(double &ambient, double &direct, const Camera *came
 
 	Planet *planet = static_cast<Planet*>(astro);
 
+	// light directions and the planet's constants relative to the rotating
+	// frame of the planet, shared by every body lit by this planet this frame
+	const Camera::FrameLighting &frameLighting = camera->GetFrameLighting(planet->GetFrame());
+
 	// position relative to the rotating frame of the planet
 	vector3d upDir = GetInterpPositionRelTo(planet->GetFrame());
-	const double planetRadius = planet->GetSystemBody()->GetRadius();
+	const double planetRadius = frameLighting.planetRadius;
 	const double dist = std::max(planetRadius, upDir.Length());
 	upDir = upDir.Normalized();
 
+	// above the air; nothing to scatter the light
+	if (dist >= frameLighting.atmosphereRadius)
+		return;
+
 	double pressure, density;
 	planet->GetAtmosphericState(dist, &pressure, &density);
-	double surfaceDensity;
-	Color cl;
-	planet->GetSystemBody()->GetAtmosphereFlavor(&cl, &surfaceDensity);
 
 	// approximate optical thickness fraction as fraction of density remaining relative to earths
 	double opticalThicknessFraction = density/EARTH_ATMOSPHERE_SURFACE_DENSITY;
@@ -317,14 +335,11 @@ void ModelBody::CalcLighting(double &ambient, double &direct, const Camera *came
 	double light_clamped = 0.0;
 
 	const std::vector<Camera::LightSource> &lightSources = camera->GetLightSources();
-	for(std::vector<Camera::LightSource>::const_iterator l = lightSources.begin();
-			l != lightSources.end(); ++l) {
+	for (size_t i = 0; i < lightSources.size(); i++) {
 		double sunAngle;
 		// calculate the extent the sun is towards zenith
-		if (l->GetBody()){
-			// relative to the rotating frame of the planet
-			const vector3d lightDir = (l->GetBody()->GetInterpPositionRelTo(planet->GetFrame()).Normalized());
-			sunAngle = lightDir.Dot(upDir);
+		if (lightSources[i].GetBody()){
+			sunAngle = frameLighting.lightInterpDir[i].Dot(upDir);
 		} else {
 			// light is the default light for systems without lights
 			sunAngle = 1.0;
@@ -430,6 +445,11 @@ void ModelBody::RenderModel(Graphics::Renderer *r, const Camera *camera, const v
 	trans[14] = viewCoords.z;
 	trans[15] = 1.0f;
 
+	//animations are only brought up to date when they're seen
+	const float pixrad = Graphics::GetScreenHeight() * GetClipRadius() / (viewCoords.Length() * Graphics::GetFovFactor());
+	if (pixrad >= ANIMATION_DETAIL_PIXELS || (m_animationFrame++ & 3) == 0)
+		m_model->UpdateAnimations();
+
 	m_model->Render(trans);
 
 	if (setLighting)
@@ -442,5 +462,8 @@ void ModelBody::TimeStepUpdate(const float timestep)
 		// step animation by timestep/total length, loop to 0.0 if it goes >= 1.0
 		m_idleAnimation->SetProgress(fmod(m_idleAnimation->GetProgress() + timestep / m_idleAnimation->GetDuration(), 1.0));
 
-	m_model->UpdateAnimations();
+	//otherwise they're updated when the model is drawn, but the dynamic
+	//collision geometry follows the animations whether it's seen or not
+	if (!m_dynGeoms.empty())
+		m_model->UpdateAnimations();
 }
@@ -48,11 +48,15 @@ protected:
 
 	Shields* GetShields() const { return m_shields.get(); }
 
+	// the body just moved continuously from orient, pos to where it is now
+	void SweepGeomsFrom(const matrix3x3d &orient, const vector3d &pos);
+
+	void AddGeomsToFrame(Frame*);
+	void RemoveGeomsFromFrame(Frame*);
+
 private:
 	void RebuildCollisionMesh();
 	void DeleteGeoms();
-	void AddGeomsToFrame(Frame*);
-	void RemoveGeomsFromFrame(Frame*);
 	void MoveGeoms(const matrix4x4d&, const vector3d&);
 
 	void CalcLighting(double &ambient, double &direct, const Camera *camera);
@@ -65,6 +69,7 @@ private:
 	SceneGraph::Model *m_model;
 	std::vector<Geom*> m_dynGeoms;
 	SceneGraph::Animation *m_idleAnimation;
+	Uint32 m_animationFrame; //for updating small models' animations less often
 	std::unique_ptr<Shields> m_shields;
 };
 
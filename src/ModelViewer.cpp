@@ -148,6 +148,8 @@ void ModelViewer::Run(const std::string &modelName)
 	videoSettings.requestedSamples = config->Int("AntiAliasingMode");
 	videoSettings.vsync = (config->Int("VSync") != 0);
 	videoSettings.useTextureCompression = (config->Int("UseTextureCompression") != 0);
+	videoSettings.useProgramCache = (config->Int("UseShaderCache") != 0);
+	videoSettings.warmPrograms = (config->Int("WarmShaderCache") != 0);
 	videoSettings.iconFile = OS::GetIconFilename();
 	videoSettings.title = "Model viewer";
 	Graphics::Renderer *renderer = Graphics::Init(videoSettings);
@@ -251,6 +253,7 @@ bool ModelViewer::OnToggleGuns(UI::CheckBox *w)
 		tagL->RemoveChildAt(0);
 		tagR->RemoveChildAt(0);
 	}
+	m_model->InvalidateDrawList();
 	return true;
 }
 
@@ -119,6 +119,7 @@ NavLights::NavLights(SceneGraph::Model *model, float period)
 		mt->SetNodeMask(SceneGraph::NODE_TRANSPARENT);
 		mt->AddChild(bblight);
 	}
+	model->InvalidateDrawList();
 }
 
 NavLights::~NavLights()
@@ -138,6 +138,24 @@ vector3d Orbit::OrbitalPosAtTime(double t) const
 	return m_orient * vector3d(-cos_v*r, sin_v*r, 0);
 }
 
+vector3d Orbit::OrbitalVelocityAtTime(double t) const
+{
+	double cos_v, sin_v, r;
+	calc_position_from_mean_anomaly(MeanAnomalyAtTime(t), m_eccentricity, m_semiMajorAxis, cos_v, sin_v, &r);
+
+	// specific angular momentum is twice the areal velocity. true anomaly
+	// increases with time for both ellipses and hyperbolas, so the speed
+	// splits into h/r across the radius and h/p * e*sin(v) along it
+	const double e = m_eccentricity;
+	const double h = 2.0 * m_velocityAreaPerSecond;
+	const double p = m_semiMajorAxis * fabs(1.0 - e*e);
+	if (is_zero_general(r) || is_zero_general(p)) return vector3d(0.0);
+
+	const double radial = h * e * sin_v / p;
+	const double tangential = h / r;
+	return m_orient * vector3d(-cos_v*radial + sin_v*tangential, sin_v*radial + cos_v*tangential, 0);
+}
+
 // used for stepping through the orbit in small fractions
 // mean anomaly <-> true anomaly conversion doesn't have
 // to be taken into account
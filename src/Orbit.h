@@ -26,6 +26,7 @@ public:
 	void SetPhase(double orbitalPhaseAtStart) { m_orbitalPhaseAtStart = orbitalPhaseAtStart; }
 
 	vector3d OrbitalPosAtTime(double t) const;
+	vector3d OrbitalVelocityAtTime(double t) const;
 
 	// 0.0 <= t <= 1.0. Not for finding orbital pos
 	vector3d EvenSpacedPosTrajectory(double t) const;
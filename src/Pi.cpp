@@ -3,6 +3,7 @@
 
 #include "Pi.h"
 #include "libs.h"
+#include "AutoSave.h"
 #include "CityOnPlanet.h"
 #include "DeathView.h"
 #include "FaceGenManager.h"
@@ -39,6 +40,8 @@
 #include "EnumStrings.h"
 #include "galaxy/Galaxy.h"
 #include "galaxy/StarSystem.h"
+#include "galaxy/SystemNameIndex.h"
+#include "galaxy/RoutePlanner.h"
 #include "graphics/Graphics.h"
 #include "graphics/Light.h"
 #include "graphics/Renderer.h"
@@ -110,6 +113,8 @@ ObjectViewerView *Pi::objectViewerView;
 
 std::unique_ptr<AsyncJobQueue> Pi::asyncJobQueue;
 std::unique_ptr<SyncJobQueue> Pi::syncJobQueue;
+std::unique_ptr<RoutePlanner> Pi::routePlanner;
+std::unique_ptr<AutoSave> Pi::autoSave;
 
 // XXX enabling this breaks UI gauge rendering. see #2627
 #define USE_RTT 0
@@ -302,6 +307,8 @@ void Pi::Init(const std::map<std::string,std::string> &options, bool no_gui)
 	videoSettings.vsync = (config->Int("VSync") != 0);
 	videoSettings.useTextureCompression = (config->Int("UseTextureCompression") != 0);
 	videoSettings.enableDebugMessages = (config->Int("EnableGLDebug") != 0);
+	videoSettings.useProgramCache = (config->Int("UseShaderCache") != 0);
+	videoSettings.warmPrograms = (config->Int("WarmShaderCache") != 0);
 	videoSettings.iconFile = OS::GetIconFilename();
 	videoSettings.title = "Pioneer";
 
@@ -367,6 +374,9 @@ void Pi::Init(const std::map<std::string,std::string> &options, bool no_gui)
 	draw_progress(gauge, label, 0.1f);
 
 	Galaxy::Init();
+	SystemNameIndex::Init(asyncJobQueue.get(), config->Int("SystemNameIndexRadius"));
+	routePlanner.reset(new RoutePlanner);
+	autoSave.reset(new AutoSave("_autosave", asyncJobQueue.get(), config->Float("AutosaveInterval"), config->Int("AutosaveCompactEvery")));
 	draw_progress(gauge, label, 0.2f);
 
 	FaceGenManager::Init();
@@ -516,12 +526,16 @@ void Pi::Init(const std::map<std::string,std::string> &options, bool no_gui)
 
 void Pi::Quit()
 {
+	// before anything the bodies it may still be serialising use
+	autoSave.reset();
 	delete Pi::intro;
 	NavLights::Uninit();
 	Shields::Uninit();
 	Sfx::Uninit();
 	CityOnPlanet::Uninit();
 	BaseSphere::Uninit();
+	routePlanner.reset();
+	SystemNameIndex::Uninit();
 	Galaxy::Uninit();
 	FaceGenManager::Destroy();
 	Graphics::Uninit();
@@ -850,9 +864,30 @@ void Pi::Start()
 	Pi::intro = new Intro(Pi::renderer, Graphics::GetScreenWidth(), Graphics::GetScreenHeight());
 
 	auto b = ui->Button()->SetInnerWidget(ui->Label("Start"));
-	ui->DropAllLayers();
-	ui->GetTopLayer()->SetInnerWidget(b);
 	b->onClick.connect([]{ Pi::game = new Game(SystemPath(0,0,0,0,1), vector3d(EARTH_RADIUS*5)); return false; });
+	UI::VBox *buttons = ui->VBox(10.0f);
+	buttons->PackEnd(b);
+
+	// carry on from the last autosave
+	if (AutoSave::Exists("_autosave")) {
+		auto c = ui->Button()->SetInnerWidget(ui->Label("Continue"));
+		c->onClick.connect([]{
+			try {
+				Pi::game = AutoSave::Load("_autosave");
+			} catch (const SavedGameWrongVersionException &) {
+				Output("autosave is from a different version\n");
+			} catch (const CouldNotOpenFileException &) {
+				Output("couldn't open autosave\n");
+			} catch (const SavedGameCorruptException &) {
+				Output("autosave is corrupt\n");
+			}
+			return false;
+		});
+		buttons->PackEnd(c);
+	}
+
+	ui->DropAllLayers();
+	ui->GetTopLayer()->SetInnerWidget(buttons);
 
 	Pi::ui->SetMousePointer("icons/cursors/mouse_cursor_2.png", UI::Point(15, 8));
 
@@ -913,6 +948,7 @@ void Pi::EndGame()
 	Pi::SetMouseGrab(false);
 
 	assert(game);
+	autoSave->Reset();
 	delete game;
 	game = 0;
 	player = 0;
@@ -985,6 +1021,8 @@ void Pi::MainLoop()
 			PROFILE_SCOPED_RAW("paused")
 			BaseSphere::UpdateAllBaseSphereDerivatives();
 		}
+		// coasting bodies are only put on their orbits when someone looks
+		game->GetSpace()->ResolveCoasters(game->GetTime());
 		frame_stat++;
 
 		// fuckadoodledoo, did the player die?
@@ -1067,10 +1105,16 @@ void Pi::MainLoop()
 		}
 #endif
 
+		// the bodies are serialised while the frame is shown, and must be
+		// done before anything moves them again
+		autoSave->Update(Pi::game, Pi::frameTime);
+
 		Pi::EndRenderTarget();
 		Pi::DrawRenderTarget();
 		Pi::renderer->SwapBuffers();
 
+		autoSave->FinishBodies();
+
 		// game exit will have cleared Pi::game. we can't continue.
 		if (!Pi::game)
 			return;
@@ -1081,6 +1125,7 @@ void Pi::MainLoop()
 		syncJobQueue->RunJobs(SYNC_JOBS_PER_LOOP);
 		asyncJobQueue->FinishJobs();
 		syncJobQueue->FinishJobs();
+		routePlanner->Update();
 
 #if WITH_DEVKEYS
 		if (Pi::showDebugInfo && SDL_GetTicks() - last_stats > 1000) {
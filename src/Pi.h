@@ -15,11 +15,13 @@
 #include <string>
 #include <vector>
 
+class AutoSave;
 class DeathView;
 class GalacticView;
 class Intro;
 class ModelCache;
 class Player;
+class RoutePlanner;
 class SectorView;
 class Ship;
 class SpaceStation;
@@ -149,6 +151,7 @@ public:
 
 	static JobQueue *GetAsyncJobQueue() { return asyncJobQueue.get();}
 	static JobQueue *GetSyncJobQueue() { return syncJobQueue.get();}
+	static RoutePlanner *GetRoutePlanner() { return routePlanner.get(); }
 
 	static bool DrawGUI;
 
@@ -159,6 +162,8 @@ private:
 	static const Uint32 SYNC_JOBS_PER_LOOP = 1;
 	static std::unique_ptr<AsyncJobQueue> asyncJobQueue;
 	static std::unique_ptr<SyncJobQueue> syncJobQueue;
+	static std::unique_ptr<RoutePlanner> routePlanner;
+	static std::unique_ptr<AutoSave> autoSave;
 
 	static bool menuDone;
 
@@ -77,6 +77,16 @@ public:
 		seed(&value, 1);
 	}
 
+	// Where we are in the sequence, to carry on from later with SetState.
+	// A second Normal waiting to be handed out isn't included
+	Uint32 GetState() const { return current; }
+
+	void SetState(Uint32 state)
+	{
+		current = state;
+		cached = false;
+	}
+
 	//
 	// Number generators.
 	//
@@ -14,6 +14,7 @@
 #include "galaxy/Sector.h"
 #include "galaxy/GalaxyCache.h"
 #include "galaxy/StarSystem.h"
+#include "galaxy/SystemNameIndex.h"
 #include "graphics/Graphics.h"
 #include "graphics/Material.h"
 #include "graphics/Renderer.h"
@@ -29,6 +30,131 @@ static const int DRAW_RAD = 5;
 #define INNER_RADIUS (Sector::SIZE*1.5f)
 #define OUTER_RADIUS (Sector::SIZE*float(DRAW_RAD))
 static const float FAR_LIMIT = 7.5f;
+// sectors out to here are drawn as points beyond the near sphere
+static const int FAR_RAD = 8;
+// sectors turned into geometry by each job
+static const Uint32 GEOMETRY_BATCH_SIZE = 64;
+
+namespace {
+	// every corner of a star's billboard is at its centre. the shader moves
+	// it out by corner, which is in view space, so the billboards face the
+	// camera without being rebuilt when the view turns
+	struct StarVert {
+		vector3f pos;
+		Color col;
+		vector2f uv;
+		vector3f corner;
+	};
+
+	struct LineVert {
+		vector3f pos;
+		Color col;
+	};
+}
+
+static bool WithinRadius(const SystemPath &path, const SystemPath &centre, int rad)
+{
+	return abs(path.sectorX - centre.sectorX) <= rad
+		&& abs(path.sectorY - centre.sectorY) <= rad
+		&& abs(path.sectorZ - centre.sectorZ) <= rad;
+}
+
+static int SectorDistanceSqr(const SystemPath &a, const SystemPath &b)
+{
+	const int dx = a.sectorX - b.sectorX;
+	const int dy = a.sectorY - b.sectorY;
+	const int dz = a.sectorZ - b.sectorZ;
+	return dx*dx + dy*dy + dz*dz;
+}
+
+// a system's leg down (or up) to the grid layer, with a cross where it meets it
+static void SystemLeg(const vector3f &star, float gridZ, vector3f pos[8], Color col[8])
+{
+	const Color light(128);
+	const Color dark(51);
+	const vector3f end(star.x, star.y, gridZ);
+	const vector3f mid(star.x, star.y, 0.5f*(star.z + gridZ));
+	pos[0] = end; col[0] = light;
+	pos[1] = mid; col[1] = dark;
+	pos[2] = mid; col[2] = dark;
+	pos[3] = star; col[3] = light;
+	pos[4] = end + vector3f(-0.1f, -0.1f, 0.f); col[4] = light;
+	pos[5] = end + vector3f(0.1f, 0.1f, 0.f); col[5] = light;
+	pos[6] = end + vector3f(-0.1f, 0.1f, 0.f); col[6] = light;
+	pos[7] = end + vector3f(0.1f, -0.1f, 0.f); col[7] = light;
+}
+
+// make sure buf holds at least numVertices, keeping it if it already does
+static void ReserveBuffer(Renderer *r, RefCountedPtr<VertexBuffer> &buf, Uint32 numVertices, bool billboards)
+{
+	if (buf && buf->GetDesc().numVertices >= numVertices)
+		return;
+
+	VertexBufferDesc vbd;
+	vbd.attrib[0].semantic = ATTRIB_POSITION;
+	vbd.attrib[0].format = ATTRIB_FORMAT_FLOAT3;
+	vbd.attrib[1].semantic = ATTRIB_DIFFUSE;
+	vbd.attrib[1].format = ATTRIB_FORMAT_UBYTE4;
+	if (billboards) {
+		vbd.attrib[2].semantic = ATTRIB_UV0;
+		vbd.attrib[2].format = ATTRIB_FORMAT_FLOAT2;
+		vbd.attrib[3].semantic = ATTRIB_NORMAL;
+		vbd.attrib[3].format = ATTRIB_FORMAT_FLOAT3;
+	}
+	vbd.usage = BUFFER_USAGE_DYNAMIC;
+	// some slack, so a few more stars arriving don't mean a new buffer
+	vbd.numVertices = std::max(numVertices + numVertices/4, 64U);
+	buf.Reset(r->CreateVertexBuffer(vbd));
+	assert(buf->GetDesc().stride == (billboards ? sizeof(StarVert) : sizeof(LineVert)));
+}
+
+// turns a batch of generated sectors into SectorGeometry
+class SectorView::SectorGeometryJob : public Job {
+public:
+	SectorGeometryJob(SectorView *view, std::vector<RefCountedPtr<Sector> > &sectors) : m_view(view) {
+		m_sectors.swap(sectors);
+	}
+
+	virtual void OnRun() { // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
+		m_built.reserve(m_sectors.size());
+		for (const RefCountedPtr<Sector> &sec : m_sectors) {
+			m_built.push_back(std::make_pair(sec->GetSystemPath(), SectorGeometry()));
+			SectorGeometry &geom = m_built.back().second;
+			const Uint32 numSystems = sec->GetNumSystems();
+			geom.starPos.reserve(numSystems);
+			geom.starColor.reserve(numSystems);
+			geom.starSize.reserve(numSystems);
+			vector3f farPos(0.f);
+			float r = 0.f, g = 0.f, b = 0.f, weight = 0.f;
+			for (Uint32 i = 0; i < numSystems; i++) {
+				const SystemBody::BodyType type = sec->GetStarType(i, 0);
+				const Uint8 *col = StarSystem::starColors[type];
+				const float size = StarSystem::starScale[type];
+				geom.starPos.push_back(sec->GetPosition(i));
+				geom.starColor.push_back(Color(col[0], col[1], col[2], 255));
+				geom.starSize.push_back(size);
+
+				farPos += size * geom.starPos.back();
+				r += size * col[0]; g += size * col[1]; b += size * col[2];
+				weight += size;
+			}
+			// the more stars, the brighter the point
+			if (weight > 0.f) {
+				geom.farPos = farPos / weight;
+				geom.farColor = Color(Uint8(r / weight), Uint8(g / weight), Uint8(b / weight),
+					Uint8(std::min(64U + 16U*numSystems, 255U)));
+			}
+		}
+	}
+	virtual void OnFinish() { m_view->AddSectorGeometry(m_built); }
+	virtual void OnCancel() {}
+
+private:
+	SectorView *m_view;
+	// only let go of with the job, which happens on the main thread
+	std::vector<RefCountedPtr<Sector> > m_sectors;
+	std::vector<std::pair<SystemPath, SectorGeometry> > m_built;
+};
 
 enum DetailSelection {
 	DETAILBOX_NONE    = 0
@@ -38,7 +164,8 @@ enum DetailSelection {
 static const float ZOOM_SPEED = 15;
 static const float WHEEL_SENSITIVITY = .03f;		// Should be a variable in user settings.
 
-SectorView::SectorView() : UIView()
+SectorView::SectorView() : UIView(),
+	m_geometryJobs(Pi::GetAsyncJobQueue())
 {
 	InitDefaults();
 
@@ -68,7 +195,8 @@ SectorView::SectorView() : UIView()
 	InitObject();
 }
 
-SectorView::SectorView(Serializer::Reader &rd) : UIView()
+SectorView::SectorView(Serializer::Reader &rd) : UIView(),
+	m_geometryJobs(Pi::GetAsyncJobQueue())
 {
 	InitDefaults();
 
@@ -101,8 +229,6 @@ void SectorView::InitDefaults()
 	m_zoomDefault = Clamp(m_zoomDefault, 0.1f, 5.0f);
 	m_previousSearch = "";
 
-	m_secPosFar = vector3f(INT_MAX, INT_MAX, INT_MAX);
-	m_radiusFar = 0;
 	m_cacheXMin = 0;
 	m_cacheXMax = 0;
 	m_cacheYMin = 0;
@@ -111,6 +237,13 @@ void SectorView::InitDefaults()
 	m_cacheYMax = 0;
 
 	m_sectorCache = Sector::cache.NewSlaveCache();
+
+	m_sectorsArrived = false;
+	m_geomValid = false;
+	m_geomLayer = 0;
+	m_geomAllLegs = false;
+	m_nearStarsDirty = m_nearLinesDirty = m_farStarsDirty = true;
+	m_systemsValid = false;
 }
 
 void SectorView::InitObject()
@@ -118,9 +251,6 @@ void SectorView::InitObject()
 	SetTransparency(true);
 
 	m_lineVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION, 500));
-	m_secLineVerts.reset(new Graphics::VertexArray(Graphics::ATTRIB_POSITION, 500));
-	m_starVerts.reset(new Graphics::VertexArray(
-		Graphics::ATTRIB_POSITION | Graphics::ATTRIB_DIFFUSE | Graphics::ATTRIB_UV0, 500));
 
 	Gui::Screen::PushFont("OverlayFont");
 	m_clickableLabels = new Gui::LabelSet();
@@ -339,37 +469,49 @@ void SectorView::OnSearchBoxKeyPress(const SDL_Keysym *keysym)
 		return;
 	} catch (SystemPath::ParseFailure) {}
 
+	// the name index covers everything around Sol whether it's loaded or not
+	std::vector<SystemNameIndex::Match> indexMatches;
+	if (const SystemNameIndex *index = SystemNameIndex::Get()) {
+		index->Search(search, indexMatches, 1);
+		if (!indexMatches.empty() && indexMatches[0].atStart && indexMatches[0].name.size() == search.size()) {
+			m_statusLabel->SetText(stringf(Lang::EXACT_MATCH_X, formatarg("system", indexMatches[0].name)));
+			GotoSystem(indexMatches[0].path);
+			return;
+		}
+	}
+
+	// then whatever is loaded, which may be beyond the index
 	bool gotMatch = false, gotStartMatch = false;
 	SystemPath bestMatch;
-	const std::string *bestMatchName = 0;
+	std::string bestMatchName;
 
 	for (auto i = m_sectorCache->Begin(); i != m_sectorCache->End(); ++i)
 
-		for (unsigned int systemIndex = 0; systemIndex < (*i).second->m_systems.size(); systemIndex++) {
-			const Sector::System *ss = &((*i).second->m_systems[systemIndex]);
+		for (unsigned int systemIndex = 0; systemIndex < (*i).second->GetNumSystems(); systemIndex++) {
+			const std::string name = (*i).second->GetName(systemIndex);
 
 			// compare with the start of the current system
-			if (strncasecmp(search.c_str(), ss->name.c_str(), search.size()) == 0) {
+			if (strncasecmp(search.c_str(), name.c_str(), search.size()) == 0) {
 
 				// matched, see if they're the same size
-				if (search.size() == ss->name.size()) {
+				if (search.size() == name.size()) {
 
 					// exact match, take it and go
 					SystemPath path = (*i).first;
 					path.systemIndex = systemIndex;
-					m_statusLabel->SetText(stringf(Lang::EXACT_MATCH_X, formatarg("system", ss->name)));
+					m_statusLabel->SetText(stringf(Lang::EXACT_MATCH_X, formatarg("system", name)));
 					GotoSystem(path);
 					return;
 				}
 
 				// partial match at start of name
-				if (!gotMatch || !gotStartMatch || bestMatchName->size() > ss->name.size()) {
+				if (!gotMatch || !gotStartMatch || bestMatchName.size() > name.size()) {
 
 					// don't already have one or its shorter than the previous
 					// one, take it
 					bestMatch = (*i).first;
 					bestMatch.systemIndex = systemIndex;
-					bestMatchName = &(ss->name);
+					bestMatchName = name;
 					gotMatch = gotStartMatch = true;
 				}
 
@@ -377,22 +519,32 @@ void SectorView::OnSearchBoxKeyPress(const SDL_Keysym *keysym)
 			}
 
 			// look for the search term somewhere within the current system
-			if (pi_strcasestr(ss->name.c_str(), search.c_str())) {
+			if (pi_strcasestr(name.c_str(), search.c_str())) {
 
 				// found it
-				if (!gotMatch || !gotStartMatch || bestMatchName->size() > ss->name.size()) {
+				if (!gotMatch || !gotStartMatch || bestMatchName.size() > name.size()) {
 
 					// best we've found so far, take it
 					bestMatch = (*i).first;
 					bestMatch.systemIndex = systemIndex;
-					bestMatchName = &(ss->name);
+					bestMatchName = name;
 					gotMatch = true;
 				}
 			}
 		}
 
+	if (!indexMatches.empty()) {
+		const SystemNameIndex::Match &m = indexMatches[0];
+		if (!gotMatch || (m.atStart && !gotStartMatch)
+				|| (m.atStart == gotStartMatch && m.name.size() < bestMatchName.size())) {
+			bestMatch = m.path;
+			bestMatchName = m.name;
+			gotMatch = true;
+		}
+	}
+
 	if (gotMatch) {
-		m_statusLabel->SetText(stringf(Lang::NOT_FOUND_BEST_MATCH_X, formatarg("system", *bestMatchName)));
+		m_statusLabel->SetText(stringf(Lang::NOT_FOUND_BEST_MATCH_X, formatarg("system", bestMatchName)));
 		GotoSystem(bestMatch);
 	}
 
@@ -407,9 +559,7 @@ void SectorView::Draw3D()
 	PROFILE_SCOPED()
 
 	m_lineVerts->Clear();
-	m_secLineVerts->Clear();
 	m_clickableLabels->Clear();
-	m_starVerts->Clear();
 
 	m_renderer->SetPerspectiveProjection(40.f, m_renderer->GetDisplayAspect(), 1.f, 300.f);
 
@@ -441,20 +591,30 @@ void SectorView::Draw3D()
 	modelview.Translate(-FFRAC(m_pos.x)*Sector::SIZE, -FFRAC(m_pos.y)*Sector::SIZE, -FFRAC(m_pos.z)*Sector::SIZE);
 	m_renderer->SetTransform(modelview);
 
+	if (m_nearStarsDirty) BuildNearStars();
+	if (m_nearLinesDirty) BuildNearLines();
+	if (m_farStarsDirty) BuildFarStars();
+
 	DrawNearSectors(modelview);
 
-	m_renderer->SetTransform(matrix4x4f::Identity());
+	m_renderer->SetTransform(modelview);
 
 	//draw star billboards in one go
 	m_renderer->SetAmbientColor(Color(30));
-	m_renderer->DrawTriangles(m_starVerts.get(), m_solidState, m_starMaterial.Get());
+	if (m_nearStars && m_nearStars->GetVertexCount())
+		m_renderer->DrawBuffer(m_nearStars.Get(), m_solidState, m_starMaterial.Get(), Graphics::TRIANGLES);
+
+	if (m_farStars && m_farStars->GetVertexCount())
+		m_renderer->DrawBuffer(m_farStars.Get(), m_alphaBlendState, Graphics::vtxColorMaterial, Graphics::POINTS);
+
+	//grid and sector legs in one go
+	if (m_nearLines && m_nearLines->GetVertexCount())
+		m_renderer->DrawBuffer(m_nearLines.Get(), m_alphaBlendState, Graphics::vtxColorMaterial, Graphics::LINES);
 
-	//draw sector legs in one go
 	if (m_lineVerts->GetNumVerts() > 2)
 		m_renderer->DrawLines(m_lineVerts->GetNumVerts(), &m_lineVerts->position[0], &m_lineVerts->diffuse[0], m_alphaBlendState);
 
-	if (m_secLineVerts->GetNumVerts() > 2)
-		m_renderer->DrawLines(m_secLineVerts->GetNumVerts(), &m_secLineVerts->position[0], &m_secLineVerts->diffuse[0], m_alphaBlendState);
+	m_renderer->SetTransform(matrix4x4f::Identity());
 
 	UIView::Draw3D();
 }
@@ -504,7 +664,7 @@ void SectorView::GotoSector(const SystemPath &path)
 void SectorView::GotoSystem(const SystemPath &path)
 {
 	RefCountedPtr<Sector> ps = GetCached(path);
-	const vector3f &p = ps->m_systems[path.systemIndex].p;
+	const vector3f p = ps->GetPosition(path.systemIndex);
 	m_posMovingTo.x = path.sectorX + p.x/Sector::SIZE;
 	m_posMovingTo.y = path.sectorY + p.y/Sector::SIZE;
 	m_posMovingTo.z = path.sectorZ + p.z/Sector::SIZE;
@@ -549,16 +709,17 @@ void SectorView::OnClickSystem(const SystemPath &path)
 	}
 }
 
-void SectorView::PutSystemLabels(RefCountedPtr<Sector> sec, const vector3f &origin, int drawRadius)
+void SectorView::PutSystemLabels(RefCountedPtr<Sector> sec, const vector3f &origin)
 {
 	PROFILE_SCOPED()
-	Uint32 sysIdx = 0;
-	for (std::vector<Sector::System>::iterator sys = sec->m_systems.begin(); sys !=sec->m_systems.end(); ++sys, ++sysIdx) {
+	const vector3f sphereCentre = origin + vector3f(0.5f*Sector::SIZE);
+	for (Uint32 sysIdx = 0; sysIdx < sec->GetNumSystems(); ++sysIdx) {
+		const vector3f fullPos = sec->GetFullPosition(sysIdx);
 		// skip the system if it doesn't fall within the sphere we're viewing.
-		if ((m_pos*Sector::SIZE - (*sys).FullPosition()).Length() > drawRadius) continue;
+		if ((sphereCentre - fullPos).Length() > OUTER_RADIUS) continue;
 
 		// place the label
-		vector3d systemPos = vector3d((*sys).FullPosition() - origin);
+		vector3d systemPos = vector3d(fullPos - origin);
 		vector3d screenPos;
 		if (Gui::Screen::Project(systemPos, screenPos)) {
 			// reject back-projected labels
@@ -566,33 +727,14 @@ void SectorView::PutSystemLabels(RefCountedPtr<Sector> sec, const vector3f &orig
 				continue;
 
 			// get a system path to pass to the event handler when the label is licked
-			SystemPath sysPath = SystemPath((*sys).sx, (*sys).sy, (*sys).sz, sysIdx);
+			SystemPath sysPath = sec->GetSystemPath(sysIdx);
 
 			// setup the label;
-			m_clickableLabels->Add((*sys).name, sigc::bind(sigc::mem_fun(this, &SectorView::OnClickSystem), sysPath), screenPos.x, screenPos.y, Color::WHITE);
+			m_clickableLabels->Add(sec->GetName(sysIdx), sigc::bind(sigc::mem_fun(this, &SectorView::OnClickSystem), sysPath), screenPos.x, screenPos.y, Color::WHITE);
 		}
 	}
 }
 
-void SectorView::AddStarBillboard(const matrix4x4f &trans, const vector3f &pos, const Color &col, float size)
-{
-	const matrix3x3f rot = trans.GetOrient().Transpose();
-
-	const vector3f offset = trans * pos;
-
-	const vector3f rotv1 = rot * vector3f(size/2.f, -size/2.f, 0.0f);
-	const vector3f rotv2 = rot * vector3f(size/2.f, size/2.f, 0.0f);
-
-	Graphics::VertexArray &va = *m_starVerts;
-	va.Add(offset-rotv1, col, vector2f(0.f, 0.f)); //top left
-	va.Add(offset-rotv2, col, vector2f(0.f, 1.f)); //bottom left
-	va.Add(offset+rotv2, col, vector2f(1.f, 0.f)); //top right
-
-	va.Add(offset+rotv2, col, vector2f(1.f, 0.f)); //top right
-	va.Add(offset-rotv2, col, vector2f(0.f, 1.f)); //bottom left
-	va.Add(offset+rotv1, col, vector2f(1.f, 1.f)); //bottom right
-}
-
 void SectorView::UpdateDistanceLabelAndLine(DistanceIndicator &distance, const SystemPath &src, const SystemPath &dest)
 {
 	PROFILE_SCOPED()
@@ -668,175 +810,430 @@ void SectorView::DrawNearSectors(const matrix4x4f& modelview)
 	PROFILE_SCOPED()
 
 	RefCountedPtr<const Sector> playerSec = GetCached(m_current);
-	const vector3f playerPos = Sector::SIZE * vector3f(float(m_current.sectorX), float(m_current.sectorY), float(m_current.sectorZ)) + playerSec->m_systems[m_current.systemIndex].p;
-
-	for (int sx = -DRAW_RAD; sx <= DRAW_RAD; sx++) {
-		for (int sy = -DRAW_RAD; sy <= DRAW_RAD; sy++) {
-			for (int sz = -DRAW_RAD; sz <= DRAW_RAD; sz++) {
-				DrawNearSector(int(floorf(m_pos.x))+sx, int(floorf(m_pos.y))+sy, int(floorf(m_pos.z))+sz, playerPos,
-					modelview * matrix4x4f::Translation(Sector::SIZE*sx, Sector::SIZE*sy, Sector::SIZE*sz));
-			}
-		}
-	}
+	const vector3f playerPos = Sector::SIZE * vector3f(float(m_current.sectorX), float(m_current.sectorY), float(m_current.sectorZ)) + playerSec->GetPosition(m_current.systemIndex);
+
+	// the stars themselves come from the retained buffers, only the current,
+	// selected and target systems need anything drawn for them each frame
+	DrawSystemOverlay(m_current, modelview, playerPos);
+	if (!m_selected.IsSameSystem(m_current))
+		DrawSystemOverlay(m_selected, modelview, playerPos);
+	if (!m_hyperspaceTarget.IsSameSystem(m_current) && !m_hyperspaceTarget.IsSameSystem(m_selected))
+		DrawSystemOverlay(m_hyperspaceTarget, modelview, playerPos);
+	glDepthRange(0,1);
 
-	// ...then switch and do all the labels
-	const vector3f secOrigin = vector3f(int(floorf(m_pos.x)), int(floorf(m_pos.y)), int(floorf(m_pos.z)));
+	// ...then switch and do all the labels. sectors that aren't here yet
+	// don't get any
+	const SystemPath &centre = m_geomCentre;
+	const vector3f secOrigin = Sector::SIZE * vector3f(float(centre.sectorX), float(centre.sectorY), float(centre.sectorZ));
 
 	m_renderer->SetTransform(modelview);
-	glDepthRange(0,1);
 	Gui::Screen::EnterOrtho();
 	for (int sx = -DRAW_RAD; sx <= DRAW_RAD; sx++) {
 		for (int sy = -DRAW_RAD; sy <= DRAW_RAD; sy++) {
 			for (int sz = -DRAW_RAD; sz <= DRAW_RAD; sz++) {
-				PutSystemLabels(GetCached(SystemPath(sx + secOrigin.x, sy + secOrigin.y, sz + secOrigin.z)), Sector::SIZE * secOrigin, Sector::SIZE * DRAW_RAD);
+				RefCountedPtr<Sector> sec = m_sectorCache->GetIfCached(SystemPath(centre.sectorX + sx, centre.sectorY + sy, centre.sectorZ + sz));
+				if (sec)
+					PutSystemLabels(sec, secOrigin);
 			}
 		}
 	}
 	Gui::Screen::LeaveOrtho();
 }
 
-void SectorView::DrawNearSector(const int sx, const int sy, const int sz, const vector3f &playerAbsPos,const matrix4x4f &trans)
+void SectorView::DrawSystemOverlay(const SystemPath &path, const matrix4x4f &modelview, const vector3f &playerAbsPos)
 {
 	PROFILE_SCOPED()
-	m_renderer->SetTransform(trans);
-	RefCountedPtr<Sector> ps = GetCached(SystemPath(sx, sy, sz));
+	const SystemPath &centre = m_geomCentre;
+	if (!WithinRadius(path, centre, DRAW_RAD)) return;
 
-	int cz = int(floor(m_pos.z+0.5f));
+	RefCountedPtr<Sector> ps = GetCached(path);
 
-	if (cz == sz) {
-		const Color darkgreen(0, 51, 0, 255);
-		const vector3f vts[] = {
-			trans * vector3f(0.f, 0.f, 0.f),
-			trans * vector3f(0.f, Sector::SIZE, 0.f),
-			trans * vector3f(Sector::SIZE, Sector::SIZE, 0.f),
-			trans * vector3f(Sector::SIZE, 0.f, 0.f)
-		};
-
-		m_secLineVerts->Add(vts[0], darkgreen);	// line segment 1
-		m_secLineVerts->Add(vts[1], darkgreen);
-		m_secLineVerts->Add(vts[1], darkgreen);	// line segment 2
-		m_secLineVerts->Add(vts[2], darkgreen);
-		m_secLineVerts->Add(vts[2], darkgreen);	// line segment 3
-		m_secLineVerts->Add(vts[3], darkgreen);
-		m_secLineVerts->Add(vts[3], darkgreen);	// line segment 4
-		m_secLineVerts->Add(vts[0], darkgreen);
-	}
+	// where the system is relative to the corner of the centre sector...
+	const vector3f sysAbsPos = ps->GetFullPosition(path.systemIndex);
+	const vector3f pos = sysAbsPos - Sector::SIZE*vector3f(float(centre.sectorX), float(centre.sectorY), float(centre.sectorZ));
 
-	Uint32 sysIdx = 0;
-	for (std::vector<Sector::System>::iterator i = ps->m_systems.begin(); i != ps->m_systems.end(); ++i, ++sysIdx) {
-		// calculate where the system is in relation the centre of the view...
-		const vector3f sysAbsPos = Sector::SIZE*vector3f(float(sx), float(sy), float(sz)) + (*i).p;
-		const vector3f toCentreOfView = m_pos*Sector::SIZE - sysAbsPos;
+	// ...and skip it if it doesn't fall within the sphere we're viewing.
+	if ((pos - vector3f(0.5f*Sector::SIZE)).Length() > OUTER_RADIUS) return;
 
-		// ...and skip the system if it doesn't fall within the sphere we're viewing.
-		if (toCentreOfView.Length() > OUTER_RADIUS) continue;
+	const bool bIsCurrentSystem = path.IsSameSystem(m_current);
 
-		const bool bIsCurrentSystem = i->IsSameSystem(m_current);
+	// legs. when they're all drawn this one is in the buffer already
+	if (!m_geomAllLegs) {
+		vector3f legPos[8];
+		Color legCol[8];
+		SystemLeg(pos, float(m_geomLayer - centre.sectorZ)*Sector::SIZE, legPos, legCol);
+		for (int i = 0; i < 8; i++)
+			m_lineVerts->Add(legPos[i], legCol[i]);
+	}
 
-		// if the system is the current system or target we can't skip it
-		bool can_skip = !i->IsSameSystem(m_selected)
-						&& !i->IsSameSystem(m_hyperspaceTarget)
-						&& !bIsCurrentSystem;
+	matrix4x4f systrans = modelview * matrix4x4f::Translation(pos.x, pos.y, pos.z);
+	m_renderer->SetTransform(systrans);
 
-		// only do this once we've pretty much stopped moving.
-		vector3f diff = vector3f(
-				fabs(m_posMovingTo.x - m_pos.x),
-				fabs(m_posMovingTo.y - m_pos.y),
-				fabs(m_posMovingTo.z - m_pos.z));
+	if (path.IsSameSystem(m_selected)) {
+		if (m_selected != m_current) {
+		    m_selectedLine.SetStart(vector3f(0.f, 0.f, 0.f));
+		    m_selectedLine.SetEnd(playerAbsPos - sysAbsPos);
+		    m_selectedLine.Draw(m_renderer, m_solidState);
+		} else {
+		    m_secondDistance.label->SetText("");
+		}
+		if (m_selected != m_hyperspaceTarget) {
+			RefCountedPtr<Sector> hyperSec = GetCached(m_hyperspaceTarget);
+			const vector3f hyperAbsPos =
+				Sector::SIZE*vector3f(m_hyperspaceTarget.sectorX, m_hyperspaceTarget.sectorY, m_hyperspaceTarget.sectorZ)
+				+ hyperSec->GetPosition(m_hyperspaceTarget.systemIndex);
+			if (m_selected != m_current) {
+			    m_secondLine.SetStart(vector3f(0.f, 0.f, 0.f));
+			    m_secondLine.SetEnd(hyperAbsPos - sysAbsPos);
+			    m_secondLine.Draw(m_renderer, m_solidState);
+			}
 
-		// Ideally, since this takes so f'ing long, it wants to be done as a threaded job but haven't written that yet.
-		if( (diff.x < 0.001f && diff.y < 0.001f && diff.z < 0.001f) ) {
-			SystemPath current = SystemPath(sx, sy, sz, sysIdx);
-			RefCountedPtr<StarSystem> pSS = StarSystem::cache->GetCached(current);
+			if (m_hyperspaceTarget != m_current) {
+			    // FIXME: Draw when drawing hyperjump target or current system
+			    m_jumpLine.SetStart(hyperAbsPos - sysAbsPos);
+			    m_jumpLine.SetEnd(playerAbsPos - sysAbsPos);
+			    m_jumpLine.Draw(m_renderer, m_solidState);
+			}
+		} else {
+		    m_secondDistance.label->SetText("");
 		}
+	}
+
+	// face the camera, at the size of the star blob
+	systrans.Rotate(DEG2RAD(-m_rotZ), 0, 0, 1);
+	systrans.Rotate(DEG2RAD(-m_rotX), 1, 0, 0);
+	systrans.Scale((StarSystem::starScale[ps->GetStarType(path.systemIndex, 0)]));
+
+	// player location indicator
+	if (m_inSystem && bIsCurrentSystem) {
+		glDepthRange(0.2,1.0);
+		m_disk->SetColor(Color(0, 0, 204));
+		m_renderer->SetTransform(systrans * matrix4x4f::ScaleMatrix(3.f));
+		m_disk->Draw(m_renderer);
+	}
+	// selected indicator
+	if (bIsCurrentSystem) {
+		glDepthRange(0.1,1.0);
+		m_disk->SetColor(Color(0, 204, 0));
+		m_renderer->SetTransform(systrans * matrix4x4f::ScaleMatrix(2.f));
+		m_disk->Draw(m_renderer);
+	}
+	// hyperspace target indicator (if different from selection)
+	if (path.IsSameSystem(m_hyperspaceTarget) && m_hyperspaceTarget != m_selected && (!m_inSystem || m_hyperspaceTarget != m_current)) {
+		glDepthRange(0.1,1.0);
+		m_disk->SetColor(Color(77));
+		m_renderer->SetTransform(systrans * matrix4x4f::ScaleMatrix(2.f));
+		m_disk->Draw(m_renderer);
+	}
+}
 
-		matrix4x4f systrans = trans * matrix4x4f::Translation((*i).p.x, (*i).p.y, (*i).p.z);
-		m_renderer->SetTransform(systrans);
+void SectorView::UpdateSectorGeometry()
+{
+	PROFILE_SCOPED()
+	const SystemPath centre(int(floorf(m_pos.x)), int(floorf(m_pos.y)), int(floorf(m_pos.z)));
 
-		// legs
-		if (m_drawSystemLegButton->GetPressed() || !can_skip) {
-			const Color light(128);
-			const Color dark(51);
+	if (!m_geomValid || !centre.IsSameSector(m_geomCentre)) {
+		m_geomValid = true;
+		m_geomCentre = centre;
+		m_nearStarsDirty = m_nearLinesDirty = m_farStarsDirty = true;
 
-			// draw system "leg"
-			float z = -(*i).p.z;
-			if (sz <= cz)
-				z = z+abs(cz-sz)*Sector::SIZE;
+		// forget whatever has fallen out of range...
+		for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ) {
+			if (!WithinRadius(it->first, centre, FAR_RAD))
+				m_sectorGeometry.erase(it++);
 			else
-				z = z-abs(cz-sz)*Sector::SIZE;
-			m_lineVerts->Add(systrans * vector3f(0.f, 0.f, z), light);
-			m_lineVerts->Add(systrans * vector3f(0.f, 0.f, z * 0.5f), dark);
-			m_lineVerts->Add(systrans * vector3f(0.f, 0.f, z * 0.5f), dark);
-			m_lineVerts->Add(systrans * vector3f(0.f, 0.f, 0.f), light);
-
-			//cross at other end
-			m_lineVerts->Add(systrans * vector3f(-0.1f, -0.1f, z), light);
-			m_lineVerts->Add(systrans * vector3f(0.1f, 0.1f, z), light);
-			m_lineVerts->Add(systrans * vector3f(-0.1f, 0.1f, z), light);
-			m_lineVerts->Add(systrans * vector3f(0.1f, -0.1f, z), light);
+				++it;
 		}
+		m_pendingSectors.erase(std::remove_if(m_pendingSectors.begin(), m_pendingSectors.end(),
+			[&centre](const SystemPath &path) { return !WithinRadius(path, centre, FAR_RAD); }), m_pendingSectors.end());
+		const SectorSet pending(m_pendingSectors.begin(), m_pendingSectors.end());
+
+		// ...and ask for what has come into it, nearest first
+		SectorCache::PathVector paths;
+		for (int sx = -FAR_RAD; sx <= FAR_RAD; sx++) {
+			for (int sy = -FAR_RAD; sy <= FAR_RAD; sy++) {
+				for (int sz = -FAR_RAD; sz <= FAR_RAD; sz++) {
+					const SystemPath path(centre.sectorX + sx, centre.sectorY + sy, centre.sectorZ + sz);
+					if (m_sectorGeometry.count(path) || pending.count(path) || m_buildingSectors.count(path))
+						continue;
+					paths.push_back(path);
+				}
+			}
+		}
+		std::sort(paths.begin(), paths.end(), [&centre](const SystemPath &a, const SystemPath &b) {
+			return SectorDistanceSqr(a, centre) < SectorDistanceSqr(b, centre);
+		});
+		if (!paths.empty()) {
+			m_pendingSectors.insert(m_pendingSectors.end(), paths.begin(), paths.end());
+			m_sectorCache->FillCache(paths, [this]() { m_sectorsArrived = true; });
+		}
+		// some may have been in the cache already
+		m_sectorsArrived = true;
+	}
 
-		if (i->IsSameSystem(m_selected)) {
-			if (m_selected != m_current) {
-			    m_selectedLine.SetStart(vector3f(0.f, 0.f, 0.f));
-			    m_selectedLine.SetEnd(playerAbsPos - sysAbsPos);
-			    m_selectedLine.Draw(m_renderer, m_solidState);
+	// hand whatever has arrived to the geometry jobs. the cache jobs finish
+	// roughly nearest first, so each frame only the front of the list is
+	// looked at; once they're all done the rest is swept up
+	if (!m_pendingSectors.empty()) {
+		std::vector<RefCountedPtr<Sector> > batch;
+		std::deque<SystemPath> notArrived;
+		while (!m_pendingSectors.empty()) {
+			const SystemPath &path = m_pendingSectors.front();
+			RefCountedPtr<Sector> sec = m_sectorCache->GetIfCached(path);
+			if (sec) {
+				m_buildingSectors.insert(path);
+				batch.push_back(sec);
+				if (batch.size() >= GEOMETRY_BATCH_SIZE)
+					m_geometryJobs.Order(new SectorGeometryJob(this, batch));
+			} else if (m_sectorsArrived) {
+				notArrived.push_back(path);
 			} else {
-			    m_secondDistance.label->SetText("");
+				break;
+			}
+			m_pendingSectors.pop_front();
+		}
+		if (m_sectorsArrived)
+			m_pendingSectors.swap(notArrived);
+		if (!batch.empty())
+			m_geometryJobs.Order(new SectorGeometryJob(this, batch));
+	}
+
+	// and drop far sectors from the cache that aren't needed for anything
+	// any more, like the ones that fell out of range while being generated
+	if (m_sectorsArrived) {
+		m_sectorsArrived = false;
+		const SectorSet pending(m_pendingSectors.begin(), m_pendingSectors.end());
+		auto it = m_sectorCache->Begin();
+		while (it != m_sectorCache->End()) {
+			const SystemPath &path = it->first;
+			if (!WithinRadius(path, centre, DRAW_RAD) && !IsSectorInUse(path) && !m_buildingSectors.count(path) && !pending.count(path))
+				m_sectorCache->Erase(it++);
+			else
+				++it;
+		}
+	}
+
+	const int layer = int(floorf(m_pos.z+0.5f));
+	const bool allLegs = m_drawSystemLegButton->GetPressed();
+	if (layer != m_geomLayer || allLegs != m_geomAllLegs) {
+		m_geomLayer = layer;
+		m_geomAllLegs = allLegs;
+		m_nearLinesDirty = true;
+	}
+}
+
+// sectors that are looked up every frame whether they're near or not
+bool SectorView::IsSectorInUse(const SystemPath &path) const
+{
+	return path.IsSameSector(m_current) || path.IsSameSector(m_selected) || path.IsSameSector(m_hyperspaceTarget);
+}
+
+void SectorView::AddSectorGeometry(std::vector<std::pair<SystemPath, SectorGeometry> > &built)
+{
+	for (auto &sg : built) {
+		const SystemPath &path = sg.first;
+		m_buildingSectors.erase(path);
+
+		// the near ones are still wanted for labels and picking
+		const bool isNear = WithinRadius(path, m_geomCentre, DRAW_RAD);
+		if (!isNear && !IsSectorInUse(path))
+			m_sectorCache->Erase(path);
+		if (!WithinRadius(path, m_geomCentre, FAR_RAD))
+			continue;
+
+		std::swap(m_sectorGeometry[path], sg.second);
+		m_farStarsDirty = true;
+		if (isNear)
+			m_nearStarsDirty = m_nearLinesDirty = true;
+	}
+}
+
+void SectorView::BuildNearStars()
+{
+	PROFILE_SCOPED()
+	m_nearStarsDirty = false;
+
+	const SystemPath &centre = m_geomCentre;
+	const vector3f sphereCentre(0.5f*Sector::SIZE);
+
+	Uint32 maxStars = 0;
+	for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ++it)
+		if (WithinRadius(it->first, centre, DRAW_RAD))
+			maxStars += it->second.starPos.size();
+	ReserveBuffer(m_renderer, m_nearStars, maxStars * 6, true);
+
+	StarVert *vtx = m_nearStars->Map<StarVert>(BUFFER_MAP_WRITE);
+	Uint32 numVerts = 0;
+	for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ++it) {
+		if (!WithinRadius(it->first, centre, DRAW_RAD)) continue;
+		const vector3f offset = Sector::SIZE*vector3f(float(it->first.sectorX - centre.sectorX),
+			float(it->first.sectorY - centre.sectorY), float(it->first.sectorZ - centre.sectorZ));
+		const SectorGeometry &geom = it->second;
+		for (size_t i = 0; i < geom.starPos.size(); i++) {
+			const vector3f pos = offset + geom.starPos[i];
+			if ((pos - sphereCentre).Length() > OUTER_RADIUS) continue;
+
+			const Color &col = geom.starColor[i];
+			const float r = 0.25f * geom.starSize[i];
+			StarVert *v = vtx + numVerts;
+			v[0].corner = vector3f(-r,  r, 0.f); v[0].uv = vector2f(0.f, 0.f); //top left
+			v[1].corner = vector3f(-r, -r, 0.f); v[1].uv = vector2f(0.f, 1.f); //bottom left
+			v[2].corner = vector3f( r,  r, 0.f); v[2].uv = vector2f(1.f, 0.f); //top right
+			v[3].corner = vector3f( r,  r, 0.f); v[3].uv = vector2f(1.f, 0.f); //top right
+			v[4].corner = vector3f(-r, -r, 0.f); v[4].uv = vector2f(0.f, 1.f); //bottom left
+			v[5].corner = vector3f( r, -r, 0.f); v[5].uv = vector2f(1.f, 1.f); //bottom right
+			for (int j = 0; j < 6; j++) {
+				v[j].pos = pos;
+				v[j].col = col;
 			}
-			if (m_selected != m_hyperspaceTarget) {
-				RefCountedPtr<Sector> hyperSec = GetCached(m_hyperspaceTarget);
-				const vector3f hyperAbsPos =
-					Sector::SIZE*vector3f(m_hyperspaceTarget.sectorX, m_hyperspaceTarget.sectorY, m_hyperspaceTarget.sectorZ)
-					+ hyperSec->m_systems[m_hyperspaceTarget.systemIndex].p;
-				if (m_selected != m_current) {
-				    m_secondLine.SetStart(vector3f(0.f, 0.f, 0.f));
-				    m_secondLine.SetEnd(hyperAbsPos - sysAbsPos);
-				    m_secondLine.Draw(m_renderer, m_solidState);
+			numVerts += 6;
+		}
+	}
+	m_nearStars->Unmap();
+	m_nearStars->SetVertexCount(numVerts);
+}
+
+void SectorView::BuildNearLines()
+{
+	PROFILE_SCOPED()
+	m_nearLinesDirty = false;
+
+	const SystemPath &centre = m_geomCentre;
+	const vector3f sphereCentre(0.5f*Sector::SIZE);
+	const float gridZ = float(m_geomLayer - centre.sectorZ)*Sector::SIZE;
+	const int gridRows = 2*DRAW_RAD + 1;
+
+	Uint32 maxLegs = 0;
+	if (m_geomAllLegs)
+		for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ++it)
+			if (WithinRadius(it->first, centre, DRAW_RAD))
+				maxLegs += it->second.starPos.size();
+	ReserveBuffer(m_renderer, m_nearLines, gridRows*gridRows*8 + maxLegs*8, false);
+
+	LineVert *vtx = m_nearLines->Map<LineVert>(BUFFER_MAP_WRITE);
+	Uint32 numVerts = 0;
+
+	// the grid, on the layer the view is in
+	if (abs(m_geomLayer - centre.sectorZ) <= DRAW_RAD) {
+		const Color darkgreen(0, 51, 0, 255);
+		for (int sx = -DRAW_RAD; sx <= DRAW_RAD; sx++) {
+			for (int sy = -DRAW_RAD; sy <= DRAW_RAD; sy++) {
+				const float x = sx*Sector::SIZE, y = sy*Sector::SIZE;
+				const vector3f vts[] = {
+					vector3f(x, y, gridZ),
+					vector3f(x, y + Sector::SIZE, gridZ),
+					vector3f(x + Sector::SIZE, y + Sector::SIZE, gridZ),
+					vector3f(x + Sector::SIZE, y, gridZ)
+				};
+				for (int i = 0; i < 4; i++) {
+					vtx[numVerts].pos = vts[i]; vtx[numVerts++].col = darkgreen;
+					vtx[numVerts].pos = vts[(i+1)%4]; vtx[numVerts++].col = darkgreen;
 				}
+			}
+		}
+	}
 
-				if (m_hyperspaceTarget != m_current) {
-				    // FIXME: Draw when drawing hyperjump target or current system
-				    m_jumpLine.SetStart(hyperAbsPos - sysAbsPos);
-				    m_jumpLine.SetEnd(playerAbsPos - sysAbsPos);
-				    m_jumpLine.Draw(m_renderer, m_solidState);
+	if (m_geomAllLegs) {
+		vector3f legPos[8];
+		Color legCol[8];
+		for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ++it) {
+			if (!WithinRadius(it->first, centre, DRAW_RAD)) continue;
+			const vector3f offset = Sector::SIZE*vector3f(float(it->first.sectorX - centre.sectorX),
+				float(it->first.sectorY - centre.sectorY), float(it->first.sectorZ - centre.sectorZ));
+			for (const vector3f &p : it->second.starPos) {
+				const vector3f pos = offset + p;
+				if ((pos - sphereCentre).Length() > OUTER_RADIUS) continue;
+				SystemLeg(pos, gridZ, legPos, legCol);
+				for (int i = 0; i < 8; i++) {
+					vtx[numVerts].pos = legPos[i];
+					vtx[numVerts++].col = legCol[i];
 				}
-			} else {
-			    m_secondDistance.label->SetText("");
 			}
 		}
+	}
 
-		// draw star blob itself
-		systrans.Rotate(DEG2RAD(-m_rotZ), 0, 0, 1);
-		systrans.Rotate(DEG2RAD(-m_rotX), 1, 0, 0);
-		systrans.Scale((StarSystem::starScale[(*i).starType[0]]));
-		m_renderer->SetTransform(systrans);
-
-		const Uint8 *col = StarSystem::starColors[(*i).starType[0]];
-		AddStarBillboard(systrans, vector3f(0.f), Color(col[0], col[1], col[2], 255), 0.5f);
-
-		// player location indicator
-		if (m_inSystem && bIsCurrentSystem) {
-			glDepthRange(0.2,1.0);
-			m_disk->SetColor(Color(0, 0, 204));
-			m_renderer->SetTransform(systrans * matrix4x4f::ScaleMatrix(3.f));
-			m_disk->Draw(m_renderer);
+	m_nearLines->Unmap();
+	m_nearLines->SetVertexCount(numVerts);
+}
+
+void SectorView::BuildFarStars()
+{
+	PROFILE_SCOPED()
+	m_farStarsDirty = false;
+
+	const SystemPath &centre = m_geomCentre;
+	const vector3f sphereCentre(0.5f*Sector::SIZE);
+	const float farRadius = Sector::SIZE*float(FAR_RAD);
+
+	// the near sectors' stars that are outside the sphere are points of
+	// their own, the sectors beyond them are one point each
+	Uint32 maxStars = 0;
+	for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ++it)
+		maxStars += WithinRadius(it->first, centre, DRAW_RAD) ? it->second.starPos.size() : 1;
+	ReserveBuffer(m_renderer, m_farStars, maxStars, false);
+
+	LineVert *vtx = m_farStars->Map<LineVert>(BUFFER_MAP_WRITE);
+	Uint32 numVerts = 0;
+	for (auto it = m_sectorGeometry.begin(); it != m_sectorGeometry.end(); ++it) {
+		const vector3f offset = Sector::SIZE*vector3f(float(it->first.sectorX - centre.sectorX),
+			float(it->first.sectorY - centre.sectorY), float(it->first.sectorZ - centre.sectorZ));
+		const SectorGeometry &geom = it->second;
+		if (geom.starPos.empty()) continue;
+
+		if (!WithinRadius(it->first, centre, DRAW_RAD)) {
+			// wholly outside the near sphere
+			const vector3f pos = offset + geom.farPos;
+			if ((pos - sphereCentre).Length() > farRadius) continue;
+			vtx[numVerts].pos = pos;
+			vtx[numVerts].col = geom.farColor;
+			numVerts++;
+			continue;
 		}
-		// selected indicator
-		if (bIsCurrentSystem) {
-			glDepthRange(0.1,1.0);
-			m_disk->SetColor(Color(0, 204, 0));
-			m_renderer->SetTransform(systrans * matrix4x4f::ScaleMatrix(2.f));
-			m_disk->Draw(m_renderer);
+
+		for (size_t i = 0; i < geom.starPos.size(); i++) {
+			const vector3f pos = offset + geom.starPos[i];
+			// everything inside the near sphere is a billboard already
+			if ((pos - sphereCentre).Length() <= OUTER_RADIUS) continue;
+			vtx[numVerts].pos = pos;
+			vtx[numVerts].col = geom.starColor[i];
+			vtx[numVerts].col.a = 160;
+			numVerts++;
 		}
-		// hyperspace target indicator (if different from selection)
-		if (i->IsSameSystem(m_hyperspaceTarget) && m_hyperspaceTarget != m_selected && (!m_inSystem || m_hyperspaceTarget != m_current)) {
-			glDepthRange(0.1,1.0);
-			m_disk->SetColor(Color(77));
-			m_renderer->SetTransform(systrans * matrix4x4f::ScaleMatrix(2.f));
-			m_disk->Draw(m_renderer);
+	}
+	m_farStars->Unmap();
+	m_farStars->SetVertexCount(numVerts);
+}
+
+void SectorView::PrefetchSystems()
+{
+	PROFILE_SCOPED()
+	const SystemPath &centre = m_geomCentre;
+	if (m_systemsValid && centre.IsSameSector(m_systemsCentre))
+		return;
+
+	const vector3f sphereCentre = Sector::SIZE*(vector3f(float(centre.sectorX), float(centre.sectorY), float(centre.sectorZ)) + vector3f(0.5f));
+
+	StarSystemCache::PathVector paths;
+	for (int sx = -DRAW_RAD; sx <= DRAW_RAD; sx++) {
+		for (int sy = -DRAW_RAD; sy <= DRAW_RAD; sy++) {
+			for (int sz = -DRAW_RAD; sz <= DRAW_RAD; sz++) {
+				RefCountedPtr<Sector> sec = m_sectorCache->GetIfCached(SystemPath(centre.sectorX + sx, centre.sectorY + sy, centre.sectorZ + sz));
+				// try again once all the sectors are here
+				if (!sec) return;
+				for (Uint32 i = 0; i < sec->GetNumSystems(); i++) {
+					if ((sphereCentre - sec->GetFullPosition(i)).Length() <= OUTER_RADIUS)
+						paths.push_back(sec->GetSystemPath(i));
+				}
+			}
 		}
 	}
+
+	// a new slave, so the systems still in view are carried over from the old one
+	RefCountedPtr<StarSystemCache::Slave> cache = StarSystem::attic.NewSlaveCache();
+	cache->FillCache(paths);
+	m_systemCache = cache;
+	m_systemsValid = true;
+	m_systemsCentre = centre;
 }
 
 void SectorView::OnSwitchTo()
@@ -1021,17 +1418,17 @@ void SectorView::Update()
 		SystemPath new_selected = SystemPath(int(floor(m_pos.x)), int(floor(m_pos.y)), int(floor(m_pos.z)), 0);
 
 		RefCountedPtr<Sector> ps = GetCached(new_selected);
-		if (ps->m_systems.size()) {
+		if (ps->GetNumSystems()) {
 			float px = FFRAC(m_pos.x)*Sector::SIZE;
 			float py = FFRAC(m_pos.y)*Sector::SIZE;
 			float pz = FFRAC(m_pos.z)*Sector::SIZE;
 
 			float min_dist = FLT_MAX;
-			for (unsigned int i=0; i<ps->m_systems.size(); i++) {
-				Sector::System *ss = &ps->m_systems[i];
-				float dx = px - ss->p.x;
-				float dy = py - ss->p.y;
-				float dz = pz - ss->p.z;
+			for (unsigned int i=0; i<ps->GetNumSystems(); i++) {
+				const vector3f p = ps->GetPosition(i);
+				float dx = px - p.x;
+				float dy = py - p.y;
+				float dz = pz - p.z;
 				float dist = sqrtf(dx*dx + dy*dy + dz*dz);
 				if (dist < min_dist) {
 					min_dist = dist;
@@ -1046,6 +1443,16 @@ void SectorView::Update()
 		}
 	}
 
+	UpdateSectorGeometry();
+
+	// only do this once we've pretty much stopped moving.
+	vector3f diff = vector3f(
+			fabs(m_posMovingTo.x - m_pos.x),
+			fabs(m_posMovingTo.y - m_pos.y),
+			fabs(m_posMovingTo.z - m_pos.z));
+	if (diff.x < 0.001f && diff.y < 0.001f && diff.z < 0.001f)
+		PrefetchSystems();
+
 	ShrinkCache();
 
 	UIView::Update();
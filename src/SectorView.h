@@ -7,6 +7,7 @@
 #include "libs.h"
 #include "gui/Gui.h"
 #include "UIView.h"
+#include <deque>
 #include <vector>
 #include <set>
 #include <string>
@@ -15,7 +16,9 @@
 #include "galaxy/SystemPath.h"
 #include "graphics/Drawables.h"
 #include "graphics/RenderState.h"
-#include <set>
+#include "graphics/VertexBuffer.h"
+#include "JobQueue.h"
+#include <map>
 
 class SectorView: public UIView {
 public:
@@ -62,11 +65,33 @@ private:
 		Gui::Label *starType;
 	};
 
-	void DrawNearSectors(const matrix4x4f& modelview);
-	void DrawNearSector(const int sx, const int sy, const int sz, const vector3f &playerAbsPos, const matrix4x4f &trans);
-	void PutSystemLabels(RefCountedPtr<Sector> sec, const vector3f &origin, int drawRadius);
+	// what's needed to draw the stars of one sector, boiled down from the
+	// Sector in the background once it's been generated. positions are
+	// relative to the sector's corner. beyond the near sphere the whole
+	// sector is drawn as the one point, at its stars' brightness-weighted
+	// centre
+	struct SectorGeometry {
+		std::vector<vector3f> starPos;
+		std::vector<Color> starColor;
+		std::vector<float> starSize;
+		vector3f farPos;
+		Color farColor;
+	};
+	typedef std::map<SystemPath, SectorGeometry, SystemPath::LessSectorOnly> SectorGeometryMap;
+	typedef std::set<SystemPath, SystemPath::LessSectorOnly> SectorSet;
+	class SectorGeometryJob;
+
+	void UpdateSectorGeometry();
+	bool IsSectorInUse(const SystemPath &path) const;
+	void AddSectorGeometry(std::vector<std::pair<SystemPath, SectorGeometry> > &built);
+	void BuildNearStars();
+	void BuildNearLines();
+	void BuildFarStars();
+	void PrefetchSystems();
 
-	void AddStarBillboard(const matrix4x4f &modelview, const vector3f &pos, const Color &col, float size);
+	void DrawNearSectors(const matrix4x4f& modelview);
+	void DrawSystemOverlay(const SystemPath &path, const matrix4x4f &modelview, const vector3f &playerAbsPos);
+	void PutSystemLabels(RefCountedPtr<Sector> sec, const vector3f &origin);
 
 	void OnClickSystem(const SystemPath &path);
 
@@ -146,12 +171,6 @@ private:
 	RefCountedPtr<Graphics::Material> m_material; //flat colour
 	RefCountedPtr<Graphics::Material> m_starMaterial;
 
-	std::vector<vector3f> m_farstars;
-	std::vector<Color>    m_farstarsColor;
-
-	vector3f m_secPosFar;
-	int      m_radiusFar;
-
 	int m_cacheXMin;
 	int m_cacheXMax;
 	int m_cacheYMin;
@@ -160,8 +179,34 @@ private:
 	int m_cacheZMax;
 
 	std::unique_ptr<Graphics::VertexArray> m_lineVerts;
-	std::unique_ptr<Graphics::VertexArray> m_secLineVerts;
-	std::unique_ptr<Graphics::VertexArray> m_starVerts;
+
+	// Stars, the sector grid and system legs are kept in buffers between
+	// frames and relative to the corner of the sector the view is in. They
+	// are rebuilt when the view moves to another sector or new sectors
+	// arrive; the near star billboards also when the view rotates. Sectors
+	// out to FAR_RAD are only kept as geometry and drawn as points.
+	SectorGeometryMap m_sectorGeometry;
+	std::deque<SystemPath> m_pendingSectors; // asked of the sector cache, nearest first
+	SectorSet m_buildingSectors; // geometry being built
+	bool m_sectorsArrived;
+	JobSet m_geometryJobs;
+
+	bool m_geomValid;
+	SystemPath m_geomCentre;
+	int m_geomLayer;
+	bool m_geomAllLegs;
+	bool m_nearStarsDirty;
+	bool m_nearLinesDirty;
+	bool m_farStarsDirty;
+
+	RefCountedPtr<Graphics::VertexBuffer> m_nearStars;
+	RefCountedPtr<Graphics::VertexBuffer> m_nearLines;
+	RefCountedPtr<Graphics::VertexBuffer> m_farStars;
+
+	// systems in view are generated in the background once the view settles
+	RefCountedPtr<StarSystemCache::Slave> m_systemCache;
+	bool m_systemsValid;
+	SystemPath m_systemsCentre;
 };
 
 #endif /* _SECTORVIEW_H */
@@ -57,6 +57,8 @@ namespace Serializer {
 		explicit Reader(const ByteRange &data);
 
 		bool AtEnd();
+		// bytes left to read
+		size_t Remaining() const { return m_data.end - m_at; }
 		void Seek(int pos);
 		Uint8 Byte();
 		bool Bool();
@@ -4,6 +4,7 @@
 #include "libs.h"
 #include "Ship.h"
 #include "ShipAICmd.h"
+#include "Slice.h"
 #include "Pi.h"
 #include "Player.h"
 #include "perlin.h"
@@ -78,6 +79,17 @@ bool Ship::AITimeStep(float timeStep)
 	else return false;
 }
 
+bool Ship::AICanStepInParallel() const
+{
+	if (!m_curAICmd) return true;
+	// launching and slice drive both reach outside the ship
+	if (m_flightState != FLYING) return false;
+	if (m_sliceDriveState != Slice::DriveState::DRIVE_OFF) return false;
+	const double readySpeed = std::max(0.0, Slice::EngageDriveMinSpeed() - 5000.0);
+	if (GetVelocity().LengthSqr() > readySpeed*readySpeed) return false;
+	return m_curAICmd->IsParallelSafe();
+}
+
 void Ship::AIClearInstructions()
 {
 	if (!m_curAICmd) return;
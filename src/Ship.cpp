@@ -181,6 +181,7 @@ Ship::Ship(const std::string &shipId): DynamicBody(),
 	m_curAICmd = 0;
 	m_aiMessage = AIERROR_NONE;
 	m_decelerating = false;
+	m_wasDecelerating = false;
 
 	SetModel(m_type->model.c_str());
 	SetLabel("UNLABELED_SHIP");
@@ -508,12 +509,29 @@ void Ship::TimeStepUpdate(const float timeStep)
 		m_landingGearAnimation->SetProgress(m_wheelState);
 
 	DynamicBody::TimeStepUpdate(timeStep);
+}
 
+void Ship::PostTimeStepUpdate(const float timeStep)
+{
 	m_navLights->SetEnabled(m_wheelState > 0.01f);
 	m_navLights->Update(timeStep);
 	if (m_sensors.get()) m_sensors->Update(timeStep);
 }
 
+bool Ship::CanCoast() const
+{
+	// an autopilot or slice drive will be setting our velocity soon enough
+	if (m_flightState != FLYING || m_curAICmd || m_launchLockTimeout > 0.0f) return false;
+	if (m_sliceDriveState != Slice::DriveState::DRIVE_OFF) return false;
+	// coasting ships get no StaticUpdate or TimeStepUpdate, so nothing can
+	// be counting down or under way. the player's controls are read in
+	// StaticUpdate
+	if (IsType(Object::PLAYER) || m_testLanded || m_wheelTransition) return false;
+	if (m_hyperspace.countdown > 0.0f || m_hyperspace.now) return false;
+	if (!is_zero_exact(m_thrusters.LengthSqr()) || !is_zero_exact(m_angThrusters.LengthSqr())) return false;
+	return DynamicBody::CanCoast();
+}
+
 // for timestep changes, to stop autopilot overshoot
 // either adds half of current accel if decelerating
 void Ship::TimeAccelAdjust(const float timeStep)
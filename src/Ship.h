@@ -42,6 +42,7 @@ struct shipstats_t {
 class Ship: public DynamicBody {
 	friend class ShipController; //only controllers need access to AITimeStep
 	friend class PlayerShipController;
+	friend class Space; //steps NPC AI for all ships at once
 public:
 	OBJDEF(Ship, DynamicBody, SHIP);
 	Ship(const std::string &shipId);
@@ -87,11 +88,16 @@ public:
 	void Blastoff();
 	bool Undock();
 	virtual void TimeStepUpdate(const float timeStep);
+	virtual void PostTimeStepUpdate(const float timeStep);
 	virtual void StaticUpdate(const float timeStep);
+	virtual bool CanCoast() const;
 
 	void TimeAccelAdjust(const float timeStep);
 	void SetDecelerating(bool decel) { m_decelerating = decel; }
 	bool IsDecelerating() const { return m_decelerating; }
+	// decelerating flag as it was at the start of this tick's AI update.
+	// other ships' AI reads this one so the order they run in doesn't matter
+	bool WasDecelerating() const { return m_wasDecelerating; }
 
 	virtual void NotifyRemoved(const Body* const removedBody);
 	virtual bool OnCollision(Object *o, Uint32 flags, double relVel);
@@ -239,6 +245,7 @@ protected:
 	void RenderLaserfire();
 
 	bool AITimeStep(float timeStep); // Called by controller. Returns true if complete
+	bool AICanStepInParallel() const; // true if this tick's AI step only touches this ship
 
 	virtual void OnEnterHyperspace();
 	virtual void OnEnterSystem();
@@ -286,6 +293,7 @@ private:
 	AICommand *m_curAICmd;
 	AIError m_aiMessage;
 	bool m_decelerating;
+	bool m_wasDecelerating;
 
 	double m_landingMinOffset;	// offset from the centre of the ship used during docking
 
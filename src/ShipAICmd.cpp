@@ -439,6 +439,16 @@ bool AICmdFlyTo::HandleSliceDrive(bool &bHandledOut)
 	return true;
 }
 
+bool AICmdFlyTo::IsParallelSafe() const
+{
+	if (m_child) return m_child->IsParallelSafe();
+	// close to a ship we match its velocity directly (see HandleSliceDrive),
+	// and other ships may be reading ours at the same time
+	if (m_target && m_target->IsType(Object::SHIP))
+		return m_target->GetPositionRelTo(m_ship).LengthSqr() > 50000.0*50000.0;
+	return true;
+}
+
 bool AICmdFlyTo::TimeStepUpdate()
 {
 	if (m_ship->GetFlightState() == Ship::JUMPING) return false;
@@ -536,7 +546,7 @@ Output("Autopilot dist = %.1f, speed = %.1f, zthrust = %.2f, state = %i\n",
 		matrix3x3d orient = m_target->GetFrame()->GetOrientRelTo(m_frame);
 		vector3d targaccel = orient * targship->GetLastForce() / m_target->GetMass();
 		// fudge: targets accelerating towards you are usually going to flip
-		if (targaccel.Dot(reldir) < 0.0 && !targship->IsDecelerating()) targaccel *= 0.5;
+		if (targaccel.Dot(reldir) < 0.0 && !targship->WasDecelerating()) targaccel *= 0.5;
 		relvel += targaccel * timestep;
 		maxdecel += targaccel.Dot(reldir);
 		// if we have margin lower than 10%, fly as if 10% anyway
@@ -624,6 +634,13 @@ AICmdDock::AICmdDock(Ship *ship, SpaceStation *target) : AICommand(ship, CMD_DOC
 // 2: get data for docking end pos
 // 3: Fly to docking end pos
 
+bool AICmdDock::IsParallelSafe() const
+{
+	if (!AICommand::IsParallelSafe()) return false;
+	// asking for clearance changes the station
+	return !m_target || m_target->GetMyDockingPort(m_ship) != -1;
+}
+
 bool AICmdDock::TimeStepUpdate()
 {
 	if (m_ship->GetFlightState() == Ship::JUMPING) return false;
@@ -979,6 +996,16 @@ AICmdFormation::AICmdFormation(Ship *ship, Ship *target, const vector3d &posoff)
 {
 }
 
+bool AICmdFormation::IsParallelSafe() const
+{
+	if (!m_target) return AICommand::IsParallelSafe();
+	// out of chase range any intercept we start can't touch our velocity
+	const double dist = m_target->GetPositionRelTo(m_ship).Length();
+	if (dist > 50000.0) return AICommand::IsParallelSafe();
+	// within it, only keeping station without an intercept is safe
+	return !m_child && dist <= 30000.0;
+}
+
 bool AICmdFormation::TimeStepUpdate()
 {
 	if (m_ship->GetFlightState() == Ship::JUMPING) return false;
@@ -1012,7 +1039,7 @@ bool AICmdFormation::TimeStepUpdate()
 	double ispeed = calc_ivel(targdist, 0.0, maxdecel);
 	vector3d vdiff = ispeed*reldir - relvel;
 	m_ship->AIChangeVelDir(vdiff * m_ship->GetOrient());
-	if (m_target->IsDecelerating()) m_ship->SetDecelerating(true);
+	if (m_target->WasDecelerating()) m_ship->SetDecelerating(true);
 
 	m_ship->AIFaceDirection(-torient.VectorZ());
 	return false;					// never self-terminates
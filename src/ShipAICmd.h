@@ -26,6 +26,10 @@ public:
 
 	virtual bool TimeStepUpdate() = 0;
 	bool ProcessChild();				// returns false if child is active
+	// true if the next TimeStepUpdate only changes m_ship (thrusters, flags,
+	// the command tree) and just reads everything else. commands that can
+	// touch other bodies or velocities other ships read must say no
+	virtual bool IsParallelSafe() const { return !m_child || m_child->IsParallelSafe(); }
 	virtual void GetStatusText(char *str) {
 		if (m_child) m_child->GetStatusText(str);
 		else strcpy(str, "AI state unknown");
@@ -51,6 +55,7 @@ protected:
 class AICmdDock : public AICommand {
 public:
 	virtual bool TimeStepUpdate();
+	virtual bool IsParallelSafe() const;
 	AICmdDock(Ship *ship, SpaceStation *target);
 
 	virtual void GetStatusText(char *str) {
@@ -109,6 +114,7 @@ private:
 class AICmdFlyTo : public AICommand {
 public:
 	virtual bool TimeStepUpdate();
+	virtual bool IsParallelSafe() const;
 	AICmdFlyTo(Ship *ship, Frame *targframe, const vector3d &posoff, double endvel, bool tangent);
 	AICmdFlyTo(Ship *ship, Body *target);
 	~AICmdFlyTo();
@@ -219,6 +225,7 @@ public:
 	virtual ~AICmdTransitAround();
 
 	virtual bool TimeStepUpdate();
+	virtual bool IsParallelSafe() const { return false; } // drives slice velocity directly
 
 	virtual void GetStatusText(char *str) {
 		if(m_child) {
@@ -305,6 +312,7 @@ public:
 class AICmdFormation : public AICommand {
 public:
 	virtual bool TimeStepUpdate();
+	virtual bool IsParallelSafe() const;
 	AICmdFormation(Ship *ship, Ship *target, const vector3d &posoff);
 
 	virtual void GetStatusText(char *str) {
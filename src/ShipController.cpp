@@ -15,9 +15,7 @@
 
 void ShipController::StaticUpdate(float timeStep)
 {
-	OS::EnableFPE();
-	m_ship->AITimeStep(timeStep);
-	OS::DisableFPE();
+	// NPC AI is stepped for all ships together by Space::UpdateAI
 }
 
 PlayerShipController::PlayerShipController() :
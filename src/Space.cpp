@@ -4,6 +4,7 @@
 #include "libs.h"
 #include "Space.h"
 #include "Body.h"
+#include "DynamicBody.h"
 #include "Frame.h"
 #include "Star.h"
 #include "Planet.h"
@@ -23,6 +24,10 @@
 #include "Lang.h"
 #include "Game.h"
 #include "MathUtil.h"
+#include "Ship.h"
+#include "ShipController.h"
+#include "JobQueue.h"
+#include "OS.h"
 
 void Space::BodyNearFinder::Prepare()
 {
@@ -55,7 +60,8 @@ void Space::BodyNearFinder::GetBodiesMaybeNear(const vector3d &pos, double dist,
 }
 
 Space::Space(Game *game)
-	: m_game(game)
+	: m_awakeDirty(true)
+	, m_game(game)
 	, m_frameIndexValid(false)
 	, m_bodyIndexValid(false)
 	, m_sbodyIndexValid(false)
@@ -73,7 +79,8 @@ Space::Space(Game *game)
 }
 
 Space::Space(Game *game, const SystemPath &path)
-	: m_game(game)
+	: m_awakeDirty(true)
+	, m_game(game)
 	, m_frameIndexValid(false)
 	, m_bodyIndexValid(false)
 	, m_sbodyIndexValid(false)
@@ -103,7 +110,8 @@ Space::Space(Game *game, const SystemPath &path)
 }
 
 Space::Space(Game *game, Serializer::Reader &rd, double at_time)
-	: m_game(game)
+	: m_awakeDirty(true)
+	, m_game(game)
 	, m_frameIndexValid(false)
 	, m_bodyIndexValid(false)
 	, m_sbodyIndexValid(false)
@@ -147,12 +155,13 @@ Space::~Space()
 	UpdateBodies();
 }
 
-void Space::Serialize(Serializer::Writer &wr)
+void Space::Serialize(std::vector<std::string> &parts, std::vector<Body*> *bodies)
 {
 	RebuildFrameIndex();
 	RebuildBodyIndex();
 	RebuildSystemBodyIndex();
 
+	Serializer::Writer wr;
 	StarSystem::Serialize(wr, m_starSystem.Get());
 
 	Serializer::Writer section;
@@ -160,8 +169,19 @@ void Space::Serialize(Serializer::Writer &wr)
 	wr.WrSection("Frames", section.GetData());
 
 	wr.Int32(m_bodies.size());
-	for (Body* b : m_bodies)
-		b->Serialize(wr, this);
+	parts.push_back(wr.GetData());
+
+	if (bodies) {
+		bodies->insert(bodies->end(), m_bodies.begin(), m_bodies.end());
+		parts.resize(parts.size() + m_bodies.size());
+		return;
+	}
+
+	for (Body* b : m_bodies) {
+		Serializer::Writer body;
+		b->Serialize(body, this);
+		parts.push_back(body.GetData());
+	}
 }
 
 Frame *Space::GetFrameByIndex(Uint32 idx) const
@@ -272,6 +292,7 @@ void Space::RebuildSystemBodyIndex()
 void Space::AddBody(Body *b)
 {
 	m_bodies.push_back(b);
+	m_awakeDirty = true;
 }
 
 void Space::RemoveBody(Body *b)
@@ -311,11 +332,8 @@ vector3d Space::GetHyperspaceExitPoint(const SystemPath &source, const SystemPat
 	RefCountedPtr<const Sector> source_sec = m_sectorCache->GetCached(source);
 	RefCountedPtr<const Sector> dest_sec = m_sectorCache->GetCached(dest);
 
-	Sector::System source_sys = source_sec->m_systems[source.systemIndex];
-	Sector::System dest_sys = dest_sec->m_systems[dest.systemIndex];
-
-	const vector3d sourcePos = vector3d(source_sys.p) + vector3d(source.sectorX, source.sectorY, source.sectorZ);
-	const vector3d destPos = vector3d(dest_sys.p) + vector3d(dest.sectorX, dest.sectorY, dest.sectorZ);
+	const vector3d sourcePos = vector3d(source_sec->GetPosition(source.systemIndex)) + vector3d(source.sectorX, source.sectorY, source.sectorZ);
+	const vector3d destPos = vector3d(dest_sec->GetPosition(dest.systemIndex)) + vector3d(dest.sectorX, dest.sectorY, dest.sectorZ);
 
 	Body *primary = 0;
 	if (dest.IsBodyPath()) {
@@ -598,8 +616,8 @@ void Space::UpdateStarSystemCache(const SystemPath* here)
 				SystemPath path(x, y, z);
 				RefCountedPtr<Sector> sec(m_sectorCache->GetIfCached(path));
 				assert(sec);
-				for (const Sector::System& ss : sec->m_systems)
-					paths.push_back(SystemPath(ss.sx, ss.sy, ss.sz, ss.idx));
+				for (Uint32 i = 0; i < sec->GetNumSystems(); i++)
+					paths.push_back(sec->GetSystemPath(i));
 			}
 		}
 	}
@@ -648,6 +666,14 @@ static bool OnCollision(Object *o1, Object *o2, CollisionContact *c, double rela
 	return true;
 }
 
+// a swept contact is where the bodies met part way through the last step,
+// which is where they should bounce from
+static void RewindToImpact(DynamicBody *b, double timeOfImpact)
+{
+	const vector3d oldPos = b->GetOldPosition();
+	b->SetPosition(oldPos + (b->GetPosition() - oldPos) * timeOfImpact);
+}
+
 static void hitCallback(CollisionContact *c)
 {
 	//Output("OUCH! %x (depth %f)\n", SDL_GetTicks(), c->depth);
@@ -674,14 +700,20 @@ static void hitCallback(CollisionContact *c)
 
 		const double invMass1 = 1.0 / b1->GetMass();
 		const double invMass2 = 1.0 / b2->GetMass();
-		const vector3d hitPos1 = c->pos - b1->GetPosition();
-		const vector3d hitPos2 = c->pos - b2->GetPosition();
+		vector3d hitPos1 = c->pos - b1->GetPosition();
+		vector3d hitPos2 = c->pos - b2->GetPosition();
 		const vector3d hitVel1 = linVel1 + angVel1.Cross(hitPos1);
 		const vector3d hitVel2 = linVel2 + angVel2.Cross(hitPos2);
 		const double relVel = (hitVel1 - hitVel2).Dot(c->normal);
 		// moving away so no collision
 		if (relVel > 0) return;
 		if (!OnCollision(po1, po2, c, -relVel)) return;
+		if (c->timeOfImpact < 1.0) {
+			RewindToImpact(b1, c->timeOfImpact);
+			RewindToImpact(b2, c->timeOfImpact);
+			hitPos1 = c->pos - b1->GetPosition();
+			hitPos2 = c->pos - b2->GetPosition();
+		}
 		const double invAngInert1 = 1.0 / b1->GetAngularInertia();
 		const double invAngInert2 = 1.0 / b2->GetAngularInertia();
 		const double numerator = -(1.0 + coeff_rest) * relVel;
@@ -718,12 +750,16 @@ static void hitCallback(CollisionContact *c)
 //		mover->UndoTimestep();
 
 		const double invMass1 = 1.0 / mover->GetMass();
-		const vector3d hitPos1 = c->pos - mover->GetPosition();
+		vector3d hitPos1 = c->pos - mover->GetPosition();
 		const vector3d hitVel1 = linVel1 + angVel1.Cross(hitPos1);
 		const double relVel = hitVel1.Dot(c->normal);
 		// moving away so no collision
 		if (relVel > 0 && !c->geomFlag) return;
 		if (!OnCollision(po1, po2, c, -relVel)) return;
+		if (c->timeOfImpact < 1.0) {
+			RewindToImpact(mover, c->timeOfImpact);
+			hitPos1 = c->pos - mover->GetPosition();
+		}
 		const double invAngInert = 1.0 / mover->GetAngularInertia();
 		const double numerator = -(1.0 + coeff_rest) * relVel;
 		const double term1 = invMass1;
@@ -772,29 +808,344 @@ void Space::CollideFrame(Frame *f)
 		CollideFrame(kid);
 }
 
+// unpowered bodies only coast along their orbits at this time accel or
+// above. below it integrating them is cheap and gets every detail right
+static const float COAST_MIN_TIME_ACCEL = 1000.0f;
+// coasting bodies this close to an integrated one are integrated as well
+static const double COAST_WAKE_RANGE = 100000.0;
+// coasting bodies are put back on their orbit before they could have moved
+// this far from where they were bucketed, so anything within the wake range
+// of one is in its cell or a neighbouring one. less if there's a child frame
+// in the way
+static const double COAST_DRIFT_RANGE = 1.0e7;
+static const double COAST_CELL_SIZE = COAST_WAKE_RANGE + COAST_DRIFT_RANGE;
+
+// ships per chunk when stepping NPC AI over the job queue
+static const Uint32 AI_CHUNK_SIZE = 8;
+
+// NPC autopilots. every ship first takes a copy of the state other ships'
+// AI reads, then the ships whose step only touches themselves run together
+// over the job queue, and the rest (launching, docking clearance, slice
+// drive) run after them one at a time in body order. neither half depends
+// on how the work was split, so the outcome is the same on any number of
+// threads. the player's autopilot is still run by its controller
+void Space::UpdateAI(float step)
+{
+	PROFILE_SCOPED()
+	m_aiParallel.clear();
+	m_aiSerial.clear();
+	for (Body* b : m_awake) {
+		if (!b->IsType(Object::SHIP)) continue;
+		Ship *s = static_cast<Ship*>(b);
+		s->m_wasDecelerating = s->m_decelerating;
+		if (s->IsDead() || !s->GetController() || s->GetController()->GetType() != ShipController::AI)
+			continue;
+		if (s->AICanStepInParallel())
+			m_aiParallel.push_back(s);
+		else
+			m_aiSerial.push_back(s);
+	}
+
+	// floating point exceptions are enabled per thread, so each job turns
+	// them on for its own chunk, as the serial loop does below
+	ParallelFor(Pi::GetAsyncJobQueue(), m_aiParallel.size(), AI_CHUNK_SIZE, [this, step](Uint32 begin, Uint32 end) {
+		OS::EnableFPE();
+		for (Uint32 i = begin; i < end; i++)
+			m_aiParallel[i]->AITimeStep(step);
+		OS::DisableFPE();
+	});
+
+	OS::EnableFPE();
+	for (Ship* s : m_aiSerial)
+		s->AITimeStep(step);
+	OS::DisableFPE();
+}
+
+bool Space::CoastCell::operator<(const CoastCell &o) const
+{
+	if (frame != o.frame) return frame < o.frame;
+	if (x != o.x) return x < o.x;
+	if (y != o.y) return y < o.y;
+	return z < o.z;
+}
+
+bool Space::CoastCell::operator==(const CoastCell &o) const
+{
+	return frame == o.frame && x == o.x && y == o.y && z == o.z;
+}
+
+static Space::CoastCell MakeCoastCell(const Frame *f, const vector3d &pos, double size)
+{
+	Space::CoastCell c;
+	c.frame = f;
+	c.x = Sint64(floor(pos.x / size));
+	c.y = Sint64(floor(pos.y / size));
+	c.z = Sint64(floor(pos.z / size));
+	return c;
+}
+
+void Space::RebuildAwake()
+{
+	m_awake.clear();
+	for (Body* b : m_bodies) {
+		if (b->IsType(Object::DYNAMICBODY) && static_cast<DynamicBody*>(b)->IsCoasting()) continue;
+		m_awake.push_back(b);
+	}
+	m_awakeDirty = false;
+}
+
+// everything near a body that is being integrated gets integrated too, so
+// encounters with ships under power play out in full
+void Space::BucketAwakeBodies()
+{
+	m_awakeCells.clear();
+	for (Body* b : m_awake) {
+		if (!b->IsType(Object::DYNAMICBODY)) continue;
+		const DynamicBody *db = static_cast<DynamicBody*>(b);
+		if (!db->IsMoving()) continue;
+
+		AwakeBody a;
+		a.body = db;
+		a.pos = db->GetPositionRelTo(m_rootFrame.get());
+		m_awakeCells[MakeCoastCell(m_rootFrame.get(), a.pos, COAST_WAKE_RANGE)].push_back(a);
+	}
+}
+
+bool Space::IsCoastBlocked(const DynamicBody *db) const
+{
+	const vector3d pos = db->GetPositionRelTo(m_rootFrame.get());
+	const CoastCell c = MakeCoastCell(m_rootFrame.get(), pos, COAST_WAKE_RANGE);
+	CoastCell n = c;
+	for (n.x = c.x-1; n.x <= c.x+1; n.x++)
+		for (n.y = c.y-1; n.y <= c.y+1; n.y++)
+			for (n.z = c.z-1; n.z <= c.z+1; n.z++) {
+				auto it = m_awakeCells.find(n);
+				if (it == m_awakeCells.end()) continue;
+				for (const AwakeBody &a : it->second)
+					if (a.body != db && (a.pos - pos).LengthSqr() < COAST_WAKE_RANGE*COAST_WAKE_RANGE)
+						return true;
+			}
+	return false;
+}
+
+void Space::BucketCoaster(DynamicBody *db, const CoastCell &cell)
+{
+	m_coastCells[cell].push_back(db);
+	m_coastFrames[cell.frame]++;
+}
+
+void Space::UnbucketCoaster(DynamicBody *db, const CoastCell &cell)
+{
+	auto it = m_coastCells.find(cell);
+	assert(it != m_coastCells.end());
+	std::vector<DynamicBody*> &v = it->second;
+	v.erase(std::find(v.begin(), v.end(), db));
+	if (v.empty()) m_coastCells.erase(it);
+
+	auto frame = m_coastFrames.find(cell.frame);
+	if (--frame->second == 0) m_coastFrames.erase(frame);
+}
+
+// after the body was put on its orbit. never leaves the frame count at zero,
+// so it's safe while going through m_coastFrames
+void Space::RebucketCoaster(DynamicBody *db)
+{
+	Coaster &c = m_coasters[db];
+	c.drift = CoastDriftRange(db);
+	const CoastCell newCell = MakeCoastCell(db->GetFrame(), db->GetPosition(), COAST_CELL_SIZE);
+	if (newCell == c.cell) return;
+	BucketCoaster(db, newCell);
+	UnbucketCoaster(db, c.cell);
+	c.cell = newCell;
+}
+
+// nothing looks for what a coasting body might run into, so it's looked at
+// again before it could reach any of its frame's child frames (moons,
+// stations), which may be coming towards it as well. the frame's own body
+// is kept clear of by the orbit (see DynamicBody::StartCoasting)
+double Space::CoastDriftRange(const DynamicBody *db) const
+{
+	double range = COAST_DRIFT_RANGE;
+	const vector3d &pos = db->GetPosition();
+	const double speed = db->GetCoastMaxSpeed();
+	for (const Frame *kid : db->GetFrame()->GetChildren()) {
+		if (kid->IsRotFrame()) continue;
+		const double gap = (kid->GetPosition() - pos).Length() - kid->GetRadius();
+		range = std::min(range, gap * speed / (speed + kid->GetVelocity().Length()));
+	}
+	return std::max(range, 0.0);
+}
+
+void Space::AddCoaster(DynamicBody *db)
+{
+	Coaster c;
+	c.cell = MakeCoastCell(db->GetFrame(), db->GetPosition(), COAST_CELL_SIZE);
+	c.drift = CoastDriftRange(db);
+	m_coasters[db] = c;
+	BucketCoaster(db, c.cell);
+	m_awakeDirty = true;
+}
+
+void Space::RemoveCoaster(DynamicBody *db)
+{
+	auto it = m_coasters.find(db);
+	if (it == m_coasters.end()) return;
+	UnbucketCoaster(db, it->second.cell);
+	m_coasters.erase(it);
+	m_awakeDirty = true;
+}
+
+void Space::ResolveCoasters(double time)
+{
+	PROFILE_SCOPED()
+	for (auto &c : m_coasters) {
+		DynamicBody *db = c.first;
+		if (db->CoastInterrupted() || db->GetCoastResolveTime() == time) continue;
+		db->ResolveCoast(time);
+		RebucketCoaster(db);
+	}
+}
+
+// wakes the coasting bodies that have to be integrated from this step on. a
+// coasting body costs a few tests here, and is only put on its orbit when it
+// could have drifted out of its cell, when it wakes or when something being
+// integrated might be close to it
+void Space::UpdateCoasters(double time, bool canCoast)
+{
+	PROFILE_SCOPED()
+	m_coastWake.clear();
+	for (auto &c : m_coasters) {
+		DynamicBody *db = c.first;
+		// whatever moved it wins over the orbit
+		if (db->CoastInterrupted()) {
+			m_coastWake.push_back(db);
+			continue;
+		}
+		if (!canCoast || !db->CanCoast()) {
+			db->ResolveCoast(time);
+			m_coastWake.push_back(db);
+			continue;
+		}
+		if ((time - db->GetCoastResolveTime()) * db->GetCoastMaxSpeed() > c.second.drift) {
+			db->ResolveCoast(time);
+			// leaving or entering a frame stops the coast
+			db->UpdateFrame();
+			if (db->IsCoasting())
+				RebucketCoaster(db);
+			else
+				m_coastWake.push_back(db);
+		}
+	}
+	for (DynamicBody *db : m_coastWake) {
+		RemoveCoaster(db);
+		db->StopCoasting(time);
+	}
+
+	if (canCoast)
+		WakeNearbyCoasters(time);
+}
+
+void Space::WakeNearbyCoasters(double time)
+{
+	m_coastWake.clear();
+	for (const auto &awakeCell : m_awakeCells) {
+		for (const AwakeBody &a : awakeCell.second) {
+			for (const auto &f : m_coastFrames) {
+				const vector3d pos = a.body->GetPositionRelTo(f.first);
+				const CoastCell c = MakeCoastCell(f.first, pos, COAST_CELL_SIZE);
+
+				m_coastNear.clear();
+				CoastCell n = c;
+				for (n.x = c.x-1; n.x <= c.x+1; n.x++)
+					for (n.y = c.y-1; n.y <= c.y+1; n.y++)
+						for (n.z = c.z-1; n.z <= c.z+1; n.z++) {
+							auto it = m_coastCells.find(n);
+							if (it != m_coastCells.end())
+								m_coastNear.insert(m_coastNear.end(), it->second.begin(), it->second.end());
+						}
+
+				for (DynamicBody *db : m_coastNear) {
+					// as far as it could have got since it was last put on its orbit
+					const double reach = COAST_WAKE_RANGE + (time - db->GetCoastResolveTime()) * db->GetCoastMaxSpeed();
+					if ((db->GetPosition() - pos).LengthSqr() >= reach*reach) continue;
+					if (db->GetCoastResolveTime() != time) {
+						db->ResolveCoast(time);
+						RebucketCoaster(db);
+					}
+					if ((db->GetPosition() - pos).LengthSqr() < COAST_WAKE_RANGE*COAST_WAKE_RANGE)
+						m_coastWake.push_back(db);
+				}
+			}
+		}
+	}
+
+	for (DynamicBody *db : m_coastWake) {
+		if (!db->IsCoasting()) continue;
+		RemoveCoaster(db);
+		db->StopCoasting(time);
+	}
+}
+
 void Space::TimeStep(float step)
 {
 	PROFILE_SCOPED()
 	m_frameIndexValid = m_bodyIndexValid = m_sbodyIndexValid = false;
 
-	// XXX does not need to be done this often
+	// bodies are still where they were at the end of the last step. wake
+	// any coasting bodies that need it first so they join in from here
+	const double stateTime = m_game->GetTime() - step;
+	const bool canCoast = m_game->GetTimeAccelRate() >= COAST_MIN_TIME_ACCEL;
+	if (m_awakeDirty)
+		RebuildAwake();
+	BucketAwakeBodies();
+	UpdateCoasters(stateTime, canCoast);
+	if (m_awakeDirty)
+		RebuildAwake();
+
+	// XXX does not need to be done this often. coasting bodies aren't in
+	// the collision spaces
 	CollideFrame(m_rootFrame.get());
-	for (Body* b : m_bodies)
+	for (Body* b : m_awake)
 		CollideWithTerrain(b);
 
-	// update frames of reference
-	for (Body* b : m_bodies)
+	// update frames of reference. bodies that aren't moving (docked, landed)
+	// are asleep and stay where they are
+	for (Body* b : m_awake) {
+		if (b->IsType(Object::DYNAMICBODY) && !static_cast<DynamicBody*>(b)->IsMoving()) continue;
 		b->UpdateFrame();
+	}
 
 	// AI acts here, then move all bodies and frames
-	for (Body* b : m_bodies)
+	UpdateAI(step);
+	for (Body* b : m_awake)
 		b->StaticUpdate(step);
 
 	m_rootFrame->UpdateOrbitRails(m_game->GetTime(), m_game->GetTimeStep());
 
-	for (Body* b : m_bodies)
+	for (Body* b : m_awake)
 		b->TimeStepUpdate(step);
 
+	// all forces are in, so move everything that moves. unpowered bodies in
+	// free fall with nothing integrated nearby start following their orbits
+	// at high time accel, the rest are integrated in one go
+	m_integrator.Begin(step);
+	for (Body* b : m_awake) {
+		if (!b->IsType(Object::DYNAMICBODY)) continue;
+		DynamicBody *db = static_cast<DynamicBody*>(b);
+		if (!db->IsMoving()) continue;
+
+		if (canCoast && db->CanCoast() && !IsCoastBlocked(db) && db->StartCoasting(stateTime)) {
+			AddCoaster(db);
+			continue;
+		}
+		m_integrator.Add(db);
+	}
+	m_integrator.Integrate(Pi::GetAsyncJobQueue());
+	m_integrator.WriteBack();
+
+	for (Body* b : m_awake)
+		b->PostTimeStepUpdate(step);
+
 	UpdateBodies();
 
 	m_bodyNearFinder.Prepare();
@@ -807,18 +1158,24 @@ void Space::UpdateBodies()
 #endif
 
 	for (Body* rmb : m_removeBodies) {
+		if (rmb->IsType(Object::DYNAMICBODY))
+			RemoveCoaster(static_cast<DynamicBody*>(rmb));
 		rmb->SetFrame(0);
 		for (Body* b : m_bodies)
 			b->NotifyRemoved(rmb);
 		m_bodies.remove(rmb);
+		m_awakeDirty = true;
 	}
 	m_removeBodies.clear();
 
 	for (Body* killb : m_killBodies) {
+		if (killb->IsType(Object::DYNAMICBODY))
+			RemoveCoaster(static_cast<DynamicBody*>(killb));
 		for (Body* b : m_bodies)
 			b->NotifyRemoved(killb);
 		m_bodies.remove(killb);
 		delete killb;
+		m_awakeDirty = true;
 	}
 	m_killBodies.clear();
 
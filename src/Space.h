@@ -5,6 +5,7 @@
 #define _SPACE_H
 
 #include <list>
+#include <map>
 #include "Object.h"
 #include "vector3.h"
 #include "Serializer.h"
@@ -12,9 +13,11 @@
 #include "galaxy/GalaxyCache.h"
 #include "galaxy/StarSystem.h"
 #include "Background.h"
+#include "BodyIntegrator.h"
 #include "IterationProxy.h"
 
 class Body;
+class DynamicBody;
 class Frame;
 class Ship;
 class HyperspaceCloud;
@@ -33,7 +36,11 @@ public:
 
 	virtual ~Space();
 
-	void Serialize(Serializer::Writer &wr);
+	// in pieces, so that bodies can be compared between saves: everything up
+	// to the bodies, then one for each body. joined up they're the section
+	// the constructor reads. with bodies, the bodies' parts are left empty
+	// and the bodies listed there instead
+	void Serialize(std::vector<std::string> &parts, std::vector<Body*> *bodies = nullptr);
 
 	// frame/body/sbody indexing for save/load. valid after
 	// construction/Serialize(), invalidated by TimeStep(). they will assert
@@ -55,6 +62,10 @@ public:
 
 	void TimeStep(float step);
 
+	// put every coasting body where its orbit has it at the given game time,
+	// for drawing or saving
+	void ResolveCoasters(double time);
+
 	vector3d GetHyperspaceExitPoint(const SystemPath &source, const SystemPath &dest) const;
 	vector3d GetHyperspaceExitPoint(const SystemPath &source) const {
 		return GetHyperspaceExitPoint(source, m_starSystem->GetSystemPath());
@@ -88,11 +99,63 @@ private:
 	Frame *GetFrameWithSystemBody(const SystemBody *b) const;
 
 	void UpdateBodies();
+	void UpdateAI(float step);
+
+	// coasting bodies (see DynamicBody::StartCoasting) take no part in the
+	// per-step passes. they're bucketed by frame and by where they were last
+	// put on their orbit, so the bodies being integrated can find the ones
+	// they should wake without looking at the rest
+public:
+	struct CoastCell {
+		const Frame *frame;
+		Sint64 x, y, z;
+		bool operator<(const CoastCell &o) const;
+		bool operator==(const CoastCell &o) const;
+	};
+private:
+	struct Coaster {
+		CoastCell cell;
+		double drift;		// how far it can go before it's looked at again
+	};
+	struct AwakeBody {
+		const DynamicBody *body;
+		vector3d pos;		// relative to the root frame
+	};
+	void RebuildAwake();
+	void BucketAwakeBodies();
+	void UpdateCoasters(double time, bool canCoast);
+	void WakeNearbyCoasters(double time);
+	bool IsCoastBlocked(const DynamicBody *db) const;
+	void AddCoaster(DynamicBody *db);
+	void RemoveCoaster(DynamicBody *db);
+	void BucketCoaster(DynamicBody *db, const CoastCell &cell);
+	void UnbucketCoaster(DynamicBody *db, const CoastCell &cell);
+	void RebucketCoaster(DynamicBody *db);
+	double CoastDriftRange(const DynamicBody *db) const;
 
 	void CollideFrame(Frame *f);
 
 	std::unique_ptr<Frame> m_rootFrame;
 
+	BodyIntegrator m_integrator;
+	// NPC ships sorted by UpdateAI into those that can step at the same time
+	// and those that have to go one by one
+	std::vector<Ship*> m_aiParallel;
+	std::vector<Ship*> m_aiSerial;
+	// everything that isn't coasting, in m_bodies order. rebuilt when a body
+	// comes, goes, starts or stops coasting
+	std::vector<Body*> m_awake;
+	bool m_awakeDirty;
+	// coasting bodies, with the cell each is bucketed in
+	std::map<DynamicBody*, Coaster> m_coasters;
+	std::map<CoastCell, std::vector<DynamicBody*> > m_coastCells;
+	std::vector<DynamicBody*> m_coastNear;
+	std::vector<DynamicBody*> m_coastWake;
+	// how many coasters each frame has
+	std::map<const Frame*, Uint32> m_coastFrames;
+	// moving bodies that aren't coasting, by where they are this step
+	std::map<CoastCell, std::vector<AwakeBody> > m_awakeCells;
+
 	RefCountedPtr<SectorCache::Slave> m_sectorCache;
 
 	RefCountedPtr<StarSystem> m_starSystem;
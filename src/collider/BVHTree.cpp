@@ -3,138 +3,287 @@
 
 #include "BVHTree.h"
 #include "../buildopts.h"
+#include "../Serializer.h"
 #include <stdio.h>
 #include <float.h>
+#include <math.h>
+#include <algorithm>
 
-const int MAX_SPLITPOS_RETRIES = 15;
+// the builder sorts object centroids into this many bins along each axis
+// and takes the split between bins with the lowest surface area heuristic
+// cost
+static const int SAH_BINS = 16;
+// cost of visiting a node, relative to testing one object
+static const float SAH_TRAVERSAL_COST = 1.0f;
+// bigger leaves are only made when the objects can't be separated
+static const Uint32 MAX_LEAF_OBJS = 4;
+
+namespace {
+	struct SAHBin {
+		Uint32 count;
+		float min[3], max[3];
+	};
+
+	inline void ResetBounds(float *mn, float *mx)
+	{
+		mn[0] = mn[1] = mn[2] = FLT_MAX;
+		mx[0] = mx[1] = mx[2] = -FLT_MAX;
+	}
+
+	inline void GrowBounds(float *mn, float *mx, const float *omn, const float *omx)
+	{
+		for (int k=0; k<3; k++) {
+			mn[k] = std::min(mn[k], omn[k]);
+			mx[k] = std::max(mx[k], omx[k]);
+		}
+	}
+
+	inline float HalfArea(const float *mn, const float *mx)
+	{
+		const float dx = mx[0]-mn[0], dy = mx[1]-mn[1], dz = mx[2]-mn[2];
+		return dx*dy + dy*dz + dz*dx;
+	}
+
+	inline int BinIndex(float centroid, float cmin, float scale)
+	{
+		return std::min(int((centroid - cmin) * scale), SAH_BINS-1);
+	}
+
+	// the nearest floats that don't cut into the box, so a ray that just
+	// grazes an object can't miss its node
+	inline float RoundDown(double d)
+	{
+		const float f = float(d);
+		return double(f) > d ? nextafterf(f, -FLT_MAX) : f;
+	}
+
+	inline float RoundUp(double d)
+	{
+		const float f = float(d);
+		return double(f) < d ? nextafterf(f, FLT_MAX) : f;
+	}
+}
 
 BVHTree::BVHTree(const int numObjs, const objPtr_t *objPtrs, const Aabb *objAabbs)
-: m_objPtrAllocPos(0)
-, m_objPtrAllocMax(numObjs)
-, m_nodeAllocPos(0)
-, m_nodeAllocMax(numObjs*2 + 1)
 {
-	std::vector<int> activeObjIdxs(numObjs);
-	for (int i=0; i<numObjs; i++) activeObjIdxs[i] = i;
+	if (numObjs <= 0) Error("BVHTree built with no objects.");
 
-	m_objPtrAlloc = new objPtr_t[numObjs];
-	m_bvhNodes = new BVHNode[numObjs*2 + 1];
+	std::vector<BuildObj> objs(numObjs);
+	for (int i=0; i<numObjs; i++) {
+		BuildObj &o = objs[i];
+		o.ptr = objPtrs[i];
+		for (int k=0; k<3; k++) {
+			o.min[k] = RoundDown(objAabbs[i].min[k]);
+			o.max[k] = RoundUp(objAabbs[i].max[k]);
+			o.centroid[k] = 0.5f * (o.min[k] + o.max[k]);
+		}
+	}
 
-	m_root = AllocNode();
-	BuildNode(m_root, objPtrs, objAabbs, activeObjIdxs);
+	// a binary tree with at least one object per leaf
+	m_nodes.reserve(numObjs*2 - 1);
+	m_objs.reserve(numObjs);
+
+	m_nodes.push_back(BVHNode());
+	BuildNode(0, objs, 0, numObjs, 0);
 }
 
-void BVHTree::MakeLeaf(BVHNode *node, const objPtr_t *objPtrs, std::vector<objPtr_t> &objs)
+// bytes Save writes per node and per object
+static const size_t NODE_SIZE = 32;
+static const size_t OBJ_SIZE = 4;
+
+BVHTree::BVHTree(Serializer::Reader &rd)
 {
-	const size_t numTris = objs.size();
-	if (numTris <= 0) Error("MakeLeaf called with no elements in objs.");
+	// the counts are checked before anything is allocated for them. a
+	// binary tree with at least one object per leaf has fewer nodes than
+	// twice its objects
+	if (rd.Remaining() < 8)
+		throw SavedGameCorruptException();
+	const Uint32 numNodes = rd.Int32();
+	if (numNodes == 0 || numNodes > (rd.Remaining() - 4) / NODE_SIZE)
+		throw SavedGameCorruptException();
+	m_nodes.resize(numNodes);
+	for (BVHNode &n : m_nodes) {
+		for (int k=0; k<3; k++) n.min[k] = rd.Float();
+		n.offset = rd.Int32();
+		for (int k=0; k<3; k++) n.max[k] = rd.Float();
+		n.numObjs = rd.Int32();
+	}
+
+	const Uint32 numObjs = rd.Int32();
+	if (numObjs == 0 || numObjs > rd.Remaining() / OBJ_SIZE || numNodes > 2*Uint64(numObjs) - 1)
+		throw SavedGameCorruptException();
+	m_objs.resize(numObjs);
+	for (objPtr_t &o : m_objs)
+		o = rd.Int32();
+}
 
-	if (numTris > m_objPtrAllocMax - m_objPtrAllocPos) {
-		Error("Out of space in m_objPtrAlloc. Left: " SIZET_FMT "; required: " SIZET_FMT ".", m_objPtrAllocMax - m_objPtrAllocPos, numTris);
+void BVHTree::Save(Serializer::Writer &wr) const
+{
+	wr.Int32(m_nodes.size());
+	for (const BVHNode &n : m_nodes) {
+		for (int k=0; k<3; k++) wr.Float(n.min[k]);
+		wr.Int32(n.offset);
+		for (int k=0; k<3; k++) wr.Float(n.max[k]);
+		wr.Int32(n.numObjs);
 	}
 
-	node->numTris = numTris;
-	node->triIndicesStart = &m_objPtrAlloc[m_objPtrAllocPos];
-	//if (objs.size()>3) Output("fat node %d\n", objs.size());
+	wr.Int32(m_objs.size());
+	for (const objPtr_t o : m_objs)
+		wr.Int32(o);
+}
+
+bool BVHTree::IsValid(objPtr_t objLimit) const
+{
+	if (m_nodes.empty()) return false;
+	for (const objPtr_t o : m_objs)
+		if (o < 0 || o >= objLimit) return false;
+
+	// walk it the way the traversals do. children always come after their
+	// parent, so the walk ends, and visiting every node exactly once means
+	// no two parents share a child
+	std::vector<bool> visited(m_nodes.size(), false);
+	Uint32 stack[MAX_DEPTH+1];
+	int depths[MAX_DEPTH+1];
+	int stackPos = 0;
+	stack[0] = 0;
+	depths[0] = 0;
+	Uint32 numVisited = 0;
+	while (stackPos >= 0) {
+		const Uint32 idx = stack[stackPos];
+		const int depth = depths[stackPos--];
+		if (visited[idx]) return false;
+		visited[idx] = true;
+		numVisited++;
 
-	// copy tri indices to the stinking flat array
-	for (int i=numTris-1; i>=0; i--) {
-		m_objPtrAlloc[m_objPtrAllocPos++] = objPtrs[objs[i]];
+		const BVHNode &n = m_nodes[idx];
+		if (n.IsLeaf()) {
+			if (n.offset > m_objs.size() || n.numObjs > m_objs.size() - n.offset) return false;
+			continue;
+		}
+		if (depth >= MAX_DEPTH) return false;
+		if (n.offset <= idx+1 || n.offset >= m_nodes.size()) return false;
+		stack[++stackPos] = idx+1;
+		depths[stackPos] = depth+1;
+		stack[++stackPos] = n.offset;
+		depths[stackPos] = depth+1;
 	}
+	return numVisited == m_nodes.size();
 }
 
-void BVHTree::BuildNode(BVHNode *node,
-			const objPtr_t *objPtrs,
-			const Aabb *objAabbs,
-			std::vector<objPtr_t> &activeObjIdx)
+void BVHTree::MakeLeaf(Uint32 nodeIdx, const std::vector<BuildObj> &objs, Uint32 begin, Uint32 end)
 {
-	const int numTris = activeObjIdx.size();
-	if (numTris <= 0) Error("BuildNode called with no elements in activeObjIndex.");
+	BVHNode &node = m_nodes[nodeIdx];
+	node.offset = m_objs.size();
+	node.numObjs = end - begin;
+	for (Uint32 i=begin; i<end; i++)
+		m_objs.push_back(objs[i].ptr);
+}
+
+void BVHTree::BuildNode(Uint32 nodeIdx, std::vector<BuildObj> &objs, Uint32 begin, Uint32 end, int depth)
+{
+	const Uint32 count = end - begin;
+	assert(count > 0);
 
-	if (numTris == 1) {
-		MakeLeaf(node, objPtrs, activeObjIdx);
+	// bounds of the objects, and of their centroids which is what we split
+	float mn[3], mx[3], cmn[3], cmx[3];
+	ResetBounds(mn, mx);
+	ResetBounds(cmn, cmx);
+	for (Uint32 i=begin; i<end; i++) {
+		GrowBounds(mn, mx, objs[i].min, objs[i].max);
+		GrowBounds(cmn, cmx, objs[i].centroid, objs[i].centroid);
+	}
+	for (int k=0; k<3; k++) {
+		m_nodes[nodeIdx].min[k] = mn[k];
+		m_nodes[nodeIdx].max[k] = mx[k];
+	}
+
+	if (count == 1 || depth >= MAX_DEPTH) {
+		MakeLeaf(nodeIdx, objs, begin, end);
 		return;
 	}
 
-	std::vector<int> splitSides(numTris);
+	// cheapest split over all three axes
+	float bestCost = FLT_MAX;
+	int bestAxis = -1, bestBin = 0;
+	for (int axis=0; axis<3; axis++) {
+		const float extent = cmx[axis] - cmn[axis];
+		if (extent <= 0.0f) continue;
+		const float scale = SAH_BINS / extent;
 
-	Aabb aabb;
-	aabb.min = vector3d(FLT_MAX, FLT_MAX, FLT_MAX);
-	aabb.max = vector3d(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		SAHBin bins[SAH_BINS];
+		for (SAHBin &b : bins) {
+			b.count = 0;
+			ResetBounds(b.min, b.max);
+		}
+		for (Uint32 i=begin; i<end; i++) {
+			SAHBin &b = bins[BinIndex(objs[i].centroid[axis], cmn[axis], scale)];
+			b.count++;
+			GrowBounds(b.min, b.max, objs[i].min, objs[i].max);
+		}
 
-	for (int i=0; i<numTris; i++) {
-		int idx = activeObjIdx[i];
-		aabb.Update(objAabbs[idx].min);
-		aabb.Update(objAabbs[idx].max);
-	}
-	node->numTris = numTris;
-	node->aabb = aabb;
-
-	Aabb splitBox = aabb;
-	double splitPos;
-	int splitAxis;
-	int s1count, s2count;
-	int attempt = 0;
-
-	for (;;) {
-		splitAxis = 0;
-
-		vector3d boxSize = splitBox.max - splitBox.min;
-
-		if (boxSize[1] > boxSize[0]) splitAxis = 1;
-		if ((boxSize[2] > boxSize[1]) && (boxSize[2] > boxSize[0])) splitAxis = 2;
-
-		// split pos in middle of splitBox
-		splitPos = 0.5f * (splitBox.min[splitAxis] + splitBox.max[splitAxis]);
-		s1count = 0, s2count = 0;
-
-		for (int i=0; i<numTris; i++) {
-			int idx = activeObjIdx[i];
-			double mid = 0.5 * (objAabbs[idx].min[splitAxis] + objAabbs[idx].max[splitAxis]);
-			if (mid < splitPos) {
-				splitSides[i] = 0;
-				s1count++;
-			} else {
-				splitSides[i] = 1;
-				s2count++;
-			}
+		// sweep from the right for the cost of everything past each split
+		Uint32 rightCount[SAH_BINS];
+		float rightArea[SAH_BINS];
+		float rmn[3], rmx[3];
+		ResetBounds(rmn, rmx);
+		Uint32 rc = 0;
+		for (int b=SAH_BINS-1; b>0; b--) {
+			rc += bins[b].count;
+			GrowBounds(rmn, rmx, bins[b].min, bins[b].max);
+			rightCount[b] = rc;
+			rightArea[b] = rc ? HalfArea(rmn, rmx) : 0.0f;
 		}
 
-		if (s1count == numTris) {
-			if (attempt < MAX_SPLITPOS_RETRIES) {
-				// try splitting at average point
-				splitBox.max[splitAxis] = splitPos;
-				attempt++;
-				continue;
-			} else {
-				MakeLeaf(node, objPtrs, activeObjIdx);
-				return;
-			}
-		} else if (s2count == numTris) {
-			if (attempt < MAX_SPLITPOS_RETRIES) {
-				// try splitting at average point
-				splitBox.min[splitAxis] = splitPos;
-				attempt++;
-				continue;
-			} else {
-				MakeLeaf(node, objPtrs, activeObjIdx);
-				return;
+		float lmn[3], lmx[3];
+		ResetBounds(lmn, lmx);
+		Uint32 lc = 0;
+		for (int b=0; b<SAH_BINS-1; b++) {
+			lc += bins[b].count;
+			GrowBounds(lmn, lmx, bins[b].min, bins[b].max);
+			if (lc == 0 || rightCount[b+1] == 0) continue;
+			const float cost = lc * HalfArea(lmn, lmx) + rightCount[b+1] * rightArea[b+1];
+			if (cost < bestCost) {
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = b;
 			}
 		}
-		break;
 	}
 
-	std::vector<int> side[2];
+	Uint32 mid;
+	if (bestAxis < 0) {
+		// every centroid in the same place, nothing to split on
+		if (count <= MAX_LEAF_OBJS) {
+			MakeLeaf(nodeIdx, objs, begin, end);
+			return;
+		}
+		mid = begin + count/2;
+	} else {
+		const float area = HalfArea(mn, mx);
+		const float splitCost = SAH_TRAVERSAL_COST + (area > 0.0f ? bestCost / area : 0.0f);
+		if (count <= MAX_LEAF_OBJS && splitCost >= float(count)) {
+			MakeLeaf(nodeIdx, objs, begin, end);
+			return;
+		}
 
-	for (int i=0; i<numTris; i++) {
-		side[splitSides[i]].push_back(activeObjIdx[i]);
+		const float cmin = cmn[bestAxis];
+		const float scale = SAH_BINS / (cmx[bestAxis] - cmin);
+		mid = std::partition(objs.begin() + begin, objs.begin() + end, [=](const BuildObj &o) {
+			return BinIndex(o.centroid[bestAxis], cmin, scale) <= bestBin;
+		}) - objs.begin();
+		if (mid == begin || mid == end) mid = begin + count/2;
 	}
 
-	// recurse!
-	node->triIndicesStart = 0;
-	node->kids[0] = AllocNode();
-	node->kids[1] = AllocNode();
+	// depth-first: the left child goes straight after us
+	const Uint32 left = m_nodes.size();
+	assert(left == nodeIdx + 1);
+	m_nodes.push_back(BVHNode());
+	BuildNode(left, objs, begin, mid, depth+1);
 
-	BuildNode(node->kids[0], objPtrs, objAabbs, side[0]);
-	BuildNode(node->kids[1], objPtrs, objAabbs, side[1]);
-}
\ No newline at end of file
+	const Uint32 right = m_nodes.size();
+	m_nodes.push_back(BVHNode());
+	BuildNode(right, objs, mid, end, depth+1);
+
+	m_nodes[nodeIdx].offset = right;
+	m_nodes[nodeIdx].numObjs = 0;
+}
@@ -10,52 +10,64 @@
 #include "../Aabb.h"
 #include "../utils.h"
 
-struct BVHNode {
-	Aabb aabb;
-
-	/* if triIndicesStart == 0 then not leaf,
-	 * kids[] valid */
-	int numTris;
-	int *triIndicesStart;
+namespace Serializer { class Reader; class Writer; }
 
-	BVHNode *kids[2];
+/* Nodes are stored flattened in depth-first order, so an interior node's
+ * first child is the node straight after it and only the second child
+ * needs an index. 32 bytes, two to a cache line. */
+struct BVHNode {
+	float min[3];
+	/* interior: index of the second child.
+	 * leaf: index of the first object in the tree's object list */
+	Uint32 offset;
+	float max[3];
+	/* 0 for interior nodes */
+	Uint32 numObjs;
 
-	BVHNode() : numTris(0), triIndicesStart(nullptr) {
-		kids[0] = nullptr;
-		kids[1] = nullptr;
-	}
 	bool IsLeaf() const {
-		return triIndicesStart != nullptr;
+		return numObjs != 0;
+	}
+	Aabb GetAabb() const {
+		Aabb aabb;
+		aabb.min = vector3d(min[0], min[1], min[2]);
+		aabb.max = vector3d(max[0], max[1], max[2]);
+		return aabb;
 	}
 };
 
 class BVHTree {
 public:
 	typedef int objPtr_t;
+	// no tree is built deeper than this, so traversals can use fixed stacks
+	static const int MAX_DEPTH = 48;
+
 	BVHTree(const int numObjs, const objPtr_t *objPtrs, const Aabb *objAabbs);
-	~BVHTree() {
-		delete [] m_objPtrAlloc;
-		delete [] m_bvhNodes;
-	}
-	BVHNode *GetRoot() { return m_root; }
+	// a tree stored with Save, so it needn't be built again. throws
+	// SavedGameCorruptException if its counts don't fit the data; check the
+	// rest with IsValid before traversing it
+	BVHTree(Serializer::Reader &rd);
+	void Save(Serializer::Writer &wr) const;
+	// every child and object index in range, no deeper than MAX_DEPTH, and
+	// all objects in [0, objLimit)
+	bool IsValid(objPtr_t objLimit) const;
+
+	const BVHNode *GetRoot() const { return &m_nodes[0]; }
+	const BVHNode *GetLeft(const BVHNode *n) const { assert(!n->IsLeaf()); return n + 1; }
+	const BVHNode *GetRight(const BVHNode *n) const { assert(!n->IsLeaf()); return &m_nodes[n->offset]; }
+	const objPtr_t *GetObjs(const BVHNode *n) const { assert(n->IsLeaf()); return &m_objs[n->offset]; }
+
+	size_t GetNumNodes() const { return m_nodes.size(); }
+
 private:
-	void BuildNode(BVHNode *node,
-			const objPtr_t *objPtrs,
-			const Aabb *objAabbs,
-			std::vector<objPtr_t> &activeObjIdxs);
-	void MakeLeaf(BVHNode *node, const objPtr_t *objPtrs, std::vector<objPtr_t> &objs);
-	BVHNode *AllocNode() {
-		if (m_nodeAllocPos >= m_nodeAllocMax) Error("Out of space in m_bvhNodes.");
-		return &m_bvhNodes[m_nodeAllocPos++];
-	}
-	BVHNode *m_root;
-	objPtr_t *m_objPtrAlloc;
-	size_t m_objPtrAllocPos;
-	size_t m_objPtrAllocMax;
-
-	BVHNode *m_bvhNodes;
-	size_t m_nodeAllocPos;
-	size_t m_nodeAllocMax;
+	struct BuildObj {
+		objPtr_t ptr;
+		float min[3], max[3], centroid[3];
+	};
+	void BuildNode(Uint32 nodeIdx, std::vector<BuildObj> &objs, Uint32 begin, Uint32 end, int depth);
+	void MakeLeaf(Uint32 nodeIdx, const std::vector<BuildObj> &objs, Uint32 begin, Uint32 end);
+
+	std::vector<BVHNode> m_nodes;
+	std::vector<objPtr_t> m_objs;
 };
 
 #endif /* _BVHTREE_H */
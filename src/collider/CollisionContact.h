@@ -13,9 +13,13 @@ struct CollisionContact {
 	int triIdx;
 	void *userData1, *userData2;
 	int geomFlag;
+	// how far through the last step a swept geom hit (see Geom::SweepFrom),
+	// 1 for contacts found where the geoms are now. the position is then
+	// where they met rather than where they ended up
+	double timeOfImpact;
 //	bool vsStatic;		// true => object 2 was in static, else dynamic
 	CollisionContact() {
-		depth = 0; triIdx = -1; userData1 = userData2 = 0; geomFlag = 0; dist = 0;
+		depth = 0; triIdx = -1; userData1 = userData2 = 0; geomFlag = 0; dist = 0; timeOfImpact = 1.0;
 	}
 };
 
@@ -73,6 +73,36 @@ private:
 	void BuildNode(BvhNode *node, const std::list<Geom*> &a_geoms, int &outGeomPos);
 };
 
+// grow aabb by the geom's bounding sphere, from where it started if it's swept
+static void UpdateAabb(Aabb &aabb, const Geom *g)
+{
+	const double rad = g->GetGeomTree()->GetRadius();
+	const vector3d r(rad, rad, rad);
+	const vector3d p = g->GetPosition();
+	aabb.Update(p + r);
+	aabb.Update(p - r);
+	if (g->IsSwept()) {
+		const vector3d p0 = g->GetSweepStartPosition();
+		aabb.Update(p0 + r);
+		aabb.Update(p0 - r);
+	}
+}
+
+// do the bounding spheres come within touching over the step, each going
+// in a straight line from its sweep start (or staying put if it has none)
+static bool SpheresMeet(const Geom *a, const Geom *b)
+{
+	const vector3d d0 = a->GetSweepStartPosition() - b->GetSweepStartPosition();
+	const vector3d d1 = a->GetPosition() - b->GetPosition();
+	const vector3d dd = d1 - d0;
+	double t = 1.0;
+	const double ddLenSqr = dd.LengthSqr();
+	if (ddLenSqr > 0.0)
+		t = Clamp(-d0.Dot(dd) / ddLenSqr, 0.0, 1.0);
+	const double r = a->GetGeomTree()->GetRadius() + b->GetGeomTree()->GetRadius();
+	return (d0 + t*dd).LengthSqr() <= r*r;
+}
+
 BvhTree::BvhTree(const std::list<Geom*> &geoms)
 {
 	m_geoms = 0;
@@ -96,10 +126,6 @@ void BvhTree::CollideGeom(Geom *g, const Aabb &geomAabb, int minMailboxValue, vo
 {
 	if (!m_root) return;
 
-	// our big aabb
-	vector3d pos = g->GetPosition();
-	double radius = g->GetGeomTree()->GetRadius();
-
 	int stackPos = -1;
 	BvhNode *stack[16];
 	BvhNode *node = m_root;
@@ -113,9 +139,7 @@ void BvhTree::CollideGeom(Geom *g, const Aabb &geomAabb, int minMailboxValue, vo
 					if (g2->GetMailboxIndex() < minMailboxValue) continue;
 					if (g2 == g) continue;
 					if (g->GetGroup() && g2->GetGroup() == g->GetGroup()) continue;
-					double radius2 = g2->GetGeomTree()->GetRadius();
-					vector3d pos2 = g2->GetPosition();
-					if ((pos-pos2).Length() <= (radius + radius2)) {
+					if (SpheresMeet(g, g2)) {
 						g->Collide(g2, callback);
 					}
 				}
@@ -144,10 +168,7 @@ void BvhTree::BuildNode(BvhNode *node, const std::list<Geom*> &a_geoms, int &out
 
 	for (std::list<Geom*>::const_iterator i = a_geoms.begin();
 			i != a_geoms.end(); ++i) {
-		vector3d p = (*i)->GetPosition();
-		double rad = (*i)->GetGeomTree()->GetRadius();
-		aabb.Update(p + vector3d(rad,rad,rad));
-		aabb.Update(p - vector3d(rad,rad,rad));
+		UpdateAabb(aabb, *i);
 	}
 
 	// divide by longest axis
@@ -212,6 +233,8 @@ CollisionSpace::~CollisionSpace()
 
 void CollisionSpace::AddGeom(Geom *geom)
 {
+	// a sweep in some other space's coords means nothing here
+	geom->EndSweep();
 	m_geoms.push_back(geom);
 }
 
@@ -373,12 +396,10 @@ pop_jizz:
 void CollisionSpace::CollideGeoms(Geom *a, int minMailboxValue, void (*callback)(CollisionContact*))
 {
 	if (!a->IsEnabled()) return;
-	// our big aabb
-	vector3d pos = a->GetPosition();
-	double radius = a->GetGeomTree()->GetRadius();
+	// our big aabb, covering the whole step if we're swept
 	Aabb ourAabb;
-	ourAabb.min = pos - vector3d(radius, radius, radius);
-	ourAabb.max = pos + vector3d(radius, radius, radius);
+	ourAabb.min = ourAabb.max = a->GetPosition();
+	UpdateAabb(ourAabb, a);
 
 	if (m_staticObjectTree) m_staticObjectTree->CollideGeom(a, ourAabb, 0, callback);
 	if (m_dynamicObjectTree) m_dynamicObjectTree->CollideGeom(a, ourAabb, minMailboxValue, callback);
@@ -417,4 +438,9 @@ void CollisionSpace::Collide(void (*callback)(CollisionContact*))
 	for (std::list<Geom*>::iterator i = m_geoms.begin(); i != m_geoms.end(); ++i, mailboxMin++) {
 		CollideGeoms(*i, mailboxMin, callback);
 	}
+
+	// every sweep has been looked along now. the next is made by the next move
+	for (std::list<Geom*>::iterator i = m_geoms.begin(); i != m_geoms.end(); ++i) {
+		(*i)->EndSweep();
+	}
 }
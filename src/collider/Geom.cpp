@@ -8,11 +8,17 @@
 #include "BVHTree.h"
 
 static const unsigned int MAX_CONTACTS = 8;
+// geoms that move less than this much of their radius in a step can't get
+// through anything without being caught where they end up
+static const double SWEEP_MIN_DISTANCE = 0.25;
 
 Geom::Geom(const GeomTree *geomtree) :
 	m_mailboxIndex(0),
 	m_orient(matrix4x4d::Identity()),
 	m_invOrient(matrix4x4d::Identity()),
+	m_sweepStart(matrix4x4d::Identity()),
+	m_invSweepStart(matrix4x4d::Identity()),
+	m_swept(false),
 	m_active(true),
 	m_geomtree(geomtree),
 	m_data(nullptr),
@@ -31,6 +37,7 @@ void Geom::MoveTo(const matrix4x4d &m)
 {
 	m_orient = m;
 	m_invOrient = m.InverseOf();
+	EndSweep();
 }
 
 void Geom::MoveTo(const matrix4x4d &m, const vector3d &pos)
@@ -40,6 +47,36 @@ void Geom::MoveTo(const matrix4x4d &m, const vector3d &pos)
 	m_orient[13] = pos.y;
 	m_orient[14] = pos.z;
 	m_invOrient = m_orient.InverseOf();
+	EndSweep();
+}
+
+void Geom::SweepFrom(const matrix4x4d &m, const vector3d &pos)
+{
+	const double minDist = SWEEP_MIN_DISTANCE * m_geomtree->GetRadius();
+	if ((GetPosition() - pos).LengthSqr() < minDist*minDist) {
+		EndSweep();
+		return;
+	}
+	m_sweepStart = m;
+	m_sweepStart[12] = pos.x;
+	m_sweepStart[13] = pos.y;
+	m_sweepStart[14] = pos.z;
+	m_invSweepStart = m_sweepStart.InverseOf();
+	m_swept = true;
+}
+
+void Geom::EndSweep()
+{
+	m_sweepStart = m_orient;
+	m_invSweepStart = m_invOrient;
+	m_swept = false;
+}
+
+vector3d Geom::GetSweepStartPosition() const
+{
+	return vector3d(m_sweepStart[12],
+		m_sweepStart[13],
+		m_sweepStart[14]);
 }
 
 vector3d Geom::GetPosition() const
@@ -88,13 +125,112 @@ void Geom::Collide(Geom *b, void (*callback)(CollisionContact*))
 		b->CollideEdgesWithTrisOf(max_contacts, this, transTo, callback);
 	}
 
+	/* Nothing touching where they are now, but one of them may have
+	 * gone right through the other on the way */
+	if (max_contacts == int(MAX_CONTACTS) && (m_swept || b->m_swept))
+		CollideSwept(b, callback);
+
 //	t = SDL_GetTicks() - t;
 //	int numEdges = GetGeomTree()->GetNumEdges() + b->GetGeomTree()->GetNumEdges();
 //	Output("%d 'rays' in %dms (%f rps)\n", numEdges, t, 1000.0*numEdges / (double)t);
 }
 
-static bool rotatedAabbIsectsNormalOne(Aabb &a, const matrix4x4d &transA, Aabb &b)
+/*
+ * Time of impact for geoms that moved too far in the last step to be
+ * caught by their edges: trace each geom's vertices along their paths
+ * through the other's triangles and report the earliest hit, if any.
+ * Vertices of one hitting faces of the other is all this sees, but at
+ * the speeds that need it that's what a hit looks like.
+ */
+void Geom::CollideSwept(Geom *b, void (*callback)(CollisionContact*))
+{
+	double toi = 1.0;
+	CollisionContact contact;
+	SweepVerticesInto(b, toi, contact);
+	b->SweepVerticesInto(this, toi, contact);
+	if (toi < 1.0) {
+		contact.timeOfImpact = toi;
+		callback(&contact);
+	}
+}
+
+/*
+ * Trace this geom's vertices from where they were to where they are, in
+ * b's coordinates at each end, against b's triangle BVH. Only hits earlier
+ * than toi count; the earliest is put in contact and toi moved back to it.
+ */
+void Geom::SweepVerticesInto(const Geom *b, double &toi, CollisionContact &contact) const
 {
+	const GeomTree *tree = GetGeomTree();
+	const GeomTree *btree = b->m_geomtree;
+	const matrix4x4d from = b->m_invSweepStart * m_sweepStart;
+	const matrix4x4d to = b->m_invOrient * m_orient;
+	const Aabb &bAabb = btree->GetAabb();
+	const BVHNode *root = btree->m_triTree->GetRoot();
+
+	const int PACKET = GeomTree::RAY_PACKET_SIZE;
+	vector3d start[PACKET];
+	double len[PACKET];
+	vector3f origin[PACKET], dir[PACKET];
+	isect_t isect[PACKET];
+	int numRays = 0;
+
+	const int numVertices = tree->GetNumVertices();
+	for (int i=0; i<=numVertices; i++) {
+		if (i < numVertices) {
+			const vector3d v(&tree->m_vertices[3*i]);
+			const vector3d p0 = from * v;
+			const vector3d p1 = to * v;
+
+			// paths that miss b's box can't hit it
+			Aabb path;
+			path.min = path.max = p0;
+			path.Update(p1);
+			if (!path.Intersects(bAabb)) continue;
+
+			const vector3d d = p1 - p0;
+			const double l = d.Length();
+			if (l <= 0.0) continue;
+			const vector3d n = d / l;
+
+			start[numRays] = p0;
+			len[numRays] = l;
+			origin[numRays] = vector3f(float(p0.x), float(p0.y), float(p0.z));
+			dir[numRays] = vector3f(float(n.x), float(n.y), float(n.z));
+			isect[numRays].dist = float(l * toi);
+			isect[numRays].triIdx = -1;
+			if (++numRays < PACKET) continue;
+		}
+		if (!numRays) continue;
+
+		btree->TraceRayPacket(root, numRays, origin, dir, isect);
+
+		for (int r=0; r<numRays; r++) {
+			if (isect[r].triIdx == -1) continue;
+			const double t = isect[r].dist / len[r];
+			if (t >= toi) continue;
+			toi = t;
+
+			// b moved too, so find the point in world coords as of the hit
+			const vector3d hit = start[r] + vector3d(&dir[r].x)*double(isect[r].dist);
+			contact.pos = (1.0-t)*(b->m_sweepStart * hit) + t*(b->m_orient * hit);
+			const vector3f n = btree->GetTriNormal(isect[r].triIdx);
+			contact.normal = b->m_orient.ApplyRotationOnly(vector3d(n.x, n.y, n.z));
+			contact.dist = isect[r].dist;
+			// how far past the face it would have ended up
+			contact.depth = len[r] - isect[r].dist;
+			contact.triIdx = isect[r].triIdx;
+			contact.userData1 = m_data;
+			contact.userData2 = b->m_data;
+			contact.geomFlag = btree->GetTriFlag(isect[r].triIdx);
+		}
+		numRays = 0;
+	}
+}
+
+static Aabb rotatedAabb(const BVHNode *n, const matrix4x4d &transA)
+{
+	const Aabb a = n->GetAabb();
 	Aabb arot;
 	vector3d p[8];
 	p[0] = transA * vector3d(a.min.x, a.min.y, a.min.z);
@@ -107,7 +243,7 @@ static bool rotatedAabbIsectsNormalOne(Aabb &a, const matrix4x4d &transA, Aabb &
 	p[7] = transA * vector3d(a.max.x, a.max.y, a.max.z);
 	arot.min = arot.max = p[0];
 	for (int i=1; i<8; i++) arot.Update(p[i]);
-	return b.Intersects(arot);
+	return arot;
 }
 
 /*
@@ -117,52 +253,55 @@ static bool rotatedAabbIsectsNormalOne(Aabb &a, const matrix4x4d &transA, Aabb &
 void Geom::CollideEdgesWithTrisOf(int &maxContacts, Geom *b, const matrix4x4d &transTo, void (*callback)(CollisionContact*))
 {
 	struct stackobj {
-		BVHNode *edgeNode;
-		BVHNode *triNode;
-	} stack[32];
+		const BVHNode *edgeNode;
+		const BVHNode *triNode;
+	} stack[2*BVHTree::MAX_DEPTH+2];
 	int stackpos = 0;
 
-	stack[0].edgeNode = GetGeomTree()->m_edgeTree->GetRoot();
-	stack[0].triNode = b->GetGeomTree()->m_triTree->GetRoot();
+	const BVHTree *edgeTree = GetGeomTree()->m_edgeTree;
+	const BVHTree *triTree = b->GetGeomTree()->m_triTree;
+	stack[0].edgeNode = edgeTree->GetRoot();
+	stack[0].triNode = triTree->GetRoot();
 
 	while ((stackpos >= 0) && (maxContacts > 0)) {
-		BVHNode *edgeNode = stack[stackpos].edgeNode;
-		BVHNode *triNode = stack[stackpos].triNode;
+		const BVHNode *edgeNode = stack[stackpos].edgeNode;
+		const BVHNode *triNode = stack[stackpos].triNode;
 		stackpos--;
 
 		// does the edgeNode (with its aabb described in 6 planes transformed and rotated to
 		// b's coordinates) intersect with one or other of b's child nodes?
-		if (triNode->triIndicesStart || edgeNode->triIndicesStart) {
+		if (triNode->IsLeaf() || edgeNode->IsLeaf()) {
 			// reached triangle leaf node or edge leaf node.
 			// Intersect all edges under edgeNode with this leaf
 			CollideEdgesTris(maxContacts, edgeNode, transTo, b, triNode, callback);
 		} else {
-			BVHNode *left = triNode->kids[0];
-			BVHNode *right = triNode->kids[1];
-			bool edgeNodeIsectsLeftChild = rotatedAabbIsectsNormalOne(edgeNode->aabb, transTo, left->aabb);
-			bool edgeNodeIsectsRightChild = rotatedAabbIsectsNormalOne(edgeNode->aabb, transTo, right->aabb);
+			const BVHNode *left = triTree->GetLeft(triNode);
+			const BVHNode *right = triTree->GetRight(triNode);
+			const Aabb edgeAabb = rotatedAabb(edgeNode, transTo);
+			bool edgeNodeIsectsLeftChild = left->GetAabb().Intersects(edgeAabb);
+			bool edgeNodeIsectsRightChild = right->GetAabb().Intersects(edgeAabb);
 			//edgeNodeIsectsRightChild = edgeNodeIsectsLeftChild = true;
 			if (edgeNodeIsectsRightChild) {
 				if (edgeNodeIsectsLeftChild) {
 					// isects both. split edgeNode and try again
 					++stackpos;
-					stack[stackpos].edgeNode = edgeNode->kids[0];
+					stack[stackpos].edgeNode = edgeTree->GetLeft(edgeNode);
 					stack[stackpos].triNode = triNode;
 					++stackpos;
-					stack[stackpos].edgeNode = edgeNode->kids[1];
+					stack[stackpos].edgeNode = edgeTree->GetRight(edgeNode);
 					stack[stackpos].triNode = triNode;
 				} else {
 					// hits only right child. go down into that
 					// side with same edge node
 					++stackpos;
 					stack[stackpos].edgeNode = edgeNode;
-					stack[stackpos].triNode = triNode->kids[1];
+					stack[stackpos].triNode = right;
 				}
 			} else if (edgeNodeIsectsLeftChild) {
 				// hits only left child
 				++stackpos;
 				stack[stackpos].edgeNode = edgeNode;
-				stack[stackpos].triNode = triNode->kids[0];
+				stack[stackpos].triNode = left;
 			} else {
 				// hits none
 			}
@@ -172,57 +311,63 @@ void Geom::CollideEdgesWithTrisOf(int &maxContacts, Geom *b, const matrix4x4d &t
 
 /*
  * Collide one edgeNode (all edges below it) of this Geom with the triangle
- * BVH of another geom (b), starting from btriNode.
+ * BVH of another geom (b), starting from btriNode. The edges of a leaf are
+ * traced through b's tree a packet at a time.
  */
 void Geom::CollideEdgesTris(int &maxContacts, const BVHNode *edgeNode, const matrix4x4d &transToB,
 		Geom *b, const BVHNode *btriNode, void (*callback)(CollisionContact*))
 {
 	if (maxContacts <= 0) return;
-	if (edgeNode->triIndicesStart) {
+	const BVHTree *edgeTree = GetGeomTree()->m_edgeTree;
+	if (edgeNode->IsLeaf()) {
 		const GeomTree::Edge *edges = this->GetGeomTree()->GetEdges();
-		int numContacts = 0;
-		vector3f dir;
-		isect_t isect;
-		for (int i=0; i<edgeNode->numTris; i++) {
-			int vtxNum = edges[ edgeNode->triIndicesStart[i] ].v1i;
-			vector3d v1 = transToB * vector3d(&GetGeomTree()->m_vertices[vtxNum]);
-			vector3f _from(float(v1.x), float(v1.y), float(v1.z));
-
-			vector3d _dir(
-					double(edges[ edgeNode->triIndicesStart[i] ].dir.x),
-					double(edges[ edgeNode->triIndicesStart[i] ].dir.y),
-					double(edges[ edgeNode->triIndicesStart[i] ].dir.z));
-			_dir = transToB.ApplyRotationOnly(_dir);
-			dir = vector3f(&_dir.x);
-			isect.dist = edges[ edgeNode->triIndicesStart[i] ].len;
-			isect.triIdx = -1;
-
-			b->GetGeomTree()->TraceRay(btriNode, _from, dir, &isect);
-
-			if (isect.triIdx == -1) continue;
-			numContacts++;
-			const double depth = edges[ edgeNode->triIndicesStart[i] ].len - isect.dist;
-			// in world coords
-			CollisionContact contact;
-			contact.pos = b->GetTransform() * (v1 + vector3d(&dir.x)*double(isect.dist));
-			vector3f n = b->m_geomtree->GetTriNormal(isect.triIdx);
-			contact.normal = vector3d(n.x, n.y, n.z);
-			contact.normal = b->GetTransform().ApplyRotationOnly(contact.normal);
-			contact.dist = isect.dist;
-
-			contact.depth = depth;
-			contact.triIdx = isect.triIdx;
-			contact.userData1 = m_data;
-			contact.userData2 = b->m_data;
-			// contact geomFlag is bitwise OR of triangle's and edge's flags
-			contact.geomFlag = b->m_geomtree->GetTriFlag(isect.triIdx) |
-				edges[ edgeNode->triIndicesStart[i] ].triFlag;
-			callback(&contact);
-			if (--maxContacts <= 0) return;
+		const BVHTree::objPtr_t *edgeIdxs = edgeTree->GetObjs(edgeNode);
+		const int PACKET = GeomTree::RAY_PACKET_SIZE;
+
+		for (Uint32 first=0; first<edgeNode->numObjs; first+=PACKET) {
+			const int numRays = std::min<int>(PACKET, edgeNode->numObjs - first);
+			vector3d from[PACKET];
+			vector3f _from[PACKET], dir[PACKET];
+			isect_t isect[PACKET];
+
+			for (int r=0; r<numRays; r++) {
+				const GeomTree::Edge &edge = edges[ edgeIdxs[first+r] ];
+				from[r] = transToB * vector3d(&GetGeomTree()->m_vertices[edge.v1i]);
+				_from[r] = vector3f(float(from[r].x), float(from[r].y), float(from[r].z));
+
+				vector3d _dir(double(edge.dir.x), double(edge.dir.y), double(edge.dir.z));
+				_dir = transToB.ApplyRotationOnly(_dir);
+				dir[r] = vector3f(&_dir.x);
+				isect[r].dist = edge.len;
+				isect[r].triIdx = -1;
+			}
+
+			b->GetGeomTree()->TraceRayPacket(btriNode, numRays, _from, dir, isect);
+
+			for (int r=0; r<numRays; r++) {
+				if (isect[r].triIdx == -1) continue;
+				const GeomTree::Edge &edge = edges[ edgeIdxs[first+r] ];
+				const double depth = edge.len - isect[r].dist;
+				// in world coords
+				CollisionContact contact;
+				contact.pos = b->GetTransform() * (from[r] + vector3d(&dir[r].x)*double(isect[r].dist));
+				vector3f n = b->m_geomtree->GetTriNormal(isect[r].triIdx);
+				contact.normal = vector3d(n.x, n.y, n.z);
+				contact.normal = b->GetTransform().ApplyRotationOnly(contact.normal);
+				contact.dist = isect[r].dist;
+
+				contact.depth = depth;
+				contact.triIdx = isect[r].triIdx;
+				contact.userData1 = m_data;
+				contact.userData2 = b->m_data;
+				// contact geomFlag is bitwise OR of triangle's and edge's flags
+				contact.geomFlag = b->m_geomtree->GetTriFlag(isect[r].triIdx) | edge.triFlag;
+				callback(&contact);
+				if (--maxContacts <= 0) return;
+			}
 		}
 	} else {
-		CollideEdgesTris(maxContacts, edgeNode->kids[0], transToB, b, btriNode, callback);
-		CollideEdgesTris(maxContacts, edgeNode->kids[1], transToB, b, btriNode, callback);
+		CollideEdgesTris(maxContacts, edgeTree->GetLeft(edgeNode), transToB, b, btriNode, callback);
+		CollideEdgesTris(maxContacts, edgeTree->GetRight(edgeNode), transToB, b, btriNode, callback);
 	}
 }
-
@@ -22,10 +22,19 @@ public:
 	const matrix4x4d &GetTransform() const { return m_orient; }
 	matrix4x4d GetRotation() const;
 	vector3d GetPosition() const;
+	// the last move was a continuous one from m, pos (rather than a jump,
+	// as MoveTo is taken to be) so collisions along the way should be found
+	// too. only kept if it went far enough for the geom to tunnel
+	void SweepFrom(const matrix4x4d &m, const vector3d &pos);
+	void EndSweep();
+	bool IsSwept() const { return m_swept; }
+	// where the sweep began, or the current transform if there isn't one
+	const matrix4x4d &GetSweepStart() const { return m_sweepStart; }
+	vector3d GetSweepStartPosition() const;
 	void Enable() { m_active = true; }
 	void Disable() { m_active = false; }
 	bool IsEnabled() { return m_active; }
-	const GeomTree *GetGeomTree() { return m_geomtree; }
+	const GeomTree *GetGeomTree() const { return m_geomtree; }
 	void Collide(Geom *b, void (*callback)(CollisionContact*));
 	void CollideSphere(Sphere &sphere, void (*callback)(CollisionContact*));
 	void SetUserData(void *d) { m_data = d; }
@@ -43,8 +52,11 @@ private:
 		Geom *b, const BVHNode *btriNode, void (*callback)(CollisionContact*));
 	int m_mailboxIndex; // used to avoid duplicate collisions
 	void CollideEdges(const matrix4x4d &transToB, Geom *b, void (*callback)(CollisionContact*));
-	// double-buffer position so we can keep previous position
+	void CollideSwept(Geom *b, void (*callback)(CollisionContact*));
+	void SweepVerticesInto(const Geom *b, double &toi, CollisionContact &contact) const;
 	matrix4x4d m_orient, m_invOrient;
+	matrix4x4d m_sweepStart, m_invSweepStart;
+	bool m_swept;
 	bool m_active;
 	const GeomTree *m_geomtree;
 	void *m_data;
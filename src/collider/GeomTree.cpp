@@ -4,6 +4,7 @@
 #include "../libs.h"
 #include "GeomTree.h"
 #include "BVHTree.h"
+#include "../Serializer.h"
 
 int GeomTree::stats_rayTriIntersections;
 
@@ -135,21 +136,121 @@ GeomTree::GeomTree(int numVerts, int numTris, float *vertices, Uint16 *indices,
 	//Output("Edge tree of %d edges build in %dms\n", m_numEdges, SDL_GetTicks() - t);
 }
 
+// reads a count of things stored in itemSize bytes each, making sure that
+// many could be there at all
+static int ReadCount(Serializer::Reader &rd, size_t itemSize, Uint32 limit)
+{
+	if (rd.Remaining() < 4)
+		throw SavedGameCorruptException();
+	const Uint32 count = rd.Int32();
+	if (count > limit || count > rd.Remaining() / itemSize)
+		throw SavedGameCorruptException();
+	return count;
+}
+
+GeomTree::GeomTree(Serializer::Reader &rd)
+: m_numVertices(ReadCount(rd, 12, 0x10000)) // indices are 16 bits
+{
+	// nothing is kept until all of it has been read
+	std::unique_ptr<float[]> vertices(new float[m_numVertices*3]);
+	for (int i=0; i<m_numVertices*3; i++) vertices[i] = rd.Float();
+
+	m_numTris = ReadCount(rd, 10, std::numeric_limits<int>::max() / 3);
+	std::unique_ptr<Uint16[]> indices(new Uint16[m_numTris*3]);
+	for (int i=0; i<m_numTris*3; i++) indices[i] = rd.Int16();
+	std::unique_ptr<unsigned int[]> triFlags(new unsigned int[m_numTris]);
+	for (int i=0; i<m_numTris; i++) triFlags[i] = rd.Int32();
+
+	if (rd.Remaining() < 56)
+		throw SavedGameCorruptException();
+	m_radius = rd.Double();
+	m_aabb.min = rd.Vector3d();
+	m_aabb.max = rd.Vector3d();
+
+	// each triangle has three edges at most
+	m_numEdges = ReadCount(rd, 28, 3*m_numTris);
+	std::unique_ptr<Edge[]> edges(new Edge[m_numEdges]);
+	for (int i=0; i<m_numEdges; i++) {
+		Edge &e = edges[i];
+		e.v1i = rd.Int32();
+		e.v2i = rd.Int32();
+		e.len = rd.Float();
+		e.dir = rd.Vector3f();
+		e.triFlag = rd.Int32();
+	}
+
+	std::unique_ptr<BVHTree> triTree(new BVHTree(rd));
+	std::unique_ptr<BVHTree> edgeTree(new BVHTree(rd));
+
+	m_vertices = vertices.release();
+	m_indices = indices.release();
+	m_triFlags = triFlags.release();
+	m_edges = edges.release();
+	m_triTree = triTree.release();
+	m_edgeTree = edgeTree.release();
+}
+
+void GeomTree::Save(Serializer::Writer &wr) const
+{
+	// indices are saved with duplicate vertices already merged
+	wr.Int32(m_numVertices);
+	for (int i=0; i<m_numVertices*3; i++) wr.Float(m_vertices[i]);
+
+	wr.Int32(m_numTris);
+	for (int i=0; i<m_numTris*3; i++) wr.Int16(m_indices[i]);
+	for (int i=0; i<m_numTris; i++) wr.Int32(m_triFlags[i]);
+
+	wr.Double(m_radius);
+	wr.Vector3d(m_aabb.min);
+	wr.Vector3d(m_aabb.max);
+
+	wr.Int32(m_numEdges);
+	for (int i=0; i<m_numEdges; i++) {
+		const Edge &e = m_edges[i];
+		wr.Int32(e.v1i);
+		wr.Int32(e.v2i);
+		wr.Float(e.len);
+		wr.Vector3f(e.dir);
+		wr.Int32(e.triFlag);
+	}
+
+	m_triTree->Save(wr);
+	m_edgeTree->Save(wr);
+}
+
+bool GeomTree::IsValid() const
+{
+	if (m_numVertices <= 0 || m_numTris <= 0 || m_numEdges <= 0) return false;
+
+	for (int i=0; i<m_numTris*3; i++)
+		if (m_indices[i] >= m_numVertices) return false;
+
+	// edges hold offsets into m_vertices, not vertex numbers
+	const int vertexEnd = 3*m_numVertices - 2;
+	for (int i=0; i<m_numEdges; i++) {
+		const Edge &e = m_edges[i];
+		if (e.v1i < 0 || e.v1i >= vertexEnd || e.v2i < 0 || e.v2i >= vertexEnd) return false;
+	}
+
+	// and the triangle tree holds offsets into m_indices
+	return m_triTree->IsValid(3*m_numTris - 2) && m_edgeTree->IsValid(m_numEdges);
+}
+
 static bool SlabsRayAabbTest(const BVHNode *n, const vector3f &start, const vector3f &invDir, isect_t *isect)
 {
 	float
-	l1      = (n->aabb.min.x - start.x) * invDir.x,
-	l2      = (n->aabb.max.x - start.x) * invDir.x,
+	l1      = (n->min[0] - start.x) * invDir.x,
+	l2      = (n->max[0] - start.x) * invDir.x,
 	lmin    = std::min(l1,l2),
 	lmax    = std::max(l1,l2);
 
-	l1      = (n->aabb.min.y - start.y) * invDir.y;
-	l2      = (n->aabb.max.y - start.y) * invDir.y;
+	l1      = (n->min[1] - start.y) * invDir.y;
+	l2      = (n->max[1] - start.y) * invDir.y;
 	lmin    = std::max(std::min(l1,l2), lmin);
 	lmax    = std::min(std::max(l1,l2), lmax);
 
-	l1      = (n->aabb.min.z - start.z) * invDir.z;
-	l2      = (n->aabb.max.z - start.z) * invDir.z;
+	l1      = (n->min[2] - start.z) * invDir.z;
+	l2      = (n->max[2] - start.z) * invDir.z;
 	lmin    = std::max(std::min(l1,l2), lmin);
 	lmax    = std::min(std::max(l1,l2), lmax);
 
@@ -163,7 +264,7 @@ void GeomTree::TraceRay(const vector3f &start, const vector3f &dir, isect_t *ise
 
 void GeomTree::TraceRay(const BVHNode *currnode, const vector3f &a_origin, const vector3f &a_dir, isect_t *isect) const
 {
-	BVHNode *stack[32];
+	const BVHNode *stack[BVHTree::MAX_DEPTH+1];
 	int stackpos = -1;
 	vector3f invDir(1.0f/a_dir.x, 1.0f/a_dir.y, 1.0f/a_dir.z);
 
@@ -172,12 +273,15 @@ void GeomTree::TraceRay(const BVHNode *currnode, const vector3f &a_origin, const
 			if (!SlabsRayAabbTest(currnode, a_origin, invDir, isect)) goto pop_bstack;
 
 			stackpos++;
-			stack[stackpos] = currnode->kids[1];
-			currnode = currnode->kids[0];
+			stack[stackpos] = m_triTree->GetRight(currnode);
+			currnode = m_triTree->GetLeft(currnode);
 		}
-		// triangle intersection jizz
-		for (int i=0; i<currnode->numTris; i++) {
-			RayTriIntersect(1, a_origin, &a_dir, currnode->triIndicesStart[i], isect);
+		{
+			// triangle intersection jizz
+			const BVHTree::objPtr_t *tris = m_triTree->GetObjs(currnode);
+			for (Uint32 i=0; i<currnode->numObjs; i++) {
+				RayTriIntersect(1, a_origin, &a_dir, tris[i], isect);
+			}
 		}
 pop_bstack:
 		if (stackpos < 0) break;
@@ -187,7 +291,7 @@ pop_bstack:
 }
 
 struct bvhstack {
-	BVHNode *node;
+	const BVHNode *node;
 	int activeRay;
 };
 
@@ -201,7 +305,7 @@ void GeomTree::TraceCoherentRays(int numRays, const vector3f &a_origin, const ve
 
 void GeomTree::TraceCoherentRays(const BVHNode *currnode, int numRays, const vector3f &a_origin, const vector3f *a_dirs, isect_t *isects) const
 {
-	bvhstack stack[32];
+	bvhstack stack[BVHTree::MAX_DEPTH+1];
 	int stackpos = -1;
 	vector3f *invDirs = static_cast<vector3f*>(alloca(sizeof(vector3f)*numRays));
 	for (int i=0; i<numRays; i++) {
@@ -217,13 +321,16 @@ void GeomTree::TraceCoherentRays(const BVHNode *currnode, int numRays, const vec
 			if (activeRay < 0) goto pop_bstack;
 
 			stackpos++;
-			stack[stackpos].node = currnode->kids[1];
+			stack[stackpos].node = m_triTree->GetRight(currnode);
 			stack[stackpos].activeRay = activeRay;
-			currnode = currnode->kids[0];
+			currnode = m_triTree->GetLeft(currnode);
 		}
-		// triangle intersection jizz
-		for (int i=0; i<currnode->numTris; i++) {
-			RayTriIntersect(activeRay+1, a_origin, a_dirs, currnode->triIndicesStart[i], isects);
+		{
+			// triangle intersection jizz
+			const BVHTree::objPtr_t *tris = m_triTree->GetObjs(currnode);
+			for (Uint32 i=0; i<currnode->numObjs; i++) {
+				RayTriIntersect(activeRay+1, a_origin, a_dirs, tris[i], isects);
+			}
 		}
 pop_bstack:
 		if (stackpos < 0) break;
@@ -233,6 +340,72 @@ pop_bstack:
 	}
 }
 
+/*
+ * Packet of rays with separate origins, kept as one array per component so
+ * the box test below runs over all lanes at once. Lanes beyond numRays are
+ * given a zero length and never hit.
+ */
+namespace {
+	struct RayPacket {
+		float ox[GeomTree::RAY_PACKET_SIZE], oy[GeomTree::RAY_PACKET_SIZE], oz[GeomTree::RAY_PACKET_SIZE];
+		float ix[GeomTree::RAY_PACKET_SIZE], iy[GeomTree::RAY_PACKET_SIZE], iz[GeomTree::RAY_PACKET_SIZE];
+		float dist[GeomTree::RAY_PACKET_SIZE];
+	};
+
+	// bit i set if ray i hits the node closer than its current isect
+	inline int SlabsRayPacketAabbTest(const BVHNode *n, const RayPacket &r)
+	{
+		int hits = 0;
+		for (int i=0; i<GeomTree::RAY_PACKET_SIZE; i++) {
+			const float x1 = (n->min[0] - r.ox[i]) * r.ix[i], x2 = (n->max[0] - r.ox[i]) * r.ix[i];
+			const float y1 = (n->min[1] - r.oy[i]) * r.iy[i], y2 = (n->max[1] - r.oy[i]) * r.iy[i];
+			const float z1 = (n->min[2] - r.oz[i]) * r.iz[i], z2 = (n->max[2] - r.oz[i]) * r.iz[i];
+			const float lmin = std::max(std::max(std::min(x1,x2), std::min(y1,y2)), std::min(z1,z2));
+			const float lmax = std::min(std::min(std::max(x1,x2), std::max(y1,y2)), std::max(z1,z2));
+			hits |= int((lmax >= 0.f) & (lmax >= lmin) & (lmin < r.dist[i])) << i;
+		}
+		return hits;
+	}
+}
+
+void GeomTree::TraceRayPacket(const BVHNode *currnode, int numRays, const vector3f *a_origins, const vector3f *a_dirs, isect_t *isects) const
+{
+	assert(numRays > 0 && numRays <= RAY_PACKET_SIZE);
+
+	RayPacket r;
+	for (int i=0; i<RAY_PACKET_SIZE; i++) {
+		const int src = std::min(i, numRays-1);
+		r.ox[i] = a_origins[src].x; r.oy[i] = a_origins[src].y; r.oz[i] = a_origins[src].z;
+		r.ix[i] = 1.0f/a_dirs[src].x; r.iy[i] = 1.0f/a_dirs[src].y; r.iz[i] = 1.0f/a_dirs[src].z;
+		r.dist[i] = (i < numRays) ? isects[i].dist : 0.0f;
+	}
+
+	const BVHNode *stack[BVHTree::MAX_DEPTH+1];
+	int stackpos = -1;
+
+	for (;;) {
+		int hits = SlabsRayPacketAabbTest(currnode, r);
+		while (hits && !currnode->IsLeaf()) {
+			stackpos++;
+			stack[stackpos] = m_triTree->GetRight(currnode);
+			currnode = m_triTree->GetLeft(currnode);
+			hits = SlabsRayPacketAabbTest(currnode, r);
+		}
+		if (hits) {
+			const BVHTree::objPtr_t *tris = m_triTree->GetObjs(currnode);
+			for (int i=0; i<numRays; i++) {
+				if (!(hits & (1 << i))) continue;
+				for (Uint32 t=0; t<currnode->numObjs; t++)
+					RayTriIntersect(1, a_origins[i], &a_dirs[i], tris[t], &isects[i]);
+				r.dist[i] = isects[i].dist;
+			}
+		}
+		if (stackpos < 0) break;
+		currnode = stack[stackpos];
+		stackpos--;
+	}
+}
+
 void GeomTree::RayTriIntersect(int numRays, const vector3f &origin, const vector3f *dirs, int triIdx, isect_t *isects) const
 {
 	stats_rayTriIntersections++;
@@ -15,11 +15,22 @@ struct isect_t {
 
 class BVHTree;
 struct BVHNode;
+namespace Serializer { class Reader; class Writer; }
 
 class GeomTree {
 public:
+	// rays traced together by TraceRayPacket
+	static const int RAY_PACKET_SIZE = 4;
+
 	GeomTree(int numVerts, int numTris, float *vertices, Uint16 *indices, unsigned int *triflags);
+	// a tree stored with Save, complete with its BVHs. throws
+	// SavedGameCorruptException if its counts don't fit the data; nothing
+	// else in it has been checked until IsValid says so
+	GeomTree(Serializer::Reader &rd);
 	~GeomTree();
+	void Save(Serializer::Writer &wr) const;
+	// every index and offset in range, so it can be traversed safely
+	bool IsValid() const;
 	const Aabb &GetAabb() const { return m_aabb; }
 	// dir should be unit length,
 	// isect.dist should be ray length
@@ -29,6 +40,9 @@ public:
 	void TraceRay(const BVHNode *startNode, const vector3f &a_origin, const vector3f &a_dir, isect_t *isect) const;
 	void TraceCoherentRays(int numRays, const vector3f &a_origin, const vector3f *a_dirs, isect_t *isects) const;
 	void TraceCoherentRays(const BVHNode *startNode, int numRays, const vector3f &a_origin, const vector3f *a_dirs, isect_t *isects) const;
+	// up to RAY_PACKET_SIZE rays with their own origins, traversing the
+	// tree together. each isect as for TraceRay
+	void TraceRayPacket(const BVHNode *startNode, int numRays, const vector3f *a_origins, const vector3f *a_dirs, isect_t *isects) const;
 	vector3f GetTriNormal(int triIdx) const;
 	unsigned int GetTriFlag(int triIdx) const { return m_triFlags[triIdx]; }
 	double GetRadius() const { return m_radius; }
@@ -7,6 +7,7 @@
 #include "Sector.h"
 #include "Pi.h"
 #include "FileSystem.h"
+#include <vector>
 
 namespace Galaxy {
 
@@ -17,6 +18,11 @@ const float SOL_OFFSET_Y = 0.0;
 
 static SDL_Surface *s_galaxybmp;
 
+// a copy of the bitmap's pixels, so that sectors can be generated on any
+// thread without locking the surface
+static std::vector<Uint8> s_density;
+static int s_densityWidth, s_densityHeight;
+
 void Init()
 {
 	static const std::string filename("galaxy.bmp");
@@ -33,11 +39,20 @@ void Init()
 		Output("Galaxy: couldn't load: %s (%s)\n", filename.c_str(), SDL_GetError());
 		Pi::Quit();
 	}
+
+	s_densityWidth = s_galaxybmp->w;
+	s_densityHeight = s_galaxybmp->h;
+	s_density.resize(s_densityWidth * s_densityHeight);
+	SDL_LockSurface(s_galaxybmp);
+	for (int y = 0; y < s_densityHeight; y++)
+		memcpy(&s_density[y * s_densityWidth], static_cast<Uint8*>(s_galaxybmp->pixels) + y*s_galaxybmp->pitch, s_densityWidth);
+	SDL_UnlockSurface(s_galaxybmp);
 }
 
 void Uninit()
 {
 	if(s_galaxybmp) SDL_FreeSurface(s_galaxybmp);
+	std::vector<Uint8>().swap(s_density);
 }
 
 SDL_Surface *GetGalaxyBitmap()
@@ -54,12 +69,10 @@ Uint8 GetSectorDensity(int sx, int sy, int sz)
 	offset_x = Clamp((offset_x + 1.0)*0.5, 0.0, 1.0);
 	offset_y = Clamp((offset_y + 1.0)*0.5, 0.0, 1.0);
 
-	int x = int(floor(offset_x * (s_galaxybmp->w - 1)));
-	int y = int(floor(offset_y * (s_galaxybmp->h - 1)));
+	int x = int(floor(offset_x * (s_densityWidth - 1)));
+	int y = int(floor(offset_y * (s_densityHeight - 1)));
 
-	SDL_LockSurface(s_galaxybmp);
-	int val = static_cast<unsigned char*>(s_galaxybmp->pixels)[x + y*s_galaxybmp->pitch];
-	SDL_UnlockSurface(s_galaxybmp);
+	int val = s_density[x + y*s_densityWidth];
 	// crappy unrealistic but currently adequate density dropoff with sector z
 	val = val * (256 - std::min(abs(sz),256)) / 256;
 	// reduce density somewhat to match real (gliese) density
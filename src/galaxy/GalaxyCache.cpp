@@ -1,6 +1,7 @@
 // Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
+#include <algorithm>
 #include <utility>
 #include "libs.h"
 #include "Pi.h"
@@ -11,6 +12,25 @@
 
 //#define DEBUG_SECTOR_CACHE
 
+// the order paths are handed out to jobs in, so that each job gets a block
+// of neighbours rather than a row
+template <typename T>
+struct JobOrder {
+	bool operator()(const SystemPath &a, const SystemPath &b) const { return a < b; }
+};
+
+template <>
+struct JobOrder<Sector> {
+	static const int BLOCK_SHIFT = 2; // 4x4x4 sectors
+
+	bool operator()(const SystemPath &a, const SystemPath &b) const {
+		const SystemPath ba(a.sectorX >> BLOCK_SHIFT, a.sectorY >> BLOCK_SHIFT, a.sectorZ >> BLOCK_SHIFT);
+		const SystemPath bb(b.sectorX >> BLOCK_SHIFT, b.sectorY >> BLOCK_SHIFT, b.sectorZ >> BLOCK_SHIFT);
+		if (!ba.IsSameSector(bb)) return ba < bb;
+		return a < b;
+	}
+};
+
 //virtual
 
 template <typename T, typename CompareT>
@@ -180,17 +200,12 @@ template <typename T, typename CompareT>
 void GalaxyObjectCache<T,CompareT>::Slave::FillCache(const typename GalaxyObjectCache<T,CompareT>::PathVector& paths,
 	typename GalaxyObjectCache<T,CompareT>::CacheFilledCallback callback)
 {
-	// allocate some space for what we're about to chunk up
-	std::vector<std::unique_ptr<PathVector> > vec_paths;
-	vec_paths.reserve(paths.size()/CACHE_JOB_SIZE + 1);
-	std::unique_ptr<PathVector> current_paths;
+	PathVector missing;
 #	ifdef DEBUG_SECTOR_CACHE
 		size_t alreadyCached = m_cache.size();
 		unsigned masterCached = 0;
-		unsigned toBeCreated = 0;
 #	endif
 
-	// chop the paths into groups of CACHE_JOB_SIZE
 	for (auto it = paths.begin(), itEnd = paths.end(); it != itEnd; ++it) {
 		RefCountedPtr<T> s = m_master->GetIfCached(*it);
 		if (s) {
@@ -198,29 +213,22 @@ void GalaxyObjectCache<T,CompareT>::Slave::FillCache(const typename GalaxyObject
 #			ifdef DEBUG_SECTOR_CACHE
 				++masterCached;
 #			endif
-		} else {
-			if (!current_paths) {
-				current_paths.reset(new PathVector);
-				current_paths->reserve(CACHE_JOB_SIZE);
-			}
-			current_paths->push_back(*it);
-			if( current_paths->size() >= CACHE_JOB_SIZE ) {
-				vec_paths.push_back( std::move(current_paths) );
-			}
-#			ifdef DEBUG_SECTOR_CACHE
-				++toBeCreated;
-#			endif
-		}
+		} else
+			missing.push_back(*it);
 	}
 
-	// catch the last loop in case it's got some entries (could be less than the spread width)
-	if (current_paths) {
-		vec_paths.push_back( std::move(current_paths) );
+	// chop the rest into groups of CACHE_JOB_SIZE neighbours
+	std::sort(missing.begin(), missing.end(), JobOrder<T>());
+	std::vector<std::unique_ptr<PathVector> > vec_paths;
+	vec_paths.reserve(missing.size()/CACHE_JOB_SIZE + 1);
+	for (size_t first = 0; first < missing.size(); first += CACHE_JOB_SIZE) {
+		const size_t last = std::min(first + CACHE_JOB_SIZE, missing.size());
+		vec_paths.push_back(std::unique_ptr<PathVector>(new PathVector(missing.begin() + first, missing.begin() + last)));
 	}
 
 #	ifdef DEBUG_SECTOR_CACHE
-		Output("%s: FillCache: %zu cached, %u in master cache, %u to be created, will use %zu jobs\n", CACHE_NAME.c_str(),
-			alreadyCached, masterCached, toBeCreated, vec_paths.size());
+		Output("%s: FillCache: %zu cached, %u in master cache, %zu to be created, will use %zu jobs\n", CACHE_NAME.c_str(),
+			alreadyCached, masterCached, missing.size(), vec_paths.size());
 #	endif
 
 	// now add the batched jobs
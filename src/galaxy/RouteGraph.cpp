@@ -0,0 +1,123 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "RouteGraph.h"
+#include <algorithm>
+
+RouteGraph::RouteGraph(float sectorSize) : m_sectorSize(sectorSize), m_neighbourEntries(0)
+{
+}
+
+// squared distance from pos to the nearest point of a sector
+static float sector_distance_sqr(const vector3f &pos, const SystemPath &sec, float size)
+{
+	const float lo[3] = { sec.sectorX*size, sec.sectorY*size, sec.sectorZ*size };
+	const float p[3] = { pos.x, pos.y, pos.z };
+	float d2 = 0.f;
+	for (int i = 0; i < 3; i++) {
+		const float d = std::max(std::max(lo[i] - p[i], p[i] - (lo[i] + size)), 0.f);
+		d2 += d*d;
+	}
+	return d2;
+}
+
+void RouteGraph::AddSector(const SystemPath &path, const std::vector<vector3f> &systems)
+{
+	if (m_sectors.count(path))
+		return;
+
+	SectorNodes sn;
+	sn.first = m_nodes.size();
+	sn.count = systems.size();
+	m_sectors.insert(std::make_pair(path, sn));
+
+	for (Uint32 i = 0; i < sn.count; i++) {
+		Node n;
+		n.pos = systems[i];
+		n.sx = path.sectorX;
+		n.sy = path.sectorY;
+		n.sz = path.sectorZ;
+		n.systemIndex = i;
+		n.neighbours = NO_NODE;
+		m_nodes.push_back(n);
+	}
+}
+
+Uint32 RouteGraph::FindNode(const SystemPath &path) const
+{
+	auto it = m_sectors.find(path);
+	if (it == m_sectors.end())
+		return NO_NODE;
+	assert(path.systemIndex < it->second.count);
+	return it->second.first + path.systemIndex;
+}
+
+SystemPath RouteGraph::GetPath(Uint32 node) const
+{
+	const Node &n = m_nodes[node];
+	return SystemPath(n.sx, n.sy, n.sz, n.systemIndex);
+}
+
+const RouteGraph::NeighbourList *RouteGraph::GetNeighbours(Uint32 node, float range, std::vector<SystemPath> &missing)
+{
+	const Node n = m_nodes[node];
+	if (n.neighbours != NO_NODE && m_neighbours[n.neighbours].range >= range)
+		return &m_neighbours[n.neighbours];
+
+	// the sectors the jump range reaches into
+	const int k = int(ceilf(range / m_sectorSize));
+	const size_t numMissing = missing.size();
+	std::vector<SectorNodes> cells;
+	for (int dx = -k; dx <= k; dx++)
+		for (int dy = -k; dy <= k; dy++)
+			for (int dz = -k; dz <= k; dz++) {
+				const SystemPath cell(n.sx + dx, n.sy + dy, n.sz + dz);
+				if (sector_distance_sqr(n.pos, cell, m_sectorSize) > range*range)
+					continue;
+				auto it = m_sectors.find(cell);
+				if (it == m_sectors.end())
+					missing.push_back(cell);
+				else
+					cells.push_back(it->second);
+			}
+	if (missing.size() != numMissing)
+		return nullptr;
+
+	NeighbourList list;
+	list.range = range;
+	for (const SectorNodes &cell : cells) {
+		for (Uint32 i = cell.first; i < cell.first + cell.count; i++) {
+			if (i == node) continue;
+			const float dist = (m_nodes[i].pos - n.pos).Length();
+			if (dist <= range)
+				list.nodes.push_back(std::make_pair(dist, i));
+		}
+	}
+	std::sort(list.nodes.begin(), list.nodes.end());
+
+	m_neighbourEntries += list.nodes.size();
+	if (n.neighbours == NO_NODE) {
+		m_nodes[node].neighbours = m_neighbours.size();
+		m_neighbours.push_back(std::move(list));
+	} else {
+		m_neighbourEntries -= m_neighbours[n.neighbours].nodes.size();
+		m_neighbours[n.neighbours] = std::move(list);
+	}
+	return &m_neighbours[m_nodes[node].neighbours];
+}
+
+void RouteGraph::ClearNeighbours()
+{
+	m_neighbours.clear();
+	m_neighbourEntries = 0;
+	for (Node &n : m_nodes)
+		n.neighbours = NO_NODE;
+}
+
+void RouteGraph::Clear()
+{
+	m_sectors.clear();
+	m_nodes.clear();
+	m_neighbours.clear();
+	m_neighbourEntries = 0;
+}
@@ -0,0 +1,76 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _ROUTEGRAPH_H
+#define _ROUTEGRAPH_H
+
+#include "libs.h"
+#include "galaxy/SystemPath.h"
+#include <unordered_map>
+#include <vector>
+
+// The systems RoutePlanner searches, kept by sector, and the neighbour lists
+// built over them. It doesn't know where sectors come from: a neighbour list
+// that reaches into a sector it hasn't been given says which are missing.
+class RouteGraph {
+public:
+	static const Uint32 NO_NODE = ~Uint32(0);
+
+	struct SectorHash {
+		size_t operator()(const SystemPath &p) const {
+			return size_t(p.sectorX) * 73856093u ^ size_t(p.sectorY) * 19349663u ^ size_t(p.sectorZ) * 83492791u;
+		}
+	};
+	struct SectorEqual {
+		bool operator()(const SystemPath &a, const SystemPath &b) const { return a.IsSameSector(b); }
+	};
+
+	// sorted by distance, so a shorter range is a prefix of the list
+	struct NeighbourList {
+		float range;
+		std::vector<std::pair<float, Uint32> > nodes;
+	};
+
+	explicit RouteGraph(float sectorSize);
+
+	// the positions of the sector's systems from Sol in ly, by system index
+	void AddSector(const SystemPath &path, const std::vector<vector3f> &systems);
+	bool HasSector(const SystemPath &path) const { return m_sectors.count(path) != 0; }
+
+	// NO_NODE if the system's sector hasn't been added
+	Uint32 FindNode(const SystemPath &path) const;
+	SystemPath GetPath(Uint32 node) const;
+	const vector3f &GetPosition(Uint32 node) const { return m_nodes[node].pos; }
+	size_t GetNumNodes() const { return m_nodes.size(); }
+
+	// the systems within range of node, or null if some of the sectors
+	// that takes aren't there, and then those are added to missing
+	const NeighbourList *GetNeighbours(Uint32 node, float range, std::vector<SystemPath> &missing);
+
+	// entries in all the neighbour lists, counted as they're built
+	size_t GetNumNeighbourEntries() const { return m_neighbourEntries; }
+	// throw the neighbour lists away, to be built again as needed
+	void ClearNeighbours();
+	void Clear();
+
+private:
+	struct SectorNodes {
+		Uint32 first;
+		Uint32 count;
+	};
+
+	struct Node {
+		vector3f pos;
+		Sint32 sx, sy, sz;
+		Uint32 systemIndex;
+		Uint32 neighbours; // index into m_neighbours, or NO_NODE
+	};
+
+	float m_sectorSize;
+	std::unordered_map<SystemPath, SectorNodes, SectorHash, SectorEqual> m_sectors;
+	std::vector<Node> m_nodes;
+	std::vector<NeighbourList> m_neighbours;
+	size_t m_neighbourEntries;
+};
+
+#endif /* _ROUTEGRAPH_H */
@@ -0,0 +1,367 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "RoutePlanner.h"
+#include "Sector.h"
+#include "Pi.h"
+#include <algorithm>
+
+// expansions a query gets before the next one has a turn
+static const Uint32 QUERY_SLICE = 256;
+// sectors asked for along the line between the ends when a query starts
+static const size_t MAX_CORRIDOR_SECTORS = 20000;
+// neighbour list entries kept before they're all thrown away and rebuilt
+// as needed. each is 8 bytes
+static const size_t MAX_NEIGHBOUR_ENTRIES = 8*1024*1024;
+// how much a jump's length counts next to the jump itself, small enough
+// that it only ever breaks ties
+static const float JUMP_DISTANCE_WEIGHT = 1e-3f;
+// systems kept while idle before everything is thrown away
+static const size_t MAX_IDLE_NODES = 1024*1024;
+
+struct RoutePlanner::Query {
+	struct Open {
+		float f, g;
+		Uint32 node;
+	};
+	// heap order: least f on top, ties to the one furthest along
+	struct OpenOrder {
+		bool operator()(const Open &a, const Open &b) const {
+			return a.f > b.f || (a.f == b.f && a.g < b.g);
+		}
+	};
+	struct Visit {
+		float g;
+		Uint32 parent;
+		bool closed;
+	};
+
+	QueryId id;
+	SystemPath from, to;
+	Params params;
+	float rangeMax; // of the drive, for fuel
+	RouteCallback callback;
+
+	Uint32 start, goal;
+	vector3f goalPos;
+	bool started;
+	bool done;
+	Uint32 expanded;
+
+	std::vector<Open> open;
+	std::vector<Open> waiting; // for their sectors
+	std::unordered_map<Uint32, Visit> visited;
+};
+
+RoutePlanner::RoutePlanner() : m_graph(Sector::SIZE), m_nextId(0), m_nextQuery(0)
+{
+	m_sectorCache = Sector::cache.NewSlaveCache();
+}
+
+RoutePlanner::~RoutePlanner()
+{
+}
+
+RoutePlanner::QueryId RoutePlanner::Plan(const SystemPath &from, const SystemPath &to, const Params &params, RouteCallback callback)
+{
+	assert(from.HasValidSystem() && to.HasValidSystem());
+
+	std::unique_ptr<Query> q(new Query);
+	q->id = ++m_nextId;
+	q->from = from.SystemOnly();
+	q->to = to.SystemOnly();
+	q->params = params;
+	q->rangeMax = params.hyperclass > 0 ? Pi::CalcHyperspaceRangeMax(params.hyperclass, int(params.mass)) : 0.f;
+	// fuel per jump stops growing past the drive's range, so the heuristic
+	// only holds up to it. the drive can't go further anyway
+	if (params.cost == COST_FUEL)
+		q->params.range = std::min(q->params.range, q->rangeMax);
+	q->callback = callback;
+	q->start = q->goal = NO_NODE;
+	q->started = false;
+	q->done = false;
+	q->expanded = 0;
+
+	if (q->params.range <= 0.f || (params.cost == COST_FUEL && params.hyperclass <= 0)) {
+		Finish(*q, false);
+		return q->id;
+	}
+
+	RequestCorridor(*q);
+	m_queries.push_back(std::move(q));
+	return m_queries.back()->id;
+}
+
+void RoutePlanner::Cancel(QueryId id)
+{
+	for (auto it = m_queries.begin(); it != m_queries.end(); ++it) {
+		if ((*it)->id == id) {
+			m_queries.erase(it);
+			return;
+		}
+	}
+}
+
+void RoutePlanner::Update(Uint32 budget)
+{
+	PROFILE_SCOPED()
+
+	// take in whatever has been generated since last time
+	for (auto it = m_sectorCache->Begin(); it != m_sectorCache->End(); ++it)
+		AddSector(it->second.Get());
+	m_sectorCache->ClearCache();
+
+	if (m_queries.empty() && m_graph.GetNumNodes() > MAX_IDLE_NODES)
+		Clear();
+	if (m_graph.GetNumNeighbourEntries() > MAX_NEIGHBOUR_ENTRIES)
+		m_graph.ClearNeighbours();
+
+	// a slice for each query in turn, until the budget is gone or every
+	// query is waiting for sectors
+	bool progress = true;
+	while (budget && progress && !m_queries.empty()) {
+		progress = false;
+		for (size_t n = m_queries.size(); n && budget; n--) {
+			if (m_nextQuery >= m_queries.size())
+				m_nextQuery = 0;
+			Query &q = *m_queries[m_nextQuery];
+
+			Uint32 slice = std::min(budget, QUERY_SLICE);
+			const Uint32 sliceStart = slice;
+			if (Step(q, slice))
+				progress = true;
+			budget -= sliceStart - slice;
+
+			if (q.done)
+				m_queries.erase(m_queries.begin() + m_nextQuery);
+			else
+				m_nextQuery++;
+		}
+	}
+
+	// answers last, since their callbacks may well start new queries
+	std::vector<std::pair<RouteCallback, Route> > finished;
+	finished.swap(m_finished);
+	for (auto &f : finished)
+		if (f.first) f.first(f.second);
+}
+
+void RoutePlanner::Clear()
+{
+	assert(m_queries.empty());
+	m_graph.Clear();
+}
+
+void RoutePlanner::AddSector(Sector *sec)
+{
+	const SystemPath path = sec->GetSystemPath();
+	m_requested.erase(path);
+	if (m_graph.HasSector(path))
+		return;
+
+	std::vector<vector3f> systems(sec->GetNumSystems());
+	for (Uint32 i = 0; i < systems.size(); i++)
+		systems[i] = sec->GetFullPosition(i);
+	m_graph.AddSector(path, systems);
+}
+
+void RoutePlanner::RequestSectors(const std::vector<SystemPath> &paths)
+{
+	SectorCache::PathVector wanted;
+	for (const SystemPath &path : paths) {
+		if (m_graph.HasSector(path) || m_requested.count(path))
+			continue;
+		m_requested.insert(path);
+		wanted.push_back(path);
+	}
+	if (!wanted.empty())
+		m_sectorCache->FillCache(wanted);
+}
+
+void RoutePlanner::RequestCorridor(const Query &q)
+{
+	// every sector the search could start with, in order along the line
+	const int k = int(ceilf(q.params.range / Sector::SIZE));
+	const vector3f a(float(q.from.sectorX), float(q.from.sectorY), float(q.from.sectorZ));
+	const vector3f b(float(q.to.sectorX), float(q.to.sectorY), float(q.to.sectorZ));
+	const int steps = std::max(1, int(ceilf(std::max(std::max(fabs(b.x-a.x), fabs(b.y-a.y)), fabs(b.z-a.z)))));
+
+	std::vector<SystemPath> paths;
+	std::unordered_set<SystemPath, RouteGraph::SectorHash, RouteGraph::SectorEqual> seen;
+	for (int i = 0; i <= steps && paths.size() < MAX_CORRIDOR_SECTORS; i++) {
+		const vector3f p = a + (b - a) * (float(i) / float(steps));
+		const int cx = int(floorf(p.x + 0.5f)), cy = int(floorf(p.y + 0.5f)), cz = int(floorf(p.z + 0.5f));
+		for (int dx = -k; dx <= k; dx++)
+			for (int dy = -k; dy <= k; dy++)
+				for (int dz = -k; dz <= k; dz++) {
+					const SystemPath path(cx + dx, cy + dy, cz + dz);
+					if (seen.insert(path).second)
+						paths.push_back(path);
+				}
+	}
+	RequestSectors(paths);
+}
+
+Uint32 RoutePlanner::FindNode(const SystemPath &path)
+{
+	const Uint32 node = m_graph.FindNode(path);
+	if (node == NO_NODE)
+		RequestSectors(std::vector<SystemPath>(1, path));
+	return node;
+}
+
+const RoutePlanner::NeighbourList *RoutePlanner::GetNeighbours(Uint32 node, float range)
+{
+	std::vector<SystemPath> missing;
+	const NeighbourList *list = m_graph.GetNeighbours(node, range, missing);
+	if (!list)
+		RequestSectors(missing);
+	return list;
+}
+
+float RoutePlanner::EdgeCost(const Query &q, float dist) const
+{
+	switch (q.params.cost) {
+		case COST_JUMPS:
+			// between routes with as many jumps, the shorter
+			return 1.f + JUMP_DISTANCE_WEIGHT * dist / q.params.range;
+		case COST_FUEL:
+			return Pi::CalcHyperspaceFuelOut(q.params.hyperclass, dist, q.rangeMax);
+		case COST_DISTANCE:
+		default:
+			return dist;
+	}
+}
+
+// never more than the cost of the rest of the way, and never drops by more
+// than the cost of a jump, so a system is only expanded twice if one was
+// set aside waiting for its sectors
+float RoutePlanner::Heuristic(const Query &q, Uint32 node) const
+{
+	const float dist = (q.goalPos - m_graph.GetPosition(node)).Length();
+	switch (q.params.cost) {
+		case COST_JUMPS:
+			return (1.f + JUMP_DISTANCE_WEIGHT) * dist / q.params.range;
+		case COST_FUEL: {
+			// each jump costs at least 1, and at least its share of the
+			// fuel for the whole distance
+			const float hc = float(q.params.hyperclass);
+			return std::max(dist / q.params.range, hc*hc*dist / q.rangeMax);
+		}
+		case COST_DISTANCE:
+		default:
+			return dist;
+	}
+}
+
+bool RoutePlanner::Step(Query &q, Uint32 &budget)
+{
+	if (!q.started) {
+		if (q.start == NO_NODE) q.start = FindNode(q.from);
+		if (q.goal == NO_NODE) q.goal = FindNode(q.to);
+		if (q.start == NO_NODE || q.goal == NO_NODE)
+			return false;
+
+		q.goalPos = m_graph.GetPosition(q.goal);
+		Query::Visit v = { 0.f, NO_NODE, false };
+		q.visited.insert(std::make_pair(q.start, v));
+		Query::Open o = { Heuristic(q, q.start), 0.f, q.start };
+		q.open.push_back(o);
+		q.started = true;
+	}
+
+	// systems set aside for their sectors go back in to be tried again
+	for (const Query::Open &o : q.waiting) {
+		q.open.push_back(o);
+		std::push_heap(q.open.begin(), q.open.end(), Query::OpenOrder());
+	}
+	q.waiting.clear();
+
+	bool progress = false;
+	while (budget) {
+		if (q.open.empty()) {
+			if (!q.waiting.empty())
+				return progress;
+			Finish(q, false);
+			return true;
+		}
+		if (q.expanded >= q.params.maxSystems) {
+			Finish(q, false);
+			return true;
+		}
+
+		const Query::Open top = q.open.front();
+		std::pop_heap(q.open.begin(), q.open.end(), Query::OpenOrder());
+		q.open.pop_back();
+
+		Query::Visit &visit = q.visited[top.node];
+		if (visit.closed || top.g > visit.g)
+			continue; // superseded by a cheaper way there
+
+		if (top.node == q.goal) {
+			// anything set aside could still be on a cheaper route
+			if (!q.waiting.empty()) {
+				q.open.push_back(top);
+				std::push_heap(q.open.begin(), q.open.end(), Query::OpenOrder());
+				return progress;
+			}
+			Finish(q, true);
+			return true;
+		}
+
+		const NeighbourList *list = GetNeighbours(top.node, q.params.range);
+		if (!list) {
+			// carry on with the rest rather than wait. that can reach a
+			// system the long way round first, hence reopening below
+			q.waiting.push_back(top);
+			continue;
+		}
+
+		visit.closed = true;
+		q.expanded++;
+		budget--;
+		progress = true;
+
+		for (const auto &nb : list->nodes) {
+			if (nb.first > q.params.range) break;
+			const float g = top.g + EdgeCost(q, nb.first);
+			auto it = q.visited.find(nb.second);
+			if (it != q.visited.end()) {
+				if (it->second.g <= g) continue;
+				it->second.g = g;
+				it->second.parent = top.node;
+				it->second.closed = false;
+			} else {
+				Query::Visit v = { g, top.node, false };
+				q.visited.insert(std::make_pair(nb.second, v));
+			}
+			Query::Open o = { g + Heuristic(q, nb.second), g, nb.second };
+			q.open.push_back(o);
+			std::push_heap(q.open.begin(), q.open.end(), Query::OpenOrder());
+		}
+	}
+	return progress;
+}
+
+void RoutePlanner::Finish(Query &q, bool found)
+{
+	Route route;
+	if (found) {
+		for (Uint32 node = q.goal; node != NO_NODE; node = q.visited[node].parent)
+			route.systems.push_back(m_graph.GetPath(node));
+		std::reverse(route.systems.begin(), route.systems.end());
+
+		for (Uint32 node = q.goal; q.visited[node].parent != NO_NODE; node = q.visited[node].parent) {
+			const float dist = (m_graph.GetPosition(node) - m_graph.GetPosition(q.visited[node].parent)).Length();
+			route.distance += dist;
+			if (q.params.hyperclass > 0)
+				route.fuel += int(Pi::CalcHyperspaceFuelOut(q.params.hyperclass, dist, q.rangeMax));
+		}
+	}
+
+	q.done = true;
+	q.open.clear();
+	q.waiting.clear();
+	q.visited.clear();
+	m_finished.push_back(std::make_pair(q.callback, route));
+}
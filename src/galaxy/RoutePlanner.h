@@ -0,0 +1,105 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _ROUTEPLANNER_H
+#define _ROUTEPLANNER_H
+
+#include "libs.h"
+#include "galaxy/GalaxyCache.h"
+#include "galaxy/RouteGraph.h"
+#include "galaxy/SystemPath.h"
+#include <functional>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+class Sector;
+
+// Multi-jump routes between systems: A* over the systems, where the
+// neighbours of a system are the systems within jump range of it.
+//
+// Sectors are the spatial index. Everything within range of a system is in
+// the sectors within ceil(range / Sector::SIZE) of its own, so a system's
+// neighbour list is built from those the first time the search reaches it.
+// The systems and neighbour lists are kept in a RouteGraph.
+// The sectors are generated in the background through a SectorCache slave;
+// a query that reaches one that isn't there yet waits for it, and the
+// sectors along the straight line between the ends are asked for up front.
+//
+// Any number of queries can be in flight, sharing sectors and neighbour
+// lists, and Update shares out the work between them.
+class RoutePlanner {
+public:
+	enum Cost {
+		COST_JUMPS,
+		COST_DISTANCE,
+		COST_FUEL
+	};
+
+	struct Params {
+		Params() : range(10.f), cost(COST_DISTANCE), hyperclass(1), mass(1.f), maxSystems(100000) {}
+		float range;       // longest single jump, ly
+		Cost cost;
+		int hyperclass;    // drive class and ship mass in tonnes, for COST_FUEL
+		float mass;
+		Uint32 maxSystems; // give up after searching this many
+	};
+
+	struct Route {
+		Route() : distance(0.f), fuel(0) {}
+		// both ends included, empty if there's no route
+		std::vector<SystemPath> systems;
+		float distance; // ly
+		int fuel;       // tonnes, if it were flown with the drive in Params
+	};
+
+	typedef Uint32 QueryId;
+	typedef std::function<void(const Route &)> RouteCallback;
+
+	RoutePlanner();
+	~RoutePlanner();
+
+	// start planning. the callback is called from Update once there's an
+	// answer, unless the query has been cancelled
+	QueryId Plan(const SystemPath &from, const SystemPath &to, const Params &params, RouteCallback callback);
+	void Cancel(QueryId id);
+
+	// take in newly generated sectors and advance the queries, expanding at
+	// most budget systems between them. call once a frame, after the job
+	// queue has been finished
+	void Update(Uint32 budget = 2000);
+
+	bool IsIdle() const { return m_queries.empty(); }
+
+	// forget all sectors and neighbour lists. only when idle
+	void Clear();
+
+private:
+	static const Uint32 NO_NODE = RouteGraph::NO_NODE;
+	typedef RouteGraph::NeighbourList NeighbourList;
+
+	struct Query;
+
+	void AddSector(Sector *sec);
+	void RequestSectors(const std::vector<SystemPath> &paths);
+	void RequestCorridor(const Query &q);
+	Uint32 FindNode(const SystemPath &path);
+	const NeighbourList *GetNeighbours(Uint32 node, float range);
+
+	// false if it got nowhere for want of sectors
+	bool Step(Query &q, Uint32 &budget);
+	void Finish(Query &q, bool found);
+	float EdgeCost(const Query &q, float dist) const;
+	float Heuristic(const Query &q, Uint32 node) const;
+
+	RefCountedPtr<SectorCache::Slave> m_sectorCache;
+	RouteGraph m_graph;
+	std::unordered_set<SystemPath, RouteGraph::SectorHash, RouteGraph::SectorEqual> m_requested;
+
+	QueryId m_nextId;
+	std::vector<std::unique_ptr<Query> > m_queries;
+	size_t m_nextQuery; // round robin
+	std::vector<std::pair<RouteCallback, Route> > m_finished;
+};
+
+#endif /* _ROUTEPLANNER_H */
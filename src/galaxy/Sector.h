@@ -7,15 +7,14 @@
 #include "libs.h"
 #include "galaxy/SystemPath.h"
 #include "galaxy/StarSystem.h"
+#include "galaxy/SectorSystems.h"
 #include "GalaxyCache.h"
 #include "RefCounted.h"
 #include <string>
-#include <vector>
-
-class Faction;
 
 class Sector : public RefCounted {
 	friend class GalaxyObjectCache<Sector, SystemPath::LessSectorOnly>;
+	friend class SystemNameIndex;
 
 public:
 	// lightyears
@@ -27,6 +26,9 @@ public:
 
 	static SectorCache cache;
 
+	// one of its own, for threads that mustn't touch the cache
+	static RefCountedPtr<const Sector> Generate(const SystemPath &path) { return RefCountedPtr<const Sector>(new Sector(path, nullptr)); }
+
 	// Sector is within a bounding rectangle - used for SectorView m_sectorCache pruning.
 	bool WithinBox(const int Xmin, const int Xmax, const int Ymin, const int Ymax, const int Zmin, const int Zmax) const;
 	bool Contains(const SystemPath &sysPath) const;
@@ -34,33 +36,20 @@ public:
 	// get the SystemPath for this sector
 	SystemPath GetSystemPath() const { return SystemPath(sx, sy, sz); }
 
-	class System {
-	public:
-		System(int x, int y, int z, Uint32 si): numStars(0), seed(0), faction(nullptr), population(-1),
-			explored(false), sx(x), sy(y), sz(z), idx(si) {};
-		~System() {};
-
-		// Check that we've had our habitation status set
-
-		// public members
-		std::string name;
-		vector3f p;
-		int numStars;
-		SystemBody::BodyType starType[4];
-		Uint32 seed;
-		Faction *faction;
-		fixed population;
-		bool explored;
-
-		vector3f FullPosition() { return Sector::SIZE*vector3f(float(sx), float(sy), float(sz)) + p; };
-		bool IsSameSystem(const SystemPath &b) const {
-			return sx == b.sectorX && sy == b.sectorY && sz == b.sectorZ && idx == b.systemIndex;
-		}
-
-		const int sx, sy, sz;
-		const Uint32 idx;
-	};
-	std::vector<System> m_systems;
+	// the systems (see SectorSystems)
+	Uint32 GetNumSystems() const { return m_systems.GetNumSystems(); }
+	SystemPath GetSystemPath(Uint32 idx) const { assert(idx < GetNumSystems()); return SystemPath(sx, sy, sz, idx); }
+
+	// within the sector
+	vector3f GetPosition(Uint32 idx) const { return m_systems.GetPosition(idx); }
+	// from the origin of sector 0,0,0
+	vector3f GetFullPosition(Uint32 idx) const { return Sector::SIZE*vector3f(float(sx), float(sy), float(sz)) + GetPosition(idx); }
+
+	int GetNumStars(Uint32 idx) const { return m_systems.GetNumStars(idx); }
+	SystemBody::BodyType GetStarType(Uint32 idx, int star) const { return m_systems.GetStarType(idx, star); }
+	bool IsExplored(Uint32 idx) const { return m_systems.IsExplored(idx); }
+
+	std::string GetName(Uint32 idx) const { return m_systems.GetName(idx); }
 
 	void Dump(FILE* file, const char* indent = "") const;
 
@@ -71,10 +60,10 @@ private:
 	int sx, sy, sz;
 	SectorCache* m_cache;
 
+	SectorSystems m_systems;
+
 	Sector(const SystemPath& path, SectorCache* cache); // Only SectorCache(Job) are allowed to create sectors
 	void SetCache(SectorCache* cache) { assert(!m_cache); m_cache = cache; }
-	const std::string GenName(System &sys, int si, Random &rand);
-	// sets appropriate factions for all systems in the sector
 };
 
 #endif /* _SECTOR_H */
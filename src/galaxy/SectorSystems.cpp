@@ -0,0 +1,292 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "SectorSystems.h"
+#include "utils.h"
+
+static const unsigned int SYS_NAME_FRAGS = 32;
+static const char *sys_names[SYS_NAME_FRAGS] =
+{ "en", "la", "can", "be", "and", "phi", "eth", "ol", "ve", "ho", "a",
+  "lia", "an", "ar", "ur", "mi", "in", "ti", "qu", "so", "ed", "ess",
+  "ex", "io", "ce", "ze", "fa", "ay", "wa", "da", "ack", "gre" };
+
+SectorSystems::SectorSystems(const SystemPath &path, Uint8 density, float size) : sx(path.sectorX), sy(path.sectorY), sz(path.sectorZ),
+	m_numSystems(0), m_posX(nullptr), m_posY(nullptr), m_posZ(nullptr), m_nameState(nullptr),
+	m_starTypes(nullptr), m_numStars(nullptr), m_explored(nullptr)
+{
+	PROFILE_SCOPED()
+	Uint32 _init[4] = { Uint32(path.sectorX), Uint32(path.sectorY), Uint32(path.sectorZ), UNIVERSE_SEED };
+	Random rng(_init, 4);
+
+	int numSystems = (rng.Int32(4,20) * density) >> 8;
+	if (numSystems <= 0)
+		return;
+
+	// floats and words first, then the bytes
+	m_numSystems = numSystems;
+	m_storage.reset(new char[numSystems * (4*sizeof(float) + 4 + 1 + 1)]);
+	m_posX = reinterpret_cast<float*>(m_storage.get());
+	m_posY = m_posX + numSystems;
+	m_posZ = m_posY + numSystems;
+	m_nameState = reinterpret_cast<Uint32*>(m_posZ + numSystems);
+	m_starTypes = reinterpret_cast<Uint8*>(m_nameState + numSystems);
+	m_numStars = m_starTypes + 4*numSystems;
+	m_explored = m_numStars + numSystems;
+
+	for (int i=0; i<numSystems; i++) {
+		int numStars;
+		SystemBody::BodyType starType[4] = { SystemBody::TYPE_GRAVPOINT, SystemBody::TYPE_GRAVPOINT, SystemBody::TYPE_GRAVPOINT, SystemBody::TYPE_GRAVPOINT };
+
+		switch (rng.Int32(15)) {
+			case 0:
+				numStars = 4; break;
+			case 1: case 2:
+				numStars = 3; break;
+			case 3: case 4: case 5: case 6:
+				numStars = 2; break;
+			default:
+				numStars = 1; break;
+		}
+
+		m_posX[i] = rng.Double(size);
+		m_posY[i] = rng.Double(size);
+		m_posZ[i] = rng.Double(size);
+
+		/*
+			* 0 - ~500ly from sol: explored
+			* ~500ly - ~700ly (65-90 sectors): gradual
+			* ~700ly+: unexplored
+			*/
+		int dist = isqrt(1 + sx*sx + sy*sy + sz*sz);
+		m_explored[i] = (dist <= 90) && ( dist <= 65 || rng.Int32(dist) <= 40);
+
+		Uint32 weight = rng.Int32(1000000);
+
+		// Frequencies are low enough that we probably don't need this anymore.
+		if (isqrt(1+sx*sx+sy*sy) > 10)
+		{
+			if (weight < 1) {
+				starType[0] = SystemBody::TYPE_STAR_IM_BH;  // These frequencies are made up
+			} else if (weight < 3) {
+				starType[0] = SystemBody::TYPE_STAR_S_BH;
+			} else if (weight < 5) {
+				starType[0] = SystemBody::TYPE_STAR_O_WF;
+			} else if (weight < 8) {
+				starType[0] = SystemBody::TYPE_STAR_B_WF;
+			} else if (weight < 12) {
+				starType[0] = SystemBody::TYPE_STAR_M_WF;
+			} else if (weight < 15) {
+				starType[0] = SystemBody::TYPE_STAR_K_HYPER_GIANT;
+			} else if (weight < 18) {
+				starType[0] = SystemBody::TYPE_STAR_G_HYPER_GIANT;
+			} else if (weight < 23) {
+				starType[0] = SystemBody::TYPE_STAR_O_HYPER_GIANT;
+			} else if (weight < 28) {
+				starType[0] = SystemBody::TYPE_STAR_A_HYPER_GIANT;
+			} else if (weight < 33) {
+				starType[0] = SystemBody::TYPE_STAR_F_HYPER_GIANT;
+			} else if (weight < 41) {
+				starType[0] = SystemBody::TYPE_STAR_B_HYPER_GIANT;
+			} else if (weight < 48) {
+				starType[0] = SystemBody::TYPE_STAR_M_HYPER_GIANT;
+			} else if (weight < 58) {
+				starType[0] = SystemBody::TYPE_STAR_K_SUPER_GIANT;
+			} else if (weight < 68) {
+				starType[0] = SystemBody::TYPE_STAR_G_SUPER_GIANT;
+			} else if (weight < 78) {
+				starType[0] = SystemBody::TYPE_STAR_O_SUPER_GIANT;
+			} else if (weight < 88) {
+				starType[0] = SystemBody::TYPE_STAR_A_SUPER_GIANT;
+			} else if (weight < 98) {
+				starType[0] = SystemBody::TYPE_STAR_F_SUPER_GIANT;
+			} else if (weight < 108) {
+				starType[0] = SystemBody::TYPE_STAR_B_SUPER_GIANT;
+			} else if (weight < 158) {
+				starType[0] = SystemBody::TYPE_STAR_M_SUPER_GIANT;
+			} else if (weight < 208) {
+				starType[0] = SystemBody::TYPE_STAR_K_GIANT;
+			} else if (weight < 250) {
+				starType[0] = SystemBody::TYPE_STAR_G_GIANT;
+			} else if (weight < 300) {
+				starType[0] = SystemBody::TYPE_STAR_O_GIANT;
+			} else if (weight < 350) {
+				starType[0] = SystemBody::TYPE_STAR_A_GIANT;
+			} else if (weight < 400) {
+				starType[0] = SystemBody::TYPE_STAR_F_GIANT;
+			} else if (weight < 500) {
+				starType[0] = SystemBody::TYPE_STAR_B_GIANT;
+			} else if (weight < 700) {
+				starType[0] = SystemBody::TYPE_STAR_M_GIANT;
+			} else if (weight < 800) {
+				starType[0] = SystemBody::TYPE_STAR_O;  // should be 1 but that is boring
+			} else if (weight < 2000) { // weight < 1300 / 20500
+				starType[0] = SystemBody::TYPE_STAR_B;
+			} else if (weight < 8000) { // weight < 7300
+				starType[0] = SystemBody::TYPE_STAR_A;
+			} else if (weight < 37300) { // weight < 37300
+				starType[0] = SystemBody::TYPE_STAR_F;
+			} else if (weight < 113300) { // weight < 113300
+				starType[0] = SystemBody::TYPE_STAR_G;
+			} else if (weight < 234300) { // weight < 234300
+				starType[0] = SystemBody::TYPE_STAR_K;
+			} else if (weight < 250000) { // weight < 250000
+				starType[0] = SystemBody::TYPE_WHITE_DWARF;
+			} else if (weight < 900000) {  //weight < 900000
+				starType[0] = SystemBody::TYPE_STAR_M;
+			} else {
+				starType[0] = SystemBody::TYPE_BROWN_DWARF;
+			}
+		} else {
+			if (weight < 100) { // should be 1 but that is boring
+				starType[0] = SystemBody::TYPE_STAR_O;
+			} else if (weight < 1300) {
+				starType[0] = SystemBody::TYPE_STAR_B;
+			} else if (weight < 7300) {
+				starType[0] = SystemBody::TYPE_STAR_A;
+			} else if (weight < 37300) {
+				starType[0] = SystemBody::TYPE_STAR_F;
+			} else if (weight < 113300) {
+				starType[0] = SystemBody::TYPE_STAR_G;
+			} else if (weight < 234300) {
+				starType[0] = SystemBody::TYPE_STAR_K;
+			} else if (weight < 250000) {
+				starType[0] = SystemBody::TYPE_WHITE_DWARF;
+			} else if (weight < 900000) {
+				starType[0] = SystemBody::TYPE_STAR_M;
+			} else {
+				starType[0] = SystemBody::TYPE_BROWN_DWARF;
+			}
+		}
+		//Output("%d: %d%\n", sx, sy);
+
+		if (numStars > 1) {
+			starType[1] = SystemBody::BodyType(rng.Int32(SystemBody::TYPE_STAR_MIN, starType[0]));
+			if (numStars > 2) {
+				starType[2] = SystemBody::BodyType(rng.Int32(SystemBody::TYPE_STAR_MIN, starType[0]));
+				starType[3] = SystemBody::BodyType(rng.Int32(SystemBody::TYPE_STAR_MIN, starType[2]));
+			}
+		}
+
+		if ((starType[0] <= SystemBody::TYPE_STAR_A) && (rng.Int32(10)==0)) {
+			// make primary a giant. never more than one giant in a system
+			// while
+			if (isqrt(1+sx*sx+sy*sy) > 10)
+			{
+				weight = rng.Int32(1000);
+				if (weight >= 999) {
+					starType[0] = SystemBody::TYPE_STAR_B_HYPER_GIANT;
+				} else if (weight >= 998) {
+					starType[0] = SystemBody::TYPE_STAR_O_HYPER_GIANT;
+				} else if (weight >= 997) {
+					starType[0] = SystemBody::TYPE_STAR_K_HYPER_GIANT;
+				} else if (weight >= 995) {
+					starType[0] = SystemBody::TYPE_STAR_B_SUPER_GIANT;
+				} else if (weight >= 993) {
+					starType[0] = SystemBody::TYPE_STAR_O_SUPER_GIANT;
+				} else if (weight >= 990) {
+					starType[0] = SystemBody::TYPE_STAR_K_SUPER_GIANT;
+				} else if (weight >= 985) {
+					starType[0] = SystemBody::TYPE_STAR_B_GIANT;
+				} else if (weight >= 980) {
+					starType[0] = SystemBody::TYPE_STAR_O_GIANT;
+				} else if (weight >= 975) {
+					starType[0] = SystemBody::TYPE_STAR_K_GIANT;
+				} else if (weight >= 950) {
+					starType[0] = SystemBody::TYPE_STAR_M_HYPER_GIANT;
+				} else if (weight >= 875) {
+					starType[0] = SystemBody::TYPE_STAR_M_SUPER_GIANT;
+				} else {
+					starType[0] = SystemBody::TYPE_STAR_M_GIANT;
+				}
+			} else if (isqrt(1+sx*sx+sy*sy) > 5) starType[0] = SystemBody::TYPE_STAR_M_GIANT;
+			else starType[0] = SystemBody::TYPE_STAR_M;
+
+			//Output("%d: %d%\n", sx, sy);
+		}
+
+		m_numStars[i] = numStars;
+		for (int star = 0; star < 4; star++)
+			m_starTypes[i*4 + star] = Uint8(starType[star]);
+
+		m_nameState[i] = rng.GetState();
+		GenName(nullptr, starType[0], rng);
+	}
+}
+
+std::string SectorSystems::GetName(Uint32 idx) const
+{
+	assert(idx < m_numSystems);
+	Random rng;
+	rng.SetState(m_nameState[idx]);
+	std::string name;
+	GenName(&name, GetStarType(idx, 0), rng);
+	return name;
+}
+
+void SectorSystems::GenName(std::string *name, SystemBody::BodyType primary, Random &rng) const
+{
+	PROFILE_SCOPED()
+	const int dist = std::max(std::max(abs(sx),abs(sy)),abs(sz));
+
+	int chance = 100;
+	switch (primary) {
+		case SystemBody::TYPE_STAR_O:
+		case SystemBody::TYPE_STAR_B: break;
+		case SystemBody::TYPE_STAR_A: chance += dist; break;
+		case SystemBody::TYPE_STAR_F: chance += 2*dist; break;
+		case SystemBody::TYPE_STAR_G: chance += 4*dist; break;
+		case SystemBody::TYPE_STAR_K: chance += 8*dist; break;
+		case SystemBody::TYPE_STAR_O_GIANT:
+		case SystemBody::TYPE_STAR_B_GIANT: chance = 50; break;
+		case SystemBody::TYPE_STAR_A_GIANT: chance = int(0.2*dist); break;
+		case SystemBody::TYPE_STAR_F_GIANT: chance = int(0.4*dist); break;
+		case SystemBody::TYPE_STAR_G_GIANT: chance = int(0.5*dist); break;
+		case SystemBody::TYPE_STAR_K_GIANT:
+		case SystemBody::TYPE_STAR_M_GIANT: chance = dist; break;
+		case SystemBody::TYPE_STAR_O_SUPER_GIANT:
+		case SystemBody::TYPE_STAR_B_SUPER_GIANT: chance = 10; break;
+		case SystemBody::TYPE_STAR_A_SUPER_GIANT:
+		case SystemBody::TYPE_STAR_F_SUPER_GIANT:
+		case SystemBody::TYPE_STAR_G_SUPER_GIANT:
+		case SystemBody::TYPE_STAR_K_SUPER_GIANT: chance = 15; break;
+		case SystemBody::TYPE_STAR_M_SUPER_GIANT: chance = 20; break;
+		case SystemBody::TYPE_STAR_O_HYPER_GIANT:
+		case SystemBody::TYPE_STAR_B_HYPER_GIANT:
+		case SystemBody::TYPE_STAR_A_HYPER_GIANT:
+		case SystemBody::TYPE_STAR_F_HYPER_GIANT:
+		case SystemBody::TYPE_STAR_G_HYPER_GIANT:
+		case SystemBody::TYPE_STAR_K_HYPER_GIANT:
+		case SystemBody::TYPE_STAR_M_HYPER_GIANT: chance = 1; break;  //Should give a nice name almost all the time
+		default: chance += 16*dist; break;
+	}
+
+	Uint32 weight = rng.Int32(chance);
+	if (weight < 500) {
+		/* well done. you get a real name  */
+		int len = rng.Int32(2,3);
+		for (int i=0; i<len; i++) {
+			const char *frag = sys_names[rng.Int32(0,SYS_NAME_FRAGS-1)];
+			if (name) *name += frag;
+		}
+		if (name) (*name)[0] = toupper((*name)[0]);
+		return;
+	}
+
+	const char *format;
+	int number;
+	if (weight < 800) {
+		format = "MJBN %d%+d%+d"; // MJBN -> Morton Jordan Bennett Norris
+		number = rng.Int32(10,999);
+	} else if (weight < 1200) {
+		format = "SC %d%+d%+d";
+		number = rng.Int32(1000,9999);
+	} else {
+		format = "DSC %d%+d%+d";
+		number = rng.Int32(1000,9999);
+	}
+	if (name) {
+		char buf[128];
+		snprintf(buf, sizeof(buf), format, number, sx, sy);
+		*name = buf;
+	}
+}
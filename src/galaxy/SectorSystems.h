@@ -0,0 +1,55 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _SECTORSYSTEMS_H
+#define _SECTORSYSTEMS_H
+
+#include "libs.h"
+#include "galaxy/SystemPath.h"
+#include "galaxy/StarSystem.h"
+#include <memory>
+#include <string>
+
+// The systems of one sector, generated from nothing but its coordinates and
+// the galaxy's density there, so that it needs neither the galaxy nor the
+// caches. Each of their properties is kept in an array of its own, and the
+// arrays share one allocation. Names aren't kept at all: the generator's
+// state from just before the name was drawn is, and GetName draws it again
+class SectorSystems {
+public:
+	// size is the length of the sector's sides in ly
+	SectorSystems(const SystemPath &path, Uint8 density, float size);
+
+	Uint32 GetNumSystems() const { return m_numSystems; }
+
+	// within the sector
+	vector3f GetPosition(Uint32 idx) const { assert(idx < m_numSystems); return vector3f(m_posX[idx], m_posY[idx], m_posZ[idx]); }
+
+	int GetNumStars(Uint32 idx) const { assert(idx < m_numSystems); return m_numStars[idx]; }
+	SystemBody::BodyType GetStarType(Uint32 idx, int star) const {
+		assert(idx < m_numSystems && star >= 0 && star < 4);
+		return SystemBody::BodyType(m_starTypes[idx*4 + star]);
+	}
+	bool IsExplored(Uint32 idx) const { assert(idx < m_numSystems); return m_explored[idx] != 0; }
+
+	std::string GetName(Uint32 idx) const;
+
+private:
+	SectorSystems(const SectorSystems&); // non-copyable
+	SectorSystems& operator=(const SectorSystems&); // non-assignable
+
+	// with name null it only takes the same numbers from rng
+	void GenName(std::string *name, SystemBody::BodyType primary, Random &rng) const;
+
+	int sx, sy, sz;
+
+	Uint32 m_numSystems;
+	std::unique_ptr<char[]> m_storage;
+	float *m_posX, *m_posY, *m_posZ;
+	Uint32 *m_nameState;
+	Uint8 *m_starTypes; // four for each system, unused ones are 0
+	Uint8 *m_numStars;
+	Uint8 *m_explored;
+};
+
+#endif /* _SECTORSYSTEMS_H */
@@ -1243,27 +1243,32 @@ StarSystem::StarSystem(const SystemPath &path, StarSystemCache* cache) : m_path(
 {
 	PROFILE_SCOPED()
 
-	RefCountedPtr<const Sector> s = Sector::cache.GetCached(m_path);
-	assert(m_path.systemIndex >= 0 && m_path.systemIndex < s->m_systems.size());
+	// without a cache we're in a job, and the sector cache is the main
+	// thread's. making the sector again is cheaper than sharing it
+	RefCountedPtr<const Sector> s;
+	if (cache)
+		s = Sector::cache.GetCached(m_path);
+	else
+		s = Sector::Generate(m_path);
+	assert(m_path.systemIndex >= 0 && m_path.systemIndex < s->GetNumSystems());
 
-	m_seed    = s->m_systems[m_path.systemIndex].seed;
-	m_name    = s->m_systems[m_path.systemIndex].name;
+	m_name    = s->GetName(m_path.systemIndex);
 
 	Uint32 _init[6] = { m_path.systemIndex, Uint32(m_path.sectorX), Uint32(m_path.sectorY), Uint32(m_path.sectorZ), UNIVERSE_SEED, Uint32(m_seed) };
 	Random rand(_init, 6);
 
-	m_unexplored = !s->m_systems[m_path.systemIndex].explored;
+	m_unexplored = !s->IsExplored(m_path.systemIndex);
 
 	SystemBody *star[4];
 	SystemBody *centGrav1(0), *centGrav2(0);
 
-	const int numStars = s->m_systems[m_path.systemIndex].numStars;
+	const int numStars = s->GetNumStars(m_path.systemIndex);
 	assert((numStars >= 1) && (numStars <= 4));
 	if (numStars == 1) {
-		SystemBody::BodyType type = s->m_systems[m_path.systemIndex].starType[0];
+		SystemBody::BodyType type = s->GetStarType(m_path.systemIndex, 0);
 		star[0] = NewBody();
 		star[0]->m_parent = 0;
-		star[0]->m_name = s->m_systems[m_path.systemIndex].name;
+		star[0]->m_name = m_name;
 		star[0]->m_orbMin = fixed(0);
 		star[0]->m_orbMax = fixed(0);
 
@@ -1274,19 +1279,19 @@ StarSystem::StarSystem(const SystemPath &path, StarSystemCache* cache) : m_path(
 		centGrav1 = NewBody();
 		centGrav1->m_type = SystemBody::TYPE_GRAVPOINT;
 		centGrav1->m_parent = 0;
-		centGrav1->m_name = s->m_systems[m_path.systemIndex].name+" A,B";
+		centGrav1->m_name = m_name+" A,B";
 		m_rootBody.Reset(centGrav1);
 
-		SystemBody::BodyType type = s->m_systems[m_path.systemIndex].starType[0];
+		SystemBody::BodyType type = s->GetStarType(m_path.systemIndex, 0);
 		star[0] = NewBody();
-		star[0]->m_name = s->m_systems[m_path.systemIndex].name+" A";
+		star[0]->m_name = m_name+" A";
 		star[0]->m_parent = centGrav1;
 		MakeStarOfType(star[0], type, rand);
 
 		star[1] = NewBody();
-		star[1]->m_name = s->m_systems[m_path.systemIndex].name+" B";
+		star[1]->m_name = m_name+" B";
 		star[1]->m_parent = centGrav1;
-		MakeStarOfTypeLighterThan(star[1], s->m_systems[m_path.systemIndex].starType[1],
+		MakeStarOfTypeLighterThan(star[1], s->GetStarType(m_path.systemIndex, 1),
 				star[0]->GetMassAsFixed(), rand);
 
 		centGrav1->m_mass = star[0]->GetMassAsFixed() + star[1]->GetMassAsFixed();
@@ -1307,29 +1312,29 @@ try_that_again_guvnah:
 			// 3rd and maybe 4th star
 			if (numStars == 3) {
 				star[2] = NewBody();
-				star[2]->m_name = s->m_systems[m_path.systemIndex].name+" C";
+				star[2]->m_name = m_name+" C";
 				star[2]->m_orbMin = 0;
 				star[2]->m_orbMax = 0;
-				MakeStarOfTypeLighterThan(star[2], s->m_systems[m_path.systemIndex].starType[2],
+				MakeStarOfTypeLighterThan(star[2], s->GetStarType(m_path.systemIndex, 2),
 					star[0]->GetMassAsFixed(), rand);
 				centGrav2 = star[2];
 				m_numStars = 3;
 			} else {
 				centGrav2 = NewBody();
 				centGrav2->m_type = SystemBody::TYPE_GRAVPOINT;
-				centGrav2->m_name = s->m_systems[m_path.systemIndex].name+" C,D";
+				centGrav2->m_name = m_name+" C,D";
 				centGrav2->m_orbMax = 0;
 
 				star[2] = NewBody();
-				star[2]->m_name = s->m_systems[m_path.systemIndex].name+" C";
+				star[2]->m_name = m_name+" C";
 				star[2]->m_parent = centGrav2;
-				MakeStarOfTypeLighterThan(star[2], s->m_systems[m_path.systemIndex].starType[2],
+				MakeStarOfTypeLighterThan(star[2], s->GetStarType(m_path.systemIndex, 2),
 					star[0]->GetMassAsFixed(), rand);
 
 				star[3] = NewBody();
-				star[3]->m_name = s->m_systems[m_path.systemIndex].name+" D";
+				star[3]->m_name = m_name+" D";
 				star[3]->m_parent = centGrav2;
-				MakeStarOfTypeLighterThan(star[3], s->m_systems[m_path.systemIndex].starType[3],
+				MakeStarOfTypeLighterThan(star[3], s->GetStarType(m_path.systemIndex, 3),
 					star[2]->GetMassAsFixed(), rand);
 
 				// Separate stars by 0.2 radii for each, so that their planets don't bump into the other star
@@ -1343,7 +1348,7 @@ try_that_again_guvnah:
 			SystemBody *superCentGrav = NewBody();
 			superCentGrav->m_type = SystemBody::TYPE_GRAVPOINT;
 			superCentGrav->m_parent = 0;
-			superCentGrav->m_name = s->m_systems[m_path.systemIndex].name;
+			superCentGrav->m_name = m_name;
 			centGrav1->m_parent = superCentGrav;
 			centGrav2->m_parent = superCentGrav;
 			m_rootBody.Reset(superCentGrav);
@@ -161,6 +161,25 @@ public:
 	fixed GetAtmosOxidizing() const { return m_atmosOxidizing; }
 	fixed GetLife() const { return m_life; }
 
+	// for bodies made up outside a StarSystem, like terrainbench's. a
+	// generated system sets all of this itself
+	void SetType(BodyType type) { m_type = type; }
+	void SetName(const std::string &name) { m_name = name; }
+	void SetSeed(Uint32 seed) { m_seed = seed; }
+	void SetRadius(fixed radius) { m_radius = radius; }
+	void SetMass(fixed mass) { m_mass = mass; }
+	void SetAverageTemp(int temp) { m_averageTemp = temp; }
+	void SetComposition(fixed metallicity, fixed volatileGas, fixed volatileLiquid, fixed volatileIces,
+		fixed volcanicity, fixed atmosOxidizing, fixed life) {
+		m_metallicity = metallicity;
+		m_volatileGas = volatileGas;
+		m_volatileLiquid = volatileLiquid;
+		m_volatileIces = volatileIces;
+		m_volcanicity = volcanicity;
+		m_atmosOxidizing = atmosOxidizing;
+		m_life = life;
+	}
+
 	fixed CalcHillRadius() const;
 	static int CalcSurfaceTemp(const SystemBody *primary, fixed distToPrimary, fixed albedo, fixed greenhouse);
 	double CalcSurfaceGravity() const;
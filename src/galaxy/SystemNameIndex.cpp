@@ -0,0 +1,266 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "SystemNameIndex.h"
+#include "gameconsts.h"
+#include "utils.h"
+#include <algorithm>
+
+// bump when Sector generation changes the names, so old files get rebuilt
+static const Uint32 INDEX_VERSION = 1;
+static const Uint32 INDEX_MAGIC = 0x58494e53; // 'SNIX', reads differently on the other endianness
+static const char *INDEX_FILE = "systemnames.idx";
+
+// layout of the file: header, entries sorted by name, trigrams sorted by key,
+// postings (entry numbers, ascending for each trigram), then the names
+// themselves, each nul-terminated
+struct SystemNameIndex::Header {
+	Uint32 magic;
+	Uint32 version;
+	Uint32 universeSeed;
+	Sint32 radius;
+	Uint32 numEntries;
+	Uint32 numTrigrams;
+	Uint32 numPostings;
+	Uint32 namesSize;
+};
+
+struct SystemNameIndex::Entry {
+	Uint32 nameOffset;
+	Uint16 nameLength;
+	Uint16 systemIndex;
+	Sint16 sx, sy, sz;
+	Uint16 pad;
+};
+
+struct SystemNameIndex::Trigram {
+	Uint32 key;
+	Uint32 first;
+	Uint32 count;
+};
+
+static inline char lower(char c)
+{
+	return char(tolower(static_cast<unsigned char>(c)));
+}
+
+static inline Uint32 trigram_key(const char *s)
+{
+	return (Uint32(Uint8(lower(s[0]))) << 16) | (Uint32(Uint8(lower(s[1]))) << 8) | Uint32(Uint8(lower(s[2])));
+}
+
+// <0, 0 or >0 as a sorts before, with or after b, ignoring case
+static int compare_nocase(const char *a, size_t alen, const char *b, size_t blen)
+{
+	const size_t n = std::min(alen, blen);
+	for (size_t i = 0; i < n; i++) {
+		const int d = int(Uint8(lower(a[i]))) - int(Uint8(lower(b[i])));
+		if (d) return d;
+	}
+	return int(alen > blen) - int(alen < blen);
+}
+
+bool SystemNameIndex::Write(FileSystem::FileSourceFS &fs, int radius, std::vector<Name> &names)
+{
+	// ties broken by place, so the file comes out the same every time
+	std::sort(names.begin(), names.end(), [](const Name &a, const Name &b) {
+		const int c = compare_nocase(a.name.c_str(), a.name.size(), b.name.c_str(), b.name.size());
+		if (c) return c < 0;
+		return a.path < b.path;
+	});
+
+	std::vector<Entry> entries(names.size());
+	std::string blob;
+	std::vector<std::pair<Uint32, Uint32> > keys; // (trigram, entry)
+	std::vector<Uint32> nameKeys;
+	for (Uint32 i = 0; i < names.size(); i++) {
+		const Name &n = names[i];
+		Entry &e = entries[i];
+		e.nameOffset = blob.size();
+		e.nameLength = Uint16(std::min(n.name.size(), size_t(0xffff)));
+		e.systemIndex = Uint16(n.path.systemIndex);
+		e.sx = Sint16(n.path.sectorX); e.sy = Sint16(n.path.sectorY); e.sz = Sint16(n.path.sectorZ);
+		e.pad = 0;
+		blob.append(n.name, 0, e.nameLength);
+		blob.push_back('\0');
+
+		nameKeys.clear();
+		for (size_t j = 0; j + 3 <= e.nameLength; j++)
+			nameKeys.push_back(trigram_key(n.name.c_str() + j));
+		std::sort(nameKeys.begin(), nameKeys.end());
+		nameKeys.erase(std::unique(nameKeys.begin(), nameKeys.end()), nameKeys.end());
+		for (Uint32 key : nameKeys)
+			keys.push_back(std::make_pair(key, i));
+	}
+	std::sort(keys.begin(), keys.end());
+
+	std::vector<Trigram> trigrams;
+	std::vector<Uint32> postings(keys.size());
+	for (Uint32 i = 0; i < keys.size(); i++) {
+		if (trigrams.empty() || trigrams.back().key != keys[i].first) {
+			Trigram t = { keys[i].first, i, 0 };
+			trigrams.push_back(t);
+		}
+		trigrams.back().count++;
+		postings[i] = keys[i].second;
+	}
+
+	Header h;
+	h.magic = INDEX_MAGIC;
+	h.version = INDEX_VERSION;
+	h.universeSeed = UNIVERSE_SEED;
+	h.radius = radius;
+	h.numEntries = entries.size();
+	h.numTrigrams = trigrams.size();
+	h.numPostings = postings.size();
+	h.namesSize = blob.size();
+
+	FILE *f = fs.OpenWriteStream(INDEX_FILE);
+	if (!f) return false;
+	bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+	if (ok && !entries.empty())
+		ok = fwrite(&entries[0], sizeof(Entry), entries.size(), f) == entries.size();
+	if (ok && !trigrams.empty())
+		ok = fwrite(&trigrams[0], sizeof(Trigram), trigrams.size(), f) == trigrams.size();
+	if (ok && !postings.empty())
+		ok = fwrite(&postings[0], sizeof(Uint32), postings.size(), f) == postings.size();
+	if (ok && !blob.empty())
+		ok = fwrite(blob.data(), blob.size(), 1, f) == 1;
+	fclose(f);
+	if (!ok)
+		remove(FileSystem::JoinPath(fs.GetRoot(), INDEX_FILE).c_str());
+	return ok;
+}
+
+SystemNameIndex *SystemNameIndex::Load(FileSystem::FileSource &fs, int radius)
+{
+	RefCountedPtr<FileSystem::FileData> data = fs.ReadFile(INDEX_FILE);
+	if (!data || data->GetSize() < sizeof(Header))
+		return nullptr;
+
+	Header h;
+	memcpy(&h, data->GetData(), sizeof(h));
+	if (h.magic != INDEX_MAGIC || h.version != INDEX_VERSION || h.universeSeed != UNIVERSE_SEED || h.radius != radius)
+		return nullptr;
+
+	if (!IsValid(data->GetData(), data->GetSize())) {
+		Output("system name index is damaged, rebuilding it\n");
+		return nullptr;
+	}
+
+	return new SystemNameIndex(data);
+}
+
+// everything Search follows from one table to another has to land inside
+// the file, and every name has to end in a nul, or a damaged file would
+// have it reading off the end
+bool SystemNameIndex::IsValid(const char *data, size_t size)
+{
+	Header h;
+	memcpy(&h, data, sizeof(h));
+	const Uint64 expected = Uint64(sizeof(Header)) + Uint64(h.numEntries)*sizeof(Entry)
+		+ Uint64(h.numTrigrams)*sizeof(Trigram) + Uint64(h.numPostings)*sizeof(Uint32) + h.namesSize;
+	if (Uint64(size) != expected)
+		return false;
+
+	const Entry *entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+	const Trigram *trigrams = reinterpret_cast<const Trigram*>(entries + h.numEntries);
+	const Uint32 *postings = reinterpret_cast<const Uint32*>(trigrams + h.numTrigrams);
+	const char *names = reinterpret_cast<const char*>(postings + h.numPostings);
+
+	for (Uint32 i = 0; i < h.numEntries; i++) {
+		const Entry &e = entries[i];
+		if (e.nameOffset >= h.namesSize || e.nameLength >= h.namesSize - e.nameOffset || names[e.nameOffset + e.nameLength] != '\0')
+			return false;
+	}
+	for (Uint32 i = 0; i < h.numTrigrams; i++) {
+		const Trigram &t = trigrams[i];
+		if (!t.count || t.first > h.numPostings || t.count > h.numPostings - t.first)
+			return false;
+	}
+	for (Uint32 i = 0; i < h.numPostings; i++)
+		if (postings[i] >= h.numEntries)
+			return false;
+	return true;
+}
+
+SystemNameIndex::SystemNameIndex(RefCountedPtr<FileSystem::FileData> data) : m_data(data)
+{
+	const Header *h = reinterpret_cast<const Header*>(m_data->GetData());
+	m_numEntries = h->numEntries;
+	m_numTrigrams = h->numTrigrams;
+	m_entries = reinterpret_cast<const Entry*>(h + 1);
+	m_trigrams = reinterpret_cast<const Trigram*>(m_entries + h->numEntries);
+	m_postings = reinterpret_cast<const Uint32*>(m_trigrams + h->numTrigrams);
+	m_names = reinterpret_cast<const char*>(m_postings + h->numPostings);
+}
+
+SystemNameIndex::Match SystemNameIndex::MakeMatch(Uint32 entry, bool atStart) const
+{
+	const Entry &e = m_entries[entry];
+	Match m;
+	m.path = SystemPath(e.sx, e.sy, e.sz, e.systemIndex);
+	m.name.assign(m_names + e.nameOffset, e.nameLength);
+	m.atStart = atStart;
+	return m;
+}
+
+void SystemNameIndex::Search(const std::string &text, std::vector<Match> &results, size_t maxResults) const
+{
+	PROFILE_SCOPED()
+	results.clear();
+	if (text.empty() || !maxResults)
+		return;
+
+	const char *q = text.c_str();
+	const size_t qlen = text.size();
+	auto shorter = [this](Uint32 a, Uint32 b) {
+		return m_entries[a].nameLength < m_entries[b].nameLength || (m_entries[a].nameLength == m_entries[b].nameLength && a < b);
+	};
+
+	// the names starting with text are one run of the sorted entries
+	const Entry *first = std::lower_bound(m_entries, m_entries + m_numEntries, text, [this, q, qlen](const Entry &e, const std::string &) {
+		return compare_nocase(m_names + e.nameOffset, std::min(size_t(e.nameLength), qlen), q, qlen) < 0;
+	});
+	std::vector<Uint32> found;
+	for (const Entry *e = first; e != m_entries + m_numEntries; ++e) {
+		if (e->nameLength < qlen || compare_nocase(m_names + e->nameOffset, qlen, q, qlen) != 0)
+			break;
+		found.push_back(Uint32(e - m_entries));
+	}
+	const size_t numStart = std::min(found.size(), maxResults);
+	std::partial_sort(found.begin(), found.begin() + numStart, found.end(), shorter);
+	for (size_t i = 0; i < numStart; i++)
+		results.push_back(MakeMatch(found[i], true));
+
+	if (results.size() >= maxResults || qlen < 3)
+		return;
+
+	// anywhere else in the name: every name with text in it is on the
+	// posting list of each of its trigrams, so check the shortest list
+	const Trigram *best = nullptr;
+	for (size_t i = 0; i + 3 <= qlen; i++) {
+		const Uint32 key = trigram_key(q + i);
+		const Trigram *t = std::lower_bound(m_trigrams, m_trigrams + m_numTrigrams, key, [](const Trigram &tg, Uint32 k) { return tg.key < k; });
+		if (t == m_trigrams + m_numTrigrams || t->key != key)
+			return;
+		if (!best || t->count < best->count)
+			best = t;
+	}
+
+	found.clear();
+	for (Uint32 i = best->first; i < best->first + best->count; i++) {
+		const Uint32 entry = m_postings[i];
+		const Entry &e = m_entries[entry];
+		const char *name = m_names + e.nameOffset;
+		// the ones at the start were taken above
+		if (e.nameLength >= qlen && compare_nocase(name, qlen, q, qlen) == 0)
+			continue;
+		if (pi_strcasestr(name, q))
+			found.push_back(entry);
+	}
+	const size_t numAnywhere = std::min(found.size(), maxResults - results.size());
+	std::partial_sort(found.begin(), found.begin() + numAnywhere, found.end(), shorter);
+	for (size_t i = 0; i < numAnywhere; i++)
+		results.push_back(MakeMatch(found[i], false));
+}
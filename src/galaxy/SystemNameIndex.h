@@ -0,0 +1,77 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _SYSTEMNAMEINDEX_H
+#define _SYSTEMNAMEINDEX_H
+
+#include "libs.h"
+#include "galaxy/SystemPath.h"
+#include "FileSystem.h"
+#include <string>
+#include <vector>
+
+class JobQueue;
+
+// Names of every system within some radius of Sol, for finding systems that
+// aren't loaded. Built once in the background and kept in the user dir, and
+// after that searched straight out of the mapped file.
+//
+// The names are sorted case-insensitively, so the names starting with
+// something are one run of the table. Names containing something are found
+// through a posting list for each three-letter sequence.
+class SystemNameIndex {
+public:
+	struct Match {
+		SystemPath path;
+		std::string name;
+		bool atStart; // the name starts with the search text
+	};
+
+	struct Name {
+		std::string name;
+		SystemPath path;
+	};
+
+	// load the index, or start building it if it's missing or was built
+	// for another radius. call after Galaxy::Init
+	static void Init(JobQueue *queue, int radius);
+	static void Uninit();
+
+	// null until the index is loaded
+	static const SystemNameIndex *Get();
+
+	// write the index of names (which get sorted) to fs, or read it back.
+	// Load gives null if the file is missing, was written for another
+	// radius or universe, or doesn't hold together
+	static bool Write(FileSystem::FileSourceFS &fs, int radius, std::vector<Name> &names);
+	static SystemNameIndex *Load(FileSystem::FileSource &fs, int radius);
+
+	// at most maxResults systems whose names start with text, shortest
+	// first, then ones that have it anywhere else, shortest first. the
+	// latter needs at least three characters
+	void Search(const std::string &text, std::vector<Match> &results, size_t maxResults) const;
+
+	Uint32 GetNumSystems() const { return m_numEntries; }
+
+private:
+	struct Header;
+	struct Entry;
+	struct Trigram;
+	class BuildJob;
+
+	// data must have been checked by Load
+	SystemNameIndex(RefCountedPtr<FileSystem::FileData> data);
+	static bool IsValid(const char *data, size_t size);
+
+	Match MakeMatch(Uint32 entry, bool atStart) const;
+
+	RefCountedPtr<FileSystem::FileData> m_data;
+	Uint32 m_numEntries;
+	Uint32 m_numTrigrams;
+	const Entry *m_entries;
+	const Trigram *m_trigrams;
+	const Uint32 *m_postings;
+	const char *m_names;
+};
+
+#endif /* _SYSTEMNAMEINDEX_H */
@@ -0,0 +1,84 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "SystemNameIndex.h"
+#include "Sector.h"
+#include "JobQueue.h"
+#include <atomic>
+#include <memory>
+
+static std::unique_ptr<SystemNameIndex> s_index;
+static std::unique_ptr<JobSet> s_jobs;
+
+// generates every sector in the radius, off the main thread, and writes out
+// the index. the sectors don't go anywhere near the sector cache
+class SystemNameIndex::BuildJob : public Job {
+public:
+	BuildJob(int radius) : m_radius(radius), m_ok(false), m_cancel(false) {}
+
+	virtual void OnRun() { // RUNS IN ANOTHER THREAD!! MUST BE THREAD SAFE!
+		std::vector<Name> names;
+
+		// in 64 bits, as three squares of the largest radius don't fit in an int
+		const Sint64 r = m_radius;
+		for (int sx = -m_radius; sx <= m_radius; sx++) {
+			if (m_cancel) return;
+			for (int sy = -m_radius; sy <= m_radius; sy++) {
+				for (int sz = -m_radius; sz <= m_radius; sz++) {
+					if (Sint64(sx)*sx + Sint64(sy)*sy + Sint64(sz)*sz > r*r) continue;
+					Sector sec(SystemPath(sx, sy, sz), nullptr);
+					for (Uint32 i = 0; i < sec.GetNumSystems(); i++) {
+						Name n = { sec.GetName(i), SystemPath(sx, sy, sz, i) };
+						names.push_back(n);
+					}
+				}
+			}
+		}
+		if (m_cancel) return;
+
+		m_ok = Write(FileSystem::userFiles, m_radius, names);
+	}
+
+	virtual void OnFinish() {
+		if (!m_ok) {
+			Output("couldn't write system name index\n");
+			return;
+		}
+		s_index.reset(SystemNameIndex::Load(FileSystem::userFiles, m_radius));
+		if (s_index)
+			Output("system name index: %u systems within %d sectors of Sol\n", s_index->GetNumSystems(), m_radius);
+	}
+
+	virtual void OnCancel() { m_cancel = true; }
+
+private:
+	int m_radius;
+	bool m_ok;
+	std::atomic<bool> m_cancel;
+};
+
+void SystemNameIndex::Init(JobQueue *queue, int radius)
+{
+	if (radius < 0) radius = 0;
+	// entries only have room for this
+	if (radius > 0x7fff) radius = 0x7fff;
+
+	s_index.reset(Load(FileSystem::userFiles, radius));
+	if (s_index)
+		return;
+
+	s_jobs.reset(new JobSet(queue));
+	s_jobs->Order(new BuildJob(radius));
+}
+
+void SystemNameIndex::Uninit()
+{
+	// cancels the build if it's still going
+	s_jobs.reset();
+	s_index.reset();
+}
+
+const SystemNameIndex *SystemNameIndex::Get()
+{
+	return s_index.get();
+}
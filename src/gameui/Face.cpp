@@ -88,7 +88,7 @@ Face *Face::SetHeightLines(Uint32 lines)
 	const Text::TextureFont *font = GetContext()->GetFont(GetFont()).Get();
 	const float height = font->GetHeight() * lines;
 	m_preferredSize = UI::Point(height * float(FACE_WIDTH) / float(FACE_HEIGHT), height);
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -100,6 +100,21 @@ bool Frustum::TestPointInfinite(const vector3d &p, double radius) const
 	return true;
 }
 
+void Frustum::TestPointsInfinite(int count, const double *x, const double *y, const double *z, const double *radius, Uint8 *inside) const
+{
+	PROFILE_SCOPED()
+	for (int i=0; i<count; i++)
+		inside[i] = 1;
+
+	// a plane at a time over every point, without branches, so that the
+	// compiler can do several points per instruction
+	for (int p=0; p<5; p++) {
+		const double a = m_planes[p].a, b = m_planes[p].b, c = m_planes[p].c, d = m_planes[p].d;
+		for (int i=0; i<count; i++)
+			inside[i] &= Uint8(a*x[i] + b*y[i] + c*z[i] + d + radius[i] >= 0.0);
+	}
+}
+
 bool Frustum::ProjectPoint(const vector3d &in, vector3d &out) const
 {
 	// see the OpenGL documentation
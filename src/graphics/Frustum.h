@@ -29,6 +29,9 @@ public:
 	bool TestPoint(const vector3d &p, double radius) const;
 	// test if point (sphere) is in the frustum, ignoring the far plane
 	bool TestPointInfinite(const vector3d &p, double radius) const;
+	// TestPointInfinite for count spheres at once, given a component per
+	// array. inside[i] is 1 for those that are at least partly in
+	void TestPointsInfinite(int count, const double *x, const double *y, const double *z, const double *radius, Uint8 *inside) const;
 
 	// project a point onto the near plane (typically the screen)
 	bool ProjectPoint(const vector3d &in, vector3d &out) const;
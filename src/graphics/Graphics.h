@@ -22,6 +22,8 @@ namespace Graphics {
 		bool hidden;
 		bool useTextureCompression;
 		bool enableDebugMessages;
+		bool useProgramCache;
+		bool warmPrograms;
 		int vsync;
 		int requestedSamples;
 		int height;
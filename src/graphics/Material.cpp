@@ -53,4 +53,19 @@ bool operator==(const MaterialDescriptor &a, const MaterialDescriptor &b)
 	);
 }
 
+size_t MaterialDescriptorHash::operator()(const MaterialDescriptor &d) const
+{
+	// hash the fields rather than the struct, the padding isn't initialised
+	const Uint32 flags =
+		(d.alphaTest    ? 1 << 0 : 0) |
+		(d.glowMap      ? 1 << 1 : 0) |
+		(d.ambientMap   ? 1 << 2 : 0) |
+		(d.lighting     ? 1 << 3 : 0) |
+		(d.specularMap  ? 1 << 4 : 0) |
+		(d.usePatterns  ? 1 << 5 : 0) |
+		(d.vertexColors ? 1 << 6 : 0);
+	const Uint32 key[5] = { Uint32(d.effect), flags, Uint32(d.textures), d.dirLights, d.quality };
+	return lookup3_hashword(key, 5, 0);
+}
+
 }
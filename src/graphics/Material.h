@@ -66,6 +66,11 @@ public:
 	friend bool operator==(const MaterialDescriptor &a, const MaterialDescriptor &b);
 };
 
+// for keying hash containers on a descriptor
+struct MaterialDescriptorHash {
+	size_t operator()(const MaterialDescriptor &d) const;
+};
+
 /*
  * A generic material with some generic parameters.
  */
@@ -102,6 +102,10 @@ public:
 	//complex unchanging geometry that is worthwhile to store in VBOs etc.
 	virtual bool DrawBuffer(VertexBuffer*, RenderState*, Material*, PrimitiveType type=TRIANGLES) { return false; }
 	virtual bool DrawBufferIndexed(VertexBuffer*, IndexBuffer*, RenderState*, Material*, PrimitiveType=TRIANGLES) { return false; }
+	//draw the index buffer once for each of numRanges meshes packed in one vertex buffer,
+	//mesh i starting at firstVertex[i] and drawn with modelview transforms[i].
+	//state, material and buffers are set up once for all of them
+	virtual bool DrawBufferIndexedRanges(VertexBuffer*, IndexBuffer*, RenderState*, Material*, Uint32 numRanges, const Uint32 *firstVertex, const matrix4x4f *transforms, PrimitiveType=TRIANGLES) { return false; }
 
 	//creates a unique material based on the descriptor. It will not be deleted automatically.
 	virtual Material *CreateMaterial(const MaterialDescriptor &descriptor) = 0;
@@ -2,6 +2,7 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "RendererGL2.h"
+#include "FileSystem.h"
 #include "Graphics.h"
 #include "Light.h"
 #include "Material.h"
@@ -33,7 +34,12 @@
 
 namespace Graphics {
 
-typedef std::vector<std::pair<MaterialDescriptor, GL2::Program*> >::const_iterator ProgramIterator;
+// list of descriptors to warm on startup, under the user dir
+static const char *PROGRAM_LIST_FILE = "shadercache/programs.txt";
+static const int PROGRAM_LIST_VERSION = 1;
+// programs built per frame while warming. with the binary cache each is
+// cheap, without it a few compiles a frame is about as much as goes unnoticed
+static const int WARM_PROGRAMS_PER_FRAME = 2;
 
 // for material-less line and point drawing
 GL2::MultiProgram *vtxColorProg;
@@ -52,6 +58,8 @@ RendererGL2::RendererGL2(WindowSDL *window, const Graphics::Settings &vs)
 , m_activeRenderTarget(0)
 , m_activeRenderState(nullptr)
 , m_matrixMode(MatrixMode::MODELVIEW)
+, m_warmPrograms(vs.warmPrograms)
+, m_programListDirty(false)
 {
 	m_viewportStack.push(Viewport());
 
@@ -78,17 +86,25 @@ RendererGL2::RendererGL2(WindowSDL *window, const Graphics::Settings &vs)
 	if (vs.enableDebugMessages)
 		GLDebug::Enable();
 
+	GL2::Program::SetBinaryCacheEnabled(vs.useProgramCache);
+
 	MaterialDescriptor desc;
 	flatColorProg = new GL2::MultiProgram(desc);
-	m_programs.push_back(std::make_pair(desc, flatColorProg));
+	m_programs[desc] = flatColorProg;
 	desc.vertexColors = true;
 	vtxColorProg = new GL2::MultiProgram(desc);
-	m_programs.push_back(std::make_pair(desc, vtxColorProg));
+	m_programs[desc] = vtxColorProg;
+
+	if (m_warmPrograms)
+		LoadProgramList();
 }
 
 RendererGL2::~RendererGL2()
 {
-	while (!m_programs.empty()) delete m_programs.back().second, m_programs.pop_back();
+	if (m_warmPrograms && m_programListDirty)
+		SaveProgramList();
+	for (auto prog : m_programs)
+		delete prog.second;
 	for (auto state : m_renderStates)
 		delete state.second;
 }
@@ -103,6 +119,8 @@ bool RendererGL2::GetNearFarRange(float &near, float &far) const
 bool RendererGL2::BeginFrame()
 {
 	PROFILE_SCOPED()
+	if (!m_warmQueue.empty())
+		WarmPrograms();
 	glClearColor(0,0,0,0);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	return true;
@@ -341,6 +359,7 @@ bool RendererGL2::DrawLines(int count, const vector3f *v, const Color *c, Render
 	SetRenderState(state);
 
 	vtxColorProg->Use();
+	vtxColorProg->diffuse.Set(Color::WHITE);
 	vtxColorProg->invLogZfarPlus1.Set(m_invLogZfarPlus1);
 
 	glEnableClientState(GL_VERTEX_ARRAY);
@@ -396,6 +415,7 @@ bool RendererGL2::DrawPoints(int count, const vector3f *points, const Color *col
 	if (count < 1 || !points || !colors) return false;
 
 	vtxColorProg->Use();
+	vtxColorProg->diffuse.Set(Color::WHITE);
 	vtxColorProg->invLogZfarPlus1.Set(m_invLogZfarPlus1);
 
 	SetRenderState(state);
@@ -513,6 +533,36 @@ bool RendererGL2::DrawBufferIndexed(VertexBuffer *vb, IndexBuffer *ib, RenderSta
 	return true;
 }
 
+bool RendererGL2::DrawBufferIndexedRanges(VertexBuffer *vb, IndexBuffer *ib, RenderState *state, Material *mat, Uint32 numRanges, const Uint32 *firstVertex, const matrix4x4f *transforms, PrimitiveType pt)
+{
+	if (!numRanges) return true;
+
+	SetRenderState(state);
+	mat->Apply();
+
+	auto gvb = static_cast<GL2::VertexBuffer*>(vb);
+	auto gib = static_cast<GL2::IndexBuffer*>(ib);
+
+	glBindBuffer(GL_ARRAY_BUFFER, gvb->GetBuffer());
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gib->GetBuffer());
+
+	EnableClientStates(gvb);
+
+	// no base vertex in GL2, so the pointers move instead
+	for (Uint32 i = 0; i < numRanges; i++) {
+		SetTransform(transforms[i]);
+		gvb->SetAttribPointers(firstVertex[i]);
+		glDrawElements(pt, ib->GetIndexCount(), GL_UNSIGNED_SHORT, 0);
+	}
+
+	gvb->UnsetAttribPointers();
+	DisableClientStates();
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	return true;
+}
 
 void RendererGL2::EnableClientStates(const VertexArray *v)
 {
@@ -597,6 +647,16 @@ Material *RendererGL2::CreateMaterial(const MaterialDescriptor &d)
 
 	// Create the material. It will be also used to create the shader,
 	// like a tiny factory
+	mat = NewMaterial(desc);
+	p = GetOrCreateProgram(mat); // XXX throws ShaderException on compile/link failure
+
+	mat->SetProgram(p);
+	return mat;
+}
+
+GL2::Material *RendererGL2::NewMaterial(const MaterialDescriptor &desc)
+{
+	GL2::Material *mat = 0;
 	switch (desc.effect) {
 	case EFFECT_PLANETRING:
 		mat = new GL2::RingMaterial();
@@ -636,18 +696,14 @@ Material *RendererGL2::CreateMaterial(const MaterialDescriptor &d)
 
 	mat->m_renderer = this;
 	mat->m_descriptor = desc;
-
-	p = GetOrCreateProgram(mat); // XXX throws ShaderException on compile/link failure
-
-	mat->SetProgram(p);
 	return mat;
 }
 
 bool RendererGL2::ReloadShaders()
 {
 	Output("Reloading " SIZET_FMT " programs...\n", m_programs.size());
-	for (ProgramIterator it = m_programs.begin(); it != m_programs.end(); ++it) {
-		it->second->Reload();
+	for (auto it : m_programs) {
+		it.second->Reload();
 	}
 	Output("Done.\n");
 
@@ -657,25 +713,95 @@ bool RendererGL2::ReloadShaders()
 GL2::Program* RendererGL2::GetOrCreateProgram(GL2::Material *mat)
 {
 	const MaterialDescriptor &desc = mat->GetDescriptor();
-	GL2::Program *p = 0;
 
 	// Find an existing program...
-	for (ProgramIterator it = m_programs.begin(); it != m_programs.end(); ++it) {
-		if ((*it).first == desc) {
-			p = (*it).second;
-			break;
-		}
-	}
+	ProgramMap::const_iterator it = m_programs.find(desc);
+	if (it != m_programs.end())
+		return it->second;
 
 	// ...or create a new one
-	if (!p) {
-		p = mat->CreateProgram(desc);
-		m_programs.push_back(std::make_pair(desc, p));
-	}
+	GL2::Program *p = mat->CreateProgram(desc);
+	m_programs[desc] = p;
+	m_programListDirty = true;
 
 	return p;
 }
 
+void RendererGL2::LoadProgramList()
+{
+	RefCountedPtr<FileSystem::FileData> data = FileSystem::userFiles.ReadFile(PROGRAM_LIST_FILE);
+	if (!data)
+		return;
+
+	std::istringstream ss(data->AsStringRange().ToString());
+	int version = 0;
+	if (!(ss >> version) || version != PROGRAM_LIST_VERSION)
+		return;
+
+	// effect alphaTest glowMap ambientMap lighting specularMap usePatterns vertexColors textures dirLights quality
+	int f[11];
+	while (ss >> f[0] >> f[1] >> f[2] >> f[3] >> f[4] >> f[5] >> f[6] >> f[7] >> f[8] >> f[9] >> f[10]) {
+		if (f[0] < EFFECT_DEFAULT || f[0] > EFFECT_SPHEREIMPOSTOR)
+			continue;
+		MaterialDescriptor desc;
+		desc.effect = EffectType(f[0]);
+		desc.alphaTest = f[1] != 0;
+		desc.glowMap = f[2] != 0;
+		desc.ambientMap = f[3] != 0;
+		desc.lighting = f[4] != 0;
+		desc.specularMap = f[5] != 0;
+		desc.usePatterns = f[6] != 0;
+		desc.vertexColors = f[7] != 0;
+		desc.textures = f[8];
+		desc.dirLights = f[9];
+		desc.quality = f[10];
+		m_warmQueue.push_back(desc);
+	}
+}
+
+void RendererGL2::SaveProgramList() const
+{
+	if (!FileSystem::userFiles.MakeDirectory("shadercache"))
+		return;
+	FILE *f = FileSystem::userFiles.OpenWriteStream(PROGRAM_LIST_FILE, FileSystem::FileSourceFS::WRITE_TEXT);
+	if (!f)
+		return;
+	fprintf(f, "%d\n", PROGRAM_LIST_VERSION);
+	for (auto it : m_programs) {
+		const MaterialDescriptor &d = it.first;
+		fprintf(f, "%d %d %d %d %d %d %d %d %d %u %u\n", int(d.effect),
+			int(d.alphaTest), int(d.glowMap), int(d.ambientMap), int(d.lighting),
+			int(d.specularMap), int(d.usePatterns), int(d.vertexColors),
+			int(d.textures), d.dirLights, d.quality);
+	}
+	fclose(f);
+}
+
+void RendererGL2::WarmPrograms()
+{
+	PROFILE_SCOPED()
+	// GL objects can only be made on this thread, so rather than warming in
+	// the background the queue is worked through a little each frame
+	int built = 0;
+	while (!m_warmQueue.empty() && built < WARM_PROGRAMS_PER_FRAME) {
+		const MaterialDescriptor desc = m_warmQueue.back();
+		m_warmQueue.pop_back();
+		if (m_programs.find(desc) != m_programs.end())
+			continue;
+
+		// the list may be stale, from other shaders or another driver. an
+		// entry that won't build is left out, and so out of the next list
+		std::unique_ptr<GL2::Material> mat(NewMaterial(desc));
+		try {
+			GetOrCreateProgram(mat.get());
+		} catch (const GL2::ShaderException &) {
+			Output("Couldn't build program for effect %d from the program list, skipping it\n", int(desc.effect));
+			m_programListDirty = true;
+		}
+		++built;
+	}
+}
+
 Texture *RendererGL2::CreateTexture(const TextureDescriptor &descriptor)
 {
 	return new TextureGL(descriptor, m_useCompressedTextures);
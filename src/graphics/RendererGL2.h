@@ -12,6 +12,7 @@
  *  - get rid of built-in glMaterial, glMatrix use
  */
 #include "Renderer.h"
+#include "Material.h"
 #include <stack>
 #include <unordered_map>
 
@@ -78,6 +79,7 @@ public:
 	virtual bool DrawPointSprites(int count, const vector3f *positions, RenderState *rs, Material *material, float size) override;
 	virtual bool DrawBuffer(VertexBuffer*, RenderState*, Material*, PrimitiveType) override;
 	virtual bool DrawBufferIndexed(VertexBuffer*, IndexBuffer*, RenderState*, Material*, PrimitiveType) override;
+	virtual bool DrawBufferIndexedRanges(VertexBuffer*, IndexBuffer*, RenderState*, Material*, Uint32 numRanges, const Uint32 *firstVertex, const matrix4x4f *transforms, PrimitiveType) override;
 
 	virtual Material *CreateMaterial(const MaterialDescriptor &descriptor) override;
 	virtual Texture *CreateTexture(const TextureDescriptor &descriptor) override;
@@ -126,6 +128,14 @@ protected:
 	matrix4x4f m_currentTransform;
 
 	GL2::Program* GetOrCreateProgram(GL2::Material*);
+	// materials double as program factories, see CreateMaterial
+	GL2::Material* NewMaterial(const MaterialDescriptor &desc);
+
+	// programs used in earlier runs are built ahead of need, a few per frame,
+	// so first use of a material doesn't stall on a compile
+	void LoadProgramList();
+	void SaveProgramList() const;
+	void WarmPrograms();
 	friend class GL2::Material;
 	friend class GL2::GasGiantSurfaceMaterial;
 	friend class GL2::GeoSphereSurfaceMaterial;
@@ -135,7 +145,11 @@ protected:
 	friend class GL2::RingMaterial;
 	friend class GL2::FresnelColourMaterial;
 	friend class GL2::ShieldMaterial;
-	std::vector<std::pair<MaterialDescriptor, GL2::Program*> > m_programs;
+	typedef std::unordered_map<MaterialDescriptor, GL2::Program*, MaterialDescriptorHash> ProgramMap;
+	ProgramMap m_programs;
+	std::vector<MaterialDescriptor> m_warmQueue;
+	bool m_warmPrograms;
+	bool m_programListDirty;
 	std::unordered_map<Uint32, GL2::RenderState*> m_renderStates;
 	float m_invLogZfarPlus1;
 	GL2::RenderTarget *m_activeRenderTarget;
@@ -49,7 +49,8 @@ enum PrimitiveType {
 	TRIANGLES = GL_TRIANGLES,
 	TRIANGLE_STRIP = GL_TRIANGLE_STRIP,
 	TRIANGLE_FAN = GL_TRIANGLE_FAN,
-	POINTS = GL_POINTS
+	POINTS = GL_POINTS,
+	LINES = GL_LINES
 };
 
 enum BlendMode {
@@ -15,8 +15,8 @@
  * Use Static buffer, when the geometry never changes.
  * Avoid mapping a buffer for reading, as it may be slow,
  * especially with static buffers.
- *
- * Expansion possibilities: range-based Map
+ * UpdateRange rewrites part of a buffer without mapping
+ * the rest, so one big buffer can hold many small meshes.
  */
 #include "libs.h"
 #include "graphics/Types.h"
@@ -78,6 +78,10 @@ public:
 	Uint32 GetVertexCount() const;
 	void SetVertexCount(Uint32);
 
+	//Write numVertices vertices from data, starting at firstVertex.
+	//The rest of the buffer is left as it is
+	virtual void UpdateRange(Uint32 firstVertex, Uint32 numVertices, const void *data) = 0;
+
 protected:
 	virtual Uint8 *MapInternal(BufferMapMode) = 0;
 	VertexBufferDesc m_desc;
@@ -122,11 +122,26 @@ void VertexBuffer::Unmap()
 	m_mapMode = BUFFER_MAP_NONE;
 }
 
-void VertexBuffer::SetAttribPointers()
+void VertexBuffer::UpdateRange(Uint32 firstVertex, Uint32 numVertices, const void *data)
 {
+	assert(m_mapMode == BUFFER_MAP_NONE); //must not be currently mapped
+	assert(firstVertex + numVertices <= m_desc.numVertices);
+
+	const Uint32 offset = firstVertex * m_desc.stride;
+	const Uint32 dataSize = numVertices * m_desc.stride;
+	if (m_data)
+		memcpy(m_data + offset, data, dataSize);
+	glBindBuffer(GL_ARRAY_BUFFER, m_buffer);
+	glBufferSubData(GL_ARRAY_BUFFER, offset, dataSize, data);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexBuffer::SetAttribPointers(Uint32 firstVertex)
+{
+	const Uint32 base = firstVertex * m_desc.stride;
 	for (Uint8 i = 0; i < MAX_ATTRIBS; i++) {
 		const auto& attr  = m_desc.attrib[i];
-		const auto offset = reinterpret_cast<const GLvoid*>(m_desc.attrib[i].offset);
+		const auto offset = reinterpret_cast<const GLvoid*>(base + m_desc.attrib[i].offset);
 		switch (attr.semantic) {
 		case ATTRIB_POSITION:
 			glVertexPointer(get_num_components(attr.format), get_component_type(attr.format), m_desc.stride, offset);
@@ -21,7 +21,9 @@ public:
 	~VertexBuffer();
 
 	virtual void Unmap() override;
-	void SetAttribPointers();
+	virtual void UpdateRange(Uint32 firstVertex, Uint32 numVertices, const void *data) override;
+	//point the attributes at the vertices from firstVertex on
+	void SetAttribPointers(Uint32 firstVertex = 0);
 	void UnsetAttribPointers();
 
 protected:
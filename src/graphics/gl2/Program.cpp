@@ -14,6 +14,10 @@ namespace GL2 {
 
 static const char *s_glslVersion = "#version 110\n";
 GLuint Program::s_curProgram = 0;
+bool Program::s_useBinaryCache = false;
+
+// linked program binaries are kept here, under the user dir
+static const char *PROGRAM_CACHE_DIR = "shadercache";
 
 // Check and warn about compile & link errors
 static bool check_glsl_errors(const char *filename, GLuint obj)
@@ -55,17 +59,21 @@ static bool check_glsl_errors(const char *filename, GLuint obj)
 }
 
 struct Shader {
-	Shader(GLenum type, const std::string &filename, const std::string &defines) {
-		RefCountedPtr<FileSystem::FileData> code = FileSystem::gameDataFiles.ReadFile(filename);
+	Shader(GLenum type, const std::string &filename, const std::string &defines)
+	: shader(0)
+	, m_type(type)
+	, m_filename(filename)
+	{
+		m_code = FileSystem::gameDataFiles.ReadFile(filename);
 
-		if (!code)
+		if (!m_code)
 			Error("Could not load %s", filename.c_str());
 
 		// Load some common code
-		RefCountedPtr<FileSystem::FileData> logzCode = FileSystem::gameDataFiles.ReadFile("shaders/gl2/logz.glsl");
-		assert(logzCode);
-		RefCountedPtr<FileSystem::FileData> libsCode = FileSystem::gameDataFiles.ReadFile("shaders/gl2/lib.glsl");
-		assert(libsCode);
+		m_logzCode = FileSystem::gameDataFiles.ReadFile("shaders/gl2/logz.glsl");
+		assert(m_logzCode);
+		m_libsCode = FileSystem::gameDataFiles.ReadFile("shaders/gl2/lib.glsl");
+		assert(m_libsCode);
 
 		AppendSource(s_glslVersion);
 		AppendSource(defines.c_str());
@@ -73,9 +81,9 @@ struct Shader {
 			AppendSource("#define VERTEX_SHADER\n");
 		else
 			AppendSource("#define FRAGMENT_SHADER\n");
-		AppendSource(logzCode->AsStringRange().StripUTF8BOM());
-		AppendSource(libsCode->AsStringRange().StripUTF8BOM());
-		AppendSource(code->AsStringRange().StripUTF8BOM());
+		AppendSource(m_logzCode->AsStringRange().StripUTF8BOM());
+		AppendSource(m_libsCode->AsStringRange().StripUTF8BOM());
+		AppendSource(m_code->AsStringRange().StripUTF8BOM());
 #if 0
 		static bool s_bDumpShaderSource = true;
 		if (s_bDumpShaderSource) {
@@ -92,16 +100,30 @@ struct Shader {
 			fclose(tmp);
 		}
 #endif
-		shader = glCreateShader(type);
-		Compile(shader);
-
-		// CheckGLSL may use OS::Warning instead of Error so the game may still (attempt to) run
-		if (!check_glsl_errors(filename.c_str(), shader))
-			throw ShaderException();
 	};
 
 	~Shader() {
-		glDeleteShader(shader);
+		if (shader)
+			glDeleteShader(shader);
+	}
+
+	// fold the complete source into a running hash
+	void Hash(Uint32 &pc, Uint32 &pb) const
+	{
+		for (Uint32 i = 0; i < blocks.size(); i++)
+			lookup3_hashlittle2(blocks[i], block_sizes[i], &pc, &pb);
+	}
+
+	void Compile()
+	{
+		assert(blocks.size() == block_sizes.size());
+		shader = glCreateShader(m_type);
+		glShaderSource(shader, blocks.size(), &blocks[0], &block_sizes[0]);
+		glCompileShader(shader);
+
+		// CheckGLSL may use OS::Warning instead of Error so the game may still (attempt to) run
+		if (!check_glsl_errors(m_filename.c_str(), shader))
+			throw ShaderException();
 	}
 
 	GLuint shader;
@@ -119,17 +141,96 @@ private:
 		block_sizes.push_back(str.Size());
 	}
 
-	void Compile(GLuint shader_id)
-	{
-		assert(blocks.size() == block_sizes.size());
-		glShaderSource(shader_id, blocks.size(), &blocks[0], &block_sizes[0]);
-		glCompileShader(shader_id);
-	}
-
+	GLenum m_type;
+	std::string m_filename;
+	// the blocks point into these, so they're held until compiled
+	RefCountedPtr<FileSystem::FileData> m_code;
+	RefCountedPtr<FileSystem::FileData> m_logzCode;
+	RefCountedPtr<FileSystem::FileData> m_libsCode;
 	std::vector<const char*> blocks;
 	std::vector<GLint> block_sizes;
 };
 
+// a binary is only good for the driver that produced it
+static const std::string &driver_string()
+{
+	static std::string s_driver;
+	if (s_driver.empty()) {
+		s_driver = stringf("%0\n%1\n%2",
+			reinterpret_cast<const char*>(glGetString(GL_VENDOR)),
+			reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+			reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+	}
+	return s_driver;
+}
+
+// cache file for a program, keyed on its full source (defines included) and the driver
+static std::string binary_cache_path(const std::string &name, const Shader &vs, const Shader &fs)
+{
+	Uint32 pc = 0, pb = 0;
+	vs.Hash(pc, pb);
+	fs.Hash(pc, pb);
+	const std::string &driver = driver_string();
+	lookup3_hashlittle2(driver.c_str(), driver.size(), &pc, &pb);
+
+	return FileSystem::JoinPath(PROGRAM_CACHE_DIR,
+		stringf("%0-%1{x}-%2{x}.bin", FileSystem::SanitiseFileName(name), pc, pb));
+}
+
+// file layout: Uint32 binary format, then the binary as glGetProgramBinary returned it
+static GLuint load_program_binary(const std::string &path)
+{
+	RefCountedPtr<FileSystem::FileData> data = FileSystem::userFiles.ReadFile(path);
+	if (!data || data->GetSize() <= sizeof(Uint32))
+		return 0;
+
+	Uint32 format;
+	memcpy(&format, data->GetData(), sizeof(Uint32));
+
+	const GLuint program = glCreateProgram();
+	glProgramBinary(program, format, data->GetData() + sizeof(Uint32), data->GetSize() - sizeof(Uint32));
+
+	// drivers reject binaries freely (updates, format changes), so a
+	// failure here just means compiling from source and rewriting the file
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	while (glGetError() != GL_NO_ERROR) {}
+	if (status == GL_FALSE) {
+		glDeleteProgram(program);
+		return 0;
+	}
+	return program;
+}
+
+static void save_program_binary(const std::string &path, GLuint program)
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return;
+
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, &binary[0]);
+	if (glGetError() != GL_NO_ERROR || length <= 0)
+		return;
+
+	static bool s_madeDir = false;
+	if (!s_madeDir)
+		s_madeDir = FileSystem::userFiles.MakeDirectory(PROGRAM_CACHE_DIR);
+
+	FILE *f = FileSystem::userFiles.OpenWriteStream(path);
+	if (!f)
+		return;
+	const Uint32 fmt = format;
+	const bool ok = fwrite(&fmt, sizeof(fmt), 1, f) == 1 &&
+		fwrite(&binary[0], length, 1, f) == 1;
+	fclose(f);
+	// a truncated file would only be rejected on load, but don't leave it around
+	if (!ok)
+		remove(FileSystem::JoinPath(FileSystem::userFiles.GetRoot(), path).c_str());
+}
+
 Program::Program()
 : m_name("")
 , m_defines("")
@@ -172,23 +273,50 @@ void Program::Unuse()
 	s_curProgram = 0;
 }
 
+void Program::SetBinaryCacheEnabled(bool enabled)
+{
+	s_useBinaryCache = false;
+	if (!enabled || !GLEW_ARB_get_program_binary)
+		return;
+	// the extension can be present with no formats to offer
+	GLint numFormats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+	s_useBinaryCache = numFormats > 0;
+}
+
 //load, compile and link
 void Program::LoadShaders(const std::string &name, const std::string &defines)
 {
 	const std::string filename = std::string("shaders/gl2/") + name;
 
-	//load, create and compile shaders
+	//load shader sources. they're needed for the cache key even if nothing gets compiled
 	Shader vs(GL_VERTEX_SHADER, filename + ".vert", defines);
 	Shader fs(GL_FRAGMENT_SHADER, filename + ".frag", defines);
 
+	std::string cachePath;
+	if (s_useBinaryCache) {
+		cachePath = binary_cache_path(name, vs, fs);
+		m_program = load_program_binary(cachePath);
+		if (m_program)
+			return;
+	}
+
+	vs.Compile();
+	fs.Compile();
+
 	//create program, attach shaders and link
 	m_program = glCreateProgram();
 	glAttachShader(m_program, vs.shader);
 	glAttachShader(m_program, fs.shader);
+	if (s_useBinaryCache)
+		glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 	glLinkProgram(m_program);
 
 	check_glsl_errors(name.c_str(), m_program);
 
+	if (s_useBinaryCache)
+		save_program_binary(cachePath, m_program);
+
 	//shaders may now be deleted by Shader destructor
 }
 
@@ -25,6 +25,10 @@ namespace Graphics {
 			virtual void Use();
 			virtual void Unuse();
 
+			// keep linked program binaries on disk (ARB_get_program_binary)
+			// so later runs can skip compiling. no-op where the driver can't
+			static void SetBinaryCacheEnabled(bool enabled);
+
 			// Some generic uniforms.
 			// to be added: matrices etc.
 			Uniform invLogZfarPlus1;
@@ -47,6 +51,7 @@ namespace Graphics {
 
 		protected:
 			static GLuint s_curProgram;
+			static bool s_useBinaryCache;
 
 			void LoadShaders(const std::string&, const std::string &defines);
 			virtual void InitUniforms();
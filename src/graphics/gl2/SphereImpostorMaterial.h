@@ -4,6 +4,8 @@
 #define _GL2_SPHEREIMPOSTORMATERIAL_H
 /*
  * Billboard sphere impostor
+ * Every corner of a quad is at the sphere's centre, with its offset in
+ * view space as the normal. The vertex shader turns it to face the camera
  */
 #include "libs.h"
 #include "GL2Material.h"
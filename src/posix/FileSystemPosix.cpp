@@ -9,7 +9,9 @@
 #include <cerrno>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <dirent.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 // on unix this is set from configure
@@ -119,31 +121,76 @@ namespace FileSystem {
 		return MakeFileInfo(path, ty);
 	}
 
+	// files at least this big are mapped rather than read. for anything
+	// smaller setting up the mapping costs more than copying the data
+	static const size_t MMAP_MIN_SIZE = 64 * 1024;
+
+	class FileDataMmap : public FileData {
+	public:
+		FileDataMmap(const FileInfo &info, size_t size, void *map):
+			FileData(info, size, static_cast<char*>(map)) {}
+		virtual ~FileDataMmap() { munmap(m_data, m_size); }
+	};
+
 	RefCountedPtr<FileData> FileSourceFS::ReadFile(const std::string &path)
 	{
 		const std::string fullpath = JoinPathBelow(GetRoot(), path);
-		FILE *fl = fopen(fullpath.c_str(), "rb");
-		if (!fl) {
+		const int fd = open(fullpath.c_str(), O_RDONLY);
+		if (fd == -1) {
 			return RefCountedPtr<FileData>(0);
-		} else {
-			fseek(fl, 0, SEEK_END);
-			long sz = ftell(fl);
-			fseek(fl, 0, SEEK_SET);
-			char *data = static_cast<char*>(std::malloc(sz));
-			if (!data) {
-				// XXX handling memory allocation failure gracefully is too hard right now
-				Output("failed when allocating buffer for '%s'\n", fullpath.c_str());
-				fclose(fl);
-				abort();
-			}
-			size_t read_size = fread(data, 1, sz, fl);
-			if (read_size != size_t(sz)) {
-				Output("file '%s' truncated!\n", fullpath.c_str());
-				memset(data + read_size, 0xee, sz - read_size);
+		}
+
+		struct stat statinfo;
+		if (fstat(fd, &statinfo) != 0 || !S_ISREG(statinfo.st_mode)) {
+			close(fd);
+			return RefCountedPtr<FileData>(0);
+		}
+		const size_t sz = size_t(statinfo.st_size);
+
+		if (sz >= MMAP_MIN_SIZE) {
+			// private and writable so that anything scribbling on its buffer
+			// gets its own copy of the page rather than a fault
+			void *map = mmap(0, sz, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			if (map != MAP_FAILED) {
+				close(fd);
+				return RefCountedPtr<FileData>(new FileDataMmap(MakeFileInfo(path, FileInfo::FT_FILE), sz, map));
 			}
-			fclose(fl);
-			return RefCountedPtr<FileData>(new FileDataMalloc(MakeFileInfo(path, FileInfo::FT_FILE), sz, data));
+			// fall back to reading it
+		}
+
+		char *data = static_cast<char*>(std::malloc(sz));
+		if (!data && sz) {
+			// XXX handling memory allocation failure gracefully is too hard right now
+			Output("failed when allocating buffer for '%s'\n", fullpath.c_str());
+			close(fd);
+			abort();
+		}
+		size_t read_size = 0;
+		while (read_size < sz) {
+			const ssize_t n = read(fd, data + read_size, sz - read_size);
+			if (n > 0)
+				read_size += n;
+			else if (n == 0 || errno != EINTR)
+				break;
+		}
+		if (read_size != sz) {
+			Output("file '%s' truncated!\n", fullpath.c_str());
+			memset(data + read_size, 0xee, sz - read_size);
 		}
+		close(fd);
+		return RefCountedPtr<FileData>(new FileDataMalloc(MakeFileInfo(path, FileInfo::FT_FILE), sz, data));
+	}
+
+	void FileSourceFS::Prefetch(const std::string &path)
+	{
+#ifdef POSIX_FADV_WILLNEED
+		// the kernel reads ahead in the background, nothing to wait for here
+		const std::string fullpath = JoinPathBelow(GetRoot(), path);
+		const int fd = open(fullpath.c_str(), O_RDONLY);
+		if (fd == -1) return;
+		posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+		close(fd);
+#endif
 	}
 
 	bool FileSourceFS::ReadDirectory(const std::string &dirpath, std::vector<FileInfo> &output)
@@ -242,6 +289,7 @@ namespace FileSystem {
 	FILE* FileSourceFS::OpenWriteStream(const std::string &path, int flags)
 	{
 		const std::string fullpath = JoinPathBelow(GetRoot(), path);
-		return fopen(fullpath.c_str(), (flags & WRITE_TEXT) ? "w" : "wb");
+		const char *mode = (flags & WRITE_APPEND) ? ((flags & WRITE_TEXT) ? "a" : "ab") : ((flags & WRITE_TEXT) ? "w" : "wb");
+		return fopen(fullpath.c_str(), mode);
 	}
 }
@@ -3,6 +3,8 @@
 
 #include "Animation.h"
 #include "scenegraph/Model.h"
+#include "NodeCopyCache.h"
+#include <algorithm>
 #include <iostream>
 
 namespace SceneGraph {
@@ -10,10 +12,51 @@ namespace SceneGraph {
 typedef std::vector<AnimationChannel> ChannelList;
 typedef ChannelList::iterator ChannelIterator;
 
+//the keys of every channel, one array per kind of value
+struct Animation::KeyTable {
+	struct Track {
+		Uint32 first;
+		Uint32 count;
+	};
+
+	std::vector<Track> positionTracks; //one of each per channel
+	std::vector<Track> rotationTracks;
+	std::vector<Track> scaleTracks;
+
+	std::vector<double> positionTimes;
+	std::vector<vector3f> positions;
+	std::vector<double> rotationTimes;
+	std::vector<Quaternionf> rotations;
+	std::vector<double> scaleTimes;
+	std::vector<vector3f> scales;
+};
+
+//the key to interpolate from at time t: the last one at or before t, or the
+//first. starts from where the last search ended, which is where it usually
+//ends again, and falls back to a binary search if it's not close
+static Uint32 find_key(const double *times, Uint32 count, double t, Uint32 &cursor)
+{
+	Uint32 frame = std::min(cursor, count - 1);
+	if (frame > 0 && t < times[frame]) {
+		frame = std::upper_bound(times + 1, times + frame, t) - (times + 1);
+	} else {
+		for (int steps = 0; frame + 1 < count && t >= times[frame + 1]; steps++) {
+			if (steps == 4) {
+				frame = std::upper_bound(times + frame + 1, times + count, t) - (times + 1);
+				break;
+			}
+			frame++;
+		}
+	}
+	cursor = frame;
+	return frame;
+}
+
 Animation::Animation(const std::string &name, double duration)
 : m_duration(duration)
 , m_time(0.0)
 , m_name(name)
+, m_dirty(true)
 {
 }
 
@@ -21,10 +64,49 @@ Animation::Animation(const Animation &anim)
 : m_duration(anim.m_duration)
 , m_time(0.0)
 , m_name(anim.m_name)
+, m_dirty(true)
 {
-	for(ChannelList::const_iterator chan = anim.m_channels.begin(); chan != anim.m_channels.end(); ++chan) {
-		m_channels.push_back(*chan);
+	//the keys are shared, an instance only needs the targets
+	anim.Compile();
+	m_keys = anim.m_keys;
+	for(ChannelList::const_iterator chan = anim.m_channels.begin(); chan != anim.m_channels.end(); ++chan)
+		m_channels.push_back(AnimationChannel(chan->node));
+	m_cursors.resize(m_channels.size());
+}
+
+void Animation::Compile() const
+{
+	if (m_keys) return;
+
+	KeyTable *keys = new KeyTable;
+	for(ChannelList::const_iterator chan = m_channels.begin(); chan != m_channels.end(); ++chan) {
+		KeyTable::Track track;
+
+		track.first = keys->positions.size();
+		track.count = chan->positionKeys.size();
+		keys->positionTracks.push_back(track);
+		for (std::vector<PositionKey>::const_iterator k = chan->positionKeys.begin(); k != chan->positionKeys.end(); ++k) {
+			keys->positionTimes.push_back(k->time);
+			keys->positions.push_back(k->position);
+		}
+
+		track.first = keys->rotations.size();
+		track.count = chan->rotationKeys.size();
+		keys->rotationTracks.push_back(track);
+		for (std::vector<RotationKey>::const_iterator k = chan->rotationKeys.begin(); k != chan->rotationKeys.end(); ++k) {
+			keys->rotationTimes.push_back(k->time);
+			keys->rotations.push_back(k->rotation);
+		}
+
+		track.first = keys->scales.size();
+		track.count = chan->scaleKeys.size();
+		keys->scaleTracks.push_back(track);
+		for (std::vector<ScaleKey>::const_iterator k = chan->scaleKeys.begin(); k != chan->scaleKeys.end(); ++k) {
+			keys->scaleTimes.push_back(k->time);
+			keys->scales.push_back(k->scale);
+		}
 	}
+	m_keys.reset(keys);
 }
 
 void Animation::UpdateChannelTargets(Node *root)
@@ -35,35 +117,48 @@ void Animation::UpdateChannelTargets(Node *root)
 		assert(trans);
 		chan->node = trans;
 	}
+	m_dirty = true;
+}
+
+void Animation::UpdateChannelTargets(const NodeCopyCache &cache)
+{
+	for(ChannelList::iterator chan = m_channels.begin(); chan != m_channels.end(); ++chan)
+		chan->node = cache.Find(chan->node);
+	m_dirty = true;
 }
 
 void Animation::Interpolate()
 {
+	//the transforms only depend on the time
+	if (!m_dirty) return;
+	m_dirty = false;
+
+	Compile();
+	const KeyTable &keys = *m_keys;
+	m_cursors.resize(m_channels.size());
+
 	const double mtime = m_time;
 
 	//go through channels and calculate transforms
-	for(ChannelIterator chan = m_channels.begin(); chan != m_channels.end(); ++chan) {
-		matrix4x4f trans = chan->node->GetTransform();
-
-		if (!chan->rotationKeys.empty()) {
-			//find a frame. To optimize, should begin search from previous frame (when mTime > previous mTime)
-			unsigned int frame = 0;
-			while (frame + 1 < chan->rotationKeys.size()) {
-				if (mtime < chan->rotationKeys[frame+1].time)
-					break;
-				frame++;
-			}
+	for(Uint32 c = 0; c < m_channels.size(); c++) {
+		MatrixTransform *node = m_channels[c].node;
+		Cursor &cursor = m_cursors[c];
+		matrix4x4f trans = node->GetTransform();
+
+		const KeyTable::Track &rotTrack = keys.rotationTracks[c];
+		if (rotTrack.count > 0) {
+			const double *times = &keys.rotationTimes[rotTrack.first];
+			const Quaternionf *rotations = &keys.rotations[rotTrack.first];
+			const Uint32 frame = find_key(times, rotTrack.count, mtime, cursor.rotation);
 
-			const RotationKey &a = chan->rotationKeys[frame];
 			vector3f saved_position = trans.GetTranslate();
-			if (frame + 1 < chan->rotationKeys.size()) {
-				const RotationKey &b = chan->rotationKeys[frame + 1];
-				double diffTime = b.time - a.time;
+			if (frame + 1 < rotTrack.count) {
+				double diffTime = times[frame + 1] - times[frame];
 				assert(diffTime > 0.0);
-				const float factor = Clamp(float((mtime - a.time) / diffTime), 0.f, 1.f);
-				trans = Quaternionf::Slerp(a.rotation, b.rotation, factor).ToMatrix3x3<float>();
+				const float factor = Clamp(float((mtime - times[frame]) / diffTime), 0.f, 1.f);
+				trans = Quaternionf::Slerp(rotations[frame], rotations[frame + 1], factor).ToMatrix3x3<float>();
 			} else {
-				trans = a.rotation.ToMatrix3x3<float>();
+				trans = rotations[frame].ToMatrix3x3<float>();
 			}
 			trans.SetTranslate(saved_position);
 		}
@@ -71,53 +166,43 @@ void Animation::Interpolate()
 		//scaling will not work without rotation since it would
 		//continously scale the transform (would have to add originalTransform or
 		//something to MT)
-		if (!chan->scaleKeys.empty() && !chan->rotationKeys.empty()) {
-			//find a frame. To optimize, should begin search from previous frame (when mTime > previous mTime)
-			unsigned int frame = 0;
-			while (frame + 1 < chan->scaleKeys.size()) {
-				if (mtime < chan->scaleKeys[frame+1].time)
-					break;
-				frame++;
-			}
+		const KeyTable::Track &scaleTrack = keys.scaleTracks[c];
+		if (scaleTrack.count > 0 && rotTrack.count > 0) {
+			const double *times = &keys.scaleTimes[scaleTrack.first];
+			const vector3f *scales = &keys.scales[scaleTrack.first];
+			const Uint32 frame = find_key(times, scaleTrack.count, mtime, cursor.scale);
 
-			const ScaleKey &a = chan->scaleKeys[frame];
 			vector3f out;
-			if (frame + 1 < chan->scaleKeys.size()) {
-				const ScaleKey &b = chan->scaleKeys[frame + 1];
-				double diffTime = b.time - a.time;
+			if (frame + 1 < scaleTrack.count) {
+				double diffTime = times[frame + 1] - times[frame];
 				assert(diffTime > 0.0);
-				const float factor = Clamp(float((mtime - a.time) / diffTime), 0.f, 1.f);
-				out = a.scale + (b.scale - a.scale) * factor;
+				const float factor = Clamp(float((mtime - times[frame]) / diffTime), 0.f, 1.f);
+				out = scales[frame] + (scales[frame + 1] - scales[frame]) * factor;
 			} else {
-				out = a.scale;
+				out = scales[frame];
 			}
 			trans.Scale(out.x, out.y, out.z);
 		}
 
-		if (!chan->positionKeys.empty()) {
-			//find a frame. To optimize, should begin search from previous frame (when mTime > previous mTime)
-			unsigned int frame = 0;
-			while (frame + 1 < chan->positionKeys.size()) {
-				if (mtime < chan->positionKeys[frame+1].time)
-					break;
-				frame++;
-			}
+		const KeyTable::Track &posTrack = keys.positionTracks[c];
+		if (posTrack.count > 0) {
+			const double *times = &keys.positionTimes[posTrack.first];
+			const vector3f *positions = &keys.positions[posTrack.first];
+			const Uint32 frame = find_key(times, posTrack.count, mtime, cursor.position);
 
-			const PositionKey &a = chan->positionKeys[frame];
 			vector3f out;
-			if (frame + 1 < chan->positionKeys.size()) {
-				const PositionKey &b = chan->positionKeys[frame + 1];
-				double diffTime = b.time - a.time;
+			if (frame + 1 < posTrack.count) {
+				double diffTime = times[frame + 1] - times[frame];
 				assert(diffTime > 0.0);
-				const float factor = Clamp(float((mtime - a.time) / diffTime), 0.f, 1.f);
-				out = a.position + (b.position - a.position) * factor;
+				const float factor = Clamp(float((mtime - times[frame]) / diffTime), 0.f, 1.f);
+				out = positions[frame] + (positions[frame + 1] - positions[frame]) * factor;
 			} else {
-				out = a.position;
+				out = positions[frame];
 			}
 			trans.SetTranslate(out);
 		}
 
-		chan->node->SetTransform(trans);
+		node->SetTransform(trans);
 	}
 }
 
@@ -128,7 +213,11 @@ double Animation::GetProgress()
 
 void Animation::SetProgress(double prog)
 {
-	m_time = Clamp(prog, 0.0, 1.0) * m_duration;
+	const double time = Clamp(prog, 0.0, 1.0) * m_duration;
+	if (time != m_time) {
+		m_time = time;
+		m_dirty = true;
+	}
 }
 
 }
@@ -7,34 +7,55 @@
  * A named animation, such as "GearDown".
  * An animation has a number of channels, each of which
  * animate the position/rotation of a single MatrixTransform node
+ *
+ * The keys are packed into one table per model, which the copies made
+ * for model instances share. A copy's channels only have their targets
+ * set. Each instance remembers where in the keys it was last time, and
+ * does nothing if the time hasn't changed since.
  */
 #include "AnimationChannel.h"
+#include <memory>
 
 namespace SceneGraph {
 
 class Loader;
 class BinaryConverter;
 class Node;
+class NodeCopyCache;
 
 class Animation {
 public:
 	Animation(const std::string &name, double duration);
 	Animation(const Animation&);
 	void UpdateChannelTargets(Node *root);
+	void UpdateChannelTargets(const NodeCopyCache &cache); //after the model was copied with cache
 	double GetDuration() const { return m_duration; }
 	const std::string &GetName() const { return m_name; }
 	double GetProgress();
 	void SetProgress(double); //0.0 -- 1.0, overrides m_time
-	void Interpolate(); //update transforms according to m_time;
+	void Interpolate(); //update transforms according to m_time, if it has changed
 	const std::vector<AnimationChannel>& GetChannels() const { return m_channels; }
 
 private:
 	friend class Loader;
 	friend class BinaryConverter;
+
+	struct KeyTable;
+	struct Cursor {
+		Cursor() : position(0), rotation(0), scale(0) {}
+		Uint32 position, rotation, scale;
+	};
+
+	//pack the channels' keys into m_keys, if that's not been done
+	void Compile() const;
+
 	double m_duration;
 	double m_time;
 	std::string m_name;
 	std::vector<AnimationChannel> m_channels;
+	mutable std::shared_ptr<const KeyTable> m_keys;
+	std::vector<Cursor> m_cursors; //per channel
+	bool m_dirty;
 };
 
 }
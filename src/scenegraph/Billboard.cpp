@@ -3,6 +3,7 @@
 
 #include "Billboard.h"
 #include "NodeVisitor.h"
+#include "NodeCopyCache.h"
 #include "graphics/Graphics.h"
 #include "graphics/Renderer.h"
 #include "graphics/VertexArray.h"
@@ -32,7 +33,7 @@ Billboard::Billboard(const Billboard &billboard, NodeCopyCache *cache)
 
 Node* Billboard::Clone(NodeCopyCache *cache)
 {
-	return new Billboard(*this, cache);
+	return cache->Copy<Billboard>(this);
 }
 
 void Billboard::Accept(NodeVisitor &nv)
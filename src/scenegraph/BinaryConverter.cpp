@@ -5,13 +5,16 @@
 #include "Parser.h"
 #include "FileSystem.h"
 #include "StringF.h"
+#include "CollMesh.h"
+#include "collider/GeomTree.h"
 
 using namespace SceneGraph;
 
 // Attempt at version history:
 // 1: prototype
 // 2: converted StaticMesh to VertexBuffer
-const Uint32 SGM_VERSION = 2;
+// 3: collision mesh stored with prebuilt BVHs
+const Uint32 SGM_VERSION = 3;
 const std::string SGM_EXTENSION = ".sgm";
 const std::string SAVE_TARGET_DIR = "binarymodels";
 
@@ -40,6 +43,18 @@ public:
 	NodeDatabase db;
 };
 
+//finds dynamic collision geometry in the same order as CollisionVisitor
+class DynamicCollisionGeometryFinder : public NodeVisitor
+{
+public:
+	virtual void ApplyCollisionGeometry(CollisionGeometry &cg) override
+	{
+		if (cg.IsDynamic()) geoms.push_back(&cg);
+	}
+
+	std::vector<CollisionGeometry*> geoms;
+};
+
 BinaryConverter::BinaryConverter(Graphics::Renderer *r)
 	: BaseLoader(r)
 	, m_patternsUsed(false)
@@ -104,9 +119,14 @@ void BinaryConverter::Save(const std::string& filename, const std::string& savep
 	for (unsigned int i = 0; i < m->GetNumTags(); i++)
 		wr.String(m->GetTagByIndex(i)->GetName().c_str());
 
+	SaveCollisionMesh(wr, m);
+
 	const std::string& data = wr.GetData();
 	const size_t nwritten = fwrite(data.data(), data.length(), 1, f);
 	fclose(f);
+	// the data dir is one of the game data sources, and it has a new file now
+	if (!savepath.empty())
+		FileSystem::gameDataFiles.InvalidateIndex();
 
 	if (nwritten != 1) throw CouldNotWriteToFileException();
 }
@@ -159,7 +179,7 @@ Model *BinaryConverter::CreateModel(Serializer::Reader &rd)
 		throw LoadingError("Not a binary model file");
 
 	const Uint32 version = rd.Int32();
-	if (version != 2)
+	if (version < 2 || version > SGM_VERSION)
 		throw LoadingError("Unsupported file version");
 
 	const std::string modelName = rd.String();
@@ -176,7 +196,13 @@ Model *BinaryConverter::CreateModel(Serializer::Reader &rd)
 	LoadAnimations(rd);
 
 	m_model->UpdateAnimations();
-	m_model->CreateCollisionMesh();
+	if (version >= 3) {
+		//tags are found again from the nodes, skip them
+		for (Uint32 numTags = rd.Int32(); numTags > 0; numTags--)
+			rd.String();
+		LoadCollisionMesh(rd);
+	} else
+		m_model->CreateCollisionMesh();
 	if (m_patternsUsed) SetUpPatterns();
 
 	return m_model;
@@ -295,6 +321,70 @@ void BinaryConverter::LoadAnimations(Serializer::Reader &rd)
 	}
 }
 
+void BinaryConverter::SaveCollisionMesh(Serializer::Writer &wr, Model *m)
+{
+	RefCountedPtr<CollMesh> collMesh = m->GetCollisionMesh();
+	if (!collMesh.Valid())
+		collMesh = m->CreateCollisionMesh();
+
+	const Aabb &aabb = collMesh->GetAabb();
+	wr.Vector3d(aabb.min);
+	wr.Vector3d(aabb.max);
+	wr.Double(aabb.radius);
+	wr.Int32(collMesh->GetNumTriangles());
+
+	collMesh->GetGeomTree()->Save(wr);
+
+	const auto &dynTrees = collMesh->GetDynGeomTrees();
+	wr.Int32(dynTrees.size());
+	for (const GeomTree *gt : dynTrees)
+		gt->Save(wr);
+}
+
+GeomTree *BinaryConverter::LoadGeomTree(Serializer::Reader &rd)
+{
+	// an old or damaged file mustn't send the traversals out of bounds
+	GeomTree *gt;
+	try {
+		gt = new GeomTree(rd);
+	} catch (const SavedGameCorruptException &) {
+		throw LoadingError("Corrupt collision mesh");
+	}
+	if (!gt->IsValid()) {
+		delete gt;
+		throw LoadingError("Corrupt collision mesh");
+	}
+	return gt;
+}
+
+void BinaryConverter::LoadCollisionMesh(Serializer::Reader &rd)
+{
+	RefCountedPtr<CollMesh> collMesh(new CollMesh());
+
+	Aabb &aabb = collMesh->GetAabb();
+	aabb.min = rd.Vector3d();
+	aabb.max = rd.Vector3d();
+	aabb.radius = rd.Double();
+	collMesh->SetNumTriangles(rd.Int32());
+
+	collMesh->SetGeomTree(LoadGeomTree(rd));
+
+	//dynamic trees were saved in the order their nodes are visited
+	DynamicCollisionGeometryFinder finder;
+	m_model->GetRoot()->Accept(finder);
+	const Uint32 numDynTrees = rd.Int32();
+	if (numDynTrees != finder.geoms.size())
+		throw LoadingError("Collision geometry mismatch");
+	for (CollisionGeometry *cg : finder.geoms) {
+		GeomTree *gt = LoadGeomTree(rd);
+		cg->SetGeomTree(gt);
+		collMesh->AddDynGeomTree(gt);
+	}
+
+	m_model->m_collMesh = collMesh;
+	m_model->m_boundingRadius = aabb.GetRadius();
+}
+
 ModelDefinition BinaryConverter::FindModelDefinition(const std::string &shortname)
 {
 	const std::string basepath = "models";
@@ -19,6 +19,8 @@
 #include "Billboard.h"
 #include <functional>
 
+class GeomTree;
+
 namespace SceneGraph
 {
 class BinaryConverter : public BaseLoader
@@ -40,6 +42,9 @@ private:
 	void LoadMaterials(Serializer::Reader&);
 	void SaveAnimations(Serializer::Writer&, Model* m);
 	void LoadAnimations(Serializer::Reader&);
+	void SaveCollisionMesh(Serializer::Writer&, Model* m);
+	void LoadCollisionMesh(Serializer::Reader&);
+	GeomTree *LoadGeomTree(Serializer::Reader&);
 	ModelDefinition FindModelDefinition(const std::string&);
 
 	Node* LoadNode(Serializer::Reader&);
@@ -0,0 +1,181 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "DrawList.h"
+#include "Billboard.h"
+#include "CollisionGeometry.h"
+#include "Group.h"
+#include "Label3D.h"
+#include "LOD.h"
+#include "MatrixTransform.h"
+#include "NodeVisitor.h"
+#include "StaticGeometry.h"
+#include "Thruster.h"
+
+namespace SceneGraph {
+
+// Group::RenderChildren checks each child's mask, LOD::Render doesn't, and
+// nothing checks the root's. m_checkMask says which applies to the node
+// being visited; every group sets it back to true when it's done
+class DrawListBuilder : public NodeVisitor {
+public:
+	DrawListBuilder(DrawList &list, const std::set<const Node*> &animated)
+	: m_list(list)
+	, m_animated(animated)
+	, m_local(matrix4x4f::Identity())
+	, m_checkMask(false)
+	{
+	}
+
+	virtual void ApplyNode(Node &n) { Emit(DrawList::OP_DRAW, &n); }
+	virtual void ApplyStaticGeometry(StaticGeometry &g) { Emit(DrawList::OP_DRAW, &g); }
+	virtual void ApplyLabel(Label3D &l) { Emit(DrawList::OP_DRAW, &l); }
+	virtual void ApplyBillboard(Billboard &b) { Emit(DrawList::OP_DRAW, &b); }
+	virtual void ApplyThruster(Thruster &t) { Emit(DrawList::OP_DRAW, &t); }
+	virtual void ApplyCollisionGeometry(CollisionGeometry &) { } //not drawn
+
+	virtual void ApplyGroup(Group &g) {
+		Watch(g);
+		const Uint32 rec = m_checkMask ? Emit(DrawList::OP_GROUP, &g) : NONE;
+		m_checkMask = true;
+		g.Traverse(*this);
+		Patch(rec);
+		m_checkMask = true;
+	}
+
+	virtual void ApplyMatrixTransform(MatrixTransform &m) {
+		Watch(m);
+		const matrix4x4f saved = m_local;
+		const bool animated = m_animated.count(&m) > 0;
+		Uint32 rec = NONE;
+		if (animated) {
+			rec = Emit(DrawList::OP_PUSH, &m);
+			m_local = matrix4x4f::Identity();
+		} else {
+			if (m_checkMask) rec = Emit(DrawList::OP_GROUP, &m);
+			m_local = m_local * m.GetTransform();
+		}
+		m_checkMask = true;
+		m.Traverse(*this);
+		if (animated)
+			Emit(DrawList::OP_POP, &m);
+		m_local = saved;
+		Patch(rec);
+		m_checkMask = true;
+	}
+
+	virtual void ApplyLOD(LOD &lod) {
+		Watch(lod);
+		const Uint32 rec = Emit(DrawList::OP_LOD, &lod);
+		const Uint32 numLevels = lod.GetNumChildren();
+		const Uint32 first = m_list.m_levels.size();
+		m_list.m_levels.resize(first + numLevels);
+		m_list.m_records[rec].levels = first;
+
+		std::vector<Uint32> jumps;
+		for (Uint32 i = 0; i < numLevels; i++) {
+			m_list.m_levels[first + i] = m_list.m_records.size();
+			m_checkMask = false;
+			lod.GetChildAt(i)->Accept(*this);
+			jumps.push_back(Emit(DrawList::OP_JUMP, &lod));
+		}
+		for (std::vector<Uint32>::const_iterator it = jumps.begin(); it != jumps.end(); ++it)
+			Patch(*it);
+		Patch(rec);
+		m_checkMask = true;
+	}
+
+private:
+	static const Uint32 NONE = ~Uint32(0);
+
+	Uint32 Emit(DrawList::Op op, Node *node) {
+		DrawList::Record r;
+		r.op = op;
+		r.checkMask = m_checkMask && op != DrawList::OP_POP && op != DrawList::OP_JUMP;
+		r.next = m_list.m_records.size() + 1;
+		r.levels = 0;
+		r.node = node;
+		r.transform = m_local;
+		m_list.m_records.push_back(r);
+		return m_list.m_records.size() - 1;
+	}
+
+	// before traversing, so parents come ahead of their children
+	void Watch(const Group &g) {
+		m_list.m_groups.push_back(std::make_pair(&g, g.GetChildrenVersion()));
+	}
+
+	// point rec past everything emitted since
+	void Patch(Uint32 rec) {
+		if (rec != NONE)
+			m_list.m_records[rec].next = m_list.m_records.size();
+	}
+
+	DrawList &m_list;
+	const std::set<const Node*> &m_animated;
+	matrix4x4f m_local;
+	bool m_checkMask;
+};
+
+void DrawList::Compile(Group *root, const std::set<const Node*> &animated)
+{
+	m_records.clear();
+	m_levels.clear();
+	m_groups.clear();
+	DrawListBuilder builder(*this, animated);
+	root->Accept(builder);
+}
+
+bool DrawList::IsCurrent() const
+{
+	// a removed group can only be reached through its parent, which is
+	// checked first and stops the loop before the removed one is read
+	for (std::vector<std::pair<const Group*, Uint32> >::const_iterator it = m_groups.begin(); it != m_groups.end(); ++it)
+		if (it->first->GetChildrenVersion() != it->second)
+			return false;
+	return true;
+}
+
+void DrawList::Render(const matrix4x4f &trans, const RenderData *rd)
+{
+	m_stack.clear();
+	m_stack.push_back(trans);
+
+	const Uint32 numRecords = m_records.size();
+	Uint32 i = 0;
+	while (i < numRecords) {
+		const Record &r = m_records[i];
+		if (r.checkMask && !(r.node->GetNodeMask() & rd->nodemask)) {
+			i = r.next;
+			continue;
+		}
+
+		switch (r.op) {
+			case OP_GROUP:
+				i++;
+				break;
+			case OP_PUSH:
+				m_stack.push_back(m_stack.back() * r.transform * static_cast<MatrixTransform*>(r.node)->GetTransform());
+				i++;
+				break;
+			case OP_POP:
+				m_stack.pop_back();
+				i++;
+				break;
+			case OP_LOD: {
+				const int level = static_cast<LOD*>(r.node)->PickLevel(m_stack.back() * r.transform, rd);
+				i = level < 0 ? r.next : m_levels[r.levels + level];
+				break;
+			}
+			case OP_JUMP:
+				i = r.next;
+				break;
+			case OP_DRAW:
+				r.node->Render(m_stack.back() * r.transform, rd);
+				i++;
+				break;
+		}
+	}
+}
+
+}
@@ -0,0 +1,70 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _SCENEGRAPH_DRAWLIST_H
+#define _SCENEGRAPH_DRAWLIST_H
+/*
+ * A model's node graph compiled into a flat list of records, so that
+ * drawing it is a loop rather than a walk through the graph.
+ *
+ * Unanimated transforms are multiplied out at compile time, each drawable
+ * record carrying the transform from the nearest animated transform (or
+ * the model) above it. Only animated transforms and LOD switches are
+ * evaluated when drawing. Node masks can change at any time (navlights,
+ * shields) so they are still checked when drawing, and a record that's
+ * masked out jumps past everything below it.
+ *
+ * The list holds plain pointers to the nodes, so it has to be compiled
+ * again whenever nodes are added or removed, or an unanimated transform
+ * changes. It keeps the children version of every group it went through,
+ * parents first, so it can tell children have been added or removed without
+ * touching a node that might have gone since; a moved transform still needs
+ * Model::InvalidateDrawList.
+ */
+#include "libs.h"
+#include <set>
+
+namespace SceneGraph {
+
+class Group;
+class Node;
+struct RenderData;
+
+class DrawList {
+public:
+	// animated: the transforms that change after compiling
+	void Compile(Group *root, const std::set<const Node*> &animated);
+	void Render(const matrix4x4f &trans, const RenderData *rd);
+	//false once a child has been added to or removed from any group in it
+	bool IsCurrent() const;
+
+private:
+	friend class DrawListBuilder;
+
+	enum Op {
+		OP_GROUP,   // only there to check the node mask
+		OP_PUSH,    // animated transform
+		OP_POP,
+		OP_LOD,
+		OP_JUMP,    // end of a LOD level
+		OP_DRAW
+	};
+
+	struct Record {
+		Uint8 op;
+		bool checkMask;
+		Uint32 next;     // where to carry on if masked out, or jump to
+		Uint32 levels;   // OP_LOD: index into m_levels
+		Node *node;
+		matrix4x4f transform;
+	};
+
+	std::vector<Record> m_records;
+	std::vector<Uint32> m_levels; // first record of each LOD level
+	std::vector<std::pair<const Group*, Uint32> > m_groups; // children versions, in preorder
+	std::vector<matrix4x4f> m_stack;
+};
+
+}
+
+#endif
@@ -10,6 +10,7 @@ namespace SceneGraph {
 
 Group::Group(Graphics::Renderer *r)
 : Node(r, NODE_SOLID | NODE_TRANSPARENT)
+, m_childrenVersion(0)
 {
 }
 
@@ -23,6 +24,7 @@ Group::~Group()
 
 Group::Group(const Group &group, NodeCopyCache *cache)
 : Node(group, cache)
+, m_childrenVersion(0)
 {
 	for(std::vector<Node*>::const_iterator itr = group.m_children.begin();
 		itr != group.m_children.end();
@@ -54,6 +56,7 @@ void Group::AddChild(Node *child)
 {
 	child->IncRefCount();
 	m_children.push_back(child);
+	m_childrenVersion++;
 }
 
 bool Group::RemoveChild(Node *node)
@@ -66,6 +69,7 @@ bool Group::RemoveChild(Node *node)
 		if((*itr) == node) {
 			itr = m_children.erase(itr);
 			node->DecRefCount();
+			m_childrenVersion++;
 			return true;
 		}
 	}
@@ -78,6 +82,7 @@ bool Group::RemoveChildAt(unsigned int idx)
 	Node *node = m_children.at(idx);
 	node->DecRefCount();
 	m_children.erase(m_children.begin() + idx);
+	m_childrenVersion++;
 	return true;
 }
 
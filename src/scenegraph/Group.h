@@ -24,6 +24,9 @@ public:
 	virtual bool RemoveChildAt(unsigned int position); //true on success
 	unsigned int GetNumChildren() const { return m_children.size(); }
 	Node* GetChildAt(unsigned int);
+	//goes up whenever a child is added or removed, so whatever was
+	//built from the children (a DrawList) can tell it's out of date
+	Uint32 GetChildrenVersion() const { return m_childrenVersion; }
 	virtual void Accept(NodeVisitor &v);
 	virtual void Traverse(NodeVisitor &v);
 	virtual void Render(const matrix4x4f &trans, const RenderData *rd);
@@ -33,6 +36,7 @@ protected:
 	virtual ~Group();
 	virtual void RenderChildren(const matrix4x4f &trans, const RenderData *rd);
 	std::vector<Node *> m_children;
+	Uint32 m_childrenVersion;
 };
 
 }
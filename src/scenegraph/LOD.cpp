@@ -39,18 +39,25 @@ void LOD::AddLevel(float pixelSize, Node *nod)
 }
 
 void LOD::Render(const matrix4x4f &trans, const RenderData *rd)
+{
+	const int lod = PickLevel(trans, rd);
+	if (lod >= 0)
+		m_children[lod]->Render(trans, rd);
+}
+
+int LOD::PickLevel(const matrix4x4f &trans, const RenderData *rd) const
 {
 	//figure out approximate pixel size of object's bounding radius
 	//on screen and pick a child to render
 	const vector3f cameraPos(-trans[12], -trans[13], -trans[14]);
 	//fov is vertical, so using screen height
 	const float pixrad = Graphics::GetScreenHeight() * rd->boundingRadius / (cameraPos.Length() * Graphics::GetFovFactor());
-	if (m_pixelSizes.empty()) return;
+	if (m_pixelSizes.empty()) return -1;
 	unsigned int lod = m_children.size() - 1;
 	for (unsigned int i=m_pixelSizes.size(); i > 0; i--) {
 		if (pixrad < m_pixelSizes[i-1]) lod = i-1;
 	}
-	m_children[lod]->Render(trans, rd);
+	return lod;
 }
 
 void LOD::Save(NodeDatabase &db)
@@ -18,6 +18,8 @@ public:
 	virtual const char *GetTypeName() const { return "LOD"; }
 	virtual void Accept(NodeVisitor &v);
 	virtual void Render(const matrix4x4f &trans, const RenderData *rd);
+	//child to draw at trans, -1 for none
+	int PickLevel(const matrix4x4f &trans, const RenderData *rd) const;
 	void AddLevel(float pixelRadius, Node *child);
 	virtual void Save(NodeDatabase&) override;
 	static LOD* Load(NodeDatabase&);
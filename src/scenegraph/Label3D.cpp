@@ -3,6 +3,7 @@
 
 #include "Label3D.h"
 #include "NodeVisitor.h"
+#include "NodeCopyCache.h"
 #include "graphics/Renderer.h"
 #include "graphics/VertexArray.h"
 
@@ -39,7 +40,7 @@ Label3D::Label3D(const Label3D &label, NodeCopyCache *cache)
 
 Node* Label3D::Clone(NodeCopyCache *cache)
 {
-	return new Label3D(*this, cache);
+	return cache->Copy<Label3D>(this);
 }
 
 void Label3D::SetText(const std::string &text)
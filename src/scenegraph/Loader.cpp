@@ -155,8 +155,13 @@ Model *Loader::LoadModel(const std::string &shortname, const std::string &basepa
 			if (sgmname == shortname) {
 				//binary loader expects extension-less name. Might want to change this.
 				SceneGraph::BinaryConverter bc(m_renderer);
-				m_model = bc.Load(shortname);
-				return m_model;
+				try {
+					m_model = bc.Load(shortname);
+					return m_model;
+				} catch (LoadingError &err) {
+					// stale or damaged, build it from the source model instead
+					Output("LoadModel: %s.sgm: %s\n", shortname.c_str(), err.what());
+				}
 			}
 		}
 	}
@@ -189,12 +194,29 @@ Model *Loader::LoadModel(const std::string &shortname, const std::string &basepa
 				throw LoadingError(err.what());
 			}
 			modelDefinition.name = shortname;
+			PrefetchFiles(modelDefinition);
 			return CreateModel(modelDefinition);
 		}
 	}
 	throw (LoadingError("File not found"));
 }
 
+// let the file system start on the meshes and textures while the model
+// is put together, they're read one after another as it goes
+void Loader::PrefetchFiles(const ModelDefinition &def)
+{
+	FileSystem::FileSource &fileSource = FileSystem::gameDataFiles;
+	for (const LodDefinition &lod : def.lodDefs)
+		for (const std::string &mesh : lod.meshNames)
+			fileSource.Prefetch(mesh);
+	for (const MaterialDefinition &mat : def.matDefs) {
+		if (!mat.tex_diff.empty()) fileSource.Prefetch(mat.tex_diff);
+		if (!mat.tex_spec.empty()) fileSource.Prefetch(mat.tex_spec);
+		if (!mat.tex_glow.empty()) fileSource.Prefetch(mat.tex_glow);
+		if (!mat.tex_ambi.empty()) fileSource.Prefetch(mat.tex_ambi);
+	}
+}
+
 Model *Loader::CreateModel(ModelDefinition &def)
 {
 	using Graphics::Material;
@@ -41,6 +41,7 @@ protected:
 	bool CheckKeysInRange(const aiNodeAnim *, double start, double end);
 	matrix4x4f ConvertMatrix(const aiMatrix4x4&) const;
 	Model *CreateModel(ModelDefinition &def);
+	void PrefetchFiles(const ModelDefinition &def);
 	RefCountedPtr<Node> LoadMesh(const std::string &filename, const AnimList &animDefs); //load one mesh file so it can be added to the model scenegraph. Materials should be created before this!
 	void AddLog(const std::string&);
 	void CheckAnimationConflicts(const Animation*, const std::vector<Animation*>&); //detect animation overlap
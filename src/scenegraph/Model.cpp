@@ -2,15 +2,51 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "Model.h"
+#include "CollisionGeometry.h"
 #include "CollisionVisitor.h"
+#include "DrawList.h"
 #include "NodeCopyCache.h"
+#include "StaticGeometry.h"
 #include "graphics/Renderer.h"
 #include "graphics/TextureBuilder.h"
 #include "graphics/VertexArray.h"
 #include "StringF.h"
+#include "utils.h"
 
 namespace SceneGraph {
 
+class CopySetVisitor : public NodeVisitor {
+public:
+	CopySetVisitor(std::set<const Node*> &nodes) : m_nodes(nodes) {}
+
+	virtual void ApplyNode(Node &n) { Visit(n, false); }
+	virtual void ApplyGroup(Group &g) { Visit(g, false); }
+	//navlights get their billboards attached per instance, and shields
+	//(see Shields::ReparentShieldNodes) show and hide their geometry
+	virtual void ApplyMatrixTransform(MatrixTransform &m) { Visit(m, starts_with(m.GetName(), "navlight_") || IsShield(m)); }
+	virtual void ApplyStaticGeometry(StaticGeometry &sg) { Visit(sg, !m_path.empty() && IsShield(*m_path.back())); }
+	virtual void ApplyLabel(Label3D &l) { Visit(l, true); }
+	virtual void ApplyCollisionGeometry(CollisionGeometry &cg) { Visit(cg, cg.IsDynamic()); }
+
+private:
+	static bool IsShield(const Node &n) { return ends_with(n.GetName(), "_accMtx4"); }
+
+	//a node that's copied needs all its parents copied too. nodes that are
+	//already in the set (animation targets) count as copied
+	void Visit(Node &n, bool copy) {
+		if (copy || m_nodes.count(&n)) {
+			m_nodes.insert(&n);
+			m_nodes.insert(m_path.begin(), m_path.end());
+		}
+		m_path.push_back(&n);
+		n.Traverse(*this);
+		m_path.pop_back();
+	}
+
+	std::set<const Node*> &m_nodes;
+	std::vector<const Node*> m_path;
+};
+
 class LabelUpdateVisitor : public NodeVisitor {
 public:
 	virtual void ApplyLabel(Label3D &l) {
@@ -45,7 +81,7 @@ Model::Model(const Model &model)
 , m_debugFlags(0)
 {
 	//selective copying of node structure
-	NodeCopyCache cache;
+	NodeCopyCache cache(&model.GetCopySet());
 	m_root.Reset(dynamic_cast<Group*>(model.m_root->Clone(&cache)));
 
 	//materials are shared by meshes
@@ -68,15 +104,12 @@ Model::Model(const Model &model)
 	for (AnimationContainer::const_iterator it = model.m_animations.begin(); it != model.m_animations.end(); ++it) {
 		const Animation *anim = *it;
 		m_animations.push_back(new Animation(*anim));
-		m_animations.back()->UpdateChannelTargets(m_root.Get());
+		m_animations.back()->UpdateChannelTargets(cache);
 	}
 
-	//m_tags needs to be updated
-	for (TagContainer::const_iterator it = model.m_tags.begin(); it != model.m_tags.end(); ++it) {
-		MatrixTransform *t = dynamic_cast<MatrixTransform*>(m_root->FindNode((*it)->GetName()));
-		assert(t != 0);
-		m_tags.push_back(t);
-	}
+	//tags are mostly shared, the copied ones need updating
+	for (TagContainer::const_iterator it = model.m_tags.begin(); it != model.m_tags.end(); ++it)
+		m_tags.push_back(cache.Find(*it));
 }
 
 Model::~Model()
@@ -90,6 +123,22 @@ Model *Model::MakeInstance() const
 	return m;
 }
 
+const std::set<const Node*> &Model::GetCopySet() const
+{
+	if (m_copySet.empty()) {
+		//the root always, so that nodes can be added to an instance
+		m_copySet.insert(m_root.Get());
+		for (AnimationContainer::const_iterator it = m_animations.begin(); it != m_animations.end(); ++it) {
+			const std::vector<AnimationChannel> &channels = (*it)->GetChannels();
+			for (std::vector<AnimationChannel>::const_iterator chan = channels.begin(); chan != channels.end(); ++chan)
+				m_copySet.insert(chan->node);
+		}
+		CopySetVisitor v(m_copySet);
+		m_root->Accept(v);
+	}
+	return m_copySet;
+}
+
 void Model::Render(const matrix4x4f &trans, const RenderData *rd)
 {
 	//update color parameters (materials are shared by model instances)
@@ -119,13 +168,24 @@ void Model::Render(const matrix4x4f &trans, const RenderData *rd)
 	if (m_debugFlags & DEBUG_WIREFRAME)
 		m_renderer->SetWireFrameMode(true);
 
+	if (!m_drawList || !m_drawList->IsCurrent()) {
+		std::set<const Node*> animated;
+		for (AnimationContainer::const_iterator it = m_animations.begin(); it != m_animations.end(); ++it) {
+			const std::vector<AnimationChannel> &channels = (*it)->GetChannels();
+			for (std::vector<AnimationChannel>::const_iterator chan = channels.begin(); chan != channels.end(); ++chan)
+				animated.insert(chan->node);
+		}
+		m_drawList.reset(new DrawList());
+		m_drawList->Compile(m_root.Get(), animated);
+	}
+
 	if (params.nodemask & MASK_IGNORE) {
-		m_root->Render(trans, &params);
+		m_drawList->Render(trans, &params);
 	} else {
 		params.nodemask = NODE_SOLID;
-		m_root->Render(trans, &params);
+		m_drawList->Render(trans, &params);
 		params.nodemask = NODE_TRANSPARENT;
-		m_root->Render(trans, &params);
+		m_drawList->Render(trans, &params);
 	}
 
 	if (!m_debugFlags)
@@ -155,6 +215,11 @@ void Model::Render(const matrix4x4f &trans, const RenderData *rd)
 	}
 }
 
+void Model::InvalidateDrawList()
+{
+	m_drawList.reset();
+}
+
 void Model::DrawAabb()
 {
 	if (!m_collMesh) return;
@@ -284,6 +349,7 @@ void Model::AddTag(const std::string &name, MatrixTransform *node)
 	node->SetNodeFlags(node->GetNodeFlags() | NODE_TAG);
 	m_root->AddChild(node);
 	m_tags.push_back(node);
+	InvalidateDrawList();
 }
 
 void Model::SetPattern(unsigned int index)
@@ -410,7 +476,14 @@ public:
 		matrix4x4f m;
 		for (int i = 0; i < 16; i++)
 			m[i] = rd->Float();
-		node.SetTransform(m);
+		//transforms shared with other instances haven't changed, leave them be
+		const matrix4x4f &cur = node.GetTransform();
+		for (int i = 0; i < 16; i++) {
+			if (m[i] != cur[i]) {
+				node.SetTransform(m);
+				break;
+			}
+		}
 	}
 
 private:
@@ -421,6 +494,7 @@ void Model::Load(Serializer::Reader &rd)
 {
 	LoadVisitor lv(&rd);
 	m_root->Accept(lv);
+	InvalidateDrawList();
 
 	for (AnimationContainer::const_iterator i = m_animations.begin(); i != m_animations.end(); ++i)
 		(*i)->SetProgress(rd.Double());
@@ -70,6 +70,8 @@
 #include "graphics/Drawables.h"
 #include "Serializer.h"
 #include "DeleteEmitter.h"
+#include <memory>
+#include <set>
 #include <stdexcept>
 
 namespace Graphics { class Renderer; }
@@ -79,6 +81,7 @@ namespace SceneGraph
 class BaseLoader;
 class ModelBinarizer;
 class BinaryConverter;
+class DrawList;
 
 struct LoadingError : public std::runtime_error {
 	LoadingError(const std::string &str) : std::runtime_error(str.c_str()) { }
@@ -98,12 +101,20 @@ public:
 	Model(Graphics::Renderer *r, const std::string &name);
 	~Model();
 
+	// instances share the template's nodes, except for the ones that hold
+	// per-instance state (animated transforms, labels, dynamic collision
+	// geometry, navlights, shields and their geometry) and the groups above
+	// them, which are copied
 	Model *MakeInstance() const;
 
 	const std::string& GetName() const { return m_name; }
 
 	float GetDrawClipRadius() const { return m_boundingRadius; }
 	void Render(const matrix4x4f &trans, const RenderData *rd = 0); //ModelNode can override RD
+	//nodes are drawn from a list compiled on first use, and again when
+	//children have been added or removed. call this after moving an
+	//unanimated transform
+	void InvalidateDrawList();
 	RefCountedPtr<CollMesh> CreateCollisionMesh();
 	RefCountedPtr<CollMesh> GetCollisionMesh() const { return m_collMesh; }
 	RefCountedPtr<Group> GetRoot() { return m_root; }
@@ -161,6 +172,12 @@ public:
 private:
 	Model(const Model&);
 
+	//nodes an instance needs its own copy of, worked out on first use
+	const std::set<const Node*> &GetCopySet() const;
+	mutable std::set<const Node*> m_copySet;
+
+	std::unique_ptr<DrawList> m_drawList;
+
 	static const unsigned int MAX_DECAL_MATERIALS = 4;
 	ColorMap m_colorMap;
 	float m_boundingRadius;
@@ -6,27 +6,43 @@
 
 #include "RefCounted.h"
 #include <map>
+#include <set>
 
 namespace SceneGraph {
 
 class Node;
 
+// nodes are copied once however many parents they have. given a set of
+// nodes to copy, everything else is shared with the original
 class NodeCopyCache {
 public:
+	NodeCopyCache() : m_copySet(0) {}
+	NodeCopyCache(const std::set<const Node*> *copySet) : m_copySet(copySet) {}
+
 	template <typename T> T *Copy(const T *origNode) {
-		const bool doCache = origNode->GetRefCount() > 1;
-		if (doCache) {
-			std::map<const Node*,Node*>::const_iterator i = m_cache.find(origNode);
-			if (i != m_cache.end())
-				return static_cast<T*>((*i).second);
-		}
+		if (m_copySet && !m_copySet->count(origNode))
+			return const_cast<T*>(origNode);
+		std::map<const Node*,Node*>::const_iterator i = m_cache.find(origNode);
+		if (i != m_cache.end())
+			return static_cast<T*>((*i).second);
 		T *newNode = new T(*origNode, this);
-		if (doCache)
-			m_cache.insert(std::make_pair(origNode, newNode));
+		m_cache.insert(std::make_pair(origNode, newNode));
 		return newNode;
 	}
 
+	// for nodes that are shared even without a set, unless it asks for them
+	bool InCopySet(const Node *node) const { return m_copySet && m_copySet->count(node); }
+
+	// what origNode became in the copy: the copy, or origNode if it was shared
+	template <typename T> T *Find(const T *origNode) const {
+		std::map<const Node*,Node*>::const_iterator i = m_cache.find(origNode);
+		if (i != m_cache.end())
+			return static_cast<T*>((*i).second);
+		return const_cast<T*>(origNode);
+	}
+
 private:
+	const std::set<const Node*> *m_copySet;
 	std::map<const Node*,Node*> m_cache;
 };
 
@@ -3,6 +3,7 @@
 
 #include "StaticGeometry.h"
 #include "NodeVisitor.h"
+#include "NodeCopyCache.h"
 #include "Model.h"
 #include "BaseLoader.h"
 #include "graphics/Graphics.h"
@@ -33,7 +34,10 @@ StaticGeometry::StaticGeometry(const StaticGeometry &sg, NodeCopyCache *cache)
 
 Node* StaticGeometry::Clone(NodeCopyCache *cache)
 {
-	return this; //geometries are shared
+	//geometries are shared, except for the ones instances change (shields)
+	if (cache->InCopySet(this))
+		return cache->Copy<StaticGeometry>(this);
+	return this;
 }
 
 void StaticGeometry::Accept(NodeVisitor &nv)
@@ -0,0 +1,273 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include "HeightMap.h"
+#include "utils.h"
+#include <cstring>
+
+static const char HEIGHTMAP_MAGIC[4] = { 'P', 'H', 'M', 'T' };
+static const Uint32 HEIGHTMAP_VERSION = 1;
+
+// for untiled files, tiled when they're loaded
+static const int UNTILED_TILE_SIZE = 64;
+
+static size_t bufread_or_die(void *ptr, size_t size, size_t nmemb, ByteRange &buf)
+{
+	size_t read_count = buf.read(static_cast<char*>(ptr), size, nmemb);
+	if (read_count < nmemb) {
+		Output("Error: failed to read file (truncated)\n");
+		abort();
+	}
+	return read_count;
+}
+
+static inline int level_size(int size, int level)
+{
+	return (size + (1 << level) - 1) >> level;
+}
+
+HeightMap::HeightMap(const std::string &filename, unsigned int fractal)
+{
+	m_file = FileSystem::gameDataFiles.ReadFile(filename);
+	if (!m_file) {
+		Output("Error: could not open file '%s'\n", filename.c_str());
+		abort();
+	}
+
+	ByteRange data = m_file->AsByteRange();
+	if (data.Size() >= sizeof(HEIGHTMAP_MAGIC) && memcmp(data.begin, HEIGHTMAP_MAGIC, sizeof(HEIGHTMAP_MAGIC)) == 0)
+		LoadTiled(data);
+	else {
+		LoadUntiled(data, fractal);
+		// everything's been copied out of it
+		m_file.Reset();
+	}
+
+	m_spacing = M_PI / std::max(m_levels[0].height-1, 1);
+}
+
+void HeightMap::LoadTiled(ByteRange data)
+{
+	const ByteRange file = data;
+
+	char magic[4];
+	Uint32 version, width, height, tileSize, numLevels, dataOffset;
+	bufread_or_die(magic, 1, 4, data);
+	bufread_or_die(&version, 4, 1, data);
+	bufread_or_die(&width, 4, 1, data);
+	bufread_or_die(&height, 4, 1, data);
+	bufread_or_die(&tileSize, 4, 1, data);
+	bufread_or_die(&numLevels, 4, 1, data);
+	bufread_or_die(&m_scale, 8, 1, data);
+	bufread_or_die(&m_offset, 8, 1, data);
+	bufread_or_die(&dataOffset, 4, 1, data);
+
+	if (version != HEIGHTMAP_VERSION || !width || !height || width > 0x100000 || height > 0x100000 ||
+			!tileSize || tileSize > 4096 || (tileSize & (tileSize-1)) ||
+			!numLevels || numLevels > 20 || (dataOffset & 1)) {
+		Output("Error: bad heightmap header (version %u, %ux%u, tiles %u, levels %u)\n", version, width, height, tileSize, numLevels);
+		abort();
+	}
+
+	// check the tiles are all there before pointing into them
+	size_t numSamples = 0;
+	for (Uint32 i = 0; i < numLevels; i++) {
+		const size_t tilesX = (level_size(width, i) + tileSize-1) / tileSize;
+		const size_t tilesY = (level_size(height, i) + tileSize-1) / tileSize;
+		numSamples += tilesX * tilesY * tileSize * tileSize;
+	}
+	if (dataOffset > file.Size() || (file.Size() - dataOffset) / sizeof(Uint16) < numSamples) {
+		Output("Error: failed to read file (truncated)\n");
+		abort();
+	}
+
+	m_tileSize = tileSize;
+	SetLevels(width, height, numLevels, reinterpret_cast<const Uint16*>(file.begin + dataOffset));
+}
+
+void HeightMap::LoadUntiled(ByteRange data, unsigned int fractal)
+{
+	Uint16 v;
+	int sizeX, sizeY;
+	std::unique_ptr<Uint16[]> samples;
+
+	// XXX unify heightmap types
+	switch (fractal) {
+		case 0: {
+			bufread_or_die(&v, 2, 1, data); sizeX = v;
+			bufread_or_die(&v, 2, 1, data); sizeY = v;
+			const Uint32 area = sizeX * sizeY;
+
+			// signed metres, moved up into unsigned range
+			std::unique_ptr<Sint16[]> heights(new Sint16[area]);
+			bufread_or_die(heights.get(), sizeof(Sint16), area, data);
+			samples.reset(new Uint16[area]);
+			for (Uint32 i = 0; i < area; i++)
+				samples[i] = Uint16(int(heights[i]) + 32768);
+			m_scale = 1.0;
+			m_offset = -32768.0;
+			break;
+		}
+
+		case 1: {
+			// XXX x and y reversed from above *sigh*
+			bufread_or_die(&v, 2, 1, data); sizeY = v;
+			bufread_or_die(&v, 2, 1, data); sizeX = v;
+			const Uint32 area = sizeX * sizeY;
+
+			bufread_or_die(&m_scale, 8, 1, data);
+			bufread_or_die(&m_offset, 8, 1, data);
+
+			samples.reset(new Uint16[area]);
+			bufread_or_die(samples.get(), sizeof(Uint16), area, data);
+			break;
+		}
+
+		default:
+			assert(0);
+			abort();
+	}
+
+	if (!sizeX || !sizeY) {
+		Output("Error: empty heightmap\n");
+		abort();
+	}
+
+	m_tileSize = UNTILED_TILE_SIZE;
+	BuildLevels(samples.get(), sizeX, sizeY);
+}
+
+// tile the samples, halving them until they fit in a tile
+void HeightMap::BuildLevels(const Uint16 *samples, int width, int height)
+{
+	const int T = m_tileSize;
+
+	int numLevels = 1;
+	while (level_size(std::max(width, height), numLevels-1) > T)
+		numLevels++;
+
+	size_t numSamples = 0;
+	for (int i = 0; i < numLevels; i++)
+		numSamples += size_t((level_size(width, i) + T-1) / T) * ((level_size(height, i) + T-1) / T) * T * T;
+	m_data.reset(new Uint16[numSamples]);
+
+	std::vector<Uint16> level(samples, samples + width*height);
+	std::vector<Uint16> next;
+	Uint16 *out = m_data.get();
+	for (int i = 0; i < numLevels; i++) {
+		const int w = level_size(width, i);
+		const int h = level_size(height, i);
+		const int tilesX = (w + T-1) / T;
+		const int tilesY = (h + T-1) / T;
+
+		for (int ty = 0; ty < tilesY; ty++)
+			for (int tx = 0; tx < tilesX; tx++)
+				for (int y = 0; y < T; y++) {
+					const Uint16 *row = &level[std::min(ty*T + y, h-1) * w];
+					for (int x = 0; x < T; x++)
+						*out++ = row[std::min(tx*T + x, w-1)];
+				}
+
+		if (i == numLevels-1) break;
+
+		// average each 2x2, repeating the last row or column of an odd size
+		const int nw = level_size(width, i+1);
+		const int nh = level_size(height, i+1);
+		next.resize(nw * nh);
+		for (int y = 0; y < nh; y++) {
+			const int y0 = 2*y, y1 = std::min(2*y+1, h-1);
+			for (int x = 0; x < nw; x++) {
+				const int x0 = 2*x, x1 = std::min(2*x+1, w-1);
+				const int sum = level[y0*w + x0] + level[y0*w + x1] + level[y1*w + x0] + level[y1*w + x1];
+				next[y*nw + x] = Uint16((sum + 2) / 4);
+			}
+		}
+		level.swap(next);
+	}
+	assert(out == m_data.get() + numSamples);
+
+	SetLevels(width, height, numLevels, m_data.get());
+}
+
+void HeightMap::SetLevels(int width, int height, int numLevels, const Uint16 *tiles)
+{
+	m_tileShift = 0;
+	while ((1 << m_tileShift) < m_tileSize)
+		m_tileShift++;
+
+	m_levels.resize(numLevels);
+	for (int i = 0; i < numLevels; i++) {
+		Level &l = m_levels[i];
+		l.width = level_size(width, i);
+		l.height = level_size(height, i);
+		l.tilesX = (l.width + m_tileSize-1) / m_tileSize;
+		l.tiles = tiles;
+		tiles += size_t(l.tilesX) * ((l.height + m_tileSize-1) / m_tileSize) * m_tileSize * m_tileSize;
+	}
+}
+
+double HeightMap::GetHeight(const vector3d &p, double footprint) const
+{
+	const double latitude = -asin(Clamp(p.y, -1.0, 1.0));
+	const double longitude = atan2(p.x, p.z);
+
+	const int last = int(m_levels.size()) - 1;
+	if (footprint <= m_spacing || last == 0)
+		return m_offset + m_scale * Interpolate(0, longitude, latitude);
+
+	// blend the two levels either side of the footprint, so that nothing
+	// jumps when a patch is split
+	const double lod = std::min(log2(footprint / m_spacing), double(last));
+	const int level = int(lod);
+	double v = Interpolate(level, longitude, latitude);
+	if (level < last)
+		v += (Interpolate(level+1, longitude, latitude) - v) * (lod - level);
+	return m_offset + m_scale * v;
+}
+
+double HeightMap::Interpolate(int l, double longitude, double latitude) const
+{
+	// position on the full size level. a sample on a smaller one averages
+	// 2^l of those across, and sits at their middle
+	const Level &level = m_levels[l];
+	const double scale = double(1 << l);
+	const double px = ((m_levels[0].width-1) * (longitude + M_PI) / (2*M_PI) + 0.5) / scale - 0.5;
+	const double py = ((m_levels[0].height-1) * (latitude + 0.5*M_PI) / M_PI + 0.5) / scale - 0.5;
+	// not clamped: Sample repeats the edges
+	int ix = int(floor(px));
+	int iy = int(floor(py));
+	double dx = px-ix;
+	double dy = py-iy;
+
+	// p0,3 p1,3 p2,3 p3,3
+	// p0,2 p1,2 p2,2 p3,2
+	// p0,1 p1,1 p2,1 p3,1
+	// p0,0 p1,0 p2,0 p3,0
+	double map[4][4];
+	for (int x=-1; x<3; x++) {
+		for (int y=-1; y<3; y++) {
+			map[x+1][y+1] = Sample(level, ix+x, iy+y);
+		}
+	}
+
+	double c[4];
+	for (int j=0; j<4; j++) {
+		double d0 = map[0][j] - map[1][j];
+		double d2 = map[2][j] - map[1][j];
+		double d3 = map[3][j] - map[1][j];
+		double a0 = map[1][j];
+		double a1 = -(1/3.0)*d0 + d2 - (1/6.0)*d3;
+		double a2 = 0.5*d0 + 0.5*d2;
+		double a3 = -(1/6.0)*d0 - 0.5*d2 + (1/6.0)*d3;
+		c[j] = a0 + a1*dx + a2*dx*dx + a3*dx*dx*dx;
+	}
+
+	double d0 = c[0] - c[1];
+	double d2 = c[2] - c[1];
+	double d3 = c[3] - c[1];
+	double a0 = c[1];
+	double a1 = -(1/3.0)*d0 + d2 - (1/6.0)*d3;
+	double a2 = 0.5*d0 + 0.5*d2;
+	double a3 = -(1/6.0)*d0 - 0.5*d2 + (1/6.0)*d3;
+	return a0 + a1*dy + a2*dy*dy + a3*dy*dy*dy;
+}
@@ -0,0 +1,79 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#ifndef _HEIGHTMAP_H
+#define _HEIGHTMAP_H
+
+#include "libs.h"
+#include "FileSystem.h"
+#include <memory>
+
+// An equirectangular heightmap of 16-bit samples, stored as square tiles
+// with a chain of half size levels below the full one. A height is
+// offset + scale*sample.
+//
+// The tiled format (.thm, written by scripts/make_heightmap.py) is read in
+// place from the file, which the filesystem maps rather than reads when it's
+// big enough, so only the tiles that get sampled are ever paged in. The old
+// untiled .hmap files are still read, and tiled in memory when loaded.
+//
+// File layout, little endian:
+//   char magic[4] "PHMT", Uint32 version
+//   Uint32 width, height    full size, in samples
+//   Uint32 tileSize         samples along a tile's side, a power of two
+//   Uint32 levels           including the full size one
+//   double scale, offset
+//   Uint32 dataOffset       to the first tile, from the start of the file
+// then each level's tiles, full size first, a row of tiles at a time. a
+// level is (size + (1<<level) - 1) >> level samples across, and the tiles
+// along its right and bottom edges repeat its last sample to fill them.
+class HeightMap {
+public:
+	// fractal picks the layout of an untiled file; tiled files say what they are
+	HeightMap(const std::string &filename, unsigned int fractal);
+
+	// height at p (on the unit sphere), cubic interpolated. footprint is the
+	// distance between samples as for Terrain::GetHeight, used to pick the
+	// level; 0 reads the full size one
+	double GetHeight(const vector3d &p, double footprint = 0.0) const;
+
+	double GetScale() const { return m_scale; }
+	double GetOffset() const { return m_offset; }
+	int GetSizeX() const { return m_levels[0].width; }
+	int GetSizeY() const { return m_levels[0].height; }
+
+private:
+	struct Level {
+		int width;
+		int height;
+		int tilesX;
+		const Uint16 *tiles;
+	};
+
+	void LoadTiled(ByteRange data);
+	void LoadUntiled(ByteRange data, unsigned int fractal);
+	void BuildLevels(const Uint16 *samples, int width, int height);
+	void SetLevels(int width, int height, int numLevels, const Uint16 *tiles);
+
+	inline double Sample(const Level &level, int x, int y) const {
+		x = Clamp(x, 0, level.width-1);
+		y = Clamp(y, 0, level.height-1);
+		const Uint16 *tile = level.tiles + ((y >> m_tileShift) * level.tilesX + (x >> m_tileShift)) * (m_tileSize * m_tileSize);
+		return tile[(y & (m_tileSize-1)) * m_tileSize + (x & (m_tileSize-1))];
+	}
+	double Interpolate(int level, double longitude, double latitude) const;
+
+	int m_tileSize;
+	int m_tileShift;
+	double m_scale;
+	double m_offset;
+	// angle between samples on the full size level
+	double m_spacing;
+	std::vector<Level> m_levels;
+
+	// whichever the tiles are in
+	RefCountedPtr<FileSystem::FileData> m_file;
+	std::unique_ptr<Uint16[]> m_data;
+};
+
+#endif
@@ -2,9 +2,9 @@
 // Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
 
 #include "Terrain.h"
+#include "HeightMap.h"
 #include "perlin.h"
 #include "Pi.h"
-#include "FileSystem.h"
 #include "FloatComparison.h"
 
 // static instancer. selects the best height and color classes for the body
@@ -350,102 +350,12 @@ Terrain *Terrain::InstanceTerrain(const SystemBody *body)
 	return gi(body);
 }
 
-static size_t bufread_or_die(void *ptr, size_t size, size_t nmemb, ByteRange &buf)
-{
-	size_t read_count = buf.read(static_cast<char*>(ptr), size, nmemb);
-	if (read_count < nmemb) {
-		Output("Error: failed to read file (truncated)\n");
-		abort();
-	}
-	return read_count;
-}
-
-// XXX this sucks, but there isn't a reliable cross-platform way to get them
-#ifndef INT16_MIN
-# define INT16_MIN   (-32767-1)
-#endif
-#ifndef INT16_MAX
-# define INT16_MAX   (32767)
-#endif
-#ifndef UINT16_MAX
-# define UINT16_MAX  (65535)
-#endif
-
-Terrain::Terrain(const SystemBody *body) : m_seed(body->GetSeed()), m_rand(body->GetSeed()), m_heightScaling(0), m_minh(0), m_minBody(body) {
+Terrain::Terrain(const SystemBody *body) : m_seed(body->GetSeed()), m_rand(body->GetSeed()), m_heightScaling(0), m_minBody(body) {
 
 	// load the heightmap
 	if (!body->GetHeightMapFilename().empty()) {
-		RefCountedPtr<FileSystem::FileData> fdata = FileSystem::gameDataFiles.ReadFile(body->GetHeightMapFilename());
-		if (!fdata) {
-			Output("Error: could not open file '%s'\n", body->GetHeightMapFilename().c_str());
-			abort();
-		}
-
-		ByteRange databuf = fdata->AsByteRange();
-
-		Sint16 minHMap = INT16_MAX, maxHMap = INT16_MIN;
-		Uint16 minHMapScld = UINT16_MAX, maxHMapScld = 0;
-
-		// XXX unify heightmap types
-		switch (body->GetHeightMapFractal()) {
-			case 0: {
-				Uint16 v;
-				bufread_or_die(&v, 2, 1, databuf); m_heightMapSizeX = v;
-				bufread_or_die(&v, 2, 1, databuf); m_heightMapSizeY = v;
-				const Uint32 heightmapPixelArea = (m_heightMapSizeX * m_heightMapSizeY);
-
-				std::unique_ptr<Sint16[]> heightMap(new Sint16[heightmapPixelArea]);
-				bufread_or_die(heightMap.get(), sizeof(Sint16), heightmapPixelArea, databuf);
-				m_heightMap.reset(new double[heightmapPixelArea]);
-				double *pHeightMap = m_heightMap.get();
-				for(Uint32 i=0; i<heightmapPixelArea; i++) {
-					const Sint16 val = heightMap.get()[i];
-					minHMap = std::min(minHMap, val);
-					maxHMap = std::max(maxHMap, val);
-					// store then increment pointer
-					(*pHeightMap) = val;
-					++pHeightMap;
-				}
-				assert(pHeightMap == &m_heightMap[heightmapPixelArea]);
-				//Output("minHMap = (%hd), maxHMap = (%hd)\n", minHMap, maxHMap);
-				break;
-			}
-
-			case 1: {
-				Uint16 v;
-				// XXX x and y reversed from above *sigh*
-				bufread_or_die(&v, 2, 1, databuf); m_heightMapSizeY = v;
-				bufread_or_die(&v, 2, 1, databuf); m_heightMapSizeX = v;
-				const Uint32 heightmapPixelArea = (m_heightMapSizeX * m_heightMapSizeY);
-
-				// read height scaling and min height which are doubles
-				double te;
-				bufread_or_die(&te, 8, 1, databuf);
-				m_heightScaling = te;
-				bufread_or_die(&te, 8, 1, databuf);
-				m_minh = te;
-
-				std::unique_ptr<Uint16[]> heightMapScaled(new Uint16[heightmapPixelArea]);
-				bufread_or_die(heightMapScaled.get(), sizeof(Uint16), heightmapPixelArea, databuf);
-				m_heightMap.reset(new double[heightmapPixelArea]);
-				double *pHeightMap = m_heightMap.get();
-				for(Uint32 i=0; i<heightmapPixelArea; i++) {
-					const Uint16 val = heightMapScaled[i];
-					minHMapScld = std::min(minHMapScld, val);
-					maxHMapScld = std::max(maxHMapScld, val);
-					// store then increment pointer
-					(*pHeightMap) = val;
-					++pHeightMap;
-				}
-				assert(pHeightMap == &m_heightMap[heightmapPixelArea]);
-				//Output("minHMapScld = (%hu), maxHMapScld = (%hu)\n", minHMapScld, maxHMapScld);
-				break;
-			}
-
-			default:
-				assert(0);
-		}
-
+		m_heightMap.reset(new HeightMap(body->GetHeightMapFilename(), body->GetHeightMapFractal()));
+		m_heightScaling = m_heightMap->GetScale();
 	}
 
 	switch (Pi::detail.textures) {
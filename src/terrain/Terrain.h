@@ -12,15 +12,17 @@
 #endif
 
 struct fracdef_t {
-	fracdef_t() : amplitude(0.0), frequency(0.0), lacunarity(0.0), octaves(0) {}
+	fracdef_t() : amplitude(0.0), frequency(0.0), lacunarity(0.0), octaves(0), fade(1.0) {}
 	double amplitude;
 	double frequency;
 	double lacunarity;
 	int octaves;
+	double fade; // weight of the last octave
 };
 
 
 template <typename,typename> class TerrainGenerator;
+class HeightMap;
 
 
 class Terrain : public RefCounted {
@@ -40,8 +42,36 @@ public:
 	void SetFracDef(const unsigned int index, const double featureHeightMeters, const double featureWidthMeters, const double smallestOctaveMeters = 20.0);
 	inline const fracdef_t &GetFracDef(const unsigned int index) const { assert(index>=0 && index<MAX_FRACDEFS); return m_fracdef[index]; }
 
-	virtual double GetHeight(const vector3d &p) const = 0;
-	virtual vector3d GetColor(const vector3d &p, double height, const vector3d &norm) const = 0;
+	// the fracdef without the octaves too fine to show between samples
+	// footprint apart (in planet radii). the finest octave kept fades out as
+	// its features shrink from lacunarity times the footprint down to the
+	// footprint, where it's dropped, so nothing pops when a patch is split
+	// or merged. the first octave is always kept whole
+	inline fracdef_t GetFracDef(const unsigned int index, const double footprint) const {
+		fracdef_t def = GetFracDef(index);
+		if (footprint <= 0.0 || def.octaves <= 1 || def.lacunarity <= 1.0) return def;
+		// size of each octave's features, dropped once they're no bigger than the footprint
+		double size = 1.0 / def.frequency;
+		int octaves = 0;
+		while (octaves < def.octaves && size > footprint) {
+			size /= def.lacunarity;
+			octaves++;
+		}
+		if (octaves <= 1) {
+			def.octaves = 1;
+			return def;
+		}
+		const double finest = size * def.lacunarity;
+		def.fade = Clamp((finest / footprint - 1.0) / (def.lacunarity - 1.0), 0.0, 1.0);
+		def.octaves = octaves;
+		return def;
+	}
+
+	// footprint is the distance between samples, in planet radii, or 0 for
+	// every octave. positions that have to agree between patches of different
+	// detail (their edges, collisions) must use 0
+	virtual double GetHeight(const vector3d &p, double footprint = 0.0) const = 0;
+	virtual vector3d GetColor(const vector3d &p, double height, const vector3d &norm, double footprint = 0.0) const = 0;
 
 	virtual const char *GetHeightFractalName() const = 0;
 	virtual const char *GetColorFractalName() const = 0;
@@ -76,12 +106,8 @@ protected:
 	Uint32 m_surfaceEffects;
 
 	// heightmap stuff
-	// XXX unify heightmap types
-	std::unique_ptr<double[]> m_heightMap;
-	double m_heightScaling, m_minh;
-
-	int m_heightMapSizeX;
-	int m_heightMapSizeY;
+	std::unique_ptr<HeightMap> m_heightMap;
+	double m_heightScaling;
 
 	/** General attributes */
 	double m_maxHeight;
@@ -128,7 +154,7 @@ protected:
 template <typename HeightFractal>
 class TerrainHeightFractal : virtual public Terrain {
 public:
-	virtual double GetHeight(const vector3d &p) const;
+	virtual double GetHeight(const vector3d &p, double footprint = 0.0) const;
 	virtual const char *GetHeightFractalName() const;
 protected:
 	TerrainHeightFractal(const SystemBody *body);
@@ -139,7 +165,7 @@ private:
 template <typename ColorFractal>
 class TerrainColorFractal : virtual public Terrain {
 public:
-	virtual vector3d GetColor(const vector3d &p, double height, const vector3d &norm) const;
+	virtual vector3d GetColor(const vector3d &p, double height, const vector3d &norm, double footprint = 0.0) const;
 	virtual const char *GetColorFractalName() const;
 protected:
 	TerrainColorFractal(const SystemBody *body);
@@ -15,7 +15,7 @@ TerrainColorFractal<TerrainColorAsteroid>::TerrainColorFractal(const SystemBody
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorAsteroid>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorAsteroid>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n = m_invMaxHeight*height/2;
 
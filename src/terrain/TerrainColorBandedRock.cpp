@@ -15,7 +15,7 @@ TerrainColorFractal<TerrainColorBandedRock>::TerrainColorFractal(const SystemBod
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorBandedRock>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorBandedRock>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	const double flatness = pow(p.Dot(norm), 6.0);
 	double n = fabs(noise(vector3d(height*10000.0,0.0,0.0)));
@@ -20,7 +20,7 @@ TerrainColorFractal<TerrainColorEarthLikeHeightmapped>::TerrainColorFractal(cons
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorEarthLikeHeightmapped>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorEarthLikeHeightmapped>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n = m_invMaxHeight*height;
 	double flatness = pow(p.Dot(norm), 8.0);
@@ -21,13 +21,13 @@ TerrainColorFractal<TerrainColorGGJupiter>::TerrainColorFractal(const SystemBody
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorGGJupiter>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorGGJupiter>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n;
-	const double h = river_octavenoise(GetFracDef(0), 0.5*m_entropy[0] + 0.25f,
+	const double h = river_octavenoise(GetFracDef(0, footprint), 0.5*m_entropy[0] + 0.25f,
 			vector3d(noise(vector3d(p.x*8, p.y*32, p.z*8))))*.125;
-	const double equatorial_region_1 = billow_octavenoise(GetFracDef(0), 0.7, p) * p.y * p.x;
-	const double equatorial_region_2 = octavenoise(GetFracDef(1), 0.8, p) * p.x * p.x;
+	const double equatorial_region_1 = billow_octavenoise(GetFracDef(0, footprint), 0.7, p) * p.y * p.x;
+	const double equatorial_region_2 = octavenoise(GetFracDef(1, footprint), 0.8, p) * p.x * p.x;
 	vector3d col;
 	col = interpolate_color(equatorial_region_1, m_ggdarkColor[0], m_ggdarkColor[1]);
 	col = interpolate_color(equatorial_region_2, col, vector3d(.45, .3, .0));
@@ -36,11 +36,11 @@ vector3d TerrainColorFractal<TerrainColorGGJupiter>::GetColor(const vector3d &p,
 		for(float i=-1 ; i < 1; i+=0.6f){
 			double temp = p.y - i;
 			if ( temp < .15+h && temp > -.15+h ){
-				n = billow_octavenoise(GetFracDef(2), 0.7*m_entropy[0],
+				n = billow_octavenoise(GetFracDef(2, footprint), 0.7*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii*0.3, p.z))*p);
-				n += 0.5*octavenoise(GetFracDef(1), 0.6*m_entropy[0],
+				n += 0.5*octavenoise(GetFracDef(1, footprint), 0.6*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii, p.z))*p);
-				n += ridged_octavenoise(GetFracDef(1), 0.6*m_entropy[0],
+				n += ridged_octavenoise(GetFracDef(1, footprint), 0.6*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii*0.3, p.z))*p);
 				//n += 0.5;
 				n *= n;
@@ -73,11 +73,11 @@ vector3d TerrainColorFractal<TerrainColorGGJupiter>::GetColor(const vector3d &p,
 		for(float i=-1 ; i < 1; i+=0.6f){
 			double temp = p.y - i;
 			if ( temp < .15+h && temp > -.15+h ){
-				n = billow_octavenoise(GetFracDef(2), 0.6*m_entropy[0],
+				n = billow_octavenoise(GetFracDef(2, footprint), 0.6*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii*0.3, p.z))*p);
-				n += 0.5*octavenoise(GetFracDef(1), 0.7*m_entropy[0],
+				n += 0.5*octavenoise(GetFracDef(1, footprint), 0.7*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii, p.z))*p);
-				n += ridged_octavenoise(GetFracDef(1), 0.6*m_entropy[0],
+				n += ridged_octavenoise(GetFracDef(1, footprint), 0.6*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii*0.3, p.z))*p);
 				//n += 0.5;
 				//n *= n;
@@ -110,11 +110,11 @@ vector3d TerrainColorFractal<TerrainColorGGJupiter>::GetColor(const vector3d &p,
 		for(float i=-1 ; i < 1; i+=0.3f){
 			double temp = p.y - i;
 			if ( temp < .1+h && temp > -.0+h ){
-				n = billow_octavenoise(GetFracDef(2), 0.6*m_entropy[0],
+				n = billow_octavenoise(GetFracDef(2, footprint), 0.6*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii*0.3, p.z))*p);
-				n += 0.5*octavenoise(GetFracDef(1), 0.6*m_entropy[0],
+				n += 0.5*octavenoise(GetFracDef(1, footprint), 0.6*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii, p.z))*p);
-				n += ridged_octavenoise(GetFracDef(1), 0.7*m_entropy[0],
+				n += ridged_octavenoise(GetFracDef(1, footprint), 0.7*m_entropy[0],
 					noise(vector3d(p.x, p.y*m_planetEarthRadii*0.3, p.z))*p);
 				//n += 0.5;
 				//n *= n;
@@ -145,7 +145,7 @@ vector3d TerrainColorFractal<TerrainColorGGJupiter>::GetColor(const vector3d &p,
 		}
 	}
 	//if is not a stripe.
-	n = octavenoise(GetFracDef(1), 0.6*m_entropy[0] +
+	n = octavenoise(GetFracDef(1, footprint), 0.6*m_entropy[0] +
 		0.25f,noise(vector3d(p.x, p.y*m_planetEarthRadii*3, p.z))*p);
 	n *= n*n;
 	n = (n<0.0 ? -n : n);
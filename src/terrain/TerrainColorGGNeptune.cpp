@@ -25,14 +25,14 @@ TerrainColorFractal<TerrainColorGGNeptune>::TerrainColorFractal(const SystemBody
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorGGNeptune>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorGGNeptune>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
-	double n = 0.8*octavenoise(GetFracDef(2), 0.6, vector3d(3.142*p.y*p.y));
-	n += 0.25*ridged_octavenoise(GetFracDef(3), 0.55, vector3d(3.142*p.y*p.y));
-	n += 0.2*octavenoise(GetFracDef(3), 0.5, vector3d(3.142*p.y*p.y));
+	double n = 0.8*octavenoise(GetFracDef(2, footprint), 0.6, vector3d(3.142*p.y*p.y));
+	n += 0.25*ridged_octavenoise(GetFracDef(3, footprint), 0.55, vector3d(3.142*p.y*p.y));
+	n += 0.2*octavenoise(GetFracDef(3, footprint), 0.5, vector3d(3.142*p.y*p.y));
 	//spot
-	n += 0.8*billow_octavenoise(GetFracDef(1), 0.8, vector3d(noise(p*3.142)*p))*
-		 megavolcano_function(GetFracDef(0), p);
+	n += 0.8*billow_octavenoise(GetFracDef(1, footprint), 0.8, vector3d(noise(p*3.142)*p))*
+		 megavolcano_function(GetFracDef(0, footprint), p);
 	n /= 2.0;
 	n *= n*n;
 	return interpolate_color(n, vector3d(.04, .05, .15), vector3d(.80,.94,.96));
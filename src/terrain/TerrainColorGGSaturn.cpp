@@ -24,17 +24,17 @@ TerrainColorFractal<TerrainColorGGSaturn>::TerrainColorFractal(const SystemBody
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorGGSaturn>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorGGSaturn>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
-	double n = 0.4*ridged_octavenoise(GetFracDef(0), 0.7, vector3d(3.142*p.y*p.y));
-	n += 0.4*octavenoise(GetFracDef(1), 0.6, vector3d(3.142*p.y*p.y));
-	n += 0.3*octavenoise(GetFracDef(2), 0.5, vector3d(3.142*p.y*p.y));
-	n += 0.8*octavenoise(GetFracDef(0), 0.7, vector3d(p*p.y*p.y));
-	n += 0.5*ridged_octavenoise(GetFracDef(1), 0.7, vector3d(p*p.y*p.y));
+	double n = 0.4*ridged_octavenoise(GetFracDef(0, footprint), 0.7, vector3d(3.142*p.y*p.y));
+	n += 0.4*octavenoise(GetFracDef(1, footprint), 0.6, vector3d(3.142*p.y*p.y));
+	n += 0.3*octavenoise(GetFracDef(2, footprint), 0.5, vector3d(3.142*p.y*p.y));
+	n += 0.8*octavenoise(GetFracDef(0, footprint), 0.7, vector3d(p*p.y*p.y));
+	n += 0.5*ridged_octavenoise(GetFracDef(1, footprint), 0.7, vector3d(p*p.y*p.y));
 	n /= 2.0;
 	n *= n*n;
-	n += billow_octavenoise(GetFracDef(0), 0.8, vector3d(noise(p*3.142)*p))*
-		 megavolcano_function(GetFracDef(3), p);
+	n += billow_octavenoise(GetFracDef(0, footprint), 0.8, vector3d(noise(p*3.142)*p))*
+		 megavolcano_function(GetFracDef(3, footprint), p);
 	return interpolate_color(n, vector3d(.69, .53, .43), vector3d(.99, .76, .62));
 }
 
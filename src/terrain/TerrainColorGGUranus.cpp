@@ -19,11 +19,11 @@ TerrainColorFractal<TerrainColorGGUranus>::TerrainColorFractal(const SystemBody
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorGGUranus>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorGGUranus>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
-	double n = 0.5*ridged_octavenoise(GetFracDef(0), 0.7, vector3d(3.142*p.y*p.y));
-	n += 0.5*octavenoise(GetFracDef(1), 0.6, vector3d(3.142*p.y*p.y));
-	n += 0.2*octavenoise(GetFracDef(2), 0.5, vector3d(3.142*p.y*p.y));
+	double n = 0.5*ridged_octavenoise(GetFracDef(0, footprint), 0.7, vector3d(3.142*p.y*p.y));
+	n += 0.5*octavenoise(GetFracDef(1, footprint), 0.6, vector3d(3.142*p.y*p.y));
+	n += 0.2*octavenoise(GetFracDef(2, footprint), 0.5, vector3d(3.142*p.y*p.y));
 	n /= 2.0;
 	n *= n*n;
 	return interpolate_color(n, vector3d(.4, .5, .55), vector3d(.85,.95,.96));
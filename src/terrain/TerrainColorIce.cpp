@@ -15,7 +15,7 @@ TerrainColorFractal<TerrainColorIce>::TerrainColorFractal(const SystemBody *body
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorIce>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorIce>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n = m_invMaxHeight*height;
 
@@ -24,8 +24,8 @@ vector3d TerrainColorFractal<TerrainColorIce>::GetColor(const vector3d &p, doubl
 	const double flatness = pow(p.Dot(norm), 24.0);
 	double equatorial_desert = (2.0-m_icyness)*(-1.0+2.0*octavenoise(12, 0.5, 2.0, (n*2.0)*p)) *
 			1.0*(2.0-m_icyness)*(1.0-p.y*p.y);
-	double equatorial_region_1 = billow_octavenoise(GetFracDef(0), 0.5, p) * p.y * p.y;
-	double equatorial_region_2 = ridged_octavenoise(GetFracDef(5), 0.5, p) * p.x * p.x;
+	double equatorial_region_1 = billow_octavenoise(GetFracDef(0, footprint), 0.5, p) * p.y * p.y;
+	double equatorial_region_2 = ridged_octavenoise(GetFracDef(5, footprint), 0.5, p) * p.x * p.x;
 	// cliff colours
 	vector3d color_cliffs;
 	// adds some variation
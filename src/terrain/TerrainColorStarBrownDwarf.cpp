@@ -18,11 +18,11 @@ TerrainColorFractal<TerrainColorStarBrownDwarf>::TerrainColorFractal(const Syste
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorStarBrownDwarf>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorStarBrownDwarf>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n;
 	vector3d col;
-	n = voronoiscam_octavenoise(GetFracDef(0), 0.6, p) * 0.5;
+	n = voronoiscam_octavenoise(GetFracDef(0, footprint), 0.6, p) * 0.5;
 	if (n > 0.666) {
 		n -= 0.666; n *= 3.0;
 		col = interpolate_color(n, vector3d(.25, .2, .2), vector3d(.1, .0, .0) );
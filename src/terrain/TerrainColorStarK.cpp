@@ -20,15 +20,15 @@ TerrainColorFractal<TerrainColorStarK>::TerrainColorFractal(const SystemBody *bo
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorStarK>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorStarK>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n;
 	vector3d col;
-	n = octavenoise(GetFracDef(0), 0.6, p) * 0.5;
-	n += ridged_octavenoise(GetFracDef(1), 0.7, p) * 0.5;
-	n += billow_octavenoise(GetFracDef(0), 0.8, p) * octavenoise(GetFracDef(1), 0.8, p);
-	n -= dunes_octavenoise(GetFracDef(2), 0.6, p) * 0.5;
-	n += octavenoise(GetFracDef(3), 0.6, p) * 0.5;
+	n = octavenoise(GetFracDef(0, footprint), 0.6, p) * 0.5;
+	n += ridged_octavenoise(GetFracDef(1, footprint), 0.7, p) * 0.5;
+	n += billow_octavenoise(GetFracDef(0, footprint), 0.8, p) * octavenoise(GetFracDef(1, footprint), 0.8, p);
+	n -= dunes_octavenoise(GetFracDef(2, footprint), 0.6, p) * 0.5;
+	n += octavenoise(GetFracDef(3, footprint), 0.6, p) * 0.5;
 	n *= n * 0.3;
 	if (n > 0.666) {
 		n -= 0.666; n *= 3.0;
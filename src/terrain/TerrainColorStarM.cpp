@@ -22,18 +22,18 @@ TerrainColorFractal<TerrainColorStarM>::TerrainColorFractal(const SystemBody *bo
 using namespace TerrainFeature;
 
 template <>
-vector3d TerrainColorFractal<TerrainColorStarM>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorStarM>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n;
 	vector3d col;
-	n = ridged_octavenoise(GetFracDef(0), 0.6, p) * 0.5;
-	n += ridged_octavenoise(GetFracDef(1), 0.7, p) * 0.5;
-	n += ridged_octavenoise(GetFracDef(0), 0.8, p) * ridged_octavenoise(GetFracDef(1), 0.8, p);
+	n = ridged_octavenoise(GetFracDef(0, footprint), 0.6, p) * 0.5;
+	n += ridged_octavenoise(GetFracDef(1, footprint), 0.7, p) * 0.5;
+	n += ridged_octavenoise(GetFracDef(0, footprint), 0.8, p) * ridged_octavenoise(GetFracDef(1, footprint), 0.8, p);
 	n *= n * n;
-	n += ridged_octavenoise(GetFracDef(2), 0.6, p) * 0.5;
-	n += ridged_octavenoise(GetFracDef(3), 0.6, p) * 0.5;
-	n += 15.0*billow_octavenoise(GetFracDef(0), 0.8, noise(p*3.142)*p)*
-	 megavolcano_function(GetFracDef(1), p);
+	n += ridged_octavenoise(GetFracDef(2, footprint), 0.6, p) * 0.5;
+	n += ridged_octavenoise(GetFracDef(3, footprint), 0.6, p) * 0.5;
+	n += 15.0*billow_octavenoise(GetFracDef(0, footprint), 0.8, noise(p*3.142)*p)*
+	 megavolcano_function(GetFracDef(1, footprint), p);
 	n *= 0.15;
 	n = 1.0-n;
 	if (n > 0.666) {
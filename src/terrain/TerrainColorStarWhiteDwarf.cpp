@@ -21,13 +21,13 @@ TerrainColorFractal<TerrainColorStarWhiteDwarf>::TerrainColorFractal(const Syste
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorStarWhiteDwarf>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorStarWhiteDwarf>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n;
 	vector3d col;
-	n = ridged_octavenoise(GetFracDef(0), 0.8, p*p.x);
-	n += ridged_octavenoise(GetFracDef(1), 0.8, p);
-	n += voronoiscam_octavenoise(GetFracDef(0), 0.8 * octavenoise(GetFracDef(1), 0.6, p), p);
+	n = ridged_octavenoise(GetFracDef(0, footprint), 0.8, p*p.x);
+	n += ridged_octavenoise(GetFracDef(1, footprint), 0.8, p);
+	n += voronoiscam_octavenoise(GetFracDef(0, footprint), 0.8 * octavenoise(GetFracDef(1, footprint), 0.6, p), p);
 	n *= n*n;
 	if (n > 0.666) {
 		n -= 0.666; n *= 3.0;
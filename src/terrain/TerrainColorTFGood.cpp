@@ -16,7 +16,7 @@ TerrainColorFractal<TerrainColorTFGood>::TerrainColorFractal(const SystemBody *b
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorTFGood>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorTFGood>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n = m_invMaxHeight*height;
 	const double flatness = pow(p.Dot(norm), 8.0);
@@ -29,8 +29,8 @@ vector3d TerrainColorFractal<TerrainColorTFGood>::GetColor(const vector3d &p, do
 	double equatorial_desert = (2.0-m_icyness)*(-1.0+2.0*octavenoise(12, 0.5, 2.0, (n*2.0)*p)) *
 			1.0*(2.0-m_icyness)*(1.0-p.y*p.y);
 	// This is for fake ocean depth by the coast.
-	double continents = octavenoise(GetFracDef(0), 0.7*
-				ridged_octavenoise(GetFracDef(8), 0.58, p), p) - m_sealevel*0.6;
+	double continents = octavenoise(GetFracDef(0, footprint), 0.7*
+				ridged_octavenoise(GetFracDef(8, footprint), 0.58, p), p) - m_sealevel*0.6;
 
 	vector3d col;
 	//we don't want water on the poles if there are ice-caps
@@ -16,7 +16,7 @@ TerrainColorFractal<TerrainColorTFPoor>::TerrainColorFractal(const SystemBody *b
 }
 
 template <>
-vector3d TerrainColorFractal<TerrainColorTFPoor>::GetColor(const vector3d &p, double height, const vector3d &norm) const
+vector3d TerrainColorFractal<TerrainColorTFPoor>::GetColor(const vector3d &p, double height, const vector3d &norm, double footprint) const
 {
 	double n = m_invMaxHeight*height;
 	double flatness = pow(p.Dot(norm), 8.0);
@@ -41,7 +41,7 @@ vector3d TerrainColorFractal<TerrainColorTFPoor>::GetColor(const vector3d &p, do
 		return col;
 	}
 	// This is for fake ocean depth by the coast.
-	continents = ridged_octavenoise(GetFracDef(3-m_fracnum), 0.55, p) * (1.0-m_sealevel) - ((m_sealevel*0.1)-0.1);
+	continents = ridged_octavenoise(GetFracDef(3-m_fracnum, footprint), 0.55, p) * (1.0-m_sealevel) - ((m_sealevel*0.1)-0.1);
 	
 	// water
 	if (n <= 0) {
@@ -22,9 +22,9 @@ TerrainHeightFractal<TerrainHeightAsteroid>::TerrainHeightFractal(const SystemBo
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightAsteroid>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightAsteroid>::GetHeight(const vector3d &p, double footprint) const
 {
-	const double n = octavenoise(GetFracDef(0), 0.4, p) * dunes_octavenoise(GetFracDef(1), 0.5, p);
+	const double n = octavenoise(GetFracDef(0, footprint), 0.4, p) * dunes_octavenoise(GetFracDef(1, footprint), 0.5, p);
 
 	return (n > 0.0 ? m_maxHeight*n : 0.0);
 }
@@ -22,9 +22,9 @@ TerrainHeightFractal<TerrainHeightAsteroid3>::TerrainHeightFractal(const SystemB
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightAsteroid3>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightAsteroid3>::GetHeight(const vector3d &p, double footprint) const
 {
-	const double n = octavenoise(GetFracDef(0), 0.5, p) * ridged_octavenoise(GetFracDef(1), 0.5, p);
+	const double n = octavenoise(GetFracDef(0, footprint), 0.5, p) * ridged_octavenoise(GetFracDef(1, footprint), 0.5, p);
 
 	return (n > 0.0 ? m_maxHeight*n : 0.0);
 }
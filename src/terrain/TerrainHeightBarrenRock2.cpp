@@ -20,7 +20,7 @@ TerrainHeightFractal<TerrainHeightBarrenRock2>::TerrainHeightFractal(const Syste
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightBarrenRock2>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightBarrenRock2>::GetHeight(const vector3d &p, double footprint) const
 {
 
 	double n = billow_octavenoise(16, 0.3*octavenoise(8, 0.4, 2.5, p),Clamp(5.0*ridged_octavenoise(8, 0.377, 4.0, p), 1.0, 5.0), p);
@@ -19,7 +19,7 @@ TerrainHeightFractal<TerrainHeightBarrenRock3>::TerrainHeightFractal(const Syste
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightBarrenRock3>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightBarrenRock3>::GetHeight(const vector3d &p, double footprint) const
 {
 
 	float n = 0.07*voronoiscam_octavenoise(12, Clamp(fabs(0.165 - (0.38*river_octavenoise(12, 0.4, 2.5, p))), 0.15, 0.5),Clamp(8.0*billow_octavenoise(12, 0.37, 4.0, p), 0.5, 9.0), p);
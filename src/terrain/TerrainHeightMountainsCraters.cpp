@@ -28,19 +28,19 @@ TerrainHeightFractal<TerrainHeightMountainsCraters>::TerrainHeightFractal(const
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightMountainsCraters>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightMountainsCraters>::GetHeight(const vector3d &p, double footprint) const
 {
-	double continents = octavenoise(GetFracDef(0), 0.5, p) - m_sealevel;
+	double continents = octavenoise(GetFracDef(0, footprint), 0.5, p) - m_sealevel;
 	if (continents < 0) return 0;
 	double n = 0.3 * continents;
-	double m = GetFracDef(1).amplitude * ridged_octavenoise(GetFracDef(1), 0.5, p);
-	double distrib = ridged_octavenoise(GetFracDef(4), 0.5, p);
-	if (distrib > 0.5) m += 2.0 * (distrib-0.5) * GetFracDef(3).amplitude * ridged_octavenoise(GetFracDef(3), 0.5*distrib, p);
+	double m = GetFracDef(1).amplitude * ridged_octavenoise(GetFracDef(1, footprint), 0.5, p);
+	double distrib = ridged_octavenoise(GetFracDef(4, footprint), 0.5, p);
+	if (distrib > 0.5) m += 2.0 * (distrib-0.5) * GetFracDef(3).amplitude * ridged_octavenoise(GetFracDef(3, footprint), 0.5*distrib, p);
 	// cliffs at shore
 	if (continents < 0.001) n += m * continents * 1000.0f;
 	else n += m;
-	n += crater_function(GetFracDef(5), p);
-	n += crater_function(GetFracDef(6), p);
+	n += crater_function(GetFracDef(5, footprint), p);
+	n += crater_function(GetFracDef(6, footprint), p);
 	n *= m_maxHeight;
 	return (n > 0.0 ? n : 0.0);
 }
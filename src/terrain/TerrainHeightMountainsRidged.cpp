@@ -29,21 +29,21 @@ TerrainHeightFractal<TerrainHeightMountainsRidged>::TerrainHeightFractal(const S
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightMountainsRidged>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightMountainsRidged>::GetHeight(const vector3d &p, double footprint) const
 {
-	double continents = octavenoise(GetFracDef(0), 0.5, p) - m_sealevel;
+	double continents = octavenoise(GetFracDef(0, footprint), 0.5, p) - m_sealevel;
 	if (continents < 0) return 0;
-	// unused variable \\ double mountain_distrib = octavenoise(GetFracDef(1), 0.5, p);
-	double mountains = octavenoise(GetFracDef(2), 0.5, p);
-	double mountains2 = ridged_octavenoise(GetFracDef(3), 0.5, p);
+	// unused variable \\ double mountain_distrib = octavenoise(GetFracDef(1, footprint), 0.5, p);
+	double mountains = octavenoise(GetFracDef(2, footprint), 0.5, p);
+	double mountains2 = ridged_octavenoise(GetFracDef(3, footprint), 0.5, p);
 
-	double hill_distrib = octavenoise(GetFracDef(4), 0.5, p);
-	double hills = hill_distrib * GetFracDef(5).amplitude * ridged_octavenoise(GetFracDef(5), 0.5, p);
-	double hills2 = hill_distrib * GetFracDef(6).amplitude * octavenoise(GetFracDef(6), 0.5, p);
+	double hill_distrib = octavenoise(GetFracDef(4, footprint), 0.5, p);
+	double hills = hill_distrib * GetFracDef(5).amplitude * ridged_octavenoise(GetFracDef(5, footprint), 0.5, p);
+	double hills2 = hill_distrib * GetFracDef(6).amplitude * octavenoise(GetFracDef(6, footprint), 0.5, p);
 
-	double hill2_distrib = octavenoise(GetFracDef(7), 0.5, p);
-	double hills3 = hill2_distrib * GetFracDef(8).amplitude * ridged_octavenoise(GetFracDef(8), 0.5, p);
-	double hills4 = hill2_distrib * GetFracDef(9).amplitude * ridged_octavenoise(GetFracDef(9), 0.5, p);
+	double hill2_distrib = octavenoise(GetFracDef(7, footprint), 0.5, p);
+	double hills3 = hill2_distrib * GetFracDef(8).amplitude * ridged_octavenoise(GetFracDef(8, footprint), 0.5, p);
+	double hills4 = hill2_distrib * GetFracDef(9).amplitude * ridged_octavenoise(GetFracDef(9, footprint), 0.5, p);
 
 	double n = continents - (GetFracDef(0).amplitude*m_sealevel);
 
@@ -59,9 +59,9 @@ double TerrainHeightFractal<TerrainHeightMountainsRidged>::GetHeight(const vecto
 		if (n < 0.05) n += hills4 * n * 20.0f;
 		else n += hills4 ;
 
-		mountains  = octavenoise(GetFracDef(1), 0.5, p) *
+		mountains  = octavenoise(GetFracDef(1, footprint), 0.5, p) *
 			GetFracDef(2).amplitude * mountains*mountains*mountains;
-		mountains2 = octavenoise(GetFracDef(4), 0.5, p) *
+		mountains2 = octavenoise(GetFracDef(4, footprint), 0.5, p) *
 			GetFracDef(3).amplitude * mountains2*mountains2*mountains2*mountains2;
 		if (n > 0.2) n += mountains2 * (n - 0.2) ;
 		if (n < 0.2) n += mountains * n * 5.0f ;
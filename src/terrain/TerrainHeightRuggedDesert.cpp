@@ -12,17 +12,17 @@ template <>
 const char *TerrainHeightFractal<TerrainHeightRuggedDesert>::GetHeightFractalName() const { return "RuggedDesert"; }
 
 template <>
-double TerrainHeightFractal<TerrainHeightRuggedDesert>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightRuggedDesert>::GetHeight(const vector3d &p, double footprint) const
 {
-	double continents = octavenoise(GetFracDef(0), 0.5, p) - m_sealevel;// + (cliff_function(GetFracDef(7), p)*0.5);
+	double continents = octavenoise(GetFracDef(0, footprint), 0.5, p) - m_sealevel;// + (cliff_function(GetFracDef(7, footprint), p)*0.5);
 	if (continents < 0) return 0;
-	double mountain_distrib = octavenoise(GetFracDef(2), 0.5, p);
-	double mountains = ridged_octavenoise(GetFracDef(1), 0.5, p);
-	//double rocks = octavenoise(GetFracDef(9), 0.5, p);
-	double hill_distrib = octavenoise(GetFracDef(4), 0.5, p);
-	double hills = hill_distrib * GetFracDef(3).amplitude * billow_octavenoise(GetFracDef(3), 0.5, p);
-	double dunes = hill_distrib * GetFracDef(5).amplitude * dunes_octavenoise(GetFracDef(5), 0.5, p);
-	double n = continents * GetFracDef(0).amplitude * 2 ;//+ (cliff_function(GetFracDef(6), p)*0.5);
+	double mountain_distrib = octavenoise(GetFracDef(2, footprint), 0.5, p);
+	double mountains = ridged_octavenoise(GetFracDef(1, footprint), 0.5, p);
+	//double rocks = octavenoise(GetFracDef(9, footprint), 0.5, p);
+	double hill_distrib = octavenoise(GetFracDef(4, footprint), 0.5, p);
+	double hills = hill_distrib * GetFracDef(3).amplitude * billow_octavenoise(GetFracDef(3, footprint), 0.5, p);
+	double dunes = hill_distrib * GetFracDef(5).amplitude * dunes_octavenoise(GetFracDef(5, footprint), 0.5, p);
+	double n = continents * GetFracDef(0).amplitude * 2 ;//+ (cliff_function(GetFracDef(6, footprint), p)*0.5);
 	n += (n<0.0 ? 0.0 : n);
 
 	// makes larger dunes at lower altitudes, flat ones at high altitude.
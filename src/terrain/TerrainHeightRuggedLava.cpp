@@ -35,45 +35,45 @@ TerrainHeightFractal<TerrainHeightRuggedLava>::TerrainHeightFractal(const System
 }
 
 template <>
-double TerrainHeightFractal<TerrainHeightRuggedLava>::GetHeight(const vector3d &p) const
+double TerrainHeightFractal<TerrainHeightRuggedLava>::GetHeight(const vector3d &p, double footprint) const
 {
-	double continents = octavenoise(GetFracDef(0), Clamp(0.725-(m_sealevel/2), 0.1, 0.725), p) - m_sealevel;
+	double continents = octavenoise(GetFracDef(0, footprint), Clamp(0.725-(m_sealevel/2), 0.1, 0.725), p) - m_sealevel;
 	if (continents < 0) return 0;
-	double mountain_distrib = octavenoise(GetFracDef(1), 0.55, p);
-	double mountains = octavenoise(GetFracDef(2), 0.5, p) * ridged_octavenoise(GetFracDef(2), 0.575, p);
-	double mountains2 = octavenoise(GetFracDef(3), 0.5, p);
-	double hill_distrib = octavenoise(GetFracDef(4), 0.5, p);
-	double hills = hill_distrib * GetFracDef(5).amplitude * octavenoise(GetFracDef(5), 0.5, p);
-	double rocks = octavenoise(GetFracDef(9), 0.5, p);
+	double mountain_distrib = octavenoise(GetFracDef(1, footprint), 0.55, p);
+	double mountains = octavenoise(GetFracDef(2, footprint), 0.5, p) * ridged_octavenoise(GetFracDef(2, footprint), 0.575, p);
+	double mountains2 = octavenoise(GetFracDef(3, footprint), 0.5, p);
+	double hill_distrib = octavenoise(GetFracDef(4, footprint), 0.5, p);
+	double hills = hill_distrib * GetFracDef(5).amplitude * octavenoise(GetFracDef(5, footprint), 0.5, p);
+	double rocks = octavenoise(GetFracDef(9, footprint), 0.5, p);
 
 
 	double n = continents - (GetFracDef(0).amplitude*m_sealevel);
 	//double n = (megavolcano_function(p) + volcano_function(p) + smlvolcano_function(p));
-	n += mountains*mountains2*5.0*megavolcano_function(GetFracDef(6), p);
-	n += 2.5*megavolcano_function(GetFracDef(6), p);
-	n += mountains*mountains2*5.0*volcano_function(GetFracDef(6), p)*volcano_function(GetFracDef(6), p);
-	n += 2.5*volcano_function(GetFracDef(6), p);
+	n += mountains*mountains2*5.0*megavolcano_function(GetFracDef(6, footprint), p);
+	n += 2.5*megavolcano_function(GetFracDef(6, footprint), p);
+	n += mountains*mountains2*5.0*volcano_function(GetFracDef(6, footprint), p)*volcano_function(GetFracDef(6, footprint), p);
+	n += 2.5*volcano_function(GetFracDef(6, footprint), p);
 
-	n += mountains*mountains2*7.5*megavolcano_function(GetFracDef(7), p);
-	n += 2.5*megavolcano_function(GetFracDef(7), p);
-	n += mountains*mountains2*7.5*volcano_function(GetFracDef(7), p)*volcano_function(GetFracDef(7), p);
-	n += 2.5*volcano_function(GetFracDef(7), p);
+	n += mountains*mountains2*7.5*megavolcano_function(GetFracDef(7, footprint), p);
+	n += 2.5*megavolcano_function(GetFracDef(7, footprint), p);
+	n += mountains*mountains2*7.5*volcano_function(GetFracDef(7, footprint), p)*volcano_function(GetFracDef(7, footprint), p);
+	n += 2.5*volcano_function(GetFracDef(7, footprint), p);
 
 
 	//n += 1.4*(continents - targ.continents.amplitude*targ.sealevel + (volcano_function(p)*1)) ;
 	//smooth canyon transitions and limit height of canyon placement
-	if (n < .01) n += n * 100.0f * canyon3_ridged_function(GetFracDef(8), p);
-	else n += canyon3_ridged_function(GetFracDef(8), p);
+	if (n < .01) n += n * 100.0f * canyon3_ridged_function(GetFracDef(8, footprint), p);
+	else n += canyon3_ridged_function(GetFracDef(8, footprint), p);
 
-	if (n < .01) n += n * 100.0f * canyon2_ridged_function(GetFracDef(8), p);
-	else n += canyon2_ridged_function(GetFracDef(8), p);
+	if (n < .01) n += n * 100.0f * canyon2_ridged_function(GetFracDef(8, footprint), p);
+	else n += canyon2_ridged_function(GetFracDef(8, footprint), p);
 	n *= 0.5;
 
 	n += continents*hills*hill_distrib*mountain_distrib;
 
-	mountains  = octavenoise(GetFracDef(1), 0.5, p) *
+	mountains  = octavenoise(GetFracDef(1, footprint), 0.5, p) *
 			GetFracDef(2).amplitude * mountains*mountains*mountains;
-	mountains2 = octavenoise(GetFracDef(4), 0.5, p) *
+	mountains2 = octavenoise(GetFracDef(4, footprint), 0.5, p) *
 			GetFracDef(3).amplitude * mountains2*mountains2*mountains2;
 	/*mountains = fractal(2, targ.mountainDistrib, (m_seed>>2)&3, p) *
 		targ.mountains.amplitude * mountains*mountains*mountains;
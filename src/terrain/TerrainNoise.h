@@ -16,6 +16,7 @@ namespace TerrainNoise {
 		double amplitude = persistence;
 		double frequency = def.frequency;
 		for (int i=0; i<def.octaves; i++) {
+			if (i == def.octaves-1) amplitude *= def.fade;
 			n += amplitude * noise(frequency*p);
 			amplitude *= persistence;
 			frequency *= def.lacunarity;
@@ -29,6 +30,7 @@ namespace TerrainNoise {
 		double amplitude = persistence;
 		double frequency = def.frequency;
 		for (int i=0; i<def.octaves; i++) {
+			if (i == def.octaves-1) amplitude *= def.fade;
 			n += amplitude * fabs(noise(frequency*p));
 			amplitude *= persistence;
 			frequency *= def.lacunarity;
@@ -42,6 +44,7 @@ namespace TerrainNoise {
 		double amplitude = persistence;
 		double frequency = def.frequency;
 		for (int i=0; i<def.octaves; i++) {
+			if (i == def.octaves-1) amplitude *= def.fade;
 			n += amplitude * noise(frequency*p);
 			amplitude *= persistence;
 			frequency *= def.lacunarity;
@@ -57,6 +60,7 @@ namespace TerrainNoise {
 		double amplitude = persistence;
 		double frequency = def.frequency;
 		for (int i=0; i<def.octaves; i++) {
+			if (i == def.octaves-1) amplitude *= def.fade;
 			n += amplitude * noise(frequency*p);
 			amplitude *= persistence;
 			frequency *= def.lacunarity;
@@ -70,6 +74,7 @@ namespace TerrainNoise {
 		double amplitude = persistence;
 		double frequency = def.frequency;
 		for (int i=0; i<def.octaves; i++) {
+			if (i == def.octaves-1) amplitude *= def.fade;
 			n += amplitude * noise(frequency*p);
 			amplitude *= persistence;
 			frequency *= def.lacunarity;
@@ -169,18 +174,19 @@ namespace TerrainNoise {
 // common colours for earthlike worlds
 // XXX better way to do this?
 
-#define terrain_colournoise_rock   octavenoise(GetFracDef(0), 0.65, p)
-#define terrain_colournoise_rock2  octavenoise(GetFracDef(1), 0.6, p)*0.6*ridged_octavenoise(GetFracDef(0), 0.55, p)
-// #define terrain_colournoise_rock3  0.5*ridged_octavenoise(GetFracDef(0), 0.5, p)*voronoiscam_octavenoise(GetFracDef(0), 0.5, p)*ridged_octavenoise(GetFracDef(1), 0.5, p)
-// #define terrain_colournoise_rock4  0.5*ridged_octavenoise(GetFracDef(1), 0.5, p)*octavenoise(GetFracDef(1), 0.5, p)*octavenoise(GetFracDef(5), 0.5, p)
-#define terrain_colournoise_mud    0.1*voronoiscam_octavenoise(GetFracDef(1), 0.5, p)*octavenoise(GetFracDef(1), 0.5, p) * GetFracDef(5).amplitude
-#define terrain_colournoise_sand   ridged_octavenoise(GetFracDef(0), 0.4, p)*dunes_octavenoise(GetFracDef(2), 0.4, p) + 0.1*dunes_octavenoise(GetFracDef(1), 0.5, p)
-#define terrain_colournoise_sand2  dunes_octavenoise(GetFracDef(0), 0.6, p)*octavenoise(GetFracDef(4), 0.6, p)
-// #define terrain_colournoise_sand3  dunes_octavenoise(GetFracDef(2), 0.6, p)*dunes_octavenoise(GetFracDef(6), 0.6, p)
-#define terrain_colournoise_grass  billow_octavenoise(GetFracDef(1), 0.8, p)
-#define terrain_colournoise_grass2 billow_octavenoise(GetFracDef(3), 0.6, p)*voronoiscam_octavenoise(GetFracDef(4), 0.6, p)*river_octavenoise(GetFracDef(5), 0.6, p)
-#define terrain_colournoise_forest octavenoise(GetFracDef(1), 0.65, p)*voronoiscam_octavenoise(GetFracDef(2), 0.65, p)
-#define terrain_colournoise_water  dunes_octavenoise(GetFracDef(6), 0.6, p)
+// these are for the colour fractals, and expect p and footprint
+#define terrain_colournoise_rock   octavenoise(GetFracDef(0, footprint), 0.65, p)
+#define terrain_colournoise_rock2  octavenoise(GetFracDef(1, footprint), 0.6, p)*0.6*ridged_octavenoise(GetFracDef(0, footprint), 0.55, p)
+// #define terrain_colournoise_rock3  0.5*ridged_octavenoise(GetFracDef(0, footprint), 0.5, p)*voronoiscam_octavenoise(GetFracDef(0, footprint), 0.5, p)*ridged_octavenoise(GetFracDef(1, footprint), 0.5, p)
+// #define terrain_colournoise_rock4  0.5*ridged_octavenoise(GetFracDef(1, footprint), 0.5, p)*octavenoise(GetFracDef(1, footprint), 0.5, p)*octavenoise(GetFracDef(5, footprint), 0.5, p)
+#define terrain_colournoise_mud    0.1*voronoiscam_octavenoise(GetFracDef(1, footprint), 0.5, p)*octavenoise(GetFracDef(1, footprint), 0.5, p) * GetFracDef(5).amplitude
+#define terrain_colournoise_sand   ridged_octavenoise(GetFracDef(0, footprint), 0.4, p)*dunes_octavenoise(GetFracDef(2, footprint), 0.4, p) + 0.1*dunes_octavenoise(GetFracDef(1, footprint), 0.5, p)
+#define terrain_colournoise_sand2  dunes_octavenoise(GetFracDef(0, footprint), 0.6, p)*octavenoise(GetFracDef(4, footprint), 0.6, p)
+// #define terrain_colournoise_sand3  dunes_octavenoise(GetFracDef(2, footprint), 0.6, p)*dunes_octavenoise(GetFracDef(6, footprint), 0.6, p)
+#define terrain_colournoise_grass  billow_octavenoise(GetFracDef(1, footprint), 0.8, p)
+#define terrain_colournoise_grass2 billow_octavenoise(GetFracDef(3, footprint), 0.6, p)*voronoiscam_octavenoise(GetFracDef(4, footprint), 0.6, p)*river_octavenoise(GetFracDef(5, footprint), 0.6, p)
+#define terrain_colournoise_forest octavenoise(GetFracDef(1, footprint), 0.65, p)*voronoiscam_octavenoise(GetFracDef(2, footprint), 0.65, p)
+#define terrain_colournoise_water  dunes_octavenoise(GetFracDef(6, footprint), 0.6, p)
 
 
 #endif
@@ -0,0 +1,199 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+// times every height and colour fractal over a fixed set of points, at the
+// sample spacing of a few patch depths. prints ns/sample for GetHeight and
+// GetColor separately, and a checksum of what they returned so that a change
+// that was only meant to make a fractal faster can be seen not to have
+// changed its output.
+//
+// each height fractal is run with TerrainColorSolid and each colour fractal
+// with TerrainHeightFlat, so the numbers are for the one fractal alone.
+// the heightmapped generators need their data files and aren't included.
+//
+//   terrainbench [samples [fracmult]]
+
+#include "libs.h"
+#include "CRC32.h"
+#include "Pi.h"
+#include "terrain/Terrain.h"
+#include "SDL.h"
+#include <cstdlib>
+
+// deepest patch a body gets split to is around 15-20
+static const int DEPTHS[] = { 0, 4, 8, 12, 16 };
+// must be odd, like the patch context's
+static const int EDGE_LEN = 25;
+// distance between two corners of a root patch, in planet radii
+static const double ROOT_EDGE = 2.0 / sqrt(3.0);
+
+static const Uint32 BODY_SEED = 0x5eed;
+static const Uint32 POINT_SEED = 12345;
+
+// a rocky body that has a bit of everything, so the fractals that look at
+// sea level, ice or volcanism all do some work
+static SystemBody *MakeBody()
+{
+	SystemBody *body = new SystemBody(SystemPath(0,0,0,0,0));
+	body->SetType(SystemBody::TYPE_PLANET_TERRESTRIAL);
+	body->SetName("terrainbench");
+	body->SetSeed(BODY_SEED);
+	body->SetRadius(fixed(1,1));
+	body->SetMass(fixed(1,1));
+	body->SetAverageTemp(288);
+	body->SetComposition(fixed(1,2), fixed(1,1), fixed(1,2), fixed(1,10), fixed(1,5), fixed(1,2), fixed(1,2));
+	return body;
+}
+
+struct Result {
+	double heightNs;
+	double colorNs;
+	Uint32 heightSum;
+	Uint32 colorSum;
+};
+
+static double ElapsedNs(Uint64 start, Uint32 samples)
+{
+	const Uint64 ticks = SDL_GetPerformanceCounter() - start;
+	return double(ticks) * 1e9 / double(SDL_GetPerformanceFrequency()) / double(samples);
+}
+
+static Result Run(const Terrain *terrain, const std::vector<vector3d> &points, double footprint)
+{
+	const Uint32 numPoints = points.size();
+	std::vector<double> heights(numPoints);
+	std::vector<vector3d> colors(numPoints);
+	Result r;
+
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (Uint32 i = 0; i < numPoints; i++)
+		heights[i] = terrain->GetHeight(points[i], footprint);
+	r.heightNs = ElapsedNs(start, numPoints);
+
+	// colours want a normal; the point's own direction will do
+	start = SDL_GetPerformanceCounter();
+	for (Uint32 i = 0; i < numPoints; i++)
+		colors[i] = terrain->GetColor(points[i], heights[i], points[i], footprint);
+	r.colorNs = ElapsedNs(start, numPoints);
+
+	CRC32 heightSum, colorSum;
+	heightSum.AddData(reinterpret_cast<const char*>(&heights[0]), numPoints * sizeof(double));
+	colorSum.AddData(reinterpret_cast<const char*>(&colors[0]), numPoints * sizeof(vector3d));
+	r.heightSum = heightSum.GetChecksum();
+	r.colorSum = colorSum.GetChecksum();
+	return r;
+}
+
+template <typename HeightFractal, typename ColorFractal>
+static void Bench(const SystemBody *body, const std::vector<vector3d> &points, bool byColor)
+{
+	std::unique_ptr<Terrain> terrain(new TerrainGenerator<HeightFractal,ColorFractal>(body));
+	const char *name = byColor ? terrain->GetColorFractalName() : terrain->GetHeightFractalName();
+
+	// once through first so the caches are warm for the first depth
+	Run(terrain.get(), points, 0.0);
+
+	for (unsigned int d = 0; d < COUNTOF(DEPTHS); d++) {
+		const double footprint = ROOT_EDGE / double(1 << DEPTHS[d]) / double(EDGE_LEN - 1);
+		const Result r = Run(terrain.get(), points, footprint);
+		Output("%-28s %5d %12.1f %12.1f   %08x %08x\n", name, DEPTHS[d], r.heightNs, r.colorNs, r.heightSum, r.colorSum);
+	}
+	const Result r = Run(terrain.get(), points, 0.0);
+	Output("%-28s %5s %12.1f %12.1f   %08x %08x\n", name, "full", r.heightNs, r.colorNs, r.heightSum, r.colorSum);
+}
+
+template <typename HeightFractal>
+static void BenchHeight(const SystemBody *body, const std::vector<vector3d> &points)
+{
+	Bench<HeightFractal,TerrainColorSolid>(body, points, false);
+}
+
+template <typename ColorFractal>
+static void BenchColor(const SystemBody *body, const std::vector<vector3d> &points)
+{
+	Bench<TerrainHeightFlat,ColorFractal>(body, points, true);
+}
+
+int main(int argc, char **argv)
+{
+	const int numPoints = argc > 1 ? atoi(argv[1]) : 20000;
+	if (numPoints <= 0) {
+		Output("usage: terrainbench [samples [fracmult]]\n");
+		return 1;
+	}
+
+	Pi::detail.textures = 1;
+	Pi::detail.fracmult = argc > 2 ? atoi(argv[2]) : 2;
+
+	// spread over the whole sphere, the same every run
+	Random rand(POINT_SEED);
+	std::vector<vector3d> points(numPoints);
+	for (int i = 0; i < numPoints; i++) {
+		vector3d p;
+		do {
+			p = vector3d(rand.Double(-1.0, 1.0), rand.Double(-1.0, 1.0), rand.Double(-1.0, 1.0));
+		} while (p.LengthSqr() > 1.0 || p.LengthSqr() < 1e-6);
+		points[i] = p.Normalized();
+	}
+
+	std::unique_ptr<SystemBody> body(MakeBody());
+
+	Output("%d samples, fracmult %d. times are ns/sample\n\n", numPoints, Pi::detail.fracmult);
+	Output("%-28s %5s %12s %12s   %-8s %-8s\n", "fractal", "depth", "height", "color", "h crc", "c crc");
+
+	BenchHeight<TerrainHeightFlat>(body.get(), points);
+	BenchHeight<TerrainHeightAsteroid>(body.get(), points);
+	BenchHeight<TerrainHeightAsteroid2>(body.get(), points);
+	BenchHeight<TerrainHeightAsteroid3>(body.get(), points);
+	BenchHeight<TerrainHeightAsteroid4>(body.get(), points);
+	BenchHeight<TerrainHeightBarrenRock>(body.get(), points);
+	BenchHeight<TerrainHeightBarrenRock2>(body.get(), points);
+	BenchHeight<TerrainHeightBarrenRock3>(body.get(), points);
+	BenchHeight<TerrainHeightEllipsoid>(body.get(), points);
+	BenchHeight<TerrainHeightHillsCraters2>(body.get(), points);
+	BenchHeight<TerrainHeightHillsCraters>(body.get(), points);
+	BenchHeight<TerrainHeightHillsDunes>(body.get(), points);
+	BenchHeight<TerrainHeightHillsNormal>(body.get(), points);
+	BenchHeight<TerrainHeightHillsRidged>(body.get(), points);
+	BenchHeight<TerrainHeightHillsRivers>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsCraters2>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsCraters>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsNormal>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsRivers>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsRidged>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsRiversVolcano>(body.get(), points);
+	BenchHeight<TerrainHeightMountainsVolcano>(body.get(), points);
+	BenchHeight<TerrainHeightRuggedDesert>(body.get(), points);
+	BenchHeight<TerrainHeightRuggedLava>(body.get(), points);
+	BenchHeight<TerrainHeightWaterSolidCanyons>(body.get(), points);
+	BenchHeight<TerrainHeightWaterSolid>(body.get(), points);
+
+	Output("\n");
+
+	BenchColor<TerrainColorAsteroid>(body.get(), points);
+	BenchColor<TerrainColorBandedRock>(body.get(), points);
+	BenchColor<TerrainColorDeadWithWater>(body.get(), points);
+	BenchColor<TerrainColorDesert>(body.get(), points);
+	BenchColor<TerrainColorEarthLike>(body.get(), points);
+	BenchColor<TerrainColorGGJupiter>(body.get(), points);
+	BenchColor<TerrainColorGGNeptune2>(body.get(), points);
+	BenchColor<TerrainColorGGNeptune>(body.get(), points);
+	BenchColor<TerrainColorGGSaturn2>(body.get(), points);
+	BenchColor<TerrainColorGGSaturn>(body.get(), points);
+	BenchColor<TerrainColorGGUranus>(body.get(), points);
+	BenchColor<TerrainColorIce>(body.get(), points);
+	BenchColor<TerrainColorMethane>(body.get(), points);
+	BenchColor<TerrainColorRock2>(body.get(), points);
+	BenchColor<TerrainColorRock>(body.get(), points);
+	BenchColor<TerrainColorSolid>(body.get(), points);
+	BenchColor<TerrainColorStarBrownDwarf>(body.get(), points);
+	BenchColor<TerrainColorStarG>(body.get(), points);
+	BenchColor<TerrainColorStarK>(body.get(), points);
+	BenchColor<TerrainColorStarM>(body.get(), points);
+	BenchColor<TerrainColorStarWhiteDwarf>(body.get(), points);
+	BenchColor<TerrainColorTFGood>(body.get(), points);
+	BenchColor<TerrainColorTFPoor>(body.get(), points);
+	BenchColor<TerrainColorVolcanic>(body.get(), points);
+
+	return 0;
+}
@@ -0,0 +1,147 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include <iostream>
+#include "Random.h"
+#include "collider/GeomTree.h"
+#include "collider/BVHTree.h"
+#include "Serializer.h"
+
+using namespace std;
+
+static const int NUM_TRIS = 1000;
+static const int NUM_RAYS = 2000;
+
+// the same test GeomTree makes at its leaves, against every triangle
+static void BruteForceTraceRay(const GeomTree *gt, const vector3f &origin, const vector3f &dir, isect_t *isect)
+{
+	const float *verts = gt->GetVertices();
+	const Uint16 *idx = gt->GetIndices();
+	for (int t=0; t<gt->GetNumTris(); t++) {
+		const vector3f a(&verts[3*idx[3*t]]);
+		const vector3f b(&verts[3*idx[3*t+1]]);
+		const vector3f c(&verts[3*idx[3*t+2]]);
+
+		const vector3f n = (c-a).Cross(b-a);
+		const float v0d = (c-origin).Cross(b-origin).Dot(dir);
+		const float v1d = (b-origin).Cross(a-origin).Dot(dir);
+		const float v2d = (a-origin).Cross(c-origin).Dot(dir);
+		if (((v0d > 0) && (v1d > 0) && (v2d > 0)) ||
+		    ((v0d < 0) && (v1d < 0) && (v2d < 0))) {
+			const float dist = n.Dot(a-origin) / dir.Dot(n);
+			if ((dist > 0) && (dist < isect->dist)) {
+				isect->dist = dist;
+				isect->triIdx = t;
+			}
+		}
+	}
+}
+
+static vector3f RandomPoint(Random &rng, double size)
+{
+	return vector3f(float(rng.Double(-size, size)), float(rng.Double(-size, size)), float(rng.Double(-size, size)));
+}
+
+// Test suite for the collision mesh BVH
+void test_collider()
+{
+	cout << "----------------------" << endl;
+	cout << "Running collider tests" << endl;
+	cout << "----------------------" << endl;
+
+	// a random soup of small triangles, so the tree has something to
+	// separate, with a few spanning the whole mesh that it can't
+	Random rng(0x5eed);
+	float *verts = new float[NUM_TRIS*3*3];
+	Uint16 *indices = new Uint16[NUM_TRIS*3];
+	unsigned int *flags = new unsigned int[NUM_TRIS];
+	for (int t=0; t<NUM_TRIS; t++) {
+		const vector3f centre = RandomPoint(rng, 10.0);
+		const double size = (t % 50 == 0) ? 10.0 : 1.0;
+		for (int k=0; k<3; k++) {
+			const vector3f v = centre + RandomPoint(rng, size);
+			verts[9*t+3*k] = v.x; verts[9*t+3*k+1] = v.y; verts[9*t+3*k+2] = v.z;
+			indices[3*t+k] = Uint16(3*t+k);
+		}
+		flags[t] = 0;
+	}
+
+	// takes ownership of the arrays
+	GeomTree gt(NUM_TRIS*3, NUM_TRIS, verts, indices, flags);
+
+	cout << "Built trees are valid: " << (gt.IsValid() ? "pass" : "fail") << endl;
+
+	// rays from all over towards the mesh, plenty of which miss
+	int mismatches = 0, hits = 0, treeTests = 0;
+	for (int i=0; i<NUM_RAYS; i++) {
+		const vector3f start = RandomPoint(rng, 20.0);
+		const vector3f end = RandomPoint(rng, 15.0);
+		const float len = (end - start).Length();
+		const vector3f dir = (end - start) / len;
+
+		isect_t tree, brute;
+		tree.dist = brute.dist = 2.0f * len;
+		tree.triIdx = brute.triIdx = -1;
+
+		const int before = GeomTree::stats_rayTriIntersections;
+		gt.TraceRay(start, dir, &tree);
+		treeTests += GeomTree::stats_rayTriIntersections - before;
+		BruteForceTraceRay(&gt, start, dir, &brute);
+
+		if (tree.triIdx != brute.triIdx || tree.dist != brute.dist) mismatches++;
+		if (brute.triIdx != -1) hits++;
+	}
+
+	cout << "Ray hits match brute force (" << hits << " of " << NUM_RAYS << " rays hit): " << (mismatches == 0 ? "pass" : "fail") << endl;
+	cout << "Ray/triangle tests per ray: " << double(treeTests) / NUM_RAYS << " of " << NUM_TRIS << endl;
+
+	// what .sgm files store
+	Serializer::Writer wr;
+	gt.Save(wr);
+	std::string data = wr.GetData();
+	{
+		Serializer::Reader rd(ByteRange(data.data(), data.size()));
+		GeomTree loaded(rd);
+		cout << "Saved tree loads valid: " << (loaded.IsValid() ? "pass" : "fail") << endl;
+	}
+
+	// send the triangle tree root's second child past the end. it comes
+	// after the vertices, triangles, bounds and edges
+	const size_t rootOffset = 4 + 12*3*NUM_TRIS + 4 + 10*NUM_TRIS + 8 + 48 + 4 + 28*gt.GetNumEdges() + 4 + 12;
+	data[rootOffset+3] = char(0x7f);
+	{
+		Serializer::Reader rd(ByteRange(data.data(), data.size()));
+		GeomTree corrupt(rd);
+		cout << "Bad child offset rejected: " << (!corrupt.IsValid() ? "pass" : "fail") << endl;
+	}
+
+	// a file cut short must not be read past its end
+	{
+		Serializer::Reader rd(ByteRange(data.data(), rootOffset));
+		bool rejected = false;
+		try {
+			GeomTree truncated(rd);
+		} catch (const SavedGameCorruptException &) {
+			rejected = true;
+		}
+		cout << "Truncated tree rejected: " << (rejected ? "pass" : "fail") << endl;
+	}
+
+	// node bounds are floats; they must still hold boxes that aren't
+	{
+		Aabb box;
+		box.min = vector3d(0.1, -0.1, 1.0/3.0);
+		box.max = vector3d(0.7, 0.3, 2.0/3.0);
+		const BVHTree::objPtr_t obj = 0;
+		BVHTree tree(1, &obj, &box);
+		const BVHNode *root = tree.GetRoot();
+		bool contains = true;
+		for (int k=0; k<3; k++)
+			contains = contains && root->min[k] <= box.min[k] && root->max[k] >= box.max[k];
+		cout << "Node bounds contain their objects: " << (contains ? "pass" : "fail") << endl;
+	}
+
+	cout << "----------------------" << endl;
+	cout << "End of collider tests." << endl;
+	cout << "----------------------" << endl;
+}
@@ -0,0 +1,107 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include <iostream>
+#include <algorithm>
+#include "Random.h"
+#include "galaxy/RouteGraph.h"
+
+using namespace std;
+
+static const float SECTOR_SIZE = 8.f;
+static const int RAD = 2;
+static const int SYSTEMS_PER_SECTOR = 12;
+
+static void AddSectors(RouteGraph &graph, Random &rng)
+{
+	for (int sx = -RAD; sx <= RAD; sx++)
+		for (int sy = -RAD; sy <= RAD; sy++)
+			for (int sz = -RAD; sz <= RAD; sz++) {
+				vector<vector3f> systems;
+				for (int i = 0; i < SYSTEMS_PER_SECTOR; i++)
+					systems.push_back(SECTOR_SIZE * vector3f(float(sx + rng.Double()), float(sy + rng.Double()), float(sz + rng.Double())));
+				graph.AddSector(SystemPath(sx, sy, sz), systems);
+			}
+}
+
+// every other system within range, nearest first, as it should be
+static bool MatchesBruteForce(const RouteGraph &graph, Uint32 node, float range, const RouteGraph::NeighbourList &list)
+{
+	vector<pair<float, Uint32> > expected;
+	for (Uint32 i = 0; i < graph.GetNumNodes(); i++) {
+		if (i == node) continue;
+		const float dist = (graph.GetPosition(i) - graph.GetPosition(node)).Length();
+		if (dist <= range) expected.push_back(make_pair(dist, i));
+	}
+	sort(expected.begin(), expected.end());
+
+	// a list built for a longer range does for a shorter one
+	size_t n = 0;
+	while (n < list.nodes.size() && list.nodes[n].first <= range) n++;
+	if (n != expected.size()) return false;
+	for (size_t i = 0; i < n; i++)
+		if (list.nodes[i].second != expected[i].second) return false;
+	return true;
+}
+
+// Test suite for the route planner's systems and neighbour lists
+void test_routegraph()
+{
+	cout << "------------------------" << endl;
+	cout << "Running route graph tests" << endl;
+	cout << "------------------------" << endl;
+
+	Random rng(0x5eed);
+	RouteGraph graph(SECTOR_SIZE);
+	AddSectors(graph, rng);
+
+	const Uint32 centre = graph.FindNode(SystemPath(0, 0, 0, 5));
+	const bool found = centre != RouteGraph::NO_NODE && graph.GetPath(centre).IsSameSystem(SystemPath(0, 0, 0, 5))
+		&& graph.FindNode(SystemPath(RAD+1, 0, 0, 0)) == RouteGraph::NO_NODE;
+	cout << "Systems found by path: " << (found ? "pass" : "fail") << endl;
+
+	// everything within two sectors of the middle one is there, and nothing past it
+	vector<SystemPath> missing;
+	bool lists = true;
+	size_t entries = 0;
+	for (int i = 0; i < SYSTEMS_PER_SECTOR; i++) {
+		const Uint32 node = graph.FindNode(SystemPath(0, 0, 0, i));
+		const RouteGraph::NeighbourList *list = graph.GetNeighbours(node, 10.f, missing);
+		if (!list || !MatchesBruteForce(graph, node, 10.f, *list)) lists = false;
+		if (list) entries += list->nodes.size();
+	}
+	cout << "Neighbour lists match brute force: " << (lists && missing.empty() ? "pass" : "fail") << endl;
+	cout << "Entries counted as lists are built: " << (graph.GetNumNeighbourEntries() == entries ? "pass" : "fail") << endl;
+
+	// a shorter range is answered from the list already there
+	const RouteGraph::NeighbourList *first = graph.GetNeighbours(centre, 10.f, missing);
+	const RouteGraph::NeighbourList *shorter = graph.GetNeighbours(centre, 6.f, missing);
+	const bool reused = first == shorter && graph.GetNumNeighbourEntries() == entries && MatchesBruteForce(graph, centre, 6.f, *shorter);
+	cout << "Shorter range reuses the list: " << (reused ? "pass" : "fail") << endl;
+
+	// a longer one replaces it, and the count follows
+	const size_t before = first->nodes.size();
+	const RouteGraph::NeighbourList *longer = graph.GetNeighbours(centre, 14.f, missing);
+	const bool replaced = longer && MatchesBruteForce(graph, centre, 14.f, *longer)
+		&& graph.GetNumNeighbourEntries() == entries - before + longer->nodes.size();
+	cout << "Longer range replaces the list: " << (replaced ? "pass" : "fail") << endl;
+
+	// at the edge the range reaches into sectors that haven't been added
+	const Uint32 edge = graph.FindNode(SystemPath(RAD, 0, 0, 0));
+	const size_t entriesBefore = graph.GetNumNeighbourEntries();
+	const bool edgeMissing = !graph.GetNeighbours(edge, 10.f, missing) && !missing.empty()
+		&& graph.GetNumNeighbourEntries() == entriesBefore;
+	bool allOutside = true;
+	for (const SystemPath &p : missing)
+		if (graph.HasSector(p)) allOutside = false;
+	cout << "Missing sectors reported: " << (edgeMissing && allOutside ? "pass" : "fail") << endl;
+
+	graph.ClearNeighbours();
+	const bool cleared = graph.GetNumNeighbourEntries() == 0 && graph.GetNeighbours(centre, 10.f, missing)
+		&& graph.GetNumNeighbourEntries() == graph.GetNeighbours(centre, 10.f, missing)->nodes.size();
+	cout << "Count starts again after clearing: " << (cleared ? "pass" : "fail") << endl;
+
+	cout << "------------------------" << endl;
+	cout << "End of route graph tests." << endl;
+	cout << "------------------------" << endl;
+}
@@ -0,0 +1,80 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include <iostream>
+#include <cstring>
+#include "galaxy/SectorSystems.h"
+
+using namespace std;
+
+// FNV-1a, over everything generated for each system
+struct Fingerprint {
+	Fingerprint() : hash(14695981039346656037ULL) {}
+	void Byte(Uint8 b) { hash = (hash ^ b) * 1099511628211ULL; }
+	void Int32(Uint32 x) { for (int i = 0; i < 4; i++) Byte(Uint8(x >> (8*i))); }
+	void Float(float f) { Uint32 x; memcpy(&x, &f, 4); Int32(x); }
+	Uint64 hash;
+};
+
+static Uint64 fingerprint(const SectorSystems &systems)
+{
+	Fingerprint f;
+	for (Uint32 i = 0; i < systems.GetNumSystems(); i++) {
+		const string name = systems.GetName(i);
+		for (char c : name) f.Byte(Uint8(c));
+		f.Byte(0);
+		const vector3f p = systems.GetPosition(i);
+		f.Float(p.x);
+		f.Float(p.y);
+		f.Float(p.z);
+		f.Byte(Uint8(systems.GetNumStars(i)));
+		for (int star = 0; star < systems.GetNumStars(i); star++)
+			f.Byte(Uint8(systems.GetStarType(i, star)));
+		f.Byte(systems.IsExplored(i) ? 1 : 0);
+	}
+	return f.hash;
+}
+
+// Test suite for sector generation
+void test_sectorsystems()
+{
+	// what the sectors were when each system kept its name, position and
+	// star types in a Sector::System of its own. changing the layout
+	// mustn't change the galaxy: near Sol and far out, in the explored,
+	// partly explored and unexplored parts, at several densities
+	struct Expected {
+		int sx, sy, sz, density;
+		Uint32 numSystems;
+		Uint64 fingerprint;
+		const char *firstName;
+	};
+	const Expected expected[] = {
+		{ 0, 0, 0, 255, 10, 0x5d275b045455471dULL, "Liaayla" },
+		{ 1, -2, 3, 255, 17, 0xf2d2d26f1b301d7aULL, "Ethioar" },
+		{ -5, 4, -1, 128, 3, 0xdee20bfc50fbfd4bULL, "Soin" },
+		{ 12, -3, 0, 255, 9, 0x68ca3b1d9553789dULL, "Oldacan" },
+		{ 70, 2, -1, 255, 10, 0x516b90d378e4e2d3ULL, "SC 6609+70+2" },
+		{ -95, 10, 4, 200, 10, 0x689632886c605cbfULL, "MJBN 556-95+10" },
+		{ 300, -40, 2, 255, 8, 0x5881251f968917b8ULL, "SC 7672+300-40" },
+		{ -2, 7, -9, 64, 4, 0x4a72d25fcbcb0831ULL, "Grephi" },
+	};
+
+	cout << "---------------------------" << endl;
+	cout << "Running sector generation tests" << endl;
+	cout << "---------------------------" << endl;
+
+	for (const Expected &e : expected) {
+		const SectorSystems systems(SystemPath(e.sx, e.sy, e.sz), Uint8(e.density), 8.f);
+		const bool same = systems.GetNumSystems() == e.numSystems && fingerprint(systems) == e.fingerprint
+			&& systems.GetName(0) == e.firstName;
+		cout << "Sector (" << e.sx << "," << e.sy << "," << e.sz << "): " << (same ? "pass" : "fail") << endl;
+	}
+
+	// nothing there where the galaxy is empty
+	const SectorSystems empty(SystemPath(0, 0, 0), 0, 8.f);
+	cout << "Empty sector: " << (empty.GetNumSystems() == 0 ? "pass" : "fail") << endl;
+
+	cout << "---------------------------" << endl;
+	cout << "End of sector generation tests." << endl;
+	cout << "---------------------------" << endl;
+}
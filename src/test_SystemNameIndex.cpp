@@ -0,0 +1,106 @@
+// Copyright © 2008-2014 Pioneer Developers. See AUTHORS.txt for details
+// Licensed under the terms of the GPL v3. See licenses/GPL-3.txt
+
+#include <iostream>
+#include <cstdio>
+#include "FileSystem.h"
+#include "galaxy/SystemNameIndex.h"
+
+using namespace std;
+
+static const int RADIUS = 3;
+
+static bool WriteNames(FileSystem::FileSourceFS &fs)
+{
+	const char *NAMES[] = { "Sol", "Solace", "Barnard's Star", "Epsilon Eridani", "Alpha Centauri",
+		"Lave", "Leesti", "Diso", "Isinor", "solaris", 0 };
+	vector<SystemNameIndex::Name> names;
+	for (int i = 0; NAMES[i]; i++) {
+		SystemNameIndex::Name n = { NAMES[i], SystemPath(i % 3 - 1, i / 3 - 1, 0, i) };
+		names.push_back(n);
+	}
+	return SystemNameIndex::Write(fs, RADIUS, names);
+}
+
+// overwrite part of the index file as it stands
+static void Patch(FileSystem::FileSourceFS &fs, long offset, const void *data, size_t size)
+{
+	FILE *f = fopen(FileSystem::JoinPath(fs.GetRoot(), "systemnames.idx").c_str(), "r+b");
+	fseek(f, offset, SEEK_SET);
+	fwrite(data, size, 1, f);
+	fclose(f);
+}
+
+// Test suite for the system name index
+void test_systemnameindex()
+{
+	cout << "-----------------------------" << endl;
+	cout << "Running system name index tests" << endl;
+	cout << "-----------------------------" << endl;
+
+	// somewhere of its own, so the real index in the user dir is left alone
+	FileSystem::userFiles.MakeDirectory(""); // ensure the config directory exists
+	FileSystem::userFiles.MakeDirectory("tests");
+	FileSystem::FileSourceFS fs(FileSystem::JoinPath(FileSystem::userFiles.GetRoot(), "tests"));
+
+	const bool written = WriteNames(fs);
+	cout << "Index written: " << (written ? "pass" : "fail") << endl;
+	if (!written) return;
+
+	SystemNameIndex *index = SystemNameIndex::Load(fs, RADIUS);
+	cout << "Index loads: " << (index ? "pass" : "fail") << endl;
+	if (index) {
+		vector<SystemNameIndex::Match> results;
+
+		// names starting with it come first, shortest first, ignoring case
+		index->Search("SOL", results, 10);
+		const bool start = results.size() == 3
+			&& results[0].name == "Sol" && results[0].atStart && results[0].path.IsSameSystem(SystemPath(-1, -1, 0, 0))
+			&& results[1].name == "Solace" && results[2].name == "solaris";
+		cout << "Prefix search: " << (start ? "pass" : "fail") << endl;
+
+		index->Search("so", results, 2);
+		cout << "Results are limited: " << (results.size() == 2 && results[1].name == "Solace" ? "pass" : "fail") << endl;
+
+		// then the ones that have it anywhere else, which takes three letters
+		index->Search("eri", results, 10);
+		const bool anywhere = results.size() == 1 && !results[0].atStart && results[0].name == "Epsilon Eridani";
+		index->Search("is", results, 10);
+		const bool twoLetters = results.size() == 1 && results[0].name == "Isinor";
+		index->Search("iso", results, 10);
+		cout << "Search inside names: " << (anywhere && twoLetters && results.size() == 1 && results[0].name == "Diso" ? "pass" : "fail") << endl;
+
+		index->Search("Xyzzy", results, 10);
+		cout << "No match: " << (results.empty() ? "pass" : "fail") << endl;
+
+		delete index;
+	}
+
+	index = SystemNameIndex::Load(fs, RADIUS + 1);
+	cout << "Other radius rejected: " << (!index ? "pass" : "fail") << endl;
+	delete index;
+
+	// the first entry's name pointing past the names
+	const Uint32 badOffset = 0x7fffffff;
+	Patch(fs, 32, &badOffset, sizeof(badOffset));
+	index = SystemNameIndex::Load(fs, RADIUS);
+	cout << "Bad name offset rejected: " << (!index ? "pass" : "fail") << endl;
+	delete index;
+
+	// the last name losing its nul
+	WriteNames(fs);
+	RefCountedPtr<FileSystem::FileData> data = fs.ReadFile("systemnames.idx");
+	const long size = long(data->GetSize());
+	data.Reset();
+	const char notNul = 'x';
+	Patch(fs, size - 1, &notNul, 1);
+	index = SystemNameIndex::Load(fs, RADIUS);
+	cout << "Unterminated name rejected: " << (!index ? "pass" : "fail") << endl;
+	delete index;
+
+	remove(FileSystem::JoinPath(fs.GetRoot(), "systemnames.idx").c_str());
+
+	cout << "-----------------------------" << endl;
+	cout << "End of system name index tests." << endl;
+	cout << "-----------------------------" << endl;
+}
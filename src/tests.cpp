@@ -5,6 +5,10 @@ void test_frames();
 void test_stringf();
 void test_filesystem();
 void test_random();
+void test_collider();
+void test_systemnameindex();
+void test_routegraph();
+void test_sectorsystems();
 
 int main(int argc, char *argv[])
 {
@@ -12,5 +16,9 @@ int main(int argc, char *argv[])
 	test_stringf();
 	test_filesystem();
 	test_random();
+	test_collider();
+	test_systemnameindex();
+	test_routegraph();
+	test_sectorsystems();
 	return 0;
 }
@@ -6,6 +6,7 @@
 #include "libs.h"
 #include "graphics/Renderer.h"
 #include "graphics/VertexArray.h"
+#include "graphics/VertexBuffer.h"
 #include "TextSupport.h"
 #include "utils.h"
 #include <algorithm>
@@ -173,7 +174,12 @@ void TextureFont::RenderString(const char *str, float x, float y, const Color &c
 {
 	PROFILE_SCOPED()
 	m_vertices.Clear();
+	CreateGeometry(m_vertices, str, x, y, color);
+	m_renderer->DrawTriangles(&m_vertices, m_renderState, m_mat.get());
+}
 
+void TextureFont::CreateGeometry(Graphics::VertexArray &va, const char *str, float x, float y, const Color &color)
+{
 	float alpha_f = color.a / 255.0f;
 	const Color premult_color = Color(color.r * alpha_f, color.g * alpha_f, color.b * alpha_f, color.a);
 
@@ -195,7 +201,7 @@ void TextureFont::RenderString(const char *str, float x, float y, const Color &c
 			i += n;
 
 			const Glyph &glyph = GetGlyph(chr);
-			AddGlyphGeometry(&m_vertices, glyph, roundf(px), py, premult_color);
+			AddGlyphGeometry(&va, glyph, roundf(px), py, premult_color);
 
 			if (str[i]) {
 				Uint32 chr2;
@@ -208,8 +214,46 @@ void TextureFont::RenderString(const char *str, float x, float y, const Color &c
 			px += glyph.advX;
 		}
 	}
+}
 
-	m_renderer->DrawTriangles(&m_vertices, m_renderState, m_mat.get());
+Graphics::VertexBuffer *TextureFont::CreateVertexBuffer(const Graphics::VertexArray &va) const
+{
+	assert(va.HasAttrib(Graphics::ATTRIB_DIFFUSE) && va.HasAttrib(Graphics::ATTRIB_UV0));
+	if (va.GetNumVerts() == 0)
+		return nullptr;
+
+	Graphics::VertexBufferDesc vbd;
+	vbd.attrib[0].semantic = Graphics::ATTRIB_POSITION;
+	vbd.attrib[0].format = Graphics::ATTRIB_FORMAT_FLOAT3;
+	vbd.attrib[1].semantic = Graphics::ATTRIB_DIFFUSE;
+	vbd.attrib[1].format = Graphics::ATTRIB_FORMAT_UBYTE4;
+	vbd.attrib[2].semantic = Graphics::ATTRIB_UV0;
+	vbd.attrib[2].format = Graphics::ATTRIB_FORMAT_FLOAT2;
+	vbd.numVertices = va.GetNumVerts();
+	vbd.usage = Graphics::BUFFER_USAGE_STATIC;
+
+	struct TextVert {
+		vector3f pos;
+		Color col;
+		vector2f uv;
+	};
+
+	Graphics::VertexBuffer *vb = m_renderer->CreateVertexBuffer(vbd);
+	TextVert *vtx = vb->Map<TextVert>(Graphics::BUFFER_MAP_WRITE);
+	for (Uint32 i = 0; i < vbd.numVertices; i++) {
+		vtx[i].pos = va.position[i];
+		vtx[i].col = va.diffuse[i];
+		vtx[i].uv = va.uv0[i];
+	}
+	vb->Unmap();
+	return vb;
+}
+
+void TextureFont::RenderBuffer(Graphics::VertexBuffer *vb, const Color &tint)
+{
+	m_mat->diffuse = tint;
+	m_renderer->DrawBuffer(vb, m_renderState, m_mat.get());
+	m_mat->diffuse = Color::WHITE;
 }
 
 Color TextureFont::RenderMarkup(const char *str, float x, float y, const Color &color)
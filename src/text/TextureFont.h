@@ -17,6 +17,7 @@
 #include FT_STROKER_H
 
 namespace FileSystem { class FileData; }
+namespace Graphics { class VertexBuffer; }
 
 namespace Text {
 
@@ -54,6 +55,12 @@ public:
 
 	// fill a vertex array with single-colored text
 	void CreateGeometry(Graphics::VertexArray &, const char *str, float x, float y, const Color &color = Color::WHITE);
+	// text that doesn't change can be kept in a buffer and drawn from there.
+	// the array must come from CreateGeometry. null if it's empty
+	Graphics::VertexBuffer *CreateVertexBuffer(const Graphics::VertexArray &) const;
+	// tint multiplies the colours in the buffer, so text built in white can
+	// be drawn in any colour or opacity without building it again
+	void RenderBuffer(Graphics::VertexBuffer *, const Color &tint = Color::WHITE);
 	RefCountedPtr<Graphics::Texture> GetTexture() { return m_texture; }
 
 private:
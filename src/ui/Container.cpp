@@ -34,8 +34,30 @@ void Container::Draw()
 
 void Container::LayoutChildren()
 {
-	for (std::vector< RefCountedPtr<Widget> >::iterator i = m_widgets.begin(); i != m_widgets.end(); ++i)
-		(*i)->Layout();
+	// the rest are already laid out for the size they have
+	for (std::vector< RefCountedPtr<Widget> >::iterator i = m_widgets.begin(); i != m_widgets.end(); ++i) {
+		Widget *w = (*i).Get();
+		if (!w->m_needsLayout && w->m_layoutSize == w->GetSize())
+			continue;
+		w->m_needsLayout = false;
+		w->m_layoutSize = w->GetSize();
+		w->Layout();
+	}
+}
+
+void Container::InvalidateLayouts()
+{
+	m_needsLayout = true;
+	m_preferredSizeValid = false;
+	for (std::vector< RefCountedPtr<Widget> >::iterator i = m_widgets.begin(); i != m_widgets.end(); ++i) {
+		Widget *w = (*i).Get();
+		if (w->IsContainer())
+			static_cast<Container*>(w)->InvalidateLayouts();
+		else {
+			w->m_needsLayout = true;
+			w->m_preferredSizeValid = false;
+		}
+	}
 }
 
 void Container::AddWidget(Widget *widget)
@@ -51,7 +73,7 @@ void Container::AddWidget(Widget *widget)
 	widget->Attach(this);
 	m_widgets.push_back(RefCountedPtr<Widget>(widget));
 
-	GetContext()->RequestLayout();
+	widget->RequestLayout();
 }
 
 void Container::RemoveWidget(Widget *widget)
@@ -67,7 +89,7 @@ void Container::RemoveWidget(Widget *widget)
 	widget->Detach();
 	m_widgets.erase(i);
 
-	GetContext()->RequestLayout();
+	RequestLayout();
 }
 
 void Container::RemoveAllWidgets()
@@ -78,7 +100,7 @@ void Container::RemoveAllWidgets()
 		i = m_widgets.erase(i);
 	}
 
-	GetContext()->RequestLayout();
+	RequestLayout();
 }
 
 void Container::Disable()
@@ -25,7 +25,7 @@ class Container: public Widget {
 
 protected:
 	// can't instantiate a base container directly
-	Container(Context *context) : Widget(context), m_needsLayout(false) {}
+	Container(Context *context) : Widget(context) {}
 
 public:
 	virtual ~Container();
@@ -47,7 +47,13 @@ public:
 	const IterationProxy<const std::vector<RefCountedPtr<Widget> > > GetWidgets() const { return MakeIterationProxy(m_widgets); }
 
 protected:
+	// lays out the children that were marked by RequestLayout or resized
 	void LayoutChildren();
+	// mark every widget below here for layout
+	void InvalidateLayouts();
+	// lay out a child next time even if its size hasn't changed, for when
+	// something it depends on has
+	void SetNeedsLayout(Widget *widget) { widget->m_needsLayout = true; }
 
 	void AddWidget(Widget *);
 	virtual void RemoveWidget(Widget *);
@@ -67,7 +73,6 @@ private:
 	void EnableChildren();
 	void DisableChildren();
 
-	bool m_needsLayout;
 	std::vector< RefCountedPtr<Widget> > m_widgets;
 };
 
@@ -38,7 +38,7 @@ Context::Context(Graphics::Renderer *renderer, int width, int height) : Containe
 	m_width(width),
 	m_height(height),
 	m_scale(std::min(float(m_height)/SCALE_CUTOFF_HEIGHT, 1.0f)),
-	m_needsLayout(false),
+	m_layoutAll(false),
 	m_mousePointer(nullptr),
 	m_mousePointerEnabled(true),
 	m_eventDispatcher(this),
@@ -79,7 +79,6 @@ Layer *Context::NewLayer()
 	AddWidget(layer);
 	SetWidgetDimensions(layer, Point(0), Point(m_width, m_height));
 	m_layers.push_back(layer);
-	m_needsLayout = true;
 	return layer;
 }
 
@@ -89,7 +88,6 @@ void Context::DropLayer()
 	assert(m_layers.size() > 1);
 	RemoveWidget(m_layers.back());
 	m_layers.pop_back();
-	m_needsLayout = true;
 }
 
 void Context::DropAllLayers()
@@ -98,7 +96,6 @@ void Context::DropAllLayers()
 		RemoveWidget(*i);
 	m_layers.clear();
 	NewLayer();
-	m_needsLayout = true;
 }
 
 Widget *Context::GetWidgetAt(const Point &pos)
@@ -108,14 +105,22 @@ Widget *Context::GetWidgetAt(const Point &pos)
 
 void Context::Layout()
 {
+	if (m_layoutAll) {
+		InvalidateLayouts();
+		m_layoutAll = false;
+	}
+
 	// some widgets (eg MultiLineText) can require two layout passes because we
 	// don't know their preferred size until after their first layout run. so
-	// then we have to do layout again to make sure everyone else gets it right
+	// then we have to do layout again to make sure everyone else gets it right.
+	// either pass only visits the widgets that need it
 	m_needsLayout = false;
 
 	LayoutChildren();
-	if (m_needsLayout)
+	if (m_needsLayout) {
+		m_needsLayout = false;
 		LayoutChildren();
+	}
 
 	m_needsLayout = false;
 
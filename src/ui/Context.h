@@ -126,7 +126,9 @@ public:
 	bool Dispatch(const Event &event) { return m_eventDispatcher.Dispatch(event); }
 	bool DispatchSDLEvent(const SDL_Event &event) { return m_eventDispatcher.DispatchSDLEvent(event); }
 
-	void RequestLayout() { m_needsLayout = true; }
+	// lay out everything again, for changes that can affect any widget (eg
+	// fonts). widgets whose own size changes should use their RequestLayout
+	void RequestLayout() { m_layoutAll = true; Widget::RequestLayout(); }
 
 	void SelectWidget(Widget *target) { m_eventDispatcher.SelectWidget(target); }
 	void DeselectWidget(Widget *target) { m_eventDispatcher.DeselectWidget(target); }
@@ -160,7 +162,7 @@ private:
 
 	float m_scale;
 
-	bool m_needsLayout;
+	bool m_layoutAll;
 
 	std::vector<Layer*> m_layers;
 
@@ -4,10 +4,13 @@
 #include "Label.h"
 #include "Context.h"
 #include "text/TextureFont.h"
+#include "graphics/VertexArray.h"
 
 namespace UI {
 
-Label::Label(Context *context, const std::string &text) : Widget(context), m_text(text), m_color(Color::WHITE)
+Label::Label(Context *context, const std::string &text) : Widget(context), m_text(text), m_color(Color::WHITE),
+	m_bufferValid(false),
+	m_bufferFont(nullptr)
 {
 	RegisterBindPoint("text", sigc::mem_fun(this, &Label::BindText));
 }
@@ -32,14 +35,32 @@ void Label::Layout()
 void Label::Draw()
 {
 	static const Color disabledColor(204, 204, 204, 255);
-	const Color color(IsDisabled() ? disabledColor : m_color);
-	GetContext()->GetFont(GetFont())->RenderString(m_text.c_str(), 0.0f, 0.0f, Color(color.r, color.g, color.b, color.a*GetContext()->GetOpacity()));
+	const Color baseColor(IsDisabled() ? disabledColor : m_color);
+	const Color color(baseColor.r, baseColor.g, baseColor.b, baseColor.a*GetContext()->GetOpacity());
+	Text::TextureFont *font = GetContext()->GetFont(GetFont()).Get();
+
+	// built in white and tinted when drawn, so changing colour or fading
+	// doesn't build it again
+	if (!m_bufferValid || font != m_bufferFont) {
+		Graphics::VertexArray va(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_DIFFUSE | Graphics::ATTRIB_UV0);
+		font->CreateGeometry(va, m_text.c_str(), 0.0f, 0.0f);
+		m_buffer.Reset(font->CreateVertexBuffer(va));
+		m_bufferValid = true;
+		m_bufferFont = font;
+	}
+
+	if (m_buffer)
+		font->RenderBuffer(m_buffer.Get(), color);
 }
 
 Label *Label::SetText(const std::string &text)
 {
+	// bound labels get set over and over, mostly to the same thing
+	if (text == m_text)
+		return this;
 	m_text = text;
-	GetContext()->RequestLayout();
+	m_bufferValid = false;
+	RequestLayout();
 	return this;
 }
 
@@ -6,9 +6,12 @@
 
 #include "Widget.h"
 #include "SmartPtr.h"
+#include "graphics/VertexBuffer.h"
 
 // single line of text
 
+namespace Text { class TextureFont; }
+
 namespace UI {
 
 class Label: public Widget {
@@ -32,6 +35,11 @@ private:
 	std::string m_text;
 	Color m_color;
 	Point m_preferredSize;
+
+	// the text as drawn last, in white, kept until it or its font changes
+	RefCountedPtr<Graphics::VertexBuffer> m_buffer;
+	bool m_bufferValid;
+	Text::TextureFont *m_bufferFont;
 };
 
 }
@@ -3,6 +3,7 @@
 
 #include "List.h"
 #include "Context.h"
+#include "text/TextureFont.h"
 #include <algorithm>
 
 namespace UI {
@@ -10,8 +11,9 @@ namespace UI {
 List::List(Context *context) : Container(context), m_selected(-1)
 {
 	Context *c = GetContext();
+	m_optionsWidget = new Options(c, this);
 	m_container = c->Background();
-	m_container->SetInnerWidget(c->VBox());
+	m_container->SetInnerWidget(m_optionsWidget);
 	AddWidget(m_container);
 }
 
@@ -27,24 +29,7 @@ void List::Layout() {
 List *List::AddOption(const std::string &text)
 {
 	m_options.push_back(text);
-
-	Context *c = GetContext();
-
-	VBox *vbox = static_cast<VBox*>(m_container->GetInnerWidget());
-
-	int index = m_optionBackgrounds.size();
-
-	ColorBackground *background = c->ColorBackground(Color(0,0,0, m_selected == index ? c->GetSkin().AlphaSelect_ub() : c->GetSkin().AlphaNormal_ub()));
-	vbox->PackEnd(background->SetInnerWidget(c->Label(text)));
-
-	background->onMouseOver.connect(sigc::bind(sigc::mem_fun(this, &List::HandleOptionMouseOver), index));
-	background->onMouseOut.connect(sigc::bind(sigc::mem_fun(this, &List::HandleOptionMouseOut), index));
-	background->onClick.connect(sigc::bind(sigc::mem_fun(this, &List::HandleOptionClick), index));
-
-	m_optionBackgrounds.push_back(background);
-
-	GetContext()->RequestLayout();
-
+	m_optionsWidget->RequestLayout();
 	return this;
 }
 
@@ -78,20 +63,6 @@ void List::SetSelectedIndex(const int index)
 	assert(index < int(m_options.size()));
 
 	if (m_selected != index) {
-		if (m_selected >= 0) {
-			ColorBackground * const from = m_optionBackgrounds[m_selected];
-			from->SetColor(Color(0,0,0, from->IsMouseOver()
-						? GetContext()->GetSkin().AlphaHover_ub()
-						: GetContext()->GetSkin().AlphaNormal_ub()));
-		}
-
-		if (index >= 0) {
-			ColorBackground * const to = m_optionBackgrounds[index];
-			if (!to->IsMouseOver()) {
-				to->SetColor(Color(0,0,0, GetContext()->GetSkin().AlphaSelect_ub()));
-			}
-		}
-
 		m_selected = index;
 		onOptionSelected.emit(index, index >= 0 ? m_options[index] : "");
 	}
@@ -100,33 +71,77 @@ void List::SetSelectedIndex(const int index)
 void List::Clear()
 {
 	m_options.clear();
-	m_optionBackgrounds.clear();
-	static_cast<VBox*>(m_container->GetInnerWidget())->Clear();
 	m_selected = -1;
+	m_optionsWidget->RequestLayout();
+}
 
-	GetContext()->RequestLayout();
+void List::HandleOptionClick(int index)
+{
+	m_selected = index;
+	onOptionSelected.emit(index, m_options[index]);
 }
 
-bool List::HandleOptionMouseOver(int index)
+int List::Options::GetLineHeight() const
 {
-	m_optionBackgrounds[index]->SetColor(Color(0,0,0, GetContext()->GetSkin().AlphaHover_ub()));
-	return false;
+	return ceilf(GetContext()->GetFont(GetFont())->GetHeight());
 }
 
-bool List::HandleOptionMouseOut(int index)
+int List::Options::OptionAt(const Point &pos) const
 {
-	m_optionBackgrounds[index]->SetColor(Color(0,0,0, m_selected == index ? GetContext()->GetSkin().AlphaSelect_ub() : GetContext()->GetSkin().AlphaNormal_ub()));
-	return false;
+	if (pos.y < 0) return -1;
+	const int index = pos.y / GetLineHeight();
+	return index < int(m_list->m_options.size()) ? index : -1;
 }
 
-bool List::HandleOptionClick(int index)
+Point List::Options::PreferredSize()
 {
-	if ((index != m_selected) && (m_selected >= 0))
-		m_optionBackgrounds[m_selected]->SetColor(Color(0,0,0, GetContext()->GetSkin().AlphaNormal_ub()));
-	m_selected = index;
-	onOptionSelected.emit(index, m_options[index]);
+	RefCountedPtr<Text::TextureFont> font = GetContext()->GetFont(GetFont());
+	float width = 0.0f;
+	for (const std::string &option : m_list->m_options) {
+		float w, h;
+		font->MeasureString(option.c_str(), w, h);
+		width = std::max(width, w);
+	}
+	return Point(ceilf(width), GetLineHeight() * m_list->m_options.size());
+}
+
+void List::Options::Draw()
+{
+	const std::vector<std::string> &options = m_list->m_options;
+	if (options.empty()) return;
+
+	Context *c = GetContext();
+	const Skin &skin = c->GetSkin();
+	RefCountedPtr<Text::TextureFont> font = c->GetFont(GetFont());
+	const int lineHeight = GetLineHeight();
+	const Color textColor(Color::WHITE.r, Color::WHITE.g, Color::WHITE.b, Color::WHITE.a*c->GetOpacity());
+
+	int top, bottom;
+	GetVisibleRange(top, bottom);
+	const int first = std::max(top / lineHeight, 0);
+	const int last = std::min((bottom + lineHeight - 1) / lineHeight, int(options.size()));
+
+	const int hover = IsMouseOver() ? OptionAt(GetMousePos()) : -1;
+
+	for (int i = first; i < last; i++) {
+		const Point pos(0, i * lineHeight);
+		const Point size(GetSize().x, lineHeight);
+		if (i == hover)
+			skin.DrawRectHover(pos, size);
+		else if (i == m_list->m_selected)
+			skin.DrawRectSelect(pos, size);
+		else if (skin.AlphaNormal_ub())
+			skin.DrawRectNormal(pos, size);
+
+		font->RenderString(options[i].c_str(), 0.0f, float(pos.y), textColor);
+	}
+}
 
-	return false;
+void List::Options::HandleClick()
+{
+	const int index = OptionAt(GetMousePos());
+	if (index >= 0)
+		m_list->HandleOptionClick(index);
 }
 
 }
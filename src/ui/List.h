@@ -9,8 +9,10 @@
 namespace UI {
 
 class Background;
-class ColorBackground;
 
+// Options are drawn straight from their text, one row to a line, and only the
+// rows that can be seen are drawn. No widgets are made for them, so a list
+// can be as long as it likes.
 class List : public Container {
 public:
 	virtual Point PreferredSize();
@@ -34,15 +36,30 @@ protected:
 	List(Context *context);
 
 private:
+	class Options : public Widget {
+	public:
+		Options(Context *context, List *list) : Widget(context), m_list(list) {}
+
+		virtual Point PreferredSize();
+		virtual void Draw();
+
+	protected:
+		virtual void HandleClick();
+
+	private:
+		int GetLineHeight() const;
+		int OptionAt(const Point &pos) const;
+
+		List *m_list;
+	};
+
 	std::vector<std::string> m_options;
 	int m_selected;
 
 	Background *m_container;
-	std::vector<ColorBackground*> m_optionBackgrounds;
+	Options *m_optionsWidget;
 
-	bool HandleOptionMouseOver(int index);
-	bool HandleOptionMouseOut(int index);
-	bool HandleOptionClick(int index);
+	void HandleOptionClick(int index);
 };
 
 }
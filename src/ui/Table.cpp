@@ -5,28 +5,33 @@
 #include "Context.h"
 #include "Slider.h"
 
+#include <algorithm>
 #include <typeinfo>
 
 namespace UI {
 
 void Table::LayoutAccumulator::AddRow(const std::vector<Widget*> &widgets)
 {
-	if (m_columnWidth.size() < widgets.size()) {
+	std::vector<int> widths(widgets.size(), 0);
+	for (std::size_t i = 0; i < widgets.size(); i++)
+		if (widgets[i])
+			widths[i] = widgets[i]->CalcLayoutContribution().x;
+	AddWidths(widths);
+}
+
+void Table::LayoutAccumulator::AddWidths(const std::vector<int> &widths)
+{
+	if (m_columnWidth.size() < widths.size()) {
 		std::size_t i = m_columnWidth.size();
-		m_columnWidth.resize(widgets.size());
-		for (; i < widgets.size(); i++)
+		m_columnWidth.resize(widths.size());
+		for (; i < widths.size(); i++)
 			m_columnWidth[i] = 0;
 	}
 
 	m_preferredWidth = 0;
 	for (std::size_t i = 0; i < m_columnWidth.size(); i++) {
-		if (i < widgets.size()) {
-			Widget *w = widgets[i];
-			if (w) {
-				const Point size(w->CalcLayoutContribution());
-				m_columnWidth[i] = std::max(m_columnWidth[i], size.x);
-			}
-		}
+		if (i < widths.size())
+			m_columnWidth[i] = std::max(m_columnWidth[i], widths[i]);
 		m_preferredWidth = SizeAdd(SizeAdd(m_preferredWidth, m_columnWidth[i]), m_columnSpacing);
 	}
 	m_preferredWidth = SizeAdd(m_preferredWidth, -m_columnSpacing);
@@ -102,7 +107,13 @@ Table::Inner::Inner(Context *context, LayoutAccumulator &layout) : Container(con
 	m_rowSpacing(0),
 	m_rowAlignment(ROW_TOP),
 	m_dirty(false),
-	m_mouseEnabled(false)
+	m_mouseEnabled(false),
+	m_source(nullptr),
+	m_numSourceRows(0),
+	m_firstRow(0),
+	m_fixedRowHeight(0),
+	m_seenRowHeight(0),
+	m_rebind(false)
 {
 }
 
@@ -111,6 +122,16 @@ Point Table::Inner::PreferredSize()
 	if (!m_dirty)
 		return m_preferredSize;
 
+	// sized before any rows have been seen, so there's room to show some
+	if (m_source) {
+		m_preferredSize.x = m_layout.Empty() ? 0 : m_layout.GetPreferredWidth();
+		m_preferredSize.y = 0;
+		if (m_numSourceRows)
+			m_preferredSize.y = m_numSourceRows*GetSourceRowHeight() + (m_numSourceRows-1)*m_rowSpacing;
+		m_dirty = false;
+		return m_preferredSize;
+	}
+
 	if (m_layout.Empty()) {
 		m_preferredSize = Point();
 		return m_preferredSize;
@@ -145,42 +166,206 @@ void Table::Inner::Layout()
 	if (m_dirty)
 		PreferredSize();
 
+	if (m_source) {
+		BindSourceRows();
+		const int rowHeight = GetSourceRowHeight();
+		for (std::size_t i = 0; i < m_rows.size(); i++)
+			LayoutRow(m_rows[i], (m_firstRow+i) * (rowHeight+m_rowSpacing), rowHeight);
+		LayoutChildren();
+		return;
+	}
+
 	int rowTop = 0;
 
+	for (std::size_t i = 0; i < m_rows.size(); i++) {
+		LayoutRow(m_rows[i], rowTop, m_rowHeight[i]);
+		rowTop += m_rowHeight[i] + m_rowSpacing;
+	}
+
+	LayoutChildren();
+}
+
+void Table::Inner::LayoutRow(const std::vector<Widget*> &row, int rowTop, int rowHeight)
+{
 	const std::vector<int> &colWidth = m_layout.ColumnWidth();
 	const std::vector<int> &colLeft = m_layout.ColumnLeft();
 
+	// a row from a source can turn up before the columns know about it. it
+	// will have asked for another layout
+	const std::size_t numCols = std::min(row.size(), colLeft.size());
+
+	for (std::size_t j = 0; j < numCols; j++) {
+		Widget *w = row[j];
+		if (!w) continue;
+
+		const Point preferredSize(w->PreferredSize());
+		int height = std::min(preferredSize.y, rowHeight);
+
+		int off = 0;
+		if (height != rowHeight) {
+			switch (m_rowAlignment) {
+				case ROW_CENTER:
+					off = (rowHeight - height) / 2;
+					break;
+				case ROW_BOTTOM:
+					off = rowHeight - height;
+					break;
+				default:
+					off = 0;
+					break;
+			}
+		}
+
+		SetWidgetDimensions(w, Point(colLeft[j], rowTop+off), Point(colWidth[j], height));
+	}
+}
+
+void Table::Inner::Update()
+{
+	// scrolled past the rows that have widgets
+	if (m_source && m_numSourceRows) {
+		unsigned first, end;
+		GetRowsInView(first, end);
+		if (first < m_firstRow || end > m_firstRow + m_rows.size())
+			RequestLayout();
+	}
+
+	Container::Update();
+}
+
+int Table::Inner::GetSourceRowHeight() const
+{
+	if (m_fixedRowHeight > 0)
+		return m_fixedRowHeight;
+	if (m_seenRowHeight > 0)
+		return m_seenRowHeight;
+	return ceilf(GetContext()->GetFont(GetFont())->GetHeight());
+}
+
+void Table::Inner::GetRowsInView(unsigned &first, unsigned &end) const
+{
+	const int pitch = std::max(GetSourceRowHeight() + m_rowSpacing, 1);
+
+	int top, bottom;
+	GetVisibleRange(top, bottom);
+	if (bottom <= top) {
+		first = end = 0;
+		return;
+	}
+
+	first = Clamp(top / pitch, 0, int(m_numSourceRows));
+	end = Clamp((bottom + pitch - 1) / pitch, 0, int(m_numSourceRows));
+}
+
+void Table::Inner::BindSourceRows()
+{
+	// a screenful either side, so scrolling doesn't need new rows every frame
+	unsigned first, end;
+	GetRowsInView(first, end);
+	const unsigned extra = end - first;
+	first = first > extra ? first - extra : 0;
+	end = std::min(end + extra, m_numSourceRows);
+
+	std::vector< std::vector<Widget*> > rows(end - first);
+	std::vector<bool> bound(end - first, false);
+	std::vector< std::vector<Widget*> > spare;
+
 	for (std::size_t i = 0; i < m_rows.size(); i++) {
-		const std::vector<Widget*> &row = m_rows[i];
-		for (std::size_t j = 0; j < row.size(); j++) {
-			Widget *w = row[j];
-			if (!w) continue;
+		const unsigned row = m_firstRow + i;
+		if (!m_rebind && row >= first && row < end) {
+			rows[row-first].swap(m_rows[i]);
+			bound[row-first] = true;
+		} else {
+			spare.push_back(std::vector<Widget*>());
+			spare.back().swap(m_rows[i]);
+		}
+	}
+	m_rebind = false;
 
-			const Point preferredSize(w->PreferredSize());
-			int height = std::min(preferredSize.y, m_rowHeight[i]);
-
-			int off = 0;
-			if (height != m_rowHeight[i]) {
-				switch (m_rowAlignment) {
-					case ROW_CENTER:
-						off = (m_rowHeight[i] - height) / 2;
-						break;
-					case ROW_BOTTOM:
-						off = m_rowHeight[i] - height;
-						break;
-					default:
-						off = 0;
-						break;
-				}
-			}
+	for (unsigned row = first; row < end; row++) {
+		if (bound[row-first]) continue;
 
-			SetWidgetDimensions(w, Point(colLeft[j], rowTop+off), Point(colWidth[j], height));
+		std::vector<Widget*> &widgets = rows[row-first];
+		if (!spare.empty()) {
+			widgets.swap(spare.back());
+			spare.pop_back();
 		}
 
-		rowTop += m_rowHeight[i] + m_rowSpacing;
+		const std::vector<Widget*> old(widgets);
+		m_source->GetRow(row, widgets);
+
+		for (Widget *w : old)
+			if (w && std::find(widgets.begin(), widgets.end(), w) == widgets.end())
+				RemoveWidget(w);
+		for (Widget *w : widgets)
+			if (w && w->GetContainer() != this)
+				AddWidget(w);
 	}
 
-	LayoutChildren();
+	for (const std::vector<Widget*> &row : spare)
+		for (Widget *w : row)
+			if (w) RemoveWidget(w);
+
+	m_rows.swap(rows);
+	m_firstRow = first;
+
+	// the columns and rows are sized from the rows seen so far. if they've
+	// grown, the table needs to know
+	bool grown = false;
+	for (const std::vector<Widget*> &row : m_rows) {
+		if (m_seenColumnWidth.size() < row.size())
+			m_seenColumnWidth.resize(row.size(), 0);
+		for (std::size_t j = 0; j < row.size(); j++) {
+			if (!row[j]) continue;
+			const Point size(row[j]->CalcLayoutContribution());
+			if (size.x > m_seenColumnWidth[j]) {
+				m_seenColumnWidth[j] = size.x;
+				grown = true;
+			}
+			if (!m_fixedRowHeight && size.y > m_seenRowHeight) {
+				m_seenRowHeight = size.y;
+				grown = true;
+			}
+		}
+	}
+	if (grown) {
+		m_dirty = true;
+		RequestLayout();
+	}
+}
+
+void Table::Inner::ReleaseSourceRows()
+{
+	for (const std::vector<Widget*> &row : m_rows)
+		for (Widget *w : row)
+			if (w) RemoveWidget(w);
+	m_rows.clear();
+	m_firstRow = 0;
+}
+
+void Table::Inner::SetRowSource(RowSource *source)
+{
+	ReleaseSourceRows();
+	m_preferredSize = Point();
+	m_source = source;
+	m_numSourceRows = source ? source->GetNumRows() : 0;
+	m_seenColumnWidth.clear();
+	m_seenRowHeight = 0;
+	m_dirty = true;
+}
+
+void Table::Inner::RefreshRows()
+{
+	if (!m_source) return;
+	m_numSourceRows = m_source->GetNumRows();
+	m_rebind = true;
+	m_dirty = true;
+}
+
+void Table::Inner::SetRowHeight(int height)
+{
+	m_fixedRowHeight = height;
+	m_dirty = true;
 }
 
 void Table::Inner::Draw()
@@ -195,6 +380,7 @@ void Table::Inner::Draw()
 
 void Table::Inner::AddRow(const std::vector<Widget*> &widgets)
 {
+	assert(!m_source);
 	m_rows.push_back(widgets);
 
 	Point rowSize;
@@ -208,23 +394,24 @@ void Table::Inner::AddRow(const std::vector<Widget*> &widgets)
 
 void Table::Inner::Clear()
 {
-	for (std::vector< std::vector<Widget*> >::const_iterator i = m_rows.begin(); i != m_rows.end(); ++i) {
-		for (std::size_t j = 0; j < (*i).size(); j++) {
-			if (!(*i)[j]) continue;
-			RemoveWidget((*i)[j]);
-		}
-	}
-
-	m_rows.clear();
+	ReleaseSourceRows();
 	m_preferredSize = Point();
 
-	m_dirty = false;
+	// a source stays set, and is asked for its rows again
+	if (m_source) {
+		m_numSourceRows = m_source->GetNumRows();
+		m_dirty = true;
+	} else
+		m_dirty = false;
 }
 
 void Table::Inner::AccumulateLayout()
 {
-	for (std::vector< std::vector<Widget*> >::const_iterator i = m_rows.begin(); i != m_rows.end(); ++i)
-		m_layout.AddRow(*i);
+	if (m_source)
+		m_layout.AddWidths(m_seenColumnWidth);
+	else
+		for (std::vector< std::vector<Widget*> >::const_iterator i = m_rows.begin(); i != m_rows.end(); ++i)
+			m_layout.AddRow(*i);
 
 	m_dirty = true;
 }
@@ -254,6 +441,20 @@ void Table::Inner::HandleClick()
 
 int Table::Inner::RowUnderPoint(const Point &pt, int *out_row_top, int *out_row_bottom) const
 {
+	if (m_source) {
+		const int rowHeight = GetSourceRowHeight();
+		const int pitch = std::max(rowHeight + m_rowSpacing, 1);
+		const int row = pt.y >= 0 ? pt.y / pitch : -1;
+		if (row >= 0 && unsigned(row) < m_numSourceRows && pt.y < row*pitch + rowHeight) {
+			if (out_row_top) { *out_row_top = row*pitch; }
+			if (out_row_bottom) { *out_row_bottom = row*pitch + rowHeight; }
+			return row;
+		}
+		if (out_row_top) { *out_row_top = 0; }
+		if (out_row_bottom) { *out_row_bottom = 0; }
+		return -1;
+	}
+
 	int start = 0, end = m_rows.size()-1, mid = 0;
 	while (start <= end) {
 		mid = start+((end-start)/2);
@@ -358,6 +559,10 @@ void Table::Layout()
 
 	SetWidgetDimensions(m_body.Get(), Point(0, top), size);
 
+	// the columns may have moved even if they haven't been resized
+	SetNeedsLayout(m_header.Get());
+	SetNeedsLayout(m_body.Get());
+
 	LayoutChildren();
 }
 
@@ -371,7 +576,7 @@ Table *Table::SetHeadingRow(const WidgetSet &set)
 	m_header->Clear();
 	m_header->AddRow(set.widgets);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -379,7 +584,7 @@ Table *Table::AddRow(const WidgetSet &set)
 {
 	m_body->AddRow(set.widgets);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -387,14 +592,37 @@ void Table::ClearRows()
 {
 	m_body->Clear();
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
+}
+
+Table *Table::SetRowSource(RowSource *source)
+{
+	m_body->SetRowSource(source);
+	m_dirty = true;
+	RequestLayout();
+	return this;
+}
+
+void Table::RefreshRows()
+{
+	m_body->RefreshRows();
+	m_dirty = true;
+	RequestLayout();
+}
+
+Table *Table::SetRowHeight(int height)
+{
+	m_body->SetRowHeight(height);
+	m_dirty = true;
+	RequestLayout();
+	return this;
 }
 
 Table *Table::SetRowSpacing(int spacing)
 {
 	m_body->SetRowSpacing(spacing);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -402,7 +630,7 @@ Table *Table::SetColumnSpacing(int spacing)
 {
 	m_layout.SetColumnSpacing(spacing);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -410,7 +638,7 @@ Table *Table::SetRowAlignment(RowAlignDirection dir)
 {
 	m_body->SetRowAlignment(dir);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -418,7 +646,7 @@ Table *Table::SetColumnAlignment(ColumnAlignDirection mode)
 {
 	m_layout.SetColumnAlignment(mode);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
@@ -426,7 +654,7 @@ Table *Table::SetHeadingFont(Font font)
 {
 	m_header->SetFont(font);
 	m_dirty = true;
-	GetContext()->RequestLayout();
+	RequestLayout();
 	return this;
 }
 
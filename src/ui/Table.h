@@ -16,13 +16,38 @@ protected:
 	Table(Context *context);
 
 public:
+	// rows for a table that's too long to have widgets for all of them. the
+	// table only asks for the rows in view (and some either side), and
+	// hands back the widgets of rows that have gone out of view to be reused
+	class RowSource {
+	public:
+		virtual ~RowSource() {}
+		virtual unsigned GetNumRows() = 0;
+		// set widgets to the row's cells. it holds the cells of a row that
+		// has gone out of view, or is empty; reuse them or replace them.
+		// the table owns them once they're returned
+		virtual void GetRow(unsigned row, std::vector<Widget*> &widgets) = 0;
+	};
+
 	virtual Point PreferredSize();
 	virtual void Layout();
 
 	Table *SetHeadingRow(const WidgetSet &set);
 	Table *AddRow(const WidgetSet &set);
+	// drop the rows. a row source stays set, and its rows are asked for
+	// again
 	void ClearRows();
 
+	// take the rows from source instead of AddRow, until it's set to null.
+	// the table doesn't own it
+	Table *SetRowSource(RowSource *source);
+	// ask the source for the rows in view again, after they or their number
+	// have changed
+	void RefreshRows();
+	// the height of every row from a source. if it isn't set, it's the
+	// tallest row seen so far
+	Table *SetRowHeight(int height);
+
 	Table *SetRowSpacing(int spacing);
 	Table *SetColumnSpacing(int spacing);
 
@@ -60,6 +85,7 @@ private:
 		LayoutAccumulator() : m_columnSpacing(0), m_preferredWidth(0), m_columnAlignment(COLUMN_LEFT) {}
 
 		void AddRow(const std::vector<Widget*> &widgets);
+		void AddWidths(const std::vector<int> &widths);
 		void Clear();
 
 		bool Empty() const { return m_columnWidth.empty(); }
@@ -89,11 +115,16 @@ private:
 
 		virtual Point PreferredSize();
 		virtual void Layout();
+		virtual void Update();
 		virtual void Draw();
 
 		void AddRow(const std::vector<Widget*> &widgets);
 		void Clear();
 
+		void SetRowSource(RowSource *source);
+		void RefreshRows();
+		void SetRowHeight(int height);
+
 		void AccumulateLayout();
 
 		void SetRowSpacing(int spacing);
@@ -110,6 +141,14 @@ private:
 
 	private:
 		int RowUnderPoint(const Point &pt, int *out_row_top = 0, int *out_row_bottom = 0) const;
+		void LayoutRow(const std::vector<Widget*> &row, int rowTop, int rowHeight);
+
+		// with a source, m_rows holds the rows from m_firstRow that have
+		// widgets, which are the rows in view and some either side
+		int GetSourceRowHeight() const;
+		void GetRowsInView(unsigned &first, unsigned &end) const;
+		void BindSourceRows();
+		void ReleaseSourceRows();
 
 		LayoutAccumulator &m_layout;
 		std::vector< std::vector<Widget*> > m_rows;
@@ -120,6 +159,14 @@ private:
 		bool m_dirty;
 
 		bool m_mouseEnabled;
+
+		RowSource *m_source;
+		unsigned m_numSourceRows;
+		unsigned m_firstRow;
+		int m_fixedRowHeight;
+		int m_seenRowHeight;
+		std::vector<int> m_seenColumnWidth; // widest cell seen in each column
+		bool m_rebind;
 	};
 
 	LayoutAccumulator m_layout;
@@ -6,11 +6,13 @@
 #include "RefCounted.h"
 #include "text/TextureFont.h"
 #include "Color.h"
+#include "graphics/VertexArray.h"
 
 namespace UI {
 
 TextLayout::TextLayout(const RefCountedPtr<Text::TextureFont> &font, const std::string &text) :
-	m_font(font)
+	m_font(font),
+	m_bufferValid(false)
 {
 	if (!text.size())
 		return;
@@ -101,21 +103,26 @@ Point TextLayout::ComputeSize(const Point &layoutSize)
 
 	m_lastRequested = layoutSize;
 	m_lastSize = bounds;
+	m_bufferValid = false;
 
 	return bounds;
 }
 
-void TextLayout::Draw(const Point &layoutSize, const Point &drawPos, const Point &drawSize, const Color &color)
+void TextLayout::Draw(const Point &layoutSize, const Color &color)
 {
 	ComputeSize(layoutSize);
 
-	const int top = -drawPos.y - m_font->GetHeight();
-	const int bottom = -drawPos.y + drawSize.y;
-
-	for (std::vector<Word>::iterator i = m_words.begin(); i != m_words.end(); ++i) {
-		if ((*i).pos.y >= top && (*i).pos.y < bottom)
-			m_font->RenderString((*i).text.c_str(), (*i).pos.x, (*i).pos.y, color);
+	// in white; the colour is a tint when it's drawn
+	if (!m_bufferValid) {
+		Graphics::VertexArray va(Graphics::ATTRIB_POSITION | Graphics::ATTRIB_DIFFUSE | Graphics::ATTRIB_UV0);
+		for (std::vector<Word>::iterator i = m_words.begin(); i != m_words.end(); ++i)
+			m_font->CreateGeometry(va, (*i).text.c_str(), (*i).pos.x, (*i).pos.y);
+		m_buffer.Reset(m_font->CreateVertexBuffer(va));
+		m_bufferValid = true;
 	}
+
+	if (m_buffer)
+		m_font->RenderBuffer(m_buffer.Get(), color);
 }
 
 }
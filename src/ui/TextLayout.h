@@ -7,6 +7,7 @@
 #include "Point.h"
 #include "RefCounted.h"
 #include "Color.h"
+#include "graphics/VertexBuffer.h"
 #include <string>
 #include <vector>
 
@@ -21,7 +22,10 @@ public:
 
 	Point ComputeSize(const Point &layoutSize);
 
-	void Draw(const Point &layoutSize, const Point &drawPos, const Point &drawSize, const Color &color = Color::WHITE);
+	// all of it in one draw, from a buffer that's kept until the layout or
+	// the colour changes. the scissor takes care of anything outside the
+	// widget
+	void Draw(const Point &layoutSize, const Color &color = Color::WHITE);
 
 private:
 	struct Word {
@@ -35,6 +39,9 @@ private:
 	Point m_lastSize;        // and the resulting size
 
 	RefCountedPtr<Text::TextureFont> m_font;
+
+	RefCountedPtr<Graphics::VertexBuffer> m_buffer;
+	bool m_bufferValid;
 };
 
 }
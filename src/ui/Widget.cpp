@@ -12,6 +12,10 @@ Widget::Widget(Context *context) :
 	m_container(0),
 	m_position(0),
 	m_size(0),
+	m_needsLayout(true),
+	m_layoutSize(0),
+	m_preferredSizeValid(false),
+	m_cachedPreferredSize(0),
 	m_sizeControlFlags(0),
 	m_drawOffset(0),
 	m_activeOffset(0),
@@ -44,6 +48,21 @@ Point Widget::GetAbsolutePosition() const
 	return m_container->GetAbsolutePosition() + m_position + m_drawOffset;
 }
 
+void Widget::GetVisibleRange(int &top, int &bottom) const
+{
+	// each widget is clipped to its own rectangle, before its draw offset
+	// moves its content
+	top = INT_MIN;
+	bottom = INT_MAX;
+	int offset = 0;
+	for (const Widget *w = this; w; w = w->m_container) {
+		const int clipTop = -w->m_drawOffset.y - offset;
+		top = std::max(top, clipTop);
+		bottom = std::min(bottom, clipTop + w->m_size.y);
+		offset += w->m_position.y + w->m_drawOffset.y;
+	}
+}
+
 Point Widget::GetMousePos() const
 {
 	return m_context->GetMousePos() - GetAbsolutePosition();
@@ -93,13 +112,31 @@ void Widget::SetActiveArea(const Point &activeArea, const Point &activeOffset)
 Widget *Widget::SetFont(Font font)
 {
 	m_font = font;
+	// children may inherit it, so everything
 	GetContext()->RequestLayout();
 	return this;
 }
 
+void Widget::RequestLayout()
+{
+	for (Widget *w = this; w; w = w->m_container) {
+		w->m_needsLayout = true;
+		w->m_preferredSizeValid = false;
+	}
+}
+
+const Point &Widget::GetPreferredSize()
+{
+	if (!m_preferredSizeValid) {
+		m_cachedPreferredSize = PreferredSize();
+		m_preferredSizeValid = true;
+	}
+	return m_cachedPreferredSize;
+}
+
 Point Widget::CalcLayoutContribution()
 {
-	Point preferredSize = PreferredSize();
+	Point preferredSize = GetPreferredSize();
 	const Uint32 flags = GetSizeControlFlags();
 
 	if (flags & NO_WIDTH)
@@ -120,7 +157,7 @@ Point Widget::CalcSize(const Point &avail)
 	if (!(GetSizeControlFlags() & PRESERVE_ASPECT))
 		return avail;
 
-	const Point preferredSize = PreferredSize();
+	const Point preferredSize = GetPreferredSize();
 
 	float wantRatio = float(preferredSize.x) / float(preferredSize.y);
 
@@ -68,8 +68,10 @@
 //
 // Event handlers from user input are called before Layout(), which gives a
 // widget an opportunity to modify the layout based on input. If a widget
-// wants to change its size it must call GetContext()->RequestLayout() to
-// force a layout change to occur.
+// wants to change its size it must call RequestLayout() to force a layout
+// change to occur. That marks the widget and its containers; on the next
+// layout only marked widgets and widgets whose size changed are laid out,
+// and preferred sizes are remembered until a widget is marked again.
 //
 // Event handlers are called against the "leaf" widgets first. Handlers return
 // a bool to indicate if the event was "handled" or not. If a widget has no
@@ -114,6 +116,11 @@ public:
 	// position relative to top container
 	Point GetAbsolutePosition() const;
 
+	// the vertical range of the widget's content that isn't clipped away by
+	// it or its containers, in its own coordinates. for widgets that only
+	// want to make or draw what can be seen. ignores animation
+	void GetVisibleRange(int &top, int &bottom) const;
+
 	// size control flags let a widget tell its container how it wants to be
 	// sized when it can't get its preferred size
 	Uint32 GetSizeControlFlags() const { return m_sizeControlFlags; }
@@ -143,6 +150,10 @@ public:
 		return (point.x >= min_corner.x && point.y >= min_corner.y && point.x < max_corner.x && point.y < max_corner.y);
 	}
 
+	// mark the widget and its containers for layout, because something that
+	// changes its preferred size or its layout has changed
+	void RequestLayout();
+
 	// calculate layout contribution based on preferred size and flags
 	Point CalcLayoutContribution();
 	// calculate size based on available space, preferred size and flags
@@ -409,6 +420,14 @@ private:
 	Point m_position;
 	Point m_size;
 
+	// PreferredSize, until the next RequestLayout
+	const Point &GetPreferredSize();
+
+	bool m_needsLayout;
+	Point m_layoutSize; // size when last laid out
+	bool m_preferredSizeValid;
+	Point m_cachedPreferredSize;
+
 	Uint32 m_sizeControlFlags;
 
 	Point m_drawOffset;
@@ -105,6 +105,35 @@ static bool remove_floating_widget(UI::Context *c, UI::Widget *widget)
 }
 #endif
 
+#if 0
+// far too many rows to have widgets for all of them
+class NumberRows : public UI::Table::RowSource {
+public:
+	NumberRows(UI::Context *c, unsigned numRows) : m_context(c), m_numRows(numRows) {}
+
+	virtual unsigned GetNumRows() { return m_numRows; }
+
+	virtual void GetRow(unsigned row, std::vector<UI::Widget*> &widgets) {
+		if (widgets.size() != 2) {
+			widgets.clear();
+			widgets.push_back(m_context->Label(""));
+			widgets.push_back(m_context->Label(""));
+		}
+		char buf[32];
+		snprintf(buf, sizeof(buf), "%u", row);
+		static_cast<UI::Label*>(widgets[0])->SetText(buf);
+		snprintf(buf, sizeof(buf), "%llu", (unsigned long long)row*row);
+		static_cast<UI::Label*>(widgets[1])->SetText(buf);
+	}
+
+	void SetNumRows(unsigned numRows) { m_numRows = numRows; }
+
+private:
+	UI::Context *m_context;
+	unsigned m_numRows;
+};
+#endif
+
 static void animation_callback(int n)
 {
 	printf("%d animation completed\n", n);
@@ -655,6 +684,15 @@ int main(int argc, char **argv)
 	c->GetTopLayer()->SetInnerWidget(t);
 #endif
 
+#if 0
+	NumberRows rows(c.Get(), 100000);
+	UI::Table *t = c->Table();
+	t->SetHeadingRow(UI::WidgetSet(c->Label("n"), c->Label("n squared")));
+	t->SetRowSource(&rows);
+	t->SetMouseEnabled(true);
+	c->GetTopLayer()->SetInnerWidget(t);
+#endif
+
 	//int count = 0;
 
 	while (1) {
@@ -694,6 +732,16 @@ int main(int argc, char **argv)
 			Output("%d\n", count);
 #endif
 
+#if 0
+		// scroll the row source from end to end, and clear it now and then;
+		// it should come back with half as many rows
+		t->SetScrollPosition(float(++count % 1000) / 1000.0f);
+		if (count % 1000 == 0) {
+			rows.SetNumRows(std::max(rows.GetNumRows() / 2, 1u));
+			t->ClearRows();
+		}
+#endif
+
 #if 0
 		if (++count % 10 == 0)
 			text->AppendText("line\n");
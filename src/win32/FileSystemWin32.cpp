@@ -108,6 +108,17 @@ namespace FileSystem {
 		return MakeFileInfo(path, file_type_for_attributes(attrs));
 	}
 
+	// files at least this big are mapped rather than read. for anything
+	// smaller setting up the mapping costs more than copying the data
+	static const size_t MMAP_MIN_SIZE = 64 * 1024;
+
+	class FileDataMmap : public FileData {
+	public:
+		FileDataMmap(const FileInfo &info, size_t size, void *view):
+			FileData(info, size, static_cast<char*>(view)) {}
+		virtual ~FileDataMmap() { UnmapViewOfFile(m_data); }
+	};
+
 	RefCountedPtr<FileData> FileSourceFS::ReadFile(const std::string &path)
 	{
 		const std::string fullpath = JoinPathBelow(GetRoot(), path);
@@ -124,6 +135,19 @@ namespace FileSystem {
 			}
 			size_t size = size_t(large_size.QuadPart);
 
+			if (size >= MMAP_MIN_SIZE) {
+				// copy-on-write, so anything scribbling on its buffer gets its own pages
+				HANDLE mapping = CreateFileMappingW(filehandle, 0, PAGE_WRITECOPY, 0, 0, 0);
+				void *view = mapping ? MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : 0;
+				// the view keeps the file open by itself
+				if (mapping) CloseHandle(mapping);
+				if (view) {
+					CloseHandle(filehandle);
+					return RefCountedPtr<FileData>(new FileDataMmap(MakeFileInfo(path, FileInfo::FT_FILE), size, view));
+				}
+				// fall back to reading it
+			}
+
 			char *data = static_cast<char*>(std::malloc(size));
 			if (!data) {
 				// XXX handling memory allocation failure gracefully is too hard right now
@@ -156,6 +180,11 @@ namespace FileSystem {
 		}
 	}
 
+	void FileSourceFS::Prefetch(const std::string &path)
+	{
+		// nothing cheap to ask windows for here; its own read-ahead has to do
+	}
+
 	bool FileSourceFS::ReadDirectory(const std::string &dirpath, std::vector<FileInfo> &output)
 	{
 		size_t output_head_size = output.size();
@@ -239,6 +268,7 @@ namespace FileSystem {
 	FILE* FileSourceFS::OpenWriteStream(const std::string &path, int flags)
 	{
 		const std::string fullpath = JoinPathBelow(GetRoot(), path);
-		return open_file_raw(fullpath, (flags & WRITE_TEXT) ? L"w" : L"wb");
+		const wchar_t *mode = (flags & WRITE_APPEND) ? ((flags & WRITE_TEXT) ? L"a" : L"ab") : ((flags & WRITE_TEXT) ? L"w" : L"wb");
+		return open_file_raw(fullpath, mode);
 	}
 }